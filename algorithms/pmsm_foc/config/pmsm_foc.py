@@ -216,10 +216,158 @@ mcPmsmFocMclv2PwmDict = {'MCLV2' : {
 #PWM dictionary used to send message to PWM PLIB
 pwmDict = {}
 
+# Hot path placement per device series: default placement, CPU clock, flash wait states and
+# flash line width for the stall report, and the memory available for placed code and data
+mcPmsmFocPlacementDict = { 'SAME70'  : { 'PLACEMENT'           : 'PLACEMENT_TCM',
+                                         'CPU_CLOCK'           : 300000000,
+                                         'FLASH_WAIT_STATES'   : 6,
+                                         'FLASH_LINE_BYTES'    : 16,
+                                         'CODE_BYTES'          : 32768,
+                                         'DATA_BYTES'          : 32768,
+                                       },
+                           'SAME54'  : { 'PLACEMENT'           : 'PLACEMENT_RAM',
+                                         'CPU_CLOCK'           : 120000000,
+                                         'FLASH_WAIT_STATES'   : 5,
+                                         'FLASH_LINE_BYTES'    : 8,
+                                         'CODE_BYTES'          : 16384,
+                                         'DATA_BYTES'          : 0,
+                                       },
+                           'PIC32MK' : { 'PLACEMENT'           : 'PLACEMENT_RAM',
+                                         'CPU_CLOCK'           : 120000000,
+                                         'FLASH_WAIT_STATES'   : 3,
+                                         'FLASH_LINE_BYTES'    : 16,
+                                         'CODE_BYTES'          : 16384,
+                                         'DATA_BYTES'          : 0,
+                                       },
+                         }
+
+# Hot path profile of the control interrupt. CALLS per PWM period and the cycle BUDGET per call
+# at the CPU clock, to be compared with the ISR profiler stage times. The first entry is the
+# interrupt itself, its budget covers the other entries. IF is the preprocessor condition under
+# which the entry is part of the interrupt.
+mcPmsmFocPlacementProfileDict = { 'CODE' : [ { 'NAME' : 'MCCTRL_CurrentLoopTasks',    'CALLS' : 1, 'BUDGET' : 3000, 'IF' : '' },
+                                             { 'NAME' : 'MCCUR_CurrentMeasurement',   'CALLS' : 1, 'BUDGET' : 150,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT)' },
+                                             { 'NAME' : 'MCVOL_VoltageMeasurement',   'CALLS' : 1, 'BUDGET' : 60,   'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT)' },
+                                             { 'NAME' : 'MCPWM_VoltageReconstruction', 'CALLS' : 1, 'BUDGET' : 100, 'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (VOLTAGE_RECONSTRUCTION == ENABLED)' },
+                                             { 'NAME' : 'MCLIB_ClarkeTransform',      'CALLS' : 1, 'BUDGET' : 40,   'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT)' },
+                                             { 'NAME' : 'MCLIB_ParkTransform',        'CALLS' : 1, 'BUDGET' : 40,   'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (FUSED_FOC_KERNEL == DISABLED)' },
+                                             { 'NAME' : 'MCRPOS_PositionMeasurement', 'CALLS' : 1, 'BUDGET' : 600,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT)' },
+                                             { 'NAME' : 'MCLIB_PIControl',            'CALLS' : 2, 'BUDGET' : 80,   'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (FUSED_FOC_KERNEL == DISABLED)' },
+                                             { 'NAME' : 'MCLIB_SinCosCalc',           'CALLS' : 2, 'BUDGET' : 120,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT)' },
+                                             { 'NAME' : 'MCLIB_SinCosTable',          'CALLS' : 2, 'BUDGET' : 100,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (SINCOS_METHOD == SINCOS_INTERPOLATED_TABLE)' },
+                                             { 'NAME' : 'MCLIB_SinCosPolynomial',     'CALLS' : 2, 'BUDGET' : 100,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (SINCOS_METHOD == SINCOS_POLYNOMIAL)' },
+                                             { 'NAME' : 'MCLIB_SinCosQuarterWave',    'CALLS' : 2, 'BUDGET' : 100,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (SINCOS_METHOD == SINCOS_QUARTER_WAVE_TABLE)' },
+                                             { 'NAME' : 'MCLIB_SinCosCordic',         'CALLS' : 2, 'BUDGET' : 200,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (SINCOS_METHOD == SINCOS_CORDIC)' },
+                                             { 'NAME' : 'MCLIB_InvParkTransform',     'CALLS' : 1, 'BUDGET' : 40,   'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (FUSED_FOC_KERNEL == DISABLED)' },
+                                             { 'NAME' : 'MCFOC_CurrentLoopKernel',    'CALLS' : 1, 'BUDGET' : 500,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (FUSED_FOC_KERNEL == ENABLED)' },
+                                             { 'NAME' : 'MCPWM_PWMModulator',         'CALLS' : 1, 'BUDGET' : 300,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (FUSED_FOC_KERNEL == DISABLED)' },
+                                             { 'NAME' : 'MCPWM_SVPWMGen',             'CALLS' : 1, 'BUDGET' : 200,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (FUSED_FOC_KERNEL == DISABLED)' },
+                                             { 'NAME' : 'MCPWM_SVPWMSectorTree',      'CALLS' : 1, 'BUDGET' : 180,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (SVPWM_METHOD == SVPWM_SECTOR_TREE)' },
+                                             { 'NAME' : 'MCPWM_SVPWMMinMax',          'CALLS' : 1, 'BUDGET' : 120,  'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT) && (SVPWM_METHOD == SVPWM_MIN_MAX)' },
+                                             { 'NAME' : 'MCPWM_PWMDutyUpdate',        'CALLS' : 1, 'BUDGET' : 80,   'IF' : '(ARITHMETIC == ARITHMETIC_FLOAT)' },
+                                             { 'NAME' : 'MCQ14_CurrentMeasurement',   'CALLS' : 1, 'BUDGET' : 100,  'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'MCQ14_VoltageMeasurement',   'CALLS' : 1, 'BUDGET' : 40,   'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'MCQ14_SignalTransformation', 'CALLS' : 1, 'BUDGET' : 80,   'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'MCQ14_PositionMeasurement',  'CALLS' : 1, 'BUDGET' : 400,  'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'MCQ14_MotorControl',         'CALLS' : 1, 'BUDGET' : 600,  'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'MCQ14_SpaceVectorModulation', 'CALLS' : 1, 'BUDGET' : 150, 'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'library_sincos',             'CALLS' : 2, 'BUDGET' : 60,   'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'library_pi_control',         'CALLS' : 2, 'BUDGET' : 60,   'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'MCSCH_Tick',                 'CALLS' : 1, 'BUDGET' : 60,   'IF' : '(TASK_SCHEDULER == ENABLED)' },
+                                           ],
+                                  'DATA' : [ { 'NAME' : 'gMCCTRL_CtrlParam',          'IF' : '' },
+                                             { 'NAME' : 'gMCCUR_OutputSignals',       'IF' : '' },
+                                             { 'NAME' : 'gMCVOL_OutputSignals',       'IF' : '' },
+                                             { 'NAME' : 'gMCLIB_CurrentAlphaBeta',    'IF' : '' },
+                                             { 'NAME' : 'gMCLIB_CurrentDQ',           'IF' : '' },
+                                             { 'NAME' : 'gMCLIB_Position',            'IF' : '' },
+                                             { 'NAME' : 'gMCLIB_VoltageDQ',           'IF' : '' },
+                                             { 'NAME' : 'gMCLIB_VoltageAlphaBeta',    'IF' : '' },
+                                             { 'NAME' : 'gMCRPOS_StateSignals',       'IF' : '' },
+                                             { 'NAME' : 'gMCRPOS_OutputSignals',      'IF' : '' },
+                                             { 'NAME' : 'gMCRPOS_HfiState',           'IF' : '(HF_INJECTION == ENABLED)' },
+                                             { 'NAME' : 'gMCRPOS_HfiOutput',          'IF' : '(HF_INJECTION == ENABLED)' },
+                                             { 'NAME' : 'gMCPWM_SVPWM',               'IF' : '' },
+                                             { 'NAME' : 'gMCPWM_StatorVoltage',       'IF' : '(VOLTAGE_RECONSTRUCTION == ENABLED)' },
+                                             { 'NAME' : 'gMCQ14_CtrlSignals',         'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                             { 'NAME' : 'gMCQ14_PLLState',            'IF' : '(ARITHMETIC == ARITHMETIC_Q14)' },
+                                           ],
+                                }
+
+
 #Encoder dictionary used to send message to Encoder plib
 encoderDict = {}
 
 
+# Placement declarations of mc_placement.h from the hot path profile
+def mcPmsmFocPlacementDeclarations(profile):
+    lines = []
+    for kind in ["CODE", "DATA"]:
+        for entry in profile[kind]:
+            if entry['IF']:
+                lines.append("#if " + entry['IF'])
+            declaration = "MCPLACE_DECLARE_%s( %s );" % (kind, entry['NAME'])
+            if 'BUDGET' in entry:
+                declaration = "%-56s/* %d x %4d cycles */" % (declaration, entry['CALLS'], entry['BUDGET'])
+            lines.append(declaration)
+            if entry['IF']:
+                lines.append("#endif")
+    return "\n".join(lines)
+
+# MTPA d-axis current at evenly spaced q-axis currents from zero to the maximum motor current:
+# id = -iq^2 / (a + sqrt(a^2 + iq^2)), a = Ke / (2 (Lq - Ld)), zero without saliency (Lq <= Ld)
+def mcPmsmFocMtpaTable(ld, lq, bemfConst, polePairs, connection, maxCurrent, size = 17):
+    import math
+    ke = bemfConst / 1000.0 * 60.0 / (2.0 * math.pi) / polePairs
+    if connection == "STAR":
+        ke = ke / math.sqrt(3.0)
+    entries = []
+    for k in range(size):
+        iq = maxCurrent * k / (size - 1)
+        if lq > ld:
+            a = ke / (2.0 * (lq - ld))
+            entries.append(0.0 - iq * iq / (a + math.sqrt(a * a + iq * iq)))
+        else:
+            entries.append(0.0)
+    lines = []
+    for k in range(0, size, 4):
+        lines.append("    " + ", ".join(["%.6ff" % entry for entry in entries[k:k + 4]]))
+    return ",\n".join(lines)
+
+# Field weakening d-axis current at evenly spaced speeds from zero to the maximum speed (rows) and q-axis
+# currents from zero to the maximum motor current (columns): the d-axis current closest to zero for which
+# the steady state voltage (Rs id - w Lq iq, Rs iq + w (Ld id + Ke)) stays within the voltage reference,
+# or which is closest to it when out of reach, limited to the maximum field weakening current
+def mcPmsmFocFieldWeakeningMap(r, ld, lq, bemfConst, polePairs, connection, maxSpeed, maxCurrent, maxFwCurrent,
+                               dcBusVolt, voltageLimit, margin, speeds = 9, currents = 9):
+    import math
+    ke = bemfConst / 1000.0 * 60.0 / (2.0 * math.pi) / polePairs
+    if connection == "STAR":
+        ke = ke / math.sqrt(3.0)
+    maxStatorVolt = { "VOLTAGE_LIMIT_LINEAR"         : 0.98,
+                      "VOLTAGE_LIMIT_OVERMODULATION" : 1.0490974577,
+                      "VOLTAGE_LIMIT_SIX_STEP"       : 1.1026577908 }[voltageLimit]
+    umax = dcBusVolt / math.sqrt(3.0) * maxStatorVolt * margin
+    rows = []
+    for k in range(speeds):
+        w = maxSpeed * 2.0 * math.pi / 60.0 * polePairs * k / (speeds - 1)
+        entries = []
+        for j in range(currents):
+            iq = maxCurrent * j / (currents - 1)
+            # |u|^2 - umax^2 = a id^2 + b id + c
+            a = r * r + w * w * ld * ld
+            b = 2.0 * (w * ld * (r * iq + w * ke) - r * w * lq * iq)
+            c = (w * lq * iq) ** 2 + (r * iq + w * ke) ** 2 - umax * umax
+            if c <= 0.0:
+                idRef = 0.0
+            elif b * b - 4.0 * a * c >= 0.0:
+                idRef = (-b + math.sqrt(b * b - 4.0 * a * c)) / (2.0 * a)
+            else:
+                idRef = -b / (2.0 * a)
+            entries.append(max(min(idRef, 0.0), maxFwCurrent))
+        rows.append("    { " + ", ".join(["%.4ff" % entry for entry in entries]) + " }")
+    return ",\n".join(rows)
+
 global sort_alphanumeric
 
 def sort_alphanumeric(l):
@@ -318,6 +466,21 @@ def mcPmsmFocEncoderHide(symbol, event):
 def mcPmsmFocVisibleOnTrue(symbol, event):
     symbol.setVisible(event["value"])
 
+def mcPmsmFocInverterErrorVisible(symbol, event):
+    # Inverter error parameters of the dead time compensation and the voltage reconstruction
+    component = symbol.getComponent()
+    symbol.setVisible(component.getSymbolValue("MCPMSMFOC_DEADTIME_COMP") or component.getSymbolValue("MCPMSMFOC_VOLTAGE_RECONSTRUCTION"))
+
+def mcPmsmFocPllVisibility(symbol, event):
+    symbol.setVisible(event["value"] == 0)
+
+def mcPmsmFocDpwmVisibility(symbol, event):
+    # Discontinuous PWM methods follow the continuous ones
+    if(event["value"] >= 2):
+        symbol.setVisible(True)
+    else:
+        symbol.setVisible(False)
+
 def mcPmsmFocSpeedRefVisible(symbol, event):
     component = symbol.getComponent()
     if component.getSymbolValue("MCPMSMFOC_SPEED_REF") == "Potentiometer Analog Input":
@@ -333,6 +496,27 @@ def mcPmsmFocFWMax(symbol, event):
     fw = component.getSymbolValue("MCPMSMFOC_FIELD_WEAKENING")
     symbol.setVisible((fw))
 
+def mcPmsmFocFWVoltageLoopVisible(symbol, event):
+    component = symbol.getComponent()
+    fw = component.getSymbolValue("MCPMSMFOC_FIELD_WEAKENING")
+    method = component.getSymbolByID("MCPMSMFOC_FW_METHOD").getSelectedKey()
+    symbol.setVisible(fw and (method != "FW_FEED_FORWARD"))
+
+def mcPmsmFocFieldWeakeningMapUpdate(symbol, event):
+    component = symbol.getComponent()
+    symbol.setValue(mcPmsmFocFieldWeakeningMap(component.getSymbolValue("MCPMSMFOC_R"), component.getSymbolValue("MCPMSMFOC_LD"),
+        component.getSymbolValue("MCPMSMFOC_LQ"), component.getSymbolValue("MCPMSMFOC_BEMF_CONST"),
+        component.getSymbolValue("MCPMSMFOC_POLE_PAIRS"), component.getSymbolByID("MCPMSMFOC_MOTOR_CONNECTION").getSelectedKey(),
+        component.getSymbolValue("MCPMSMFOC_MAX_SPEED"), component.getSymbolValue("MCPMSMFOC_MAX_MOTOR_CURRENT"),
+        component.getSymbolValue("MCPMSMFOC_MAX_FW_CURRENT"), component.getSymbolValue("MCPMSMFOC_DC_BUS_VOLT"),
+        component.getSymbolByID("MCPMSMFOC_VOLTAGE_LIMIT").getSelectedKey(), component.getSymbolValue("MCPMSMFOC_FW_VOLTAGE_MARGIN")))
+
+def mcPmsmFocMtpaTableUpdate(symbol, event):
+    component = symbol.getComponent()
+    symbol.setValue(mcPmsmFocMtpaTable(component.getSymbolValue("MCPMSMFOC_LD"), component.getSymbolValue("MCPMSMFOC_LQ"),
+        component.getSymbolValue("MCPMSMFOC_BEMF_CONST"), component.getSymbolValue("MCPMSMFOC_POLE_PAIRS"),
+        component.getSymbolByID("MCPMSMFOC_MOTOR_CONNECTION").getSelectedKey(), component.getSymbolValue("MCPMSMFOC_MAX_MOTOR_CURRENT")))
+
 def mcPmsmFocPIValueChange(symbol, event):
     if(event["value"] == 1): #encoder
         symbol.setValue(0.000005)
@@ -601,6 +785,29 @@ def instantiateComponent(mcPmsmFocComponent):
     mcPmsmFocDeadTime.setMin(0.1)
     mcPmsmFocDeadTime.setMax(10)
 
+    mcPmsmFocSym_deadtime_comp = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_DEADTIME_COMP", mcPmsmFocPwmMenu)
+    mcPmsmFocSym_deadtime_comp.setLabel("Enable Dead Time Compensation?")
+    mcPmsmFocSym_deadtime_comp.setDefaultValue(False)
+
+    mcPmsmFocSym_voltage_reconstruction = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_VOLTAGE_RECONSTRUCTION", mcPmsmFocPwmMenu)
+    mcPmsmFocSym_voltage_reconstruction.setLabel("Enable Stator Voltage Reconstruction?")
+    mcPmsmFocSym_voltage_reconstruction.setDefaultValue(False)
+
+    mcPmsmFocSym_switch_drop = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_SWITCH_DROP", mcPmsmFocPwmMenu)
+    mcPmsmFocSym_switch_drop.setLabel("Switch Voltage Drop (V)")
+    mcPmsmFocSym_switch_drop.setMin(0.0)
+    mcPmsmFocSym_switch_drop.setMax(5.0)
+    mcPmsmFocSym_switch_drop.setDefaultValue(0.0)
+    mcPmsmFocSym_switch_drop.setVisible(False)
+    mcPmsmFocSym_switch_drop.setDependencies(mcPmsmFocInverterErrorVisible, ["MCPMSMFOC_DEADTIME_COMP", "MCPMSMFOC_VOLTAGE_RECONSTRUCTION"])
+
+    mcPmsmFocSym_deadtime_band = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_DEADTIME_COMP_BAND", mcPmsmFocPwmMenu)
+    mcPmsmFocSym_deadtime_band.setLabel("Zero Crossing Current Band (A)")
+    mcPmsmFocSym_deadtime_band.setMin(0.01)
+    mcPmsmFocSym_deadtime_band.setDefaultValue(0.1)
+    mcPmsmFocSym_deadtime_band.setVisible(False)
+    mcPmsmFocSym_deadtime_band.setDependencies(mcPmsmFocInverterErrorVisible, ["MCPMSMFOC_DEADTIME_COMP", "MCPMSMFOC_VOLTAGE_RECONSTRUCTION"])
+
     global mcPmsmFocPwmFault
     mcPmsmFocPwmFault = mcPmsmFocComponent.createKeyValueSetSymbol("MCPMSMFOC_PWM_FAULT", mcPmsmFocPwmMenu)
     mcPmsmFocPwmFault.setLabel("PWM Fault")
@@ -742,6 +949,41 @@ def instantiateComponent(mcPmsmFocComponent):
     mcPmsmFocSym_curr_meas.setOutputMode("Key")
     mcPmsmFocSym_curr_meas.setDisplayMode("Description")
 
+    mcPmsmFocSym_sincos = mcPmsmFocComponent.createKeyValueSetSymbol("MCPMSMFOC_SINCOS", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_sincos.setLabel("Select Sine/Cosine Calculation")
+    mcPmsmFocSym_sincos.addKey("SINCOS_INTERPOLATED_TABLE", "0", "Interpolated Sine and Cosine Tables (2 KB)")
+    mcPmsmFocSym_sincos.addKey("SINCOS_POLYNOMIAL", "1", "Minimax Polynomial")
+    mcPmsmFocSym_sincos.addKey("SINCOS_QUARTER_WAVE_TABLE", "2", "Interpolated Quarter Wave Table (260 B)")
+    mcPmsmFocSym_sincos.addKey("SINCOS_CORDIC", "3", "CORDIC")
+    mcPmsmFocSym_sincos.setOutputMode("Key")
+    mcPmsmFocSym_sincos.setDisplayMode("Description")
+
+    mcPmsmFocSym_svpwm = mcPmsmFocComponent.createKeyValueSetSymbol("MCPMSMFOC_SVPWM", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_svpwm.setLabel("Select Space Vector Modulation")
+    mcPmsmFocSym_svpwm.addKey("SVPWM_SECTOR_TREE", "0", "Sector Based Space Vector Modulation")
+    mcPmsmFocSym_svpwm.addKey("SVPWM_MIN_MAX", "1", "Min-Max Zero Sequence Injection (Branch Free)")
+    mcPmsmFocSym_svpwm.addKey("SVPWM_DPWM_MIN", "2", "Discontinuous PWM, Clamped to Negative Rail")
+    mcPmsmFocSym_svpwm.addKey("SVPWM_DPWM60", "3", "Discontinuous PWM, 60 Degree Clamping (DPWM60)")
+    mcPmsmFocSym_svpwm.addKey("SVPWM_DPWM30", "4", "Discontinuous PWM, 30 Degree Clamping (DPWM30)")
+    mcPmsmFocSym_svpwm.setOutputMode("Key")
+    mcPmsmFocSym_svpwm.setDisplayMode("Description")
+
+    mcPmsmFocSym_dpwm_mi = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_DPWM_MIN_MI", mcPmsmFocSym_svpwm)
+    mcPmsmFocSym_dpwm_mi.setLabel("Min. Modulation Index for Discontinuous PWM")
+    mcPmsmFocSym_dpwm_mi.setMin(0.1)
+    mcPmsmFocSym_dpwm_mi.setMax(1.0)
+    mcPmsmFocSym_dpwm_mi.setDefaultValue(0.5)
+    mcPmsmFocSym_dpwm_mi.setVisible(False)
+    mcPmsmFocSym_dpwm_mi.setDependencies(mcPmsmFocDpwmVisibility, ["MCPMSMFOC_SVPWM"])
+
+    mcPmsmFocSym_voltage_limit = mcPmsmFocComponent.createKeyValueSetSymbol("MCPMSMFOC_VOLTAGE_LIMIT", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_voltage_limit.setLabel("Select Voltage Vector Limit")
+    mcPmsmFocSym_voltage_limit.addKey("VOLTAGE_LIMIT_LINEAR", "0", "Linear Modulation Range")
+    mcPmsmFocSym_voltage_limit.addKey("VOLTAGE_LIMIT_OVERMODULATION", "1", "Overmodulation Mode I, up to the Voltage Hexagon")
+    mcPmsmFocSym_voltage_limit.addKey("VOLTAGE_LIMIT_SIX_STEP", "2", "Overmodulation Mode I and II, up to Six-Step")
+    mcPmsmFocSym_voltage_limit.setOutputMode("Key")
+    mcPmsmFocSym_voltage_limit.setDisplayMode("Description")
+
     mcPmsmFocSym_open_loop = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_OPEN_LOOP", mcPmsmFocAlgoMenu)
     mcPmsmFocSym_open_loop.setLabel("Run in Open Loop?")
     mcPmsmFocSym_open_loop.setDependencies(mcPmsmFocOpenloop, ["MCPMSMFOC_POSITION_FB", "MCPMSMFOC_TORQUE_MODE", "MCPMSMFOC_FIELD_WEAKENING"])
@@ -768,6 +1010,154 @@ def instantiateComponent(mcPmsmFocComponent):
     mcPmsmFocSym_max_fw_current.setMax(0.0)
     mcPmsmFocSym_max_fw_current.setDefaultValue(float(mcPmsmFocMotorParamDict['LONG_HURST']['MAX_FW_CURRENT']))
 
+    mcPmsmFocSym_fw_method = mcPmsmFocComponent.createKeyValueSetSymbol("MCPMSMFOC_FW_METHOD", mcPmsmFocSym_field_weakening)
+    mcPmsmFocSym_fw_method.setLabel("Select Field Weakening Method")
+    mcPmsmFocSym_fw_method.addKey("FW_FEED_FORWARD", "0", "Feed-Forward from the Voltage Equation")
+    mcPmsmFocSym_fw_method.addKey("FW_VOLTAGE_LOOP", "1", "PI Control of the Voltage Margin")
+    mcPmsmFocSym_fw_method.addKey("FW_MAP_VOLTAGE_LOOP", "2", "Speed and Torque Map, Trimmed by the Voltage Margin PI")
+    mcPmsmFocSym_fw_method.setOutputMode("Key")
+    mcPmsmFocSym_fw_method.setDisplayMode("Description")
+    mcPmsmFocSym_fw_method.setVisible(False)
+    mcPmsmFocSym_fw_method.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_FIELD_WEAKENING"])
+
+    mcPmsmFocSym_fw_margin = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_FW_VOLTAGE_MARGIN", mcPmsmFocSym_field_weakening)
+    mcPmsmFocSym_fw_margin.setLabel("Voltage Reference / Maximum Voltage")
+    mcPmsmFocSym_fw_margin.setMin(0.5)
+    mcPmsmFocSym_fw_margin.setMax(1.0)
+    mcPmsmFocSym_fw_margin.setDefaultValue(0.95)
+    mcPmsmFocSym_fw_margin.setVisible(False)
+    mcPmsmFocSym_fw_margin.setDependencies(mcPmsmFocFWVoltageLoopVisible, ["MCPMSMFOC_FIELD_WEAKENING", "MCPMSMFOC_FW_METHOD"])
+
+    mcPmsmFocSym_fw_kp = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_FW_KP", mcPmsmFocSym_field_weakening)
+    mcPmsmFocSym_fw_kp.setLabel("Voltage Loop Kp (A)")
+    mcPmsmFocSym_fw_kp.setDefaultValue(1.0)
+    mcPmsmFocSym_fw_kp.setVisible(False)
+    mcPmsmFocSym_fw_kp.setDependencies(mcPmsmFocFWVoltageLoopVisible, ["MCPMSMFOC_FIELD_WEAKENING", "MCPMSMFOC_FW_METHOD"])
+
+    mcPmsmFocSym_fw_ki = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_FW_KI", mcPmsmFocSym_field_weakening)
+    mcPmsmFocSym_fw_ki.setLabel("Voltage Loop Ki (A per PWM period)")
+    mcPmsmFocSym_fw_ki.setDefaultValue(0.002)
+    mcPmsmFocSym_fw_ki.setVisible(False)
+    mcPmsmFocSym_fw_ki.setDependencies(mcPmsmFocFWVoltageLoopVisible, ["MCPMSMFOC_FIELD_WEAKENING", "MCPMSMFOC_FW_METHOD"])
+
+    mcPmsmFocSym_mtpa = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_MTPA", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_mtpa.setLabel("Enable Maximum Torque Per Ampere (MTPA)?")
+    mcPmsmFocSym_mtpa.setDefaultValue(False)
+
+    mcPmsmFocSym_pll_scheduling = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_PLL_SPEED_SCHEDULING", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_pll_scheduling.setLabel("Speed Scheduled PLL Filters?")
+    mcPmsmFocSym_pll_scheduling.setDefaultValue(False)
+    mcPmsmFocSym_pll_scheduling.setDependencies(mcPmsmFocPllVisibility, ["MCPMSMFOC_POSITION_FB"])
+
+    mcPmsmFocSym_pll_esdq_ratio = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_PLL_ESDQ_BANDWIDTH_RATIO", mcPmsmFocSym_pll_scheduling)
+    mcPmsmFocSym_pll_esdq_ratio.setLabel("BEMF Filter Bandwidth / Electrical Speed")
+    mcPmsmFocSym_pll_esdq_ratio.setMin(0.0)
+    mcPmsmFocSym_pll_esdq_ratio.setMax(2.0)
+    mcPmsmFocSym_pll_esdq_ratio.setDefaultValue(1.0)
+    mcPmsmFocSym_pll_esdq_ratio.setVisible(False)
+    mcPmsmFocSym_pll_esdq_ratio.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_PLL_SPEED_SCHEDULING"])
+
+    mcPmsmFocSym_pll_velestim_ratio = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_PLL_VELESTIM_BANDWIDTH_RATIO", mcPmsmFocSym_pll_scheduling)
+    mcPmsmFocSym_pll_velestim_ratio.setLabel("Speed Filter Bandwidth / Electrical Speed")
+    mcPmsmFocSym_pll_velestim_ratio.setMin(0.0)
+    mcPmsmFocSym_pll_velestim_ratio.setMax(2.0)
+    mcPmsmFocSym_pll_velestim_ratio.setDefaultValue(0.5)
+    mcPmsmFocSym_pll_velestim_ratio.setVisible(False)
+    mcPmsmFocSym_pll_velestim_ratio.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_PLL_SPEED_SCHEDULING"])
+
+    mcPmsmFocSym_hf_injection = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_HF_INJECTION", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_hf_injection.setLabel("High Frequency Injection below the Back EMF Handoff Speed (Lq > Ld)?")
+    mcPmsmFocSym_hf_injection.setDefaultValue(False)
+    mcPmsmFocSym_hf_injection.setDependencies(mcPmsmFocPllVisibility, ["MCPMSMFOC_POSITION_FB"])
+
+    mcPmsmFocSym_hfi_voltage = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_HFI_VOLTAGE", mcPmsmFocSym_hf_injection)
+    mcPmsmFocSym_hfi_voltage.setLabel("Injection Voltage Amplitude (V)")
+    mcPmsmFocSym_hfi_voltage.setMin(0.0)
+    mcPmsmFocSym_hfi_voltage.setDefaultValue(2.0)
+    mcPmsmFocSym_hfi_voltage.setVisible(False)
+    mcPmsmFocSym_hfi_voltage.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_HF_INJECTION"])
+
+    mcPmsmFocSym_hfi_periods = mcPmsmFocComponent.createIntegerSymbol("MCPMSMFOC_HFI_PERIODS", mcPmsmFocSym_hf_injection)
+    mcPmsmFocSym_hfi_periods.setLabel("Injection Period (PWM Periods)")
+    mcPmsmFocSym_hfi_periods.setMin(4)
+    mcPmsmFocSym_hfi_periods.setMax(32)
+    mcPmsmFocSym_hfi_periods.setDefaultValue(10)
+    mcPmsmFocSym_hfi_periods.setVisible(False)
+    mcPmsmFocSym_hfi_periods.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_HF_INJECTION"])
+
+    mcPmsmFocSym_hfi_bandwidth = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_HFI_BANDWIDTH", mcPmsmFocSym_hf_injection)
+    mcPmsmFocSym_hfi_bandwidth.setLabel("Angle Tracking Bandwidth (rad/s)")
+    mcPmsmFocSym_hfi_bandwidth.setMin(1.0)
+    mcPmsmFocSym_hfi_bandwidth.setDefaultValue(500.0)
+    mcPmsmFocSym_hfi_bandwidth.setVisible(False)
+    mcPmsmFocSym_hfi_bandwidth.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_HF_INJECTION"])
+
+    mcPmsmFocSym_hfi_handoff = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_HFI_HANDOFF_SPEED", mcPmsmFocSym_hf_injection)
+    mcPmsmFocSym_hfi_handoff.setLabel("Back EMF Estimator Handoff Speed (RPM)")
+    mcPmsmFocSym_hfi_handoff.setMin(0.0)
+    mcPmsmFocSym_hfi_handoff.setDefaultValue(500.0)
+    mcPmsmFocSym_hfi_handoff.setVisible(False)
+    mcPmsmFocSym_hfi_handoff.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_HF_INJECTION"])
+
+    mcPmsmFocSym_fused_kernel = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_FUSED_KERNEL", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_fused_kernel.setLabel("Use Fused Current Control Kernel?")
+    mcPmsmFocSym_fused_kernel.setDefaultValue(False)
+
+    mcPmsmFocSym_arithmetic = mcPmsmFocComponent.createKeyValueSetSymbol("MCPMSMFOC_ARITHMETIC", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_arithmetic.setLabel("Select Control Arithmetic")
+    mcPmsmFocSym_arithmetic.addKey("ARITHMETIC_FLOAT", "0", "Floating Point")
+    mcPmsmFocSym_arithmetic.addKey("ARITHMETIC_Q14", "1", "Q2.14 Fixed Point (Sensorless PLL, Dual Shunt, SVPWM, no Field Weakening)")
+    mcPmsmFocSym_arithmetic.setOutputMode("Key")
+    mcPmsmFocSym_arithmetic.setDisplayMode("Description")
+
+    mcPmsmFocSym_isr_profiler = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_ISR_PROFILER", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_isr_profiler.setLabel("Enable Control ISR Profiler?")
+    mcPmsmFocSym_isr_profiler.setDefaultValue(False)
+
+    mcPmsmFocSym_isr_profiler_bin = mcPmsmFocComponent.createIntegerSymbol("MCPMSMFOC_ISR_PROFILER_BIN_SHIFT", mcPmsmFocSym_isr_profiler)
+    mcPmsmFocSym_isr_profiler_bin.setLabel("Histogram Bin Width (2^n counter ticks)")
+    mcPmsmFocSym_isr_profiler_bin.setMin(0)
+    mcPmsmFocSym_isr_profiler_bin.setMax(12)
+    mcPmsmFocSym_isr_profiler_bin.setDefaultValue(6)
+    mcPmsmFocSym_isr_profiler_bin.setVisible(False)
+    mcPmsmFocSym_isr_profiler_bin.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_ISR_PROFILER"])
+
+    mcPmsmFocSym_task_scheduler = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_TASK_SCHEDULER", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_task_scheduler.setLabel("Run Slow Tasks from Software Interrupt?")
+    mcPmsmFocSym_task_scheduler.setDefaultValue(False)
+
+    mcPmsmFocSym_parameter_channel = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_PARAMETER_CHANNEL", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_parameter_channel.setLabel("Double Buffered Run Time Parameter Updates?")
+    mcPmsmFocSym_parameter_channel.setDefaultValue(False)
+
+    mcPmsmFocSym_motor_identification = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_MOTOR_IDENTIFICATION", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_motor_identification.setLabel("Enable Motor Parameter Identification?")
+    mcPmsmFocSym_motor_identification.setDefaultValue(False)
+
+    mcPmsmFocSym_load_observer = mcPmsmFocComponent.createBooleanSymbol("MCPMSMFOC_LOAD_OBSERVER", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_load_observer.setLabel("Enable Load Torque Observer with Iq Feed-Forward?")
+    mcPmsmFocSym_load_observer.setDefaultValue(False)
+
+    mcPmsmFocSym_load_observer_bandwidth = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_LOAD_OBSERVER_BANDWIDTH", mcPmsmFocSym_load_observer)
+    mcPmsmFocSym_load_observer_bandwidth.setLabel("Load Observer Bandwidth (rad/s)")
+    mcPmsmFocSym_load_observer_bandwidth.setMin(1.0)
+    mcPmsmFocSym_load_observer_bandwidth.setDefaultValue(300.0)
+    mcPmsmFocSym_load_observer_bandwidth.setVisible(False)
+    mcPmsmFocSym_load_observer_bandwidth.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_LOAD_OBSERVER"])
+
+    mcPmsmFocSym_placement = mcPmsmFocComponent.createKeyValueSetSymbol("MCPMSMFOC_PLACEMENT", mcPmsmFocAlgoMenu)
+    mcPmsmFocSym_placement.setLabel("Select Hot Path Placement")
+    mcPmsmFocSym_placement.addKey("PLACEMENT_FLASH", "0", "Flash")
+    mcPmsmFocSym_placement.addKey("PLACEMENT_RAM", "1", "Code in SRAM (__ramfunc__)")
+    mcPmsmFocSym_placement.addKey("PLACEMENT_TCM", "2", "Code in ITCM, data in DTCM")
+    mcPmsmFocSym_placement.setOutputMode("Key")
+    mcPmsmFocSym_placement.setDisplayMode("Description")
+    mcPmsmFocSym_placement.setSelectedKey(mcPmsmFocPlacementDict.get(mcPmsmFocSeries.getValue(), { 'PLACEMENT' : 'PLACEMENT_FLASH' })['PLACEMENT'])
+
+    mcPmsmFocSym_placement_profile = mcPmsmFocComponent.createStringSymbol("MCPMSMFOC_PLACEMENT_PROFILE", mcPmsmFocSym_placement)
+    mcPmsmFocSym_placement_profile.setVisible(False)
+    mcPmsmFocSym_placement_profile.setDefaultValue(mcPmsmFocPlacementDeclarations(mcPmsmFocPlacementProfileDict))
+
     mcPmsmFocEncoderMenu.setDependencies(mcPmsmFocEncoderVisibility, ["MCPMSMFOC_POSITION_FB"])
 ########################### Motor Parameters   #################################
 
@@ -835,6 +1225,35 @@ def instantiateComponent(mcPmsmFocComponent):
 
     mcPmsmFocSym_max_fw_current.setDependencies(mcPmsmFocFWMax, ["MCPMSMFOC_MAX_MOTOR_CURRENT", "MCPMSMFOC_FIELD_WEAKENING"])
 
+    mcPmsmFocSym_mtpa_table = mcPmsmFocComponent.createStringSymbol("MCPMSMFOC_MTPA_TABLE", mcPmsmFocSym_motor)
+    mcPmsmFocSym_mtpa_table.setVisible(False)
+    mcPmsmFocSym_mtpa_table.setDefaultValue(mcPmsmFocMtpaTable(float(mcPmsmFocMotorParamDict['LONG_HURST']['LD']),
+        float(mcPmsmFocMotorParamDict['LONG_HURST']['LQ']), float(mcPmsmFocMotorParamDict['LONG_HURST']['BEMF_CONST']),
+        float(mcPmsmFocMotorParamDict['LONG_HURST']['POLE_PAIRS']), mcPmsmFocMotorParamDict['LONG_HURST']['MOTOR_CONNECTION'],
+        float(mcPmsmFocMotorParamDict['LONG_HURST']['MAX_MOTOR_CURRENT'])))
+    mcPmsmFocSym_mtpa_table.setDependencies(mcPmsmFocMtpaTableUpdate, ["MCPMSMFOC_LD", "MCPMSMFOC_LQ", "MCPMSMFOC_BEMF_CONST",
+        "MCPMSMFOC_POLE_PAIRS", "MCPMSMFOC_MOTOR_CONNECTION", "MCPMSMFOC_MAX_MOTOR_CURRENT"])
+
+    mcPmsmFocSym_fw_map = mcPmsmFocComponent.createStringSymbol("MCPMSMFOC_FW_MAP", mcPmsmFocSym_motor)
+    mcPmsmFocSym_fw_map.setVisible(False)
+    mcPmsmFocSym_fw_map.setDefaultValue(mcPmsmFocFieldWeakeningMap(float(mcPmsmFocMotorParamDict['LONG_HURST']['R']),
+        float(mcPmsmFocMotorParamDict['LONG_HURST']['LD']), float(mcPmsmFocMotorParamDict['LONG_HURST']['LQ']),
+        float(mcPmsmFocMotorParamDict['LONG_HURST']['BEMF_CONST']), float(mcPmsmFocMotorParamDict['LONG_HURST']['POLE_PAIRS']),
+        mcPmsmFocMotorParamDict['LONG_HURST']['MOTOR_CONNECTION'], float(mcPmsmFocMotorParamDict['LONG_HURST']['MAX_SPEED']),
+        float(mcPmsmFocMotorParamDict['LONG_HURST']['MAX_MOTOR_CURRENT']), float(mcPmsmFocMotorParamDict['LONG_HURST']['MAX_FW_CURRENT']),
+        float(mcPmsmFocBoardParamDict['MCLV2']['DC_BUS_VOLT']), "VOLTAGE_LIMIT_LINEAR", 0.95))
+    mcPmsmFocSym_fw_map.setDependencies(mcPmsmFocFieldWeakeningMapUpdate, ["MCPMSMFOC_R", "MCPMSMFOC_LD", "MCPMSMFOC_LQ",
+        "MCPMSMFOC_BEMF_CONST", "MCPMSMFOC_POLE_PAIRS", "MCPMSMFOC_MOTOR_CONNECTION", "MCPMSMFOC_MAX_SPEED",
+        "MCPMSMFOC_MAX_MOTOR_CURRENT", "MCPMSMFOC_MAX_FW_CURRENT", "MCPMSMFOC_DC_BUS_VOLT", "MCPMSMFOC_VOLTAGE_LIMIT",
+        "MCPMSMFOC_FW_VOLTAGE_MARGIN"])
+
+    mcPmsmFocSym_inertia = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_INERTIA", mcPmsmFocSym_motor)
+    mcPmsmFocSym_inertia.setLabel("Rotor and Load Inertia (kg m^2)")
+    mcPmsmFocSym_inertia.setMin(0.0)
+    mcPmsmFocSym_inertia.setDefaultValue(8.0e-6)
+    mcPmsmFocSym_inertia.setVisible(False)
+    mcPmsmFocSym_inertia.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_LOAD_OBSERVER"])
+
     mcPmsmFocSym_motor_params = mcPmsmFocComponent.createStringSymbol("MCPMSMFOC_MOTOR_PARAMS", mcPmsmFocSym_motor)
     mcPmsmFocSym_motor_params.setVisible(False)
     mcPmsmFocSym_motor_params.setDependencies(mcPmsmFocMotorParamSet, ["MCPMSMFOC_MOTOR_SEL"])
@@ -1050,6 +1469,12 @@ def instantiateComponent(mcPmsmFocComponent):
     mcPmsmFocSym_speed_Ki.setLabel("Ki")
     mcPmsmFocSym_speed_Ki.setDefaultValue(0.000020)
 
+    mcPmsmFocSym_speed_Bandwidth = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_SPEED_BANDWIDTH", mcPmsmFocSpeedPIMenu)
+    mcPmsmFocSym_speed_Bandwidth.setLabel("Identified Motor Speed Loop Bandwidth (rad/s)")
+    mcPmsmFocSym_speed_Bandwidth.setDefaultValue(150)
+    mcPmsmFocSym_speed_Bandwidth.setVisible(False)
+    mcPmsmFocSym_speed_Bandwidth.setDependencies(mcPmsmFocVisibleOnTrue, ["MCPMSMFOC_MOTOR_IDENTIFICATION"])
+
     mcPmsmFocSym_speed_Kc = mcPmsmFocComponent.createFloatSymbol("MCPMSMFOC_SPEED_KC", mcPmsmFocSpeedPIMenu)
     mcPmsmFocSym_speed_Kc.setLabel("Kc")
     mcPmsmFocSym_speed_Kc.setDefaultValue(0.5)
@@ -0,0 +1,156 @@
+/*******************************************************************************
+ Motor Control Hardware Abstraction interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_hal.h
+
+  Summary:
+    Host stand-in for the hardware abstraction layer
+
+  Description:
+    This file replaces the mc_hal.h generated from mc_hal.h.ftl when the
+    pmsm_foc component is built for a host computer. The PWM, ADC and GPIO
+    accesses are mapped to the simulated peripherals in mc_host_hal.c, which
+    are driven by the plant model.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MCHAL_H    // Guards against multiple inclusion
+#define MCHAL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stddef.h>
+#include "definitions.h"
+#include "mc_host_hal.h"
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/* PWM */
+#define MCHAL_PWM_PH_U                  MCHOST_PWM_PH_U
+#define MCHAL_PWM_PH_V                  MCHOST_PWM_PH_V
+#define MCHAL_PWM_PH_W                  MCHOST_PWM_PH_W
+#define MCHAL_PWM_PH_MASK               0x7
+#define MCHAL_PWMStop(mask)                 MCHOST_PWMStop(mask)
+#define MCHAL_PWMStart(mask)                MCHOST_PWMStart(mask)
+#define MCHAL_PWMPrimaryPeriodGet(ch)       MCHOST_PWMPrimaryPeriodGet(ch)
+#define MCHAL_PWMDutySet(ch, duty)          MCHOST_PWMDutySet(ch, duty)
+#define MCHAL_PWMOutputDisable(ch)          MCHOST_PWMOutputDisable(ch)
+#define MCHAL_PWMOutputEnable(ch)           MCHOST_PWMOutputEnable(ch)
+#define MCHAL_PWMCallbackRegister(ch, fn, context)  MCHOST_PWMCallbackRegister(fn, context)
+
+/* ADC */
+#define MCHAL_ADC_PH_U                                   MCHOST_ADC_PH_U
+#define MCHAL_ADC_PH_V                                   MCHOST_ADC_PH_V
+#define MCHAL_ADC_PH_W
+#define MCHAL_ADC_VDC                                    MCHOST_ADC_VDC
+#define MCHAL_ADC_POT                                    MCHOST_ADC_POT
+
+#define MCHAL_ADC_RESULT_SHIFT                           (0U)
+#define MCHAL_ADCCallbackRegister(ch, fn, context)       MCHOST_ADCCallbackRegister(fn, context)
+#define MCHAL_ADCChannelConversionStart(ch)
+#define MCHAL_ADCChannelResultGet(ch)                    (gMCHOST_Hal.adcResult[(ch)])
+#define MCHAL_ADCChannelResultIsReady(ch)                (true)
+
+/* Interrupt */
+#define MCHAL_CTRL_IRQ              (0)
+#define MCHAL_FAULT_IRQ             (1)
+
+#define MCHAL_IntDisable(irq)
+#define MCHAL_IntEnable(irq)
+#define MCHAL_IntClear(irq)
+#define MCHAL_MemoryBarrier()       __sync_synchronize()
+
+/* Software interrupt, executed after the ADC interrupt by the host driver */
+#define MCHAL_SW_IRQ                (2)
+#define MCHAL_SwIrqInitialize()     MCHOST_SwInterruptEnable()
+#define MCHAL_SwIrqPend()           MCHOST_SwInterruptPend()
+#define MCHAL_SwIrqAcknowledge()
+#define MCHAL_SW_IRQ_HANDLER()      void MCHOST_SwInterruptHandler( void )
+
+
+/* LED and Switches */
+
+#define MCHAL_FAULT_LED_SET()       (gMCHOST_Hal.faultLed = true)
+#define MCHAL_FAULT_LED_CLEAR()     (gMCHOST_Hal.faultLed = false)
+#define MCHAL_FAULT_LED_TOGGLE()    (gMCHOST_Hal.faultLed = !gMCHOST_Hal.faultLed)
+
+#define MCHAL_DIR_LED_SET()         (gMCHOST_Hal.directionLed = true)
+#define MCHAL_DIR_LED_CLEAR()       (gMCHOST_Hal.directionLed = false)
+#define MCHAL_DIR_LED_TOGGLE()      (gMCHOST_Hal.directionLed = !gMCHOST_Hal.directionLed)
+
+/* Switches are active low as on the development boards */
+#define MCHAL_START_STOP_SWITCH_GET()  (!gMCHOST_Hal.startStopPressed)
+
+#define MCHAL_DIR_SWITCH_GET()         (!gMCHOST_Hal.directionPressed)
+
+#define MCHAL_X2C_Update()
+
+/* Cycle counter */
+#define MCHAL_CYCLE_COUNTER_CLOCK_HZ   (gMCHOST_Hal.cycleCounterHz)
+#define MCHAL_CycleCounterStart()      MCHOST_CycleCounterStart()
+#define MCHAL_CycleCounterGet()        MCHOST_CycleCounterGet()
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MCHAL_H
+
+/**
+ End of File
+*/
@@ -0,0 +1,492 @@
+# coding: utf-8
+"""*****************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*****************************************************************************"""
+
+###################################################################################################
+########################### Host build of the pmsm_foc component  ################################
+###################################################################################################
+#
+# Renders the pmsm_foc templates the same way MHC does (every "mc_*.c/.h" file plus the selected
+# rotor position module) with a fixed symbol set, replaces mc_hal.h, definitions.h and device.h
+# with the host stand-ins from this folder and compiles the result together with the host plant
+# model into native executables.
+#
+#   python3 mc_host_build.py [-o <output folder>] [-D SYMBOL=value ...] [-C <compiler flag> ...] [target ...]
+#
+# The reference configuration is the LONG_HURST motor on the MCLV2 board with SAME70 PWM settings,
+# taken from the dictionaries in config/pmsm_foc.py so that both stay in sync.
+
+import argparse
+import ast
+import os
+import re
+import subprocess
+import sys
+
+mcHostPath = os.path.dirname(os.path.abspath(__file__))
+mcHostTemplatePath = os.path.join(mcHostPath, "..", "templates")
+mcHostConfigPath = os.path.join(mcHostPath, "..", "config", "pmsm_foc.py")
+mcHostRepositoryPath = os.path.join(mcHostPath, "..", "..", "..")
+
+# Templates which are replaced by the host stand-ins
+mcHostReplacedTemplates = ["mc_hal.h.ftl"]
+
+# Rotor position module per position feedback key
+mcHostPositionDict = { 'SENSORLESS_PLL' : ["pos_pll.c.ftl", "pos_pll.h.ftl"],
+                     }
+
+# Host executables: sources from this folder and symbol overrides on top of the reference set. Sources
+# and include folders of other parts of the repository are given relative to its root; their include
+# folders are searched after those of the component.
+mcHostTargetDict = { 'mc_host_sim' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                       'SYMBOLS' : {},
+                                     },
+                     'mc_host_profile' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                           'SYMBOLS' : { 'MCPMSMFOC_ISR_PROFILER' : True },
+                                         },
+                     'mc_host_foc_kernel' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_foc_kernel.c"],
+                                              'SYMBOLS' : { 'MCPMSMFOC_FUSED_KERNEL' : True },
+                                            },
+                     'mc_host_overmodulation' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_overmodulation.c"],
+                                                  'SYMBOLS' : { 'MCPMSMFOC_VOLTAGE_LIMIT' : "VOLTAGE_LIMIT_SIX_STEP" },
+                                                },
+                     'mc_host_sincos' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_sincos.c"],
+                                          'SYMBOLS' : {},
+                                          'CFLAGS'  : ["-DMCLIB_SINCOS_ALL_METHODS"],
+                                        },
+                     'mc_host_svpwm' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_svpwm.c"],
+                                         'SYMBOLS' : {},
+                                         'CFLAGS'  : ["-DMCPWM_SVPWM_ALL_METHODS"],
+                                       },
+                     # No-load case, the floating point build reaches a current THD of 1.7 %, the Q14 backend about
+                     # 8 % from its voltage resolution at the small no-load current, bounded at 10 times the floating point result
+                     'mc_host_sim_q14' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                           'SYMBOLS' : { 'MCPMSMFOC_ARITHMETIC' : "ARITHMETIC_Q14" },
+                                           'CFLAGS'  : ["-DMCHOST_SIM_MAX_CURRENT_THD=16.0f"],
+                                         },
+                     # Loaded case at half the motor current limit, the Q14 backend has to stay within the same
+                     # current THD and Iq error bounds as the floating point build (0.01 % and 0.007 A)
+                     'mc_host_sim_load' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                            'SYMBOLS' : {},
+                                            'CFLAGS'  : ["-DMCHOST_SIM_TIME=14.0f", "-DMCHOST_SIM_LOAD=0.12f",
+                                                         "-DMCHOST_SIM_LOAD_TIME=8.0f", "-DMCHOST_SIM_SETTLE=3.0f",
+                                                         "-DMCHOST_SIM_MAX_IQ_ERROR=0.02f", "-DMCHOST_SIM_MAX_CURRENT_THD=2.0f"],
+                                          },
+                     'mc_host_sim_q14_load' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                                'SYMBOLS' : { 'MCPMSMFOC_ARITHMETIC' : "ARITHMETIC_Q14" },
+                                                'CFLAGS'  : ["-DMCHOST_SIM_TIME=14.0f", "-DMCHOST_SIM_LOAD=0.12f",
+                                                             "-DMCHOST_SIM_LOAD_TIME=8.0f", "-DMCHOST_SIM_SETTLE=3.0f",
+                                                             "-DMCHOST_SIM_MAX_IQ_ERROR=0.02f", "-DMCHOST_SIM_MAX_CURRENT_THD=2.0f"],
+                                              },
+                     'mc_host_profile_q14' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                               'SYMBOLS' : { 'MCPMSMFOC_ARITHMETIC' : "ARITHMETIC_Q14",
+                                                             'MCPMSMFOC_ISR_PROFILER' : True },
+                                             },
+                     'mc_host_sched' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                         'SYMBOLS' : { 'MCPMSMFOC_TASK_SCHEDULER' : True },
+                                       },
+                     'mc_host_retune' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                          'SYMBOLS' : { 'MCPMSMFOC_PARAMETER_CHANNEL' : True },
+                                        },
+                     'mc_host_identification' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_ident.c"],
+                                                  'SYMBOLS' : { 'MCPMSMFOC_MOTOR_IDENTIFICATION' : True,
+                                                                'MCPMSMFOC_PLL_SPEED_SCHEDULING' : True },
+                                                },
+                     'mc_host_load_step' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_load.c"],
+                                             'SYMBOLS' : {},
+                                           },
+                     'mc_host_load_step_observer' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_load.c"],
+                                                      'SYMBOLS' : { 'MCPMSMFOC_LOAD_OBSERVER' : True },
+                                                    },
+                     'mc_host_deadtime' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_deadtime.c"],
+                                            'SYMBOLS' : { 'MCPMSMFOC_DEADTIME_COMP' : True },
+                                          },
+                     'mc_host_voltage' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_voltage.c"],
+                                           'SYMBOLS' : { 'MCPMSMFOC_VOLTAGE_RECONSTRUCTION' : True,
+                                                         'MCPMSMFOC_PLL_SPEED_SCHEDULING' : True },
+                                         },
+                     'mc_host_mtpa' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_mtpa.c"],
+                                        'SYMBOLS' : { 'MCPMSMFOC_MTPA' : True,
+                                                      'MCPMSMFOC_LQ' : 0.00064 },
+                                      },
+                     'mc_host_hfi' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_hfi.c"],
+                                       'SYMBOLS' : { 'MCPMSMFOC_HF_INJECTION' : True,
+                                                     'MCPMSMFOC_LQ' : 0.00064 },
+                                     },
+                     'mc_host_fw' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_fw.c"],
+                                      'SYMBOLS' : { 'MCPMSMFOC_FIELD_WEAKENING' : True,
+                                                    'MCPMSMFOC_FW_METHOD' : "FW_VOLTAGE_LOOP",
+                                                    'MCPMSMFOC_LD' : 0.002,
+                                                    'MCPMSMFOC_LQ' : 0.002,
+                                                    'MCPMSMFOC_MAX_FW_CURRENT' : -3.0,
+                                                    'MCPMSMFOC_MAX_SPEED' : 6000.0,
+                                                    'MCPMSMFOC_ID_KP' : 0.14,
+                                                    'MCPMSMFOC_ID_KI' : 0.00002,
+                                                    'MCPMSMFOC_IQ_KP' : 0.14,
+                                                    'MCPMSMFOC_IQ_KI' : 0.00002,
+                                                    'MCPMSMFOC_SPEED_KP' : 0.01,
+                                                    'MCPMSMFOC_SPEED_KI' : 0.00001 },
+                                    },
+                     'mc_host_fw_map' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_fw.c"],
+                                          'SYMBOLS' : { 'MCPMSMFOC_FIELD_WEAKENING' : True,
+                                                        'MCPMSMFOC_FW_METHOD' : "FW_MAP_VOLTAGE_LOOP",
+                                                        'MCPMSMFOC_LD' : 0.002,
+                                                        'MCPMSMFOC_LQ' : 0.002,
+                                                        'MCPMSMFOC_MAX_FW_CURRENT' : -3.0,
+                                                        'MCPMSMFOC_MAX_SPEED' : 6000.0,
+                                                        'MCPMSMFOC_ID_KP' : 0.14,
+                                                        'MCPMSMFOC_ID_KI' : 0.00002,
+                                                        'MCPMSMFOC_IQ_KP' : 0.14,
+                                                        'MCPMSMFOC_IQ_KI' : 0.00002,
+                                                        'MCPMSMFOC_SPEED_KP' : 0.01,
+                                                        'MCPMSMFOC_SPEED_KI' : 0.00001 },
+                                        },
+                     'mc_host_q14' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_q14.c"],
+                                       'SYMBOLS' : { 'MCPMSMFOC_ARITHMETIC' : "ARITHMETIC_Q14" },
+                                     },
+                     'mc_host_placement' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_sim.c"],
+                                             'SYMBOLS' : { 'MCPMSMFOC_PLACEMENT' : "PLACEMENT_RAM" },
+                                           },
+                     'mc_host_pll' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_trace.c", "mc_host_pll.c"],
+                                       'SYMBOLS' : {},
+                                     },
+                     'mc_host_pll_speed' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_trace.c", "mc_host_pll_speed.c"],
+                                             'SYMBOLS' : { 'MCPMSMFOC_PLL_SPEED_SCHEDULING' : True },
+                                           },
+                     'mc_host_replay' : { 'SOURCES' : ["mc_host_hal.c", "mc_host_plant.c", "mc_host_trace.c", "mc_host_smo.c",
+                                                       "mc_host_rolo.c", "mc_host_replay.c"],
+                                          'SYMBOLS' : {},
+                                          'REPOSITORY_SOURCES' : ["apps/pmsm_foc_smo_sam_e70/firmware/src/positionEstimator.c",
+                                                                  "algorithms/q14_mclib/src/q14_rolo_mcLib.c"],
+                                          'REPOSITORY_INCLUDES' : ["apps/pmsm_foc_smo_sam_e70/firmware/src",
+                                                                   "algorithms/q14_mclib/src", "algorithms/q14_mclib/host"],
+                                          # The SMO application source leaves an observer argument unused
+                                          'CFLAGS'  : ["-fcommon", "-Wno-unused-parameter"],
+                                        },
+                   }
+
+mcHostCompiler = os.environ.get("CC", "gcc")
+# The templates zero initialize the state structures with { 0 } and { 0.0f }
+mcHostCFlags = ["-O2", "-std=gnu99", "-Wall", "-Wextra", "-Wno-missing-field-initializers"]
+
+###################################################################################################
+########################### Symbols   #################################
+###################################################################################################
+
+def mcHostLoadConfigDicts():
+    # Picks the literal parameter dictionaries out of pmsm_foc.py without executing the MHC script
+    dicts = {}
+    with open(mcHostConfigPath) as f:
+        tree = ast.parse(f.read())
+    for node in tree.body:
+        if isinstance(node, ast.Assign) and len(node.targets) == 1 and isinstance(node.targets[0], ast.Name):
+            name = node.targets[0].id
+            if name.endswith("Dict"):
+                try:
+                    dicts[name] = ast.literal_eval(node.value)
+                except ValueError:
+                    pass
+    return dicts
+
+def mcHostLoadConfigFunction(functionName):
+    # Compiles a helper of pmsm_foc.py which only depends on its arguments
+    with open(mcHostConfigPath) as f:
+        tree = ast.parse(f.read())
+    for node in tree.body:
+        if isinstance(node, ast.FunctionDef) and node.name == functionName:
+            scope = {}
+            exec(compile(ast.Module(body = [node], type_ignores = []), mcHostConfigPath, "exec"), scope)
+            return scope[functionName]
+    raise NameError("%s not found in %s" % (functionName, mcHostConfigPath))
+
+def mcHostReferenceSymbols(motor = "LONG_HURST", board = "MCLV2", series = "SAME70"):
+    dicts = mcHostLoadConfigDicts()
+    motorParam = dicts['mcPmsmFocMotorParamDict'][motor]
+    boardParam = dicts['mcPmsmFocBoardParamDict'][board]
+    pwmParam = dicts['mcPmsmFocMclv2PwmDict'][board][series]
+    adcParam = dicts['mcPmsmFocMclv2ADCDict'][board][series]
+    piParam = dicts['mcPmsmFocCurrentPIDict'][board]
+
+    symbols = {
+        '__PROCESSOR'                   : "ATSAME70Q21B",
+        'MCPMSMFOC_X2CScope'            : "None",
+        'MCPMSMFOC_PWM_FREQ'            : int(pwmParam['PWM_FREQ']),
+        'MCPMSMFOC_PWM_DEAD_TIME'       : float(pwmParam['PWM_DEAD_TIME']),
+        'MCPMSMFOC_DEADTIME_COMP'       : False,
+        'MCPMSMFOC_VOLTAGE_RECONSTRUCTION' : False,
+        'MCPMSMFOC_SWITCH_DROP'         : 0.0,
+        'MCPMSMFOC_DEADTIME_COMP_BAND'  : 0.1,
+        'MCPMSMFOC_ADC_RESOLUTION'      : str(adcParam['RESOLUTION']),
+        'MCPMSMFOC_ADC_MAX'             : pow(2, int(adcParam['RESOLUTION'])) - 1,
+        'MCPMSMFOC_POSITION_FB'         : "SENSORLESS_PLL",
+        'MCPMSMFOC_CURRENT_MEAS'        : "DUAL_SHUNT",
+        'MCPMSMFOC_SINCOS'              : "SINCOS_INTERPOLATED_TABLE",
+        'MCPMSMFOC_SVPWM'               : "SVPWM_SECTOR_TREE",
+        'MCPMSMFOC_VOLTAGE_LIMIT'       : "VOLTAGE_LIMIT_LINEAR",
+        'MCPMSMFOC_DPWM_MIN_MI'         : 0.5,
+        'MCPMSMFOC_OPEN_LOOP'           : False,
+        'MCPMSMFOC_TORQUE_MODE'         : False,
+        'MCPMSMFOC_END_TORQUE'          : 0.2,
+        'MCPMSMFOC_FIELD_WEAKENING'     : False,
+        'MCPMSMFOC_FW_METHOD'           : "FW_FEED_FORWARD",
+        'MCPMSMFOC_FW_VOLTAGE_MARGIN'   : 0.95,
+        'MCPMSMFOC_FW_KP'               : 1.0,
+        'MCPMSMFOC_FW_KI'               : 0.002,
+        'MCPMSMFOC_MTPA'                : False,
+        'MCPMSMFOC_PLL_SPEED_SCHEDULING' : False,
+        'MCPMSMFOC_PLL_ESDQ_BANDWIDTH_RATIO' : 1.0,
+        'MCPMSMFOC_PLL_VELESTIM_BANDWIDTH_RATIO' : 0.5,
+        'MCPMSMFOC_HF_INJECTION'        : False,
+        'MCPMSMFOC_HFI_VOLTAGE'         : 2.0,
+        'MCPMSMFOC_HFI_PERIODS'         : 10,
+        'MCPMSMFOC_HFI_BANDWIDTH'       : 500.0,
+        'MCPMSMFOC_HFI_HANDOFF_SPEED'   : 500.0,
+        'MCPMSMFOC_FUSED_KERNEL'        : False,
+        'MCPMSMFOC_ARITHMETIC'          : "ARITHMETIC_FLOAT",
+        'MCPMSMFOC_ISR_PROFILER'        : False,
+        'MCPMSMFOC_ISR_PROFILER_BIN_SHIFT' : 6,
+        'MCPMSMFOC_TASK_SCHEDULER'      : False,
+        'MCPMSMFOC_PARAMETER_CHANNEL'   : False,
+        'MCPMSMFOC_MOTOR_IDENTIFICATION' : False,
+        'MCPMSMFOC_LOAD_OBSERVER'       : False,
+        'MCPMSMFOC_LOAD_OBSERVER_BANDWIDTH' : 300.0,
+        'MCPMSMFOC_PLACEMENT'           : "PLACEMENT_FLASH",
+        'MCPMSMFOC_PLACEMENT_PROFILE'   : mcHostLoadConfigFunction("mcPmsmFocPlacementDeclarations")(dicts['mcPmsmFocPlacementProfileDict']),
+        'MCPMSMFOC_MAX_FW_CURRENT'      : float(motorParam['MAX_FW_CURRENT']),
+        'MCPMSMFOC_MOTOR_CONNECTION'    : motorParam['MOTOR_CONNECTION'],
+        'MCPMSMFOC_R'                   : float(motorParam['R']),
+        'MCPMSMFOC_LD'                  : float(motorParam['LD']),
+        'MCPMSMFOC_LQ'                  : float(motorParam['LQ']),
+        'MCPMSMFOC_POLE_PAIRS'          : float(motorParam['POLE_PAIRS']),
+        'MCPMSMFOC_BEMF_CONST'          : float(motorParam['BEMF_CONST']),
+        'MCPMSMFOC_RATED_SPEED'         : float(motorParam['RATED_SPEED']),
+        'MCPMSMFOC_MAX_SPEED'           : float(motorParam['MAX_SPEED']),
+        'MCPMSMFOC_MAX_MOTOR_CURRENT'   : float(motorParam['MAX_MOTOR_CURRENT']),
+        'MCPMSMFOC_INERTIA'             : 8.0e-6,
+        'MCPMSMFOC_QE_PULSES_PER_REV'   : int(motorParam['QE_PULSES_PER_REV']),
+        'MCPMSMFOC_MAX_CURRENT'         : float(boardParam['MAX_CURRENT']),
+        'MCPMSMFOC_DC_BUS_VOLT'         : float(boardParam['DC_BUS_VOLT']),
+        'MCPMSMFOC_DC_BUS_RATIO'        : float(boardParam['DC_BUS_RATIO']),
+        'MCPMSMFOC_ALIGNMENT_METHOD'    : "FORCED_ALIGNMENT",
+        'MCPMSMFOC_ALIGNMENT'           : "0",
+        'MCPMSMFOC_LOCK_TIME'           : 2.0,
+        'MCPMSMFOC_OL_RAMP_TIME'        : 5.0,
+        'MCPMSMFOC_OL_END_SPEED'        : 500.0,
+        'MCPMSMFOC_OL_IQ_REF'           : 0.4,
+        'MCPMSMFOC_CL_AUTOCALCULATE'    : False,
+        'MCPMSMFOC_CL_BANDWIDTH'        : 2000.0,
+        'MCPMSMFOC_ID_KP'               : float(piParam['KP']),
+        'MCPMSMFOC_ID_KI'               : float(piParam['KI']),
+        'MCPMSMFOC_ID_KC'               : 0.5,
+        'MCPMSMFOC_ID_OUT_MAX'          : 0.98,
+        'MCPMSMFOC_IQ_KP'               : float(piParam['KP']),
+        'MCPMSMFOC_IQ_KI'               : float(piParam['KI']),
+        'MCPMSMFOC_IQ_KC'               : 0.5,
+        'MCPMSMFOC_IQ_OUT_MAX'          : 0.98,
+        'MCPMSMFOC_SPEED_REF_INPUT'     : "UI Input",
+        'MCPMSMFOC_SPEED_REF'           : 2000.0,
+        'MCPMSMFOC_SPEED_KP'            : 0.005,
+        'MCPMSMFOC_SPEED_KI'            : 0.000020,
+        'MCPMSMFOC_SPEED_BANDWIDTH'     : 150.0,
+        'MCPMSMFOC_SPEED_KC'            : 0.5,
+        'MCPMSMFOC_SPEED_OUT_MAX'       : float(boardParam['MAX_CURRENT']),
+    }
+    return symbols
+
+def mcHostParseValue(text):
+    if text in ["True", "true"]:
+        return True
+    if text in ["False", "false"]:
+        return False
+    try:
+        return int(text)
+    except ValueError:
+        pass
+    try:
+        return float(text)
+    except ValueError:
+        return text
+
+###################################################################################################
+########################### FreeMarker subset   #################################
+###################################################################################################
+#
+# Only the constructs used by the pmsm_foc templates are supported: full line <#if>, <#elseif>,
+# <#else>, </#if> and <#assign> directives, and ${...} interpolations with the ?then, ?matches,
+# ?number and ?lower_case built-ins.
+
+mcHostDirective = re.compile(r'^\s*<(#if|#elseif|#else|/#if|#assign)\b\s*(.*?)\s*>\s*$')
+mcHostInterpolation = re.compile(r'\$\{([^{}]*)\}')
+
+def mcHostFormat(value):
+    if isinstance(value, bool):
+        return "true" if value else "false"
+    if isinstance(value, float):
+        if value == int(value) and abs(value) < 1e15:
+            return str(int(value))
+        return repr(value)
+    return str(value)
+
+def mcHostEval(expression, symbols):
+    expr = expression
+    expr = re.sub(r'(\w+)\?matches\(("[^"]*")\)', r'_matches(\1, \2)', expr)
+    expr = re.sub(r'(\w+)\?then\(([^,]+),([^)]+)\)', r'(\2 if \1 else \3)', expr)
+    expr = re.sub(r'(\w+)\?number', r'_number(\1)', expr)
+    expr = re.sub(r'(\w+)\?lower_case', r'\1.lower()', expr)
+    expr = expr.replace("&&", " and ").replace("||", " or ")
+    expr = re.sub(r'!(?!=)', " not ", expr)
+    expr = re.sub(r'\btrue\b', "True", expr)
+    expr = re.sub(r'\bfalse\b', "False", expr)
+    scope = dict(symbols)
+    scope['_matches'] = lambda value, pattern: re.match(pattern + "$", str(value)) is not None
+    scope['_number'] = lambda value: float(value)
+    try:
+        return eval(expr, {"__builtins__": {}}, scope)
+    except NameError as e:
+        raise NameError("undefined symbol in '%s': %s" % (expression, e))
+
+def mcHostRender(text, symbols, sourceName):
+    symbols = dict(symbols)
+    output = []
+    # Each stack entry: [parent active, branch taken, current branch active]
+    stack = []
+    active = True
+    for lineNumber, line in enumerate(text.splitlines(True), 1):
+        match = mcHostDirective.match(line)
+        if match:
+            directive, argument = match.group(1), match.group(2)
+            if directive == "#if":
+                value = active and bool(mcHostEval(argument, symbols))
+                stack.append([active, value, value])
+            elif directive == "#elseif":
+                entry = stack[-1]
+                value = entry[0] and not entry[1] and bool(mcHostEval(argument, symbols))
+                entry[1] = entry[1] or value
+                entry[2] = value
+            elif directive == "#else":
+                entry = stack[-1]
+                entry[2] = entry[0] and not entry[1]
+                entry[1] = True
+            elif directive == "/#if":
+                stack.pop()
+            elif directive == "#assign" and active:
+                name, expr = argument.split("=", 1)
+                symbols[name.strip()] = mcHostEval(expr, symbols)
+            active = stack[-1][2] if stack else True
+            continue
+        if "<#" in line or "</#" in line:
+            raise SyntaxError("%s:%d: unsupported FreeMarker construct" % (sourceName, lineNumber))
+        if active:
+            output.append(mcHostInterpolation.sub(lambda m: mcHostFormat(mcHostEval(m.group(1), symbols)), line))
+    if stack:
+        raise SyntaxError("%s: unterminated <#if>" % sourceName)
+    return "".join(output)
+
+###################################################################################################
+########################### Code Generation   #################################
+###################################################################################################
+
+def mcHostTemplateFiles(symbols):
+    # Same selection rule as the os.walk loop in pmsm_foc.py
+    files = []
+    for filename in sorted(os.listdir(mcHostTemplatePath)):
+        if filename in mcHostReplacedTemplates:
+            continue
+        if ("mc_" in filename) and ((".c" in filename) or (".h" in filename)):
+            outputName = filename[:-4] if filename.endswith(".ftl") else filename
+            files.append((filename, outputName))
+
+    position = symbols['MCPMSMFOC_POSITION_FB']
+    if position not in mcHostPositionDict:
+        raise ValueError("position feedback %s is not supported on host" % position)
+    for filename in mcHostPositionDict[position]:
+        outputName = filename.replace("pos_pll", "mc_rotorposition")[:-4]
+        files.append((filename, outputName))
+    return files
+
+def mcHostDerivedSymbols(symbols):
+    # Symbols which pmsm_foc.py recalculates from others, after the target and command line overrides
+    derived = {}
+    derived['MCPMSMFOC_MTPA_TABLE'] = mcHostLoadConfigFunction("mcPmsmFocMtpaTable")(symbols['MCPMSMFOC_LD'],
+        symbols['MCPMSMFOC_LQ'], symbols['MCPMSMFOC_BEMF_CONST'], symbols['MCPMSMFOC_POLE_PAIRS'],
+        symbols['MCPMSMFOC_MOTOR_CONNECTION'], symbols['MCPMSMFOC_MAX_MOTOR_CURRENT'])
+    derived['MCPMSMFOC_FW_MAP'] = mcHostLoadConfigFunction("mcPmsmFocFieldWeakeningMap")(symbols['MCPMSMFOC_R'],
+        symbols['MCPMSMFOC_LD'], symbols['MCPMSMFOC_LQ'], symbols['MCPMSMFOC_BEMF_CONST'], symbols['MCPMSMFOC_POLE_PAIRS'],
+        symbols['MCPMSMFOC_MOTOR_CONNECTION'], symbols['MCPMSMFOC_MAX_SPEED'], symbols['MCPMSMFOC_MAX_MOTOR_CURRENT'],
+        symbols['MCPMSMFOC_MAX_FW_CURRENT'], symbols['MCPMSMFOC_DC_BUS_VOLT'], symbols['MCPMSMFOC_VOLTAGE_LIMIT'],
+        symbols['MCPMSMFOC_FW_VOLTAGE_MARGIN'])
+    return derived
+
+def mcHostGenerate(outputPath, symbols):
+    if not os.path.isdir(outputPath):
+        os.makedirs(outputPath)
+    sources = []
+    for filename, outputName in mcHostTemplateFiles(symbols):
+        with open(os.path.join(mcHostTemplatePath, filename)) as f:
+            text = mcHostRender(f.read(), symbols, filename)
+        with open(os.path.join(outputPath, outputName), "w") as f:
+            f.write(text)
+        if outputName.endswith(".c"):
+            sources.append(os.path.join(outputPath, outputName))
+    return sources
+
+def mcHostBuild(outputPath, target, overrides, cflags = []):
+    symbols = mcHostReferenceSymbols()
+    symbols.update(mcHostTargetDict[target]['SYMBOLS'])
+    symbols.update(overrides)
+    symbols.update(dict((name, value) for name, value in mcHostDerivedSymbols(symbols).items() if name not in overrides))
+
+    generatedPath = os.path.join(outputPath, target, "pmsm_foc")
+    sources = mcHostGenerate(generatedPath, symbols)
+    sources += [os.path.join(mcHostPath, source) for source in mcHostTargetDict[target]['SOURCES']]
+    sources += [os.path.join(mcHostRepositoryPath, source) for source in mcHostTargetDict[target].get('REPOSITORY_SOURCES', [])]
+
+    executable = os.path.join(outputPath, target, target)
+    command = [mcHostCompiler] + mcHostCFlags + mcHostTargetDict[target].get('CFLAGS', []) + cflags
+    command += ["-I" + mcHostPath, "-I" + generatedPath]
+    command += ["-I" + os.path.join(mcHostRepositoryPath, include) for include in mcHostTargetDict[target].get('REPOSITORY_INCLUDES', [])]
+    command += sources + ["-o", executable, "-lm"]
+    print("Building " + executable)
+    subprocess.check_call(command)
+    return executable
+
+def main():
+    parser = argparse.ArgumentParser(description = "Host build of the pmsm_foc component")
+    parser.add_argument("-o", "--output", default = "mc_host_out", help = "output folder")
+    parser.add_argument("-D", "--define", action = "append", default = [], help = "symbol override SYMBOL=value")
+    parser.add_argument("-C", "--cflag", action = "append", default = [], help = "extra compiler flag, e.g. -C=-DOBS_H_GAIN=0.3f")
+    parser.add_argument("targets", nargs = "*", help = "targets to build (default: all)")
+    args = parser.parse_args()
+
+    overrides = {}
+    for define in args.define:
+        name, value = define.split("=", 1)
+        overrides[name] = mcHostParseValue(value)
+
+    targets = args.targets if args.targets else sorted(mcHostTargetDict.keys())
+    for target in targets:
+        mcHostBuild(args.output, target, overrides, args.cflag)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,315 @@
+/*******************************************************************************
+ Dead Time Compensation Host Test source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_deadtime.c
+
+  Summary:
+    Runs the motor at low speed against a plant with inverter dead time
+
+  Description:
+    This file contains the host test of the dead time compensation. The plant
+    inverter loses the dead time and the switch voltage drop in the direction
+    of every phase current. The motor is started in closed loop, settles at
+    the speed reference with the given load and the harmonic distortion of
+    the phase currents and the angle estimation error are measured. The
+    distortion is the RMS deviation of the rotor frame currents from their
+    mean, relative to the mean current magnitude, which are the 6k +/- 1
+    harmonics of the phase currents. The run is repeated with the compensation
+    voltage set to zero as the reference. The result fails if the motor leaves
+    the closed loop or the compensation does not reduce both the current
+    distortion and the angle estimation error of the reference.
+
+    Usage: mc_host_deadtime [options]
+      --speed <rpm>           speed reference (default MCHOST_DEADTIME_SPEED_RPM)
+      --load <Nm>             load torque (default 0.01)
+      --dead-time <us>        plant dead time (default the configured dead time)
+      --drop <V>              plant switch voltage drop (default SWITCH_VOLTAGE_DROP)
+      --ripple <A>            plant current ripple, half peak to peak (default 0.1)
+      --time <s>              measurement time (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_rotorposition.h"
+#include "mc_speed.h"
+#include "mc_pwm.h"
+#include "mc_lib.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+
+/* Time from the start to the measurement: alignment, open loop ramp and closed loop settling */
+#define     MCHOST_SETTLE_TIME_SEC                  (10.0f)
+
+/* Low speed, just above the end of the open loop startup */
+#define     MCHOST_DEADTIME_SPEED_RPM               ( 1.2f * (float)OPEN_LOOP_END_SPEED_RPM )
+
+#if (ENABLED != DEADTIME_COMPENSATION)
+#error "mc_host_deadtime compares the dead time compensation with its reference, enable DEADTIME_COMPENSATION"
+#endif
+
+typedef struct
+{
+    float                           speed;
+    float                           load;
+    float                           deadTime;
+    float                           drop;
+    float                           ripple;
+    float                           time;
+}tMCHOST_DEADTIME_PARAM_S;
+
+typedef struct
+{
+    bool                            closedLoop;
+    float                           distortion;         /* Current harmonic distortion (relative)           */
+    float                           angleError;         /* RMS angle estimation error (rad)                  */
+    float                           current;            /* Mean current magnitude (A)                        */
+}tMCHOST_DEADTIME_RESULT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCHOST_DeadTimeRun( tMCHOST_DEADTIME_RESULT_S * const pResult );
+static void MCHOST_DeadTimeReport( const char * name, const tMCHOST_DEADTIME_RESULT_S * const pResult );
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_DEADTIME_PARAM_S gMCHOST_DeadTimeParam;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_DeadTimeRun                                          */
+/* Function parameters: pResult - current distortion and angle error          */
+/* Function return: None                                                      */
+/* Description: Starts the motor from standstill, measures after the         */
+/*              settling time and stops the motor again                       */
+/******************************************************************************/
+static void MCHOST_DeadTimeRun( tMCHOST_DEADTIME_RESULT_S * const pResult )
+{
+    uint64_t tick, ticks = (uint64_t)( MCHOST_SETTLE_TIME_SEC / FAST_LOOP_TIME_SEC );
+    double id = 0.0, iq = 0.0, idSqr = 0.0, iqSqr = 0.0, angleErrorSqr = 0.0;
+    double angleError, samples;
+
+    memset( pResult, 0, sizeof( *pResult ) );
+    MCHOST_PlantReset();
+    gMCHOST_PlantInput.loadTorque = gMCHOST_DeadTimeParam.load;
+    PMSM_FOC_MotorStart();
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+    ticks = (uint64_t)( gMCHOST_DeadTimeParam.time / FAST_LOOP_TIME_SEC );
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+        id += (double)gMCHOST_PlantState.id;
+        iq += (double)gMCHOST_PlantState.iq;
+        idSqr += (double)gMCHOST_PlantState.id * (double)gMCHOST_PlantState.id;
+        iqSqr += (double)gMCHOST_PlantState.iq * (double)gMCHOST_PlantState.iq;
+        angleError = (double)MCHOST_AngleDifference( gMCRPOS_OutputSignals.angle, gMCHOST_PlantState.thetaElec );
+        angleErrorSqr += angleError * angleError;
+    }
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+
+    samples = (double)ticks;
+    id /= samples;
+    iq /= samples;
+    pResult->closedLoop = ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState );
+    pResult->current = (float)sqrt( ( id * id ) + ( iq * iq ) );
+    pResult->distortion = (float)( sqrt( fmax( ( idSqr / samples ) - ( id * id ) + ( iqSqr / samples ) - ( iq * iq ), 0.0 ) )
+                                 / (double)pResult->current );
+    pResult->angleError = (float)sqrt( angleErrorSqr / samples );
+
+    PMSM_FOC_MotorStop();
+    MCHOST_Tick();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_DeadTimeReport                                       */
+/* Function parameters: name - run, pResult - dead time run                   */
+/* Function return: None                                                      */
+/* Description: One line of the dead time table                               */
+/******************************************************************************/
+static void MCHOST_DeadTimeReport( const char * name, const tMCHOST_DEADTIME_RESULT_S * const pResult )
+{
+    printf( "%-28s : %8.3f A %8.2f %% %8.3f deg%s\n", name, pResult->current, 100.0f * pResult->distortion,
+            pResult->angleError * ( 180.0f / (float)M_PI ), pResult->closedLoop ? "" : " (not in closed loop)" );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv - command line                             */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "speed",              required_argument, NULL, 's' },
+        { "load",               required_argument, NULL, 'l' },
+        { "dead-time",          required_argument, NULL, 'd' },
+        { "drop",               required_argument, NULL, 'v' },
+        { "ripple",             required_argument, NULL, 'r' },
+        { "time",               required_argument, NULL, 't' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_DeadTimeParam.speed = MCHOST_DEADTIME_SPEED_RPM;
+    gMCHOST_DeadTimeParam.load = 0.01f;
+    gMCHOST_DeadTimeParam.deadTime = PWM_DEAD_TIME_SEC;
+    gMCHOST_DeadTimeParam.drop = SWITCH_VOLTAGE_DROP;
+    gMCHOST_DeadTimeParam.ripple = 0.1f;
+    gMCHOST_DeadTimeParam.time = 1.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 's': gMCHOST_DeadTimeParam.speed = strtof( optarg, NULL ); break;
+            case 'l': gMCHOST_DeadTimeParam.load = strtof( optarg, NULL ); break;
+            case 'd': gMCHOST_DeadTimeParam.deadTime = 1.0e-6f * strtof( optarg, NULL ); break;
+            case 'v': gMCHOST_DeadTimeParam.drop = strtof( optarg, NULL ); break;
+            case 'r': gMCHOST_DeadTimeParam.ripple = strtof( optarg, NULL ); break;
+            case 't': gMCHOST_DeadTimeParam.time = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--speed rpm] [--load Nm] [--dead-time us] [--drop V] [--ripple A] [--time s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( ( gMCHOST_DeadTimeParam.speed < (float)OPEN_LOOP_END_SPEED_RPM ) || ( gMCHOST_DeadTimeParam.speed > MAX_SPEED_RPM ) )
+    {
+        fprintf( stderr, "--speed must be within %.0f and %.0f rpm\n", (float)OPEN_LOOP_END_SPEED_RPM, MAX_SPEED_RPM );
+        return -1;
+    }
+    if( ( gMCHOST_DeadTimeParam.deadTime < 0.0f ) || ( gMCHOST_DeadTimeParam.drop < 0.0f ) || ( gMCHOST_DeadTimeParam.ripple < 0.0f ) )
+    {
+        fprintf( stderr, "--dead-time, --drop and --ripple must not be negative\n" );
+        return -1;
+    }
+    if( gMCHOST_DeadTimeParam.time <= 0.0f )
+    {
+        fprintf( stderr, "--time must be positive\n" );
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_DEADTIME_RESULT_S referenceRun, compensatedRun;
+    uint64_t tick;
+    float duty;
+    int result = 0;
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    gMCHOST_PlantParam.deadTime = gMCHOST_DeadTimeParam.deadTime;
+    gMCHOST_PlantParam.switchDrop = gMCHOST_DeadTimeParam.drop;
+    gMCHOST_PlantParam.rippleCurrent = gMCHOST_DeadTimeParam.ripple;
+    PMSM_FOC_Initialize();
+    gMCSPE_InputSignals.speedRef = gMCHOST_DeadTimeParam.speed * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+    /* Uncompensated inverter */
+    duty = gMCPWM_DeadTimeParam.duty;
+    gMCPWM_DeadTimeParam.duty = 0.0f;
+    MCHOST_DeadTimeRun( &referenceRun );
+    gMCPWM_DeadTimeParam.duty = duty;
+    MCHOST_DeadTimeRun( &compensatedRun );
+
+    printf( "Dead time compensation\n" );
+    printf( "%-28s : %.2f us, %.2f V, %.3f A ripple\n", "Plant inverter", 1.0e6f * gMCHOST_DeadTimeParam.deadTime,
+            gMCHOST_DeadTimeParam.drop, gMCHOST_DeadTimeParam.ripple );
+    printf( "%-28s : %.4f N m at %.0f rpm\n", "Load", gMCHOST_DeadTimeParam.load, gMCHOST_DeadTimeParam.speed );
+    printf( "%-28s : %.4f of the DC bus, %.3f A band\n", "Compensation", gMCPWM_DeadTimeParam.duty,
+            1.0f / gMCPWM_DeadTimeParam.invBand );
+    printf( "%-28s : %10s %10s %12s\n", "Run", "current", "distortion", "angle error" );
+    MCHOST_DeadTimeReport( "uncompensated", &referenceRun );
+    MCHOST_DeadTimeReport( "compensated", &compensatedRun );
+
+    /* Written to fail also on a diverged, not a number, result */
+    if( !referenceRun.closedLoop || !compensatedRun.closedLoop )
+    {
+        result = 1;
+    }
+    if( !( compensatedRun.distortion < referenceRun.distortion ) || !( compensatedRun.angleError < referenceRun.angleError ) )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,122 @@
+/*******************************************************************************
+ Replay Estimator interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_estimator.h
+
+  Summary:
+    Rotor position estimators replayed by mc_host_replay
+
+  Description:
+    This file contains the interface through which mc_host_replay runs the
+    estimators of the other motor control applications on a trace: the
+    sliding mode observer of the SAM E70 SMO application (mc_host_smo.c) and
+    the reduced order Luenberger observer of q14_mclib (mc_host_rolo.c). The
+    estimators are set up for the motor of the build and the PWM period of
+    the trace and return the electrical angle and speed of every period. The
+    tuning parameters which the estimators take at run time are listed in
+    their parameter table and can be changed before the initialization.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MCHOST_ESTIMATOR_H    // Guards against multiple inclusion
+#define MCHOST_ESTIMATOR_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include "mc_host_trace.h"
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Lowest speed at which the control runs on the estimated angle, the open loop end speed (electrical rad/s) */
+#define     MCHOST_ESTIMATOR_MIN_SPEED              (float)( OPEN_LOOP_END_SPEED_RPM * ( M_PI / 30.0 ) * NUM_POLE_PAIRS )
+
+/* Estimate of one PWM period */
+typedef struct
+{
+    float                           angle;              /* Electrical angle (rad)                          */
+    float                           speed;              /* Electrical speed (rad/s)                        */
+}tMCHOST_ESTIMATE_S;
+
+/* Tuning parameter, the table of an estimator ends with a NULL name */
+typedef struct
+{
+    const char *                    name;
+    float *                         value;
+}tMCHOST_ESTIMATOR_PARAMETER_S;
+
+typedef struct
+{
+    const char *                    name;
+    const tMCHOST_ESTIMATOR_PARAMETER_S * parameters;
+    float                           maxAngleError;      /* Default limit of the RMS angle error (deg)     */
+    int                             (*initialize)( void );  /* Reset for gMCHOST_Trace, 0 on success      */
+    void                            (*step)( const tMCHOST_TRACE_RECORD_S * const record,
+                                             tMCHOST_ESTIMATE_S * const estimate );
+}tMCHOST_ESTIMATOR_S;
+
+extern const tMCHOST_ESTIMATOR_S        gMCHOST_SmoEstimator;
+extern const tMCHOST_ESTIMATOR_S        gMCHOST_RoloEstimator;
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MCHOST_ESTIMATOR_H
+
+/**
+ End of File
+*/
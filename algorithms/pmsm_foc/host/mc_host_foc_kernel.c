@@ -0,0 +1,401 @@
+/*******************************************************************************
+ Fused Current Control Kernel Check source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_foc_kernel.c
+
+  Summary:
+    Comparison of the fused current control kernel with the reference chain
+
+  Description:
+    This file runs MCFOC_CurrentLoopKernel and the reference chain of
+    MCLIB_ClarkeTransform, MCLIB_ParkTransform, MCLIB_PIControl (Iq, Id),
+    MCLIB_SinCosCalc, MCLIB_InvParkTransform, MCPWM_VoltageLimit and
+    MCPWM_SVPWMGen on the same pseudo random phase currents, angles,
+    references and PI controller states, including saturated controllers. It reports the number of bit exact
+    results, the largest deviation of the signals and of the duty cycles and
+    the execution time per call of both implementations.
+
+    Usage: mc_host_foc_kernel [--max-duty-error <counts>]
+      --max-duty-error <counts>   fail if a duty cycle differs by more
+                                  (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_generic_lib.h"
+#include "mc_lib.h"
+#include "mc_picontrol.h"
+#include "mc_pwm.h"
+#include "mc_foc_kernel.h"
+#include "mc_hal.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_KERNEL_CHECK_POINTS              (1000000U)
+#define     MCHOST_KERNEL_BENCH_POINTS              (1024U)
+#define     MCHOST_KERNEL_BENCH_ROUNDS              (2000U)
+
+/* Inputs of one control cycle */
+typedef struct
+{
+    tMCCUR_PHASE_CURRENTS_S     current;
+    float                       idRef;
+    float                       iqRef;
+    float                       angle;
+}tMCHOST_KERNEL_INPUT_S;
+
+/* Signals updated by one control cycle */
+typedef struct
+{
+    tMCLIB_PICONTROLLER_S       idController;
+    tMCLIB_PICONTROLLER_S       iqController;
+    tMCLIB_POSITION_S           position;
+    tMCLIB_CLARK_TRANSFORM_S    currentAlphaBeta;
+    tMCLIB_PARK_TRANSFORM_S     currentDQ;
+    tMCLIB_PARK_TRANSFORM_S     voltageDQ;
+    tMCLIB_CLARK_TRANSFORM_S    voltageAlphaBeta;
+    tMCPWM_SVPWM_S              svm;
+}tMCHOST_KERNEL_STATE_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_KERNEL_INPUT_S gMCHOST_BenchInputs[MCHOST_KERNEL_BENCH_POINTS];
+static uint32_t gMCHOST_Seed = 12345U;
+volatile uint32_t gMCHOST_BenchSink;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_Random                                               */
+/* Function parameters: minimum, maximum                                      */
+/* Function return: Pseudo random value in [minimum, maximum)                 */
+/* Description: Linear congruential generator                                 */
+/******************************************************************************/
+static float MCHOST_Random( const float minimum, const float maximum )
+{
+    gMCHOST_Seed = ( gMCHOST_Seed * 1664525U ) + 1013904223U;
+    return minimum + ( maximum - minimum ) * ( (float)( gMCHOST_Seed >> 8 ) * ( 1.0f / 16777216.0f ) );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RandomInput                                          */
+/* Function parameters: input                                                 */
+/* Function return: None                                                      */
+/* Description: Currents and references up to 1.5 times the motor limit      */
+/******************************************************************************/
+static void MCHOST_RandomInput( tMCHOST_KERNEL_INPUT_S * const input )
+{
+    input->current.iu = MCHOST_Random( -1.5f * MAX_MOTOR_CURRENT, 1.5f * MAX_MOTOR_CURRENT );
+    input->current.iv = MCHOST_Random( -1.5f * MAX_MOTOR_CURRENT, 1.5f * MAX_MOTOR_CURRENT );
+    input->idRef = MCHOST_Random( -MAX_MOTOR_CURRENT, 0.2f * MAX_MOTOR_CURRENT );
+    input->iqRef = MCHOST_Random( -1.5f * MAX_MOTOR_CURRENT, 1.5f * MAX_MOTOR_CURRENT );
+    input->angle = MCHOST_Random( 0.0f, TOTAL_SINE_TABLE_ANGLE );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_StateInitialize                                      */
+/* Function parameters: state                                                 */
+/* Function return: None                                                      */
+/* Description: Controller gains of the configuration, random integrators     */
+/*              up to 1.2 times the output limit and random previous angle    */
+/******************************************************************************/
+static void MCHOST_StateInitialize( tMCHOST_KERNEL_STATE_S * const state )
+{
+    memset( state, 0, sizeof( *state ) );
+
+    state->iqController.kp = Q_CURRCNTR_PTERM;
+    state->iqController.ki = Q_CURRCNTR_ITERM;
+    state->iqController.kc = Q_CURRCNTR_CTERM;
+    state->iqController.outMax = Q_CURRCNTR_OUTMAX;
+    state->iqController.outMin = -Q_CURRCNTR_OUTMAX;
+    state->iqController.dSum = MCHOST_Random( -1.2f * Q_CURRCNTR_OUTMAX, 1.2f * Q_CURRCNTR_OUTMAX );
+
+    state->idController.kp = D_CURRCNTR_PTERM;
+    state->idController.ki = D_CURRCNTR_ITERM;
+    state->idController.kc = D_CURRCNTR_CTERM;
+    state->idController.outMax = D_CURRCNTR_OUTMAX;
+    state->idController.outMin = -D_CURRCNTR_OUTMAX;
+    state->idController.dSum = MCHOST_Random( -1.2f * D_CURRCNTR_OUTMAX, 1.2f * D_CURRCNTR_OUTMAX );
+
+    state->position.angle = MCHOST_Random( 0.0f, TOTAL_SINE_TABLE_ANGLE );
+    MCLIB_SinCosCalc( state->position.angle, &state->position.sineAngle, &state->position.cosAngle );
+
+    state->svm.period = (float)MCHAL_PWMPrimaryPeriodGet( MCHAL_PWM_PH_U );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ReferenceChain                                       */
+/* Function parameters: input, state                                          */
+/* Function return: None                                                      */
+/* Description: Current control as done by MCCTRL_SignalTransformation and    */
+/*              MCCTRL_MotorControl without the fused kernel                  */
+/******************************************************************************/
+static void MCHOST_ReferenceChain( const tMCHOST_KERNEL_INPUT_S * const input, tMCHOST_KERNEL_STATE_S * const state )
+{
+    MCLIB_ClarkeTransform( &input->current, &state->currentAlphaBeta );
+    MCLIB_ParkTransform( &state->currentAlphaBeta, &state->position, &state->currentDQ );
+
+    state->position.angle = input->angle;
+
+    state->iqController.inMeas = state->currentDQ.quadratureAxis;
+    state->iqController.inRef  = input->iqRef;
+    MCLIB_PIControl( &state->iqController );
+    state->voltageDQ.quadratureAxis = state->iqController.out;
+
+    state->idController.inMeas = state->currentDQ.directAxis;
+    state->idController.inRef  = input->idRef;
+    MCLIB_PIControl( &state->idController );
+    state->voltageDQ.directAxis = state->idController.out;
+
+    MCLIB_SinCosCalc( state->position.angle, &state->position.sineAngle, &state->position.cosAngle );
+    MCLIB_InvParkTransform( &state->voltageDQ, &state->position, &state->voltageAlphaBeta );
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+    MCPWM_VoltageLimit( &state->voltageAlphaBeta.alphaAxis, &state->voltageAlphaBeta.betaAxis );
+#endif
+    MCPWM_SVPWMGen( &state->voltageAlphaBeta, &state->svm );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_KernelBind                                           */
+/* Function parameters: state, kernel                                         */
+/* Function return: None                                                      */
+/* Description: Points the kernel to the signals of a state                   */
+/******************************************************************************/
+static void MCHOST_KernelBind( tMCHOST_KERNEL_STATE_S * const state, tMCFOC_KERNEL_S * const kernel )
+{
+    kernel->pIdController = &state->idController;
+    kernel->pIqController = &state->iqController;
+    kernel->pPosition = &state->position;
+    kernel->pCurrentDQ = &state->currentDQ;
+    kernel->pVoltageDQ = &state->voltageDQ;
+    kernel->pVoltageAlphaBeta = &state->voltageAlphaBeta;
+    kernel->pSvm = &state->svm;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_FusedKernel                                          */
+/* Function parameters: input, state, kernel                                  */
+/* Function return: None                                                      */
+/* Description: Current control as done with the fused kernel                 */
+/******************************************************************************/
+static void MCHOST_FusedKernel( const tMCHOST_KERNEL_INPUT_S * const input, tMCHOST_KERNEL_STATE_S * const state,
+                                const tMCFOC_KERNEL_S * const kernel )
+{
+    MCLIB_ClarkeTransform( &input->current, &state->currentAlphaBeta );
+
+    state->position.angle = input->angle;
+    MCFOC_CurrentLoopKernel( &input->current, input->idRef, input->iqRef, kernel );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Deviation                                            */
+/* Function parameters: reference, value, maximum deviation                   */
+/* Function return: true if bit exact                                         */
+/* Description: Tracks the largest absolute deviation                         */
+/******************************************************************************/
+static bool MCHOST_Deviation( const float reference, const float value, double * const maxDeviation )
+{
+    double deviation = fabs( (double)value - (double)reference );
+
+    if( deviation > *maxDeviation )
+    {
+        *maxDeviation = deviation;
+    }
+    return ( 0 == memcmp( &reference, &value, sizeof( float ) ) );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_DutyDeviation                                        */
+/* Function parameters: reference, value, maximum deviation                   */
+/* Function return: true if equal                                             */
+/* Description: Tracks the largest duty cycle deviation in counts             */
+/******************************************************************************/
+static bool MCHOST_DutyDeviation( const uint32_t reference, const uint32_t value, uint32_t * const maxDeviation )
+{
+    uint32_t deviation = ( value > reference ) ? ( value - reference ) : ( reference - value );
+
+    if( deviation > *maxDeviation )
+    {
+        *maxDeviation = deviation;
+    }
+    return ( 0U == deviation );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Benchmark                                            */
+/* Function parameters: fused - kernel or reference chain                     */
+/* Function return: cycle counter ticks per control cycle                     */
+/* Description: Best round over the benchmark inputs, PI states carried on    */
+/******************************************************************************/
+static double MCHOST_Benchmark( const bool fused )
+{
+    tMCHOST_KERNEL_STATE_S state;
+    tMCFOC_KERNEL_S kernel;
+    uint32_t round, i, start, cycles, best = UINT32_MAX;
+
+    MCHOST_StateInitialize( &state );
+    MCHOST_KernelBind( &state, &kernel );
+
+    for( round = 0U; round < MCHOST_KERNEL_BENCH_ROUNDS; round++ )
+    {
+        start = MCHAL_CycleCounterGet();
+        if( fused )
+        {
+            for( i = 0U; i < MCHOST_KERNEL_BENCH_POINTS; i++ )
+            {
+                MCHOST_FusedKernel( &gMCHOST_BenchInputs[i], &state, &kernel );
+            }
+        }
+        else
+        {
+            for( i = 0U; i < MCHOST_KERNEL_BENCH_POINTS; i++ )
+            {
+                MCHOST_ReferenceChain( &gMCHOST_BenchInputs[i], &state );
+            }
+        }
+        cycles = MCHAL_CycleCounterGet() - start;
+        gMCHOST_BenchSink = state.svm.dPwm1;
+
+        /* Best round, free from preemption */
+        if( cycles < best )
+        {
+            best = cycles;
+        }
+    }
+    return (double)best / (double)MCHOST_KERNEL_BENCH_POINTS;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_KERNEL_INPUT_S input;
+    tMCHOST_KERNEL_STATE_S reference, fused;
+    tMCFOC_KERNEL_S kernel;
+    uint32_t i, exact = 0U, maxDutyError = 1U, dutyDeviation = 0U, saturated = 0U;
+    double signalDeviation = 0.0, stateDeviation = 0.0, referenceCycles, fusedCycles;
+    bool equal;
+    int result = 0;
+
+    if( ( argc == 3 ) && ( 0 == strcmp( argv[1], "--max-duty-error" ) ) )
+    {
+        maxDutyError = (uint32_t)strtoul( argv[2], NULL, 0 );
+    }
+    else if( argc != 1 )
+    {
+        fprintf( stderr, "usage: %s [--max-duty-error counts]\n", argv[0] );
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+    MCHOST_KernelBind( &fused, &kernel );
+
+    for( i = 0U; i < MCHOST_KERNEL_CHECK_POINTS; i++ )
+    {
+        MCHOST_StateInitialize( &reference );
+        memcpy( &fused, &reference, sizeof( reference ) );
+        MCHOST_RandomInput( &input );
+
+        MCHOST_ReferenceChain( &input, &reference );
+        MCHOST_FusedKernel( &input, &fused, &kernel );
+
+        equal = MCHOST_Deviation( reference.currentDQ.directAxis, fused.currentDQ.directAxis, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.currentDQ.quadratureAxis, fused.currentDQ.quadratureAxis, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.voltageDQ.directAxis, fused.voltageDQ.directAxis, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.voltageDQ.quadratureAxis, fused.voltageDQ.quadratureAxis, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.voltageAlphaBeta.alphaAxis, fused.voltageAlphaBeta.alphaAxis, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.voltageAlphaBeta.betaAxis, fused.voltageAlphaBeta.betaAxis, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.position.sineAngle, fused.position.sineAngle, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.position.cosAngle, fused.position.cosAngle, &signalDeviation );
+        equal &= MCHOST_Deviation( reference.idController.dSum, fused.idController.dSum, &stateDeviation );
+        equal &= MCHOST_Deviation( reference.iqController.dSum, fused.iqController.dSum, &stateDeviation );
+        equal &= MCHOST_Deviation( reference.idController.inMeas, fused.idController.inMeas, &stateDeviation );
+        equal &= MCHOST_Deviation( reference.iqController.inMeas, fused.iqController.inMeas, &stateDeviation );
+        equal &= MCHOST_Deviation( reference.idController.inRef, fused.idController.inRef, &stateDeviation );
+        equal &= MCHOST_Deviation( reference.iqController.inRef, fused.iqController.inRef, &stateDeviation );
+        equal &= MCHOST_DutyDeviation( reference.svm.dPwm1, fused.svm.dPwm1, &dutyDeviation );
+        equal &= MCHOST_DutyDeviation( reference.svm.dPwm2, fused.svm.dPwm2, &dutyDeviation );
+        equal &= MCHOST_DutyDeviation( reference.svm.dPwm3, fused.svm.dPwm3, &dutyDeviation );
+        if( equal )
+        {
+            exact++;
+        }
+        if( ( reference.iqController.out == reference.iqController.outMax )
+         || ( reference.iqController.out == reference.iqController.outMin ) )
+        {
+            saturated++;
+        }
+    }
+
+    for( i = 0U; i < MCHOST_KERNEL_BENCH_POINTS; i++ )
+    {
+        MCHOST_RandomInput( &gMCHOST_BenchInputs[i] );
+    }
+    referenceCycles = MCHOST_Benchmark( false );
+    fusedCycles = MCHOST_Benchmark( true );
+
+    printf( "Test points                  : %u (Iq controller saturated in %u)\n", (unsigned)MCHOST_KERNEL_CHECK_POINTS, (unsigned)saturated );
+    printf( "Bit exact                    : %u\n", (unsigned)exact );
+    printf( "Max signal deviation         : %.3e\n", signalDeviation );
+    printf( "Max PI state deviation       : %.3e\n", stateDeviation );
+    printf( "Max duty deviation           : %u counts (limit %u)\n", (unsigned)dutyDeviation, (unsigned)maxDutyError );
+    printf( "%-28s %10s %10s\n", "Implementation", "counts", "ns" );
+    printf( "%-28s %10.1f %10.2f\n", "Reference chain", referenceCycles, referenceCycles * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ );
+    printf( "%-28s %10.1f %10.2f\n", "Fused kernel", fusedCycles, fusedCycles * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ );
+
+    if( dutyDeviation > maxDutyError )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
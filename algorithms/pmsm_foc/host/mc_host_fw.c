@@ -0,0 +1,284 @@
+/*******************************************************************************
+ Field Weakening Host Test source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_fw.c
+
+  Summary:
+    Runs the field weakening control above the rated speed against the plant
+    model
+
+  Description:
+    This file contains the host test of FIELD_WEAKENING. The motor is started
+    in closed loop from standstill and settles at MCHOST_START_SPEED_RPM, then
+    with the given load torque the speed reference steps through
+    MCHOST_SPEED_STEPS equal steps from the rated speed up to the given speed. At the end of each
+    step the speed, the d- and q-axis currents and the modulation index of the
+    plant voltage are averaged, and the peak to peak speed ripple is taken.
+    The plant inductances can be scaled against the configured ones to check
+    the sensitivity to inductance errors. The result fails if the motor leaves
+    the closed loop, or if at any step the mean speed deviates from the
+    reference or the speed ripple exceeds MCHOST_SPEED_TOLERANCE.
+
+    Usage: mc_host_fw [options]
+      --speed <rpm>           speed reference of the last step (default twice the rated speed)
+      --load <Nm>             load torque (default 0.02)
+      --inductance <ratio>    plant inductances relative to the configured ones (default 1)
+      --time <s>              time of each speed step (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_rotorposition.h"
+#include "mc_speed.h"
+#include "mc_lib.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+
+/* Time from the start to the first speed step: alignment, open loop ramp and closed loop settling at the
+   start speed, which is well below the rated speed for the open to closed loop transition */
+#define     MCHOST_SETTLE_TIME_SEC                  (10.0f)
+#define     MCHOST_START_SPEED_RPM                  (1000.0f)
+
+/* Speed steps above the rated speed, and the averaging time at the end of each step */
+#define     MCHOST_SPEED_STEPS                      (4U)
+#define     MCHOST_MEASURE_TIME_SEC                 (0.25f)
+
+/* Largest mean speed error and peak to peak speed ripple, relative to the speed reference */
+#define     MCHOST_SPEED_TOLERANCE                  (0.02f)
+
+typedef struct
+{
+    float                           speed;
+    float                           load;
+    float                           inductance;
+    float                           time;
+}tMCHOST_FW_PARAM_S;
+
+typedef struct
+{
+    double                          speed;              /* Sums of the averaged quantities                  */
+    double                          id;
+    double                          iq;
+    double                          modulation;
+    float                           speedMin;
+    float                           speedMax;
+    uint64_t                        samples;
+}tMCHOST_FW_MEASUREMENT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_FW_PARAM_S gMCHOST_FwParam;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv - command line                             */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "speed",              required_argument, NULL, 's' },
+        { "load",               required_argument, NULL, 'l' },
+        { "inductance",         required_argument, NULL, 'i' },
+        { "time",               required_argument, NULL, 't' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_FwParam.speed = 2.0f * RATED_SPEED_RPM;
+    gMCHOST_FwParam.load = 0.02f;
+    gMCHOST_FwParam.inductance = 1.0f;
+    gMCHOST_FwParam.time = 1.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 's': gMCHOST_FwParam.speed = strtof( optarg, NULL ); break;
+            case 'l': gMCHOST_FwParam.load = strtof( optarg, NULL ); break;
+            case 'i': gMCHOST_FwParam.inductance = strtof( optarg, NULL ); break;
+            case 't': gMCHOST_FwParam.time = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--speed rpm] [--load Nm] [--inductance ratio] [--time s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( ( gMCHOST_FwParam.speed <= RATED_SPEED_RPM ) || ( gMCHOST_FwParam.speed > MAX_SPEED_RPM ) )
+    {
+        fprintf( stderr, "--speed must be above %.0f and within %.0f rpm\n", RATED_SPEED_RPM, MAX_SPEED_RPM );
+        return -1;
+    }
+    if( gMCHOST_FwParam.inductance <= 0.0f )
+    {
+        fprintf( stderr, "--inductance must be positive\n" );
+        return -1;
+    }
+    if( gMCHOST_FwParam.time <= MCHOST_MEASURE_TIME_SEC )
+    {
+        fprintf( stderr, "--time must be longer than %.2f s\n", MCHOST_MEASURE_TIME_SEC );
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    static const char * const methods[] = { "feed-forward", "voltage loop", "map and voltage loop" };
+    tMCHOST_FW_MEASUREMENT_S measurement;
+    uint64_t tick, ticks = (uint64_t)( MCHOST_SETTLE_TIME_SEC / FAST_LOOP_TIME_SEC );
+    uint64_t measureTick;
+    float speedRef, speed, ripple, id, iq, modulation;
+    uint32_t step;
+    int result = 0;
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    gMCHOST_PlantParam.ld *= gMCHOST_FwParam.inductance;
+    gMCHOST_PlantParam.lq *= gMCHOST_FwParam.inductance;
+    PMSM_FOC_Initialize();
+    gMCSPE_InputSignals.speedRef = MCHOST_START_SPEED_RPM * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+    MCHOST_PlantReset();
+    PMSM_FOC_MotorStart();
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+    }
+    gMCHOST_PlantInput.loadTorque = gMCHOST_FwParam.load;
+
+    printf( "Field weakening\n" );
+    printf( "%-28s : %s\n", "Method", methods[FIELD_WEAKENING_METHOD] );
+    printf( "%-28s : Ld %.3g H, Lq %.3g H (x%.2f), %.3f N m\n", "Motor", gMCHOST_PlantParam.ld, gMCHOST_PlantParam.lq,
+            gMCHOST_FwParam.inductance, gMCHOST_FwParam.load );
+    printf( "%-28s : %8s %8s %8s %8s %8s\n", "Speed reference (rpm)", "speed", "ripple", "id", "iq", "m" );
+
+    ticks = (uint64_t)( gMCHOST_FwParam.time / FAST_LOOP_TIME_SEC );
+    measureTick = (uint64_t)( ( gMCHOST_FwParam.time - MCHOST_MEASURE_TIME_SEC ) / FAST_LOOP_TIME_SEC );
+    for( step = 1U; step <= MCHOST_SPEED_STEPS; step++ )
+    {
+        memset( &measurement, 0, sizeof( measurement ) );
+        measurement.speedMin = MAX_SPEED_RPM;
+        speedRef = RATED_SPEED_RPM + ( ( gMCHOST_FwParam.speed - RATED_SPEED_RPM ) * (float)step / (float)MCHOST_SPEED_STEPS );
+        gMCSPE_InputSignals.speedRef = speedRef * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+        for( tick = 0U; tick < ticks; tick++ )
+        {
+            MCHOST_Tick();
+            if( tick >= measureTick )
+            {
+                measurement.speed += (double)gMCHOST_PlantOutput.speedRpm;
+                measurement.id += (double)gMCHOST_PlantState.id;
+                measurement.iq += (double)gMCHOST_PlantState.iq;
+                measurement.modulation += sqrt( ( (double)gMCHOST_PlantOutput.ud * (double)gMCHOST_PlantOutput.ud )
+                                              + ( (double)gMCHOST_PlantOutput.uq * (double)gMCHOST_PlantOutput.uq ) )
+                                        / ( (double)gMCHOST_PlantParam.udc * (double)ONE_BY_SQRT3 );
+                measurement.speedMin = fminf( measurement.speedMin, gMCHOST_PlantOutput.speedRpm );
+                measurement.speedMax = fmaxf( measurement.speedMax, gMCHOST_PlantOutput.speedRpm );
+                measurement.samples++;
+            }
+        }
+
+        speed = (float)( measurement.speed / (double)measurement.samples );
+        ripple = measurement.speedMax - measurement.speedMin;
+        id = (float)( measurement.id / (double)measurement.samples );
+        iq = (float)( measurement.iq / (double)measurement.samples );
+        modulation = (float)( measurement.modulation / (double)measurement.samples );
+
+        printf( "%-28.0f : %8.1f %8.1f %8.3f %8.3f %8.3f\n", speedRef, speed, ripple, id, iq, modulation );
+
+        /* Written to fail also on a diverged, not a number, plant state */
+        if( !( fabsf( speed - speedRef ) <= ( MCHOST_SPEED_TOLERANCE * speedRef ) )
+         || !( ripple <= ( MCHOST_SPEED_TOLERANCE * speedRef ) ) )
+        {
+            result = 1;
+        }
+    }
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+
+    if( MCAPP_CLOSED_LOOP != gMCCTRL_CtrlParam.mcState )
+    {
+        printf( "%-28s : %s\n", "Control state", "not in closed loop" );
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,309 @@
+/*******************************************************************************
+ Host Peripheral Simulation source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_hal.c
+
+  Summary:
+    Simulated PWM, ADC and GPIO peripherals for host builds
+
+  Description:
+    This file implements the peripherals behind the host mc_hal.h. The plant
+    model writes the sampled phase currents and DC bus voltage through
+    MCHOST_ADCConversion and reads back the duty ratios through
+    MCHOST_PWMDutyGet.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_host_hal.h"
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+__STATIC_INLINE uint16_t MCHOST_ADCQuantize( float counts );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCHOST_HAL_S       gMCHOST_Hal;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_ADCQuantize                                          */
+/* Function parameters: counts - ideal ADC result                             */
+/* Function return: ADC result                                                */
+/* Description: Rounds and saturates to the ADC range                         */
+/******************************************************************************/
+__STATIC_INLINE uint16_t MCHOST_ADCQuantize( float counts )
+{
+    if( counts < 0.0f )
+    {
+        counts = 0.0f;
+    }
+    else if( counts > MAX_ADC_COUNT )
+    {
+        counts = MAX_ADC_COUNT;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+    return (uint16_t)( counts + 0.5f );
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCHOST_HalInitialize                                        */
+/* Function parameters: pwmFrequency - PWM frequency in Hz                    */
+/* Function return: None                                                      */
+/* Description: Resets the simulated peripherals                              */
+/******************************************************************************/
+void MCHOST_HalInitialize( uint32_t pwmFrequency )
+{
+    uint32_t channel;
+
+    gMCHOST_Hal.period = MCHOST_PWM_CLOCK_HZ / ( 2U * pwmFrequency );
+    for( channel = 0U; channel < (uint32_t)MCHOST_PWM_CHANNELS; channel++ )
+    {
+        gMCHOST_Hal.dutyRegister[channel] = gMCHOST_Hal.period >> 1;
+        gMCHOST_Hal.outputEnabled[channel] = false;
+    }
+    gMCHOST_Hal.runningChannels = 0U;
+    gMCHOST_Hal.adcCallback = NULL;
+    gMCHOST_Hal.pwmCallback = NULL;
+    gMCHOST_Hal.startStopPressed = false;
+    gMCHOST_Hal.directionPressed = false;
+    gMCHOST_Hal.faultLed = false;
+    gMCHOST_Hal.directionLed = false;
+    gMCHOST_Hal.swIrqEnabled = false;
+    gMCHOST_Hal.swIrqPending = false;
+
+    MCHOST_ADCConversion( 0.0f, 0.0f, 0.0f, 0.0f );
+}
+
+void MCHOST_PWMStart( uint32_t mask )
+{
+    gMCHOST_Hal.runningChannels |= mask;
+}
+
+void MCHOST_PWMStop( uint32_t mask )
+{
+    gMCHOST_Hal.runningChannels &= ~mask;
+}
+
+uint32_t MCHOST_PWMPrimaryPeriodGet( tMCHOST_PWM_CHANNEL_E channel )
+{
+    /* All channels share the period */
+    (void)channel;
+    return gMCHOST_Hal.period;
+}
+
+void MCHOST_PWMDutySet( tMCHOST_PWM_CHANNEL_E channel, uint32_t duty )
+{
+    gMCHOST_Hal.dutyRegister[channel] = duty;
+}
+
+void MCHOST_PWMOutputDisable( tMCHOST_PWM_CHANNEL_E channel )
+{
+    gMCHOST_Hal.outputEnabled[channel] = false;
+}
+
+void MCHOST_PWMOutputEnable( tMCHOST_PWM_CHANNEL_E channel )
+{
+    gMCHOST_Hal.outputEnabled[channel] = true;
+}
+
+void MCHOST_PWMCallbackRegister( MCHOST_CALLBACK callback, uintptr_t context )
+{
+    gMCHOST_Hal.pwmCallback = callback;
+    gMCHOST_Hal.pwmContext = context;
+}
+
+void MCHOST_ADCCallbackRegister( MCHOST_CALLBACK callback, uintptr_t context )
+{
+    gMCHOST_Hal.adcCallback = callback;
+    gMCHOST_Hal.adcContext = context;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PWMOutputIsEnabled                                   */
+/* Function parameters: None                                                  */
+/* Function return: true if the inverter is switching                         */
+/* Description: Inverter state as seen by the plant                           */
+/******************************************************************************/
+bool MCHOST_PWMOutputIsEnabled( void )
+{
+    return ( ( 0x7U == ( gMCHOST_Hal.runningChannels & 0x7U ) )
+          && gMCHOST_Hal.outputEnabled[MCHOST_PWM_PH_U]
+          && gMCHOST_Hal.outputEnabled[MCHOST_PWM_PH_V]
+          && gMCHOST_Hal.outputEnabled[MCHOST_PWM_PH_W] );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PWMDutyGet                                           */
+/* Function parameters: dutyU, dutyV, dutyW - high side duty ratio [0, 1]     */
+/* Function return: None                                                      */
+/* Description: Converts the duty registers into high side duty ratios        */
+/******************************************************************************/
+void MCHOST_PWMDutyGet( float * const dutyU, float * const dutyV, float * const dutyW )
+{
+    float invPeriod = 1.0f / (float)gMCHOST_Hal.period;
+
+    *dutyU = (float)( gMCHOST_Hal.period - gMCHOST_Hal.dutyRegister[MCHOST_PWM_PH_U] ) * invPeriod;
+    *dutyV = (float)( gMCHOST_Hal.period - gMCHOST_Hal.dutyRegister[MCHOST_PWM_PH_V] ) * invPeriod;
+    *dutyW = (float)( gMCHOST_Hal.period - gMCHOST_Hal.dutyRegister[MCHOST_PWM_PH_W] ) * invPeriod;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ADCConversion                                        */
+/* Function parameters: iu, iv - phase currents in A                          */
+/*                      udc - DC bus voltage in V                             */
+/*                      pot - potentiometer position [0, 1]                   */
+/* Function return: None                                                      */
+/* Description: Converts the sampled signals into ADC results using the       */
+/*              board scaling of mc_derivedparams.h                           */
+/******************************************************************************/
+void MCHOST_ADCConversion( const float iu, const float iv, const float udc, const float pot )
+{
+    /* Current sense amplifiers are inverting, see MCCUR_CurrentMeasurement */
+    gMCHOST_Hal.adcResult[MCHOST_ADC_PH_U] = MCHOST_ADCQuantize( MCHOST_ADC_CURRENT_OFFSET - ( iu / ADC_CURRENT_SCALE ) );
+    gMCHOST_Hal.adcResult[MCHOST_ADC_PH_V] = MCHOST_ADCQuantize( MCHOST_ADC_CURRENT_OFFSET - ( iv / ADC_CURRENT_SCALE ) );
+    gMCHOST_Hal.adcResult[MCHOST_ADC_VDC] = MCHOST_ADCQuantize( udc / VOLTAGE_ADC_TO_PHY_RATIO );
+    gMCHOST_Hal.adcResult[MCHOST_ADC_POT] = MCHOST_ADCQuantize( pot * MAX_ADC_COUNT );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ADCInterrupt                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Executes the registered ADC end of conversion handler         */
+/******************************************************************************/
+void MCHOST_ADCInterrupt( void )
+{
+    if( NULL != gMCHOST_Hal.adcCallback )
+    {
+        gMCHOST_Hal.adcCallback( 0U, gMCHOST_Hal.adcContext );
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PWMFaultInterrupt                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Executes the registered PWM fault handler                     */
+/******************************************************************************/
+void MCHOST_PWMFaultInterrupt( void )
+{
+    if( NULL != gMCHOST_Hal.pwmCallback )
+    {
+        gMCHOST_Hal.pwmCallback( 0U, gMCHOST_Hal.pwmContext );
+    }
+}
+
+void MCHOST_SwInterruptEnable( void )
+{
+    gMCHOST_Hal.swIrqEnabled = true;
+}
+
+void MCHOST_SwInterruptPend( void )
+{
+    gMCHOST_Hal.swIrqPending = true;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SwInterrupt                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Executes the software interrupt handler if it was pended.     */
+/*              Called after the ADC interrupt, which it cannot preempt.      */
+/******************************************************************************/
+void MCHOST_SwInterrupt( void )
+{
+    if( gMCHOST_Hal.swIrqEnabled && gMCHOST_Hal.swIrqPending )
+    {
+        gMCHOST_Hal.swIrqPending = false;
+        MCHOST_SwInterruptHandler();
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SwInterruptHandler                                   */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Default handler, replaced by the one of the scheduler as the  */
+/*              weak exception handlers of the device                         */
+/******************************************************************************/
+__attribute__((weak)) void MCHOST_SwInterruptHandler( void )
+{
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_CycleCounterStart                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Determines the frequency of MCHOST_CycleCounterGet against    */
+/*              the monotonic clock                                           */
+/******************************************************************************/
+void MCHOST_CycleCounterStart( void )
+{
+#if defined(__x86_64__) || defined(__i386__)
+    struct timespec start, now;
+    uint64_t startCount, count;
+    double elapsed;
+
+    clock_gettime( CLOCK_MONOTONIC, &start );
+    startCount = __rdtsc();
+    do
+    {
+        clock_gettime( CLOCK_MONOTONIC, &now );
+        elapsed = (double)( now.tv_sec - start.tv_sec ) + ( (double)( now.tv_nsec - start.tv_nsec ) * 1.0e-9 );
+    } while( elapsed < 0.02 );
+    count = __rdtsc() - startCount;
+    gMCHOST_Hal.cycleCounterHz = (uint32_t)( (double)count / elapsed );
+#else
+    gMCHOST_Hal.cycleCounterHz = 1000000000U;
+#endif
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,183 @@
+/*******************************************************************************
+ Host Peripheral Simulation interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_hal.h
+
+  Summary:
+    Simulated PWM, ADC and GPIO peripherals for host builds
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    simulated peripherals behind the host mc_hal.h. The PWM registers follow
+    the SAME70 convention used by MCPWM_PWMDutyUpdate, i.e. the duty register
+    holds the low side on time (period - high side on time).
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MCHOST_HAL_H    // Guards against multiple inclusion
+#define MCHOST_HAL_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stddef.h>
+#include <time.h>
+#include "definitions.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Simulated PWM peripheral clock. Center aligned PWM counts up and down. */
+#define     MCHOST_PWM_CLOCK_HZ                   (150000000U)
+
+/* ADC offset of the current sense amplifiers in counts */
+#define     MCHOST_ADC_CURRENT_OFFSET             (2048.0f)
+
+typedef void (*MCHOST_CALLBACK)( uint32_t status, uintptr_t context );
+
+typedef enum
+{
+    MCHOST_PWM_PH_U,
+    MCHOST_PWM_PH_V,
+    MCHOST_PWM_PH_W,
+    MCHOST_PWM_CHANNELS
+}tMCHOST_PWM_CHANNEL_E;
+
+typedef enum
+{
+    MCHOST_ADC_PH_U,
+    MCHOST_ADC_PH_V,
+    MCHOST_ADC_VDC,
+    MCHOST_ADC_POT,
+    MCHOST_ADC_CHANNELS
+}tMCHOST_ADC_CHANNEL_E;
+
+typedef struct
+{
+    uint32_t            period;                                 /* PWM period in counts                */
+    uint32_t            dutyRegister[MCHOST_PWM_CHANNELS];      /* PWM duty registers                  */
+    uint32_t            runningChannels;                        /* PWM channels started                */
+    bool                outputEnabled[MCHOST_PWM_CHANNELS];     /* PWM output override released        */
+    uint16_t            adcResult[MCHOST_ADC_CHANNELS];         /* ADC conversion results              */
+    MCHOST_CALLBACK     adcCallback;                            /* ADC end of conversion ISR           */
+    uintptr_t           adcContext;
+    MCHOST_CALLBACK     pwmCallback;                            /* PWM fault ISR                       */
+    uintptr_t           pwmContext;
+    bool                startStopPressed;                       /* Start/stop push button state        */
+    bool                directionPressed;                       /* Direction push button state         */
+    bool                faultLed;
+    bool                directionLed;
+    uint32_t            cycleCounterHz;                         /* Cycle counter frequency             */
+    bool                swIrqEnabled;                           /* Software interrupt enabled          */
+    bool                swIrqPending;                           /* Software interrupt requested        */
+}tMCHOST_HAL_S;
+
+extern tMCHOST_HAL_S gMCHOST_Hal;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCHOST_HalInitialize( uint32_t pwmFrequency );
+void MCHOST_PWMStart( uint32_t mask );
+void MCHOST_PWMStop( uint32_t mask );
+uint32_t MCHOST_PWMPrimaryPeriodGet( tMCHOST_PWM_CHANNEL_E channel );
+void MCHOST_PWMDutySet( tMCHOST_PWM_CHANNEL_E channel, uint32_t duty );
+void MCHOST_PWMOutputDisable( tMCHOST_PWM_CHANNEL_E channel );
+void MCHOST_PWMOutputEnable( tMCHOST_PWM_CHANNEL_E channel );
+void MCHOST_PWMCallbackRegister( MCHOST_CALLBACK callback, uintptr_t context );
+void MCHOST_ADCCallbackRegister( MCHOST_CALLBACK callback, uintptr_t context );
+
+bool MCHOST_PWMOutputIsEnabled( void );
+void MCHOST_PWMDutyGet( float * const dutyU, float * const dutyV, float * const dutyW );
+void MCHOST_ADCConversion( const float iu, const float iv, const float udc, const float pot );
+void MCHOST_ADCInterrupt( void );
+void MCHOST_PWMFaultInterrupt( void );
+void MCHOST_SwInterruptEnable( void );
+void MCHOST_SwInterruptPend( void );
+void MCHOST_SwInterrupt( void );
+void MCHOST_SwInterruptHandler( void );
+void MCHOST_CycleCounterStart( void );
+
+/******************************************************************************/
+/* Function name: MCHOST_CycleCounterGet                                      */
+/* Function parameters: None                                                  */
+/* Function return: Free running 32 bit cycle count                           */
+/* Description: Time stamp counter on x86, monotonic clock in ns otherwise    */
+/******************************************************************************/
+__STATIC_INLINE uint32_t MCHOST_CycleCounterGet( void )
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return (uint32_t)( ( (uint64_t)now.tv_sec * 1000000000U ) + (uint64_t)now.tv_nsec );
+#endif
+}
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MCHOST_HAL_H
+
+/**
+ End of File
+*/
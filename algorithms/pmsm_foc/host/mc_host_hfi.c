@@ -0,0 +1,325 @@
+/*******************************************************************************
+ High Frequency Injection Host Test source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_hfi.c
+
+  Summary:
+    Starts the salient plant under load with the high frequency injection
+
+  Description:
+    This file contains the host test of the high frequency injection. The
+    plant has Lq > Ld and the load torque is applied from standstill, where
+    the open loop startup stalls. The motor runs at a low speed within the
+    injection band and the RMS angle error of the injection estimate is
+    measured against the rotor angle at the current sampling. The speed
+    reference is then raised above the handoff speed, the time to the
+    handoff and the angle error of the back EMF estimate are measured, and
+    the speed reference is lowered again so that the injection has to take
+    over. The result fails if the motor leaves the closed loop, the angle
+    error of the injection exceeds the limit, the handoff is not made within
+    the measurement time or the injection does not restart.
+
+    Usage: mc_host_hfi [options]
+      --load <Nm>             load torque (default 0.02)
+      --speed <rpm>           low speed reference (default 100)
+      --time <s>              measurement time (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_rotorposition.h"
+#include "mc_speed.h"
+#include "mc_lib.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+
+/* Time from the start to the measurement: alignment and closed loop settling */
+#define     MCHOST_SETTLE_TIME_SEC                  (1.0f + LOCK_TIME_IN_SEC)
+
+/* Speed reference above the handoff and time for the speed changes */
+#define     MCHOST_HFI_HIGH_SPEED_RPM               ( 2.0f * HFI_HANDOFF_SPEED_RPM )
+#define     MCHOST_HFI_TRANSITION_TIME_SEC          (2.0f)
+
+/* RMS angle error limit of the injection estimate */
+#define     MCHOST_HFI_ANGLE_LIMIT_DEG              (10.0f)
+
+#if (ENABLED != HF_INJECTION)
+#error "mc_host_hfi tests the high frequency injection, enable HF_INJECTION"
+#endif
+
+typedef struct
+{
+    float                           load;
+    float                           speed;
+    float                           time;
+}tMCHOST_HFI_PARAM_S;
+
+typedef struct
+{
+    bool                            closedLoop;
+    bool                            injection;          /* Injection active during the whole measurement    */
+    float                           speed;              /* Mean plant speed (rpm)                           */
+    float                           angleError;         /* RMS angle estimation error (rad)                 */
+}tMCHOST_HFI_RESULT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCHOST_HfiMeasure( const float time, tMCHOST_HFI_RESULT_S * const pResult );
+static float MCHOST_HfiTransition( const float speed, const bool injection );
+static void MCHOST_HfiReport( const char * name, const tMCHOST_HFI_RESULT_S * const pResult );
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_HFI_PARAM_S          gMCHOST_HfiParam;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_HfiMeasure                                           */
+/* Function parameters: time - measurement time (s), pResult - run            */
+/* Function return: None                                                      */
+/* Description: Angle error and speed at the present speed reference         */
+/******************************************************************************/
+static void MCHOST_HfiMeasure( const float time, tMCHOST_HFI_RESULT_S * const pResult )
+{
+    uint64_t tick, ticks = (uint64_t)( time / FAST_LOOP_TIME_SEC );
+    double speedSum = 0.0, angleErrorSqr = 0.0, angleError;
+    float theta;
+
+    memset( pResult, 0, sizeof( *pResult ) );
+    pResult->injection = true;
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        /* Rotor angle at the current sampling */
+        theta = gMCHOST_PlantState.thetaElec;
+        MCHOST_Tick();
+
+        speedSum += (double)gMCHOST_PlantOutput.speedRpm;
+        angleError = (double)MCHOST_AngleDifference( gMCRPOS_OutputSignals.angle, theta );
+        angleErrorSqr += angleError * angleError;
+        pResult->injection = pResult->injection && gMCRPOS_HfiState.active;
+    }
+    pResult->closedLoop = ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState );
+    pResult->speed = (float)( speedSum / (double)ticks );
+    pResult->angleError = (float)sqrt( angleErrorSqr / (double)ticks );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_HfiTransition                                        */
+/* Function parameters: speed - speed reference (rpm), injection - state of  */
+/*                      the injection to wait for                             */
+/* Function return: time to the injection state (s), negative if not reached */
+/* Description: Changes the speed reference and waits for the injection to    */
+/*              stop or to restart                                            */
+/******************************************************************************/
+static float MCHOST_HfiTransition( const float speed, const bool injection )
+{
+    uint64_t tick, ticks = (uint64_t)( MCHOST_HFI_TRANSITION_TIME_SEC / FAST_LOOP_TIME_SEC );
+    float time = -1.0f;
+
+    gMCSPE_InputSignals.speedRef = speed * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+        if( ( time < 0.0f ) && ( injection == gMCRPOS_HfiState.active ) )
+        {
+            time = (float)( tick + 1U ) * FAST_LOOP_TIME_SEC;
+        }
+    }
+    return time;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_HfiReport                                            */
+/* Function parameters: name - run, pResult - run                             */
+/* Function return: None                                                      */
+/* Description: One line of the result table                                  */
+/******************************************************************************/
+static void MCHOST_HfiReport( const char * name, const tMCHOST_HFI_RESULT_S * const pResult )
+{
+    printf( "%-28s : %6.0f rpm %8.3f deg %-9s%s\n", name, pResult->speed, pResult->angleError * ( 180.0f / (float)M_PI ),
+            pResult->injection ? "injection" : "back EMF", pResult->closedLoop ? "" : " (not in closed loop)" );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv - command line                             */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "load",               required_argument, NULL, 'l' },
+        { "speed",              required_argument, NULL, 's' },
+        { "time",               required_argument, NULL, 't' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_HfiParam.load = 0.02f;
+    gMCHOST_HfiParam.speed = 100.0f;
+    gMCHOST_HfiParam.time = 1.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 'l': gMCHOST_HfiParam.load = strtof( optarg, NULL ); break;
+            case 's': gMCHOST_HfiParam.speed = strtof( optarg, NULL ); break;
+            case 't': gMCHOST_HfiParam.time = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--load Nm] [--speed rpm] [--time s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( ( gMCHOST_HfiParam.speed < 0.0f ) || ( gMCHOST_HfiParam.speed >= ( 0.5f * HFI_HANDOFF_SPEED_RPM ) ) )
+    {
+        fprintf( stderr, "--speed must be within 0 and half the handoff speed\n" );
+        return -1;
+    }
+    if( gMCHOST_HfiParam.time <= 0.0f )
+    {
+        fprintf( stderr, "--time must be positive\n" );
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_HFI_RESULT_S lowSpeedRun, highSpeedRun, returnRun;
+    float handoffTime, restartTime;
+    uint64_t tick;
+    int result = 0;
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    PMSM_FOC_Initialize();
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+    /* Start under load at the low speed */
+    MCHOST_PlantReset();
+    gMCHOST_PlantInput.loadTorque = gMCHOST_HfiParam.load;
+    gMCSPE_InputSignals.speedRef = gMCHOST_HfiParam.speed * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+    PMSM_FOC_MotorStart();
+    for( tick = 0U; tick < (uint64_t)( MCHOST_SETTLE_TIME_SEC / FAST_LOOP_TIME_SEC ); tick++ )
+    {
+        MCHOST_Tick();
+    }
+    MCHOST_HfiMeasure( gMCHOST_HfiParam.time, &lowSpeedRun );
+
+    /* Handoff to the back EMF estimate and back to the injection */
+    handoffTime = MCHOST_HfiTransition( MCHOST_HFI_HIGH_SPEED_RPM, false );
+    MCHOST_HfiMeasure( gMCHOST_HfiParam.time, &highSpeedRun );
+    restartTime = MCHOST_HfiTransition( gMCHOST_HfiParam.speed, true );
+    MCHOST_HfiMeasure( gMCHOST_HfiParam.time, &returnRun );
+
+    PMSM_FOC_MotorStop();
+    MCHOST_Tick();
+
+    printf( "High frequency injection\n" );
+    printf( "%-28s : %.2f V, %u PWM periods, %.0f rad/s\n", "Injection", HFI_VOLTAGE, (unsigned)HFI_SAMPLES, HFI_BANDWIDTH );
+    printf( "%-28s : Ld %.3f mH, Lq %.3f mH\n", "Plant", 1.0e3f * gMCHOST_PlantParam.ld, 1.0e3f * gMCHOST_PlantParam.lq );
+    printf( "%-28s : %.4f N m\n", "Load", gMCHOST_HfiParam.load );
+    printf( "%-28s : %10s %12s %s\n", "Run", "speed", "angle error", "estimate" );
+    MCHOST_HfiReport( "low speed", &lowSpeedRun );
+    MCHOST_HfiReport( "above handoff", &highSpeedRun );
+    MCHOST_HfiReport( "back to low speed", &returnRun );
+    printf( "%-28s : %.3f s\n", "Handoff time", handoffTime );
+    printf( "%-28s : %.3f s\n", "Injection restart time", restartTime );
+
+    /* Written to fail also on a diverged, not a number, result */
+    if( !lowSpeedRun.closedLoop || !highSpeedRun.closedLoop || !returnRun.closedLoop )
+    {
+        result = 1;
+    }
+    if( !lowSpeedRun.injection || highSpeedRun.injection || !returnRun.injection )
+    {
+        result = 1;
+    }
+    if( !( lowSpeedRun.angleError < ( MCHOST_HFI_ANGLE_LIMIT_DEG * (float)M_PI / 180.0f ) )
+     || !( returnRun.angleError < ( MCHOST_HFI_ANGLE_LIMIT_DEG * (float)M_PI / 180.0f ) ) )
+    {
+        result = 1;
+    }
+    if( ( handoffTime < 0.0f ) || ( restartTime < 0.0f ) )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
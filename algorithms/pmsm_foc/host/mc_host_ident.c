@@ -0,0 +1,450 @@
+/*******************************************************************************
+ Motor Parameter Identification Host Test source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_ident.c
+
+  Summary:
+    Runs the motor parameter identification against a plant model whose
+    parameters differ from the configured ones
+
+  Description:
+    This file contains the host test of MOTOR_IDENTIFICATION. The plant model
+    is loaded with the configured motor parameters scaled by the given
+    ratios. The motor is started in closed loop from standstill with the
+    configured parameters and with the plant parameters in gMCID_MotorParam,
+    then identified with PMSM_FOC_MotorIdentify and started again with the
+    identified parameters, first with the configured speed controller gains
+    and then with the tuned ones. Each run ends with a load torque step. The report
+    lists configured, plant and identified parameters, the controller gains
+    tuned for the plant and for the identified parameters, the current
+    controller gain after a run time update for a lower DC bus voltage, the
+    RMS angle estimation error of the three closed loop runs and the speed
+    deviation after the load step. The target is built with
+    PLL_SPEED_SCHEDULING, whose lag compensation removes the angle error of
+    the PLL estimator itself at speed, so the remaining error is the one of
+    the motor parameters. The result fails if the identification does not
+    finish, an identified parameter or tuned gain is outside the tolerance,
+    the angle error with the identified parameters exceeds the one with the
+    plant parameters or the one with the configured parameters by more than
+    MCHOST_ANGLE_MARGIN_DEG, the peak speed deviation with the tuned speed
+    gains exceeds the one with the configured speed gains by more than
+    MCHOST_SPEED_DIP_MARGIN_RPM, or the speed has not settled within
+    MCHOST_SPEED_SETTLED_RPM in the second half of the load step. Both speed
+    gains are compared with the tuned current controllers: the configured
+    current controllers are slower, so their current follows the back EMF
+    during the load step and adds damping of its own.
+
+    Usage: mc_host_ident [options]
+      --rs-ratio <r>          plant resistance / configured (default 1.2)
+      --ld-ratio <r>          plant d-axis inductance / configured (default 0.9)
+      --lq-ratio <r>          plant q-axis inductance / configured (default 1.15)
+      --ke-ratio <r>          plant back EMF constant / configured (default 1.1)
+      --j-ratio <r>           plant inertia / MCHOST_PLANT_INERTIA (default 1.5)
+      --time <s>              time of each closed loop run (default 12)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_rotorposition.h"
+#include "mc_speed.h"
+#include "mc_voltagemeasurement.h"
+#include "mc_identification.h"
+#include "mc_parameters.h"
+#include "mc_lib.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+#define     MCHOST_IDENT_TIMEOUT_SEC                (30.0f)
+
+/* Angle error measured over the end of each closed loop run */
+#define     MCHOST_MEASURE_TIME_SEC                 (2.0f)
+
+/* Load torque step at the end of each closed loop run, and the time of the speed deviation */
+#define     MCHOST_LOAD_TORQUE                      (float)(0.005f)
+#define     MCHOST_LOAD_TIME_SEC                    (1.0f)
+#define     MCHOST_SPEED_SETTLED_RPM                (2.0f)
+#define     MCHOST_SPEED_DIP_MARGIN_RPM             (2.0f)
+
+/* Tolerances of the identified parameters (relative) */
+#define     MCHOST_RS_TOLERANCE                     (0.05f)
+#define     MCHOST_L_TOLERANCE                      (0.10f)
+#define     MCHOST_KE_TOLERANCE                     (0.05f)
+#define     MCHOST_J_TOLERANCE                      (0.10f)
+#define     MCHOST_GAIN_TOLERANCE                   (0.10f)
+#define     MCHOST_ANGLE_MARGIN_DEG                 (0.5f)
+
+/* DC bus voltage of the run time gain update relative to the nominal one */
+#define     MCHOST_UDC_RATIO                        (0.75f)
+
+typedef struct
+{
+    float                           rsRatio;
+    float                           ldRatio;
+    float                           lqRatio;
+    float                           keRatio;
+    float                           jRatio;
+    float                           time;
+}tMCHOST_IDENT_PARAM_S;
+
+typedef struct
+{
+    bool                            closedLoop;
+    double                          angleErrorSqr;
+    uint64_t                        samples;
+    float                           speedDip;           /* Peak speed deviation after the load step (rpm)   */
+    float                           speedSettled;       /* Peak speed deviation over the last half (rpm)    */
+}tMCHOST_RUN_RESULT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCHOST_ClosedLoopRun( tMCHOST_RUN_RESULT_S * const pResult );
+static float MCHOST_AngleErrorReport( const char * name, const tMCHOST_RUN_RESULT_S * const pResult );
+static int MCHOST_ParameterReport( const char * name, const char * unit, const float configured,
+                                   const float plant, const float identified, const float tolerance );
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_IDENT_PARAM_S gMCHOST_IdentParam;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_ClosedLoopRun                                        */
+/* Function parameters: pResult - closed loop state and angle error           */
+/* Function return: None                                                      */
+/* Description: Starts the motor from standstill, runs it for the given time  */
+/*              and stops it again                                            */
+/******************************************************************************/
+static void MCHOST_ClosedLoopRun( tMCHOST_RUN_RESULT_S * const pResult )
+{
+    uint64_t tick, ticks = (uint64_t)( gMCHOST_IdentParam.time / FAST_LOOP_TIME_SEC );
+    uint64_t measureTick = (uint64_t)( ( gMCHOST_IdentParam.time - MCHOST_MEASURE_TIME_SEC ) / FAST_LOOP_TIME_SEC );
+    float angleError, speedError, theta;
+
+    memset( pResult, 0, sizeof( *pResult ) );
+    MCHOST_PlantReset();
+    PMSM_FOC_MotorStart();
+
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        /* Rotor angle at the current sampling */
+        theta = gMCHOST_PlantState.thetaElec;
+        MCHOST_Tick();
+        if( ( tick >= measureTick ) && ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState ) )
+        {
+            angleError = MCHOST_AngleDifference( gMCRPOS_OutputSignals.angle, theta );
+            pResult->angleErrorSqr += (double)angleError * (double)angleError;
+            pResult->samples++;
+        }
+    }
+    pResult->closedLoop = ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState ) && ( 0U != pResult->samples );
+
+    /* Speed controller response to a load torque step */
+    ticks = (uint64_t)( MCHOST_LOAD_TIME_SEC / FAST_LOOP_TIME_SEC );
+    gMCHOST_PlantInput.loadTorque = MCHOST_LOAD_TORQUE;
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+        speedError = fabsf( fabsf( gMCHOST_PlantOutput.speedRpm ) - SPEED_REF_RPM );
+        pResult->speedDip = fmaxf( pResult->speedDip, speedError );
+        if( tick >= ( ticks / 2U ) )
+        {
+            pResult->speedSettled = fmaxf( pResult->speedSettled, speedError );
+        }
+    }
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+
+    PMSM_FOC_MotorStop();
+    MCHOST_Tick();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_AngleErrorReport                                     */
+/* Function parameters: name - run, pResult - closed loop run                 */
+/* Function return: RMS angle error in degrees                                */
+/* Description: One line of the angle error table                             */
+/******************************************************************************/
+static float MCHOST_AngleErrorReport( const char * name, const tMCHOST_RUN_RESULT_S * const pResult )
+{
+    float angleError = (float)( sqrt( pResult->angleErrorSqr / (double)( pResult->samples + 1U ) ) * 180.0 / M_PI );
+
+    printf( "%-28s : %.3f deg%s\n", name, angleError, pResult->closedLoop ? "" : " (not in closed loop)" );
+    return angleError;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParameterReport                                      */
+/* Function parameters: name, unit - parameter, configured, plant and         */
+/*                      identified values, tolerance - relative tolerance     */
+/* Function return: 0 if the identified value is within the tolerance         */
+/* Description: One line of the parameter table                               */
+/******************************************************************************/
+static int MCHOST_ParameterReport( const char * name, const char * unit, const float configured,
+                                   const float plant, const float identified, const float tolerance )
+{
+    float error = ( identified - plant ) / plant;
+
+    printf( "%-28s : %12.6g %12.6g %12.6g %+8.2f %%  %s\n", name, configured, plant, identified, 100.0f * error, unit );
+    return ( fabsf( error ) <= tolerance ) ? 0 : 1;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv - command line                             */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "rs-ratio",           required_argument, NULL, 'r' },
+        { "ld-ratio",           required_argument, NULL, 'd' },
+        { "lq-ratio",           required_argument, NULL, 'q' },
+        { "ke-ratio",           required_argument, NULL, 'k' },
+        { "j-ratio",            required_argument, NULL, 'j' },
+        { "time",               required_argument, NULL, 't' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_IdentParam.rsRatio = 1.2f;
+    gMCHOST_IdentParam.ldRatio = 0.9f;
+    gMCHOST_IdentParam.lqRatio = 1.15f;
+    gMCHOST_IdentParam.keRatio = 1.1f;
+    gMCHOST_IdentParam.jRatio = 1.5f;
+    gMCHOST_IdentParam.time = 12.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 'r': gMCHOST_IdentParam.rsRatio = strtof( optarg, NULL ); break;
+            case 'd': gMCHOST_IdentParam.ldRatio = strtof( optarg, NULL ); break;
+            case 'q': gMCHOST_IdentParam.lqRatio = strtof( optarg, NULL ); break;
+            case 'k': gMCHOST_IdentParam.keRatio = strtof( optarg, NULL ); break;
+            case 'j': gMCHOST_IdentParam.jRatio = strtof( optarg, NULL ); break;
+            case 't': gMCHOST_IdentParam.time = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--rs-ratio r] [--ld-ratio r] [--lq-ratio r] [--ke-ratio r] [--j-ratio r] [--time s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( gMCHOST_IdentParam.time <= MCHOST_MEASURE_TIME_SEC )
+    {
+        fprintf( stderr, "--time must be longer than %.1f s\n", MCHOST_MEASURE_TIME_SEC );
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_RUN_RESULT_S configuredRun, motorRun, speedRun, identifiedRun;
+    uint64_t tick, timeoutTicks = (uint64_t)( MCHOST_IDENT_TIMEOUT_SEC / FAST_LOOP_TIME_SEC );
+    tMCID_MOTOR_PARAM_S motor;
+    tMCPAR_PI_GAINS_S idGains, iqGains, speedGains, tunedSpeedGains;
+    const tMCPAR_PI_GAINS_S configuredSpeedGains = { SPEEDCNTR_PTERM, SPEEDCNTR_ITERM, SPEEDCNTR_CTERM };
+    float kp, kpUpdated, angleConfigured, angleMotor, angleIdentified;
+    double identificationTime;
+    int result = 0;
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    gMCHOST_PlantParam.rs = gMCHOST_IdentParam.rsRatio * MOTOR_PER_PHASE_RESISTANCE;
+    gMCHOST_PlantParam.ld = gMCHOST_IdentParam.ldRatio * MOTOR_PER_PHASE_INDUCTANCE;
+    gMCHOST_PlantParam.lq = gMCHOST_IdentParam.lqRatio * MOTOR_Q_AXIS_INDUCTANCE;
+    gMCHOST_PlantParam.fluxLinkage = gMCHOST_IdentParam.keRatio * MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC;
+    gMCHOST_PlantParam.inertia = gMCHOST_IdentParam.jRatio * MCHOST_PLANT_INERTIA;
+    PMSM_FOC_Initialize();
+    gMCSPE_InputSignals.speedRef = SPEED_REF_RPM * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+    /* Closed loop with the configured parameters */
+    MCHOST_ClosedLoopRun( &configuredRun );
+
+    /* Closed loop with the plant parameters in the estimator */
+    gMCID_MotorParam.rs = gMCHOST_PlantParam.rs;
+    gMCID_MotorParam.ld = gMCHOST_PlantParam.ld;
+    gMCID_MotorParam.lq = gMCHOST_PlantParam.lq;
+    gMCID_MotorParam.ke = gMCHOST_PlantParam.fluxLinkage;
+    MCRPOS_InitializeRotorPositionSensing();
+    MCPAR_Initialize();
+    MCHOST_ClosedLoopRun( &motorRun );
+    MCID_Initialize();
+    MCRPOS_InitializeRotorPositionSensing();
+    MCPAR_Initialize();
+
+    /* Identification from standstill */
+    MCHOST_PlantReset();
+    PMSM_FOC_MotorIdentify();
+    for( tick = 0U; ( tick < timeoutTicks ) && ( MCAPP_IDENTIFICATION == gMCCTRL_CtrlParam.mcState ); tick++ )
+    {
+        MCHOST_Tick();
+    }
+    identificationTime = (double)tick * FAST_LOOP_TIME_SEC;
+
+    /* Closed loop with the identified parameters and the configured speed gains */
+    tunedSpeedGains.kp = gMCLIB_SpeedPIController.kp;
+    tunedSpeedGains.ki = gMCLIB_SpeedPIController.ki;
+    tunedSpeedGains.kc = gMCLIB_SpeedPIController.kc;
+    MCPAR_GainsWrite( &gMCLIB_SpeedPIController, &configuredSpeedGains );
+    MCHOST_ClosedLoopRun( &speedRun );
+
+    /* Closed loop with the identified parameters and the tuned speed gains */
+    MCPAR_GainsWrite( &gMCLIB_SpeedPIController, &tunedSpeedGains );
+    MCHOST_ClosedLoopRun( &identifiedRun );
+
+    printf( "Motor parameter identification\n" );
+    printf( "%-28s : %.2f s, %s\n", "Identification time", identificationTime,
+            ( MCID_STEP_DONE == gMCID_State.step ) ? "done" : "failed" );
+    printf( "%-28s : %12s %12s %12s %10s\n", "Parameter", "configured", "motor", "identified", "error" );
+    result |= MCHOST_ParameterReport( "Resistance", "Ohm", MOTOR_PER_PHASE_RESISTANCE, gMCHOST_PlantParam.rs,
+                                      gMCID_Result.rs, MCHOST_RS_TOLERANCE );
+    result |= MCHOST_ParameterReport( "d-axis inductance", "H", MOTOR_PER_PHASE_INDUCTANCE, gMCHOST_PlantParam.ld,
+                                      gMCID_Result.ld, MCHOST_L_TOLERANCE );
+    result |= MCHOST_ParameterReport( "q-axis inductance", "H", MOTOR_Q_AXIS_INDUCTANCE, gMCHOST_PlantParam.lq,
+                                      gMCID_Result.lq, MCHOST_L_TOLERANCE );
+    result |= MCHOST_ParameterReport( "Back EMF constant", "V/(rad/s)", MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC,
+                                      gMCHOST_PlantParam.fluxLinkage, gMCID_Result.ke, MCHOST_KE_TOLERANCE );
+
+    result |= MCHOST_ParameterReport( "Inertia", "kg m^2", 0.0f, gMCHOST_PlantParam.inertia,
+                                      gMCID_Result.inertia, MCHOST_J_TOLERANCE );
+
+    /* Gains tuned for the plant parameters */
+    motor.rs = gMCHOST_PlantParam.rs;
+    motor.ld = gMCHOST_PlantParam.ld;
+    motor.lq = gMCHOST_PlantParam.lq;
+    motor.ke = gMCHOST_PlantParam.fluxLinkage;
+    motor.inertia = gMCHOST_PlantParam.inertia;
+    MCID_GainsCalculate( &motor, gMCVOL_OutputSignals.umax, &idGains, &iqGains, &speedGains );
+    printf( "%-28s : %12s %12s %12s %10s\n", "Controller gains", "configured", "motor", "calculated", "error" );
+    result |= MCHOST_ParameterReport( "Id Kp", "", D_CURRCNTR_PTERM, idGains.kp, gMCLIB_IdPIController.kp,
+                                      MCHOST_GAIN_TOLERANCE );
+    result |= MCHOST_ParameterReport( "Id Ki", "", D_CURRCNTR_ITERM, idGains.ki, gMCLIB_IdPIController.ki,
+                                      MCHOST_GAIN_TOLERANCE );
+    result |= MCHOST_ParameterReport( "Iq Kp", "", Q_CURRCNTR_PTERM, iqGains.kp, gMCLIB_IqPIController.kp,
+                                      MCHOST_GAIN_TOLERANCE );
+    result |= MCHOST_ParameterReport( "Iq Ki", "", Q_CURRCNTR_ITERM, iqGains.ki, gMCLIB_IqPIController.ki,
+                                      MCHOST_GAIN_TOLERANCE );
+    result |= MCHOST_ParameterReport( "Speed Kp", "", SPEEDCNTR_PTERM, speedGains.kp, gMCLIB_SpeedPIController.kp,
+                                      MCHOST_GAIN_TOLERANCE );
+    result |= MCHOST_ParameterReport( "Speed Ki", "", SPEEDCNTR_ITERM, speedGains.ki,
+                                      gMCLIB_SpeedPIController.ki, MCHOST_GAIN_TOLERANCE );
+
+    /* Run time update for a lower DC bus voltage */
+    kp = gMCLIB_IqPIController.kp;
+    gMCHOST_PlantParam.udc *= MCHOST_UDC_RATIO;
+    MCHOST_Tick();
+    for( tick = 0U; ( tick < timeoutTicks ) && ( MCAPP_SUCCESS != MCID_GainsUpdate() ); tick++ )
+    {
+        MCHOST_Tick();
+    }
+    MCHOST_Tick();
+    kpUpdated = gMCLIB_IqPIController.kp;
+    gMCHOST_PlantParam.udc /= MCHOST_UDC_RATIO;
+    result |= MCHOST_ParameterReport( "Iq Kp at lower DC bus", "", kp, kp / MCHOST_UDC_RATIO, kpUpdated,
+                                      MCHOST_GAIN_TOLERANCE );
+
+    angleConfigured = MCHOST_AngleErrorReport( "RMS angle error configured", &configuredRun );
+    angleMotor = MCHOST_AngleErrorReport( "RMS angle error motor", &motorRun );
+    angleIdentified = MCHOST_AngleErrorReport( "RMS angle error identified", &identifiedRun );
+    printf( "%-28s : %12s %12s\n", "Load step speed deviation", "peak", "settled" );
+    printf( "%-28s : %8.1f rpm %8.1f rpm\n", "configured gains", motorRun.speedDip, motorRun.speedSettled );
+    printf( "%-28s : %8.1f rpm %8.1f rpm\n", "configured speed gains", speedRun.speedDip, speedRun.speedSettled );
+    printf( "%-28s : %8.1f rpm %8.1f rpm\n", "tuned gains", identifiedRun.speedDip, identifiedRun.speedSettled );
+
+    if( ( MCID_STEP_DONE != gMCID_State.step ) || !identifiedRun.closedLoop )
+    {
+        result = 1;
+    }
+    if( motorRun.closedLoop && ( angleIdentified > ( angleMotor + MCHOST_ANGLE_MARGIN_DEG ) ) )
+    {
+        result = 1;
+    }
+    if( configuredRun.closedLoop && ( angleIdentified > ( angleConfigured + MCHOST_ANGLE_MARGIN_DEG ) ) )
+    {
+        result = 1;
+    }
+    if( speedRun.closedLoop && ( identifiedRun.speedDip > ( speedRun.speedDip + MCHOST_SPEED_DIP_MARGIN_RPM ) ) )
+    {
+        result = 1;
+    }
+    if( identifiedRun.speedSettled > MCHOST_SPEED_SETTLED_RPM )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,326 @@
+/*******************************************************************************
+ Load Torque Step Host Test source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_load.c
+
+  Summary:
+    Runs a load torque step at the reference speed against the plant model
+
+  Description:
+    This file contains the host test of the speed control response to a load
+    torque step. The motor is started in closed loop from standstill, settles
+    at the speed reference and the plant load torque steps from zero to the given
+    value. The report lists the peak speed dip, the recovery time into
+    MCHOST_RECOVERY_BAND_RPM and, with LOAD_TORQUE_OBSERVER, the load current
+    estimate against the q-axis current of the load torque. The observer build
+    repeats the step with the observer gain of the load set to zero, which is
+    the speed PI control alone, as the reference. The result fails if the
+    motor leaves the closed loop, the speed does not recover within the load
+    time, the load current estimate is outside MCHOST_LOAD_TOLERANCE or the
+    observer does not reduce the speed dip of the reference.
+
+    Usage: mc_host_load [options]
+      --speed <rpm>           speed reference (default SPEED_REF_RPM)
+      --load <Nm>             load torque step (default 0.02)
+      --j-ratio <r>           plant inertia / MCHOST_PLANT_INERTIA (default 1.0)
+      --time <s>              time after the load step (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_rotorposition.h"
+#include "mc_speed.h"
+#include "mc_lib.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+
+/* Time from the start to the load step: alignment, open loop ramp and closed loop settling */
+#define     MCHOST_SETTLE_TIME_SEC                  (10.0f)
+
+/* Speed band of the recovery time, and the tolerance of the load current estimate (relative) */
+#define     MCHOST_RECOVERY_BAND_RPM                (10.0f)
+#define     MCHOST_LOAD_TOLERANCE                   (0.10f)
+
+typedef struct
+{
+    float                           speed;
+    float                           load;
+    float                           jRatio;
+    float                           time;
+}tMCHOST_LOAD_PARAM_S;
+
+typedef struct
+{
+    bool                            closedLoop;
+    bool                            recovered;
+    float                           speedDip;           /* Peak speed deviation after the load step (rpm)   */
+    float                           recoveryTime;       /* Last time outside the recovery band (s)          */
+    float                           iqLoad;             /* Change of the load current estimate (A)          */
+}tMCHOST_STEP_RESULT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static float MCHOST_LoadCurrentEstimate( void );
+static void MCHOST_LoadStepRun( tMCHOST_STEP_RESULT_S * const pResult );
+static void MCHOST_LoadStepReport( const char * name, const tMCHOST_STEP_RESULT_S * const pResult );
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_LOAD_PARAM_S gMCHOST_LoadParam;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_LoadCurrentEstimate                                  */
+/* Function parameters: None                                                  */
+/* Function return: q-axis current of the estimated load (A), 0 without the   */
+/*                  observer                                                  */
+/* Description: Load torque observer output                                   */
+/******************************************************************************/
+static float MCHOST_LoadCurrentEstimate( void )
+{
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    return gMCCTRL_LoadObserverState.iqLoad;
+#else
+    return 0.0f;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_LoadStepRun                                          */
+/* Function parameters: pResult - speed dip, recovery and load estimate       */
+/* Function return: None                                                      */
+/* Description: Starts the motor from standstill, applies the load torque     */
+/*              step after the settling time and stops the motor again        */
+/******************************************************************************/
+static void MCHOST_LoadStepRun( tMCHOST_STEP_RESULT_S * const pResult )
+{
+    uint64_t tick, ticks = (uint64_t)( MCHOST_SETTLE_TIME_SEC / FAST_LOOP_TIME_SEC );
+    uint64_t lastOutside = 0U;
+    float speedError, iqLoadBefore;
+
+    memset( pResult, 0, sizeof( *pResult ) );
+    MCHOST_PlantReset();
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+    PMSM_FOC_MotorStart();
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+    }
+    iqLoadBefore = MCHOST_LoadCurrentEstimate();
+
+    ticks = (uint64_t)( gMCHOST_LoadParam.time / FAST_LOOP_TIME_SEC );
+    gMCHOST_PlantInput.loadTorque = gMCHOST_LoadParam.load;
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+        speedError = fabsf( fabsf( gMCHOST_PlantOutput.speedRpm ) - gMCHOST_LoadParam.speed );
+        pResult->speedDip = fmaxf( pResult->speedDip, speedError );
+        if( speedError > MCHOST_RECOVERY_BAND_RPM )
+        {
+            lastOutside = tick + 1U;
+        }
+    }
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+
+    pResult->closedLoop = ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState );
+    pResult->recovered = ( lastOutside < ( ticks / 2U ) );
+    pResult->recoveryTime = (float)lastOutside * FAST_LOOP_TIME_SEC;
+    pResult->iqLoad = fabsf( MCHOST_LoadCurrentEstimate() - iqLoadBefore );
+
+    PMSM_FOC_MotorStop();
+    MCHOST_Tick();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_LoadStepReport                                       */
+/* Function parameters: name - run, pResult - load step run                   */
+/* Function return: None                                                      */
+/* Description: One line of the load step table                               */
+/******************************************************************************/
+static void MCHOST_LoadStepReport( const char * name, const tMCHOST_STEP_RESULT_S * const pResult )
+{
+    printf( "%-28s : %8.1f rpm %8.1f ms%s\n", name, pResult->speedDip, 1000.0f * pResult->recoveryTime,
+            !pResult->closedLoop ? " (not in closed loop)" : ( pResult->recovered ? "" : " (not recovered)" ) );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv - command line                             */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "speed",              required_argument, NULL, 's' },
+        { "load",               required_argument, NULL, 'l' },
+        { "j-ratio",            required_argument, NULL, 'j' },
+        { "time",               required_argument, NULL, 't' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_LoadParam.speed = SPEED_REF_RPM;
+    gMCHOST_LoadParam.load = 0.02f;
+    gMCHOST_LoadParam.jRatio = 1.0f;
+    gMCHOST_LoadParam.time = 1.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 's': gMCHOST_LoadParam.speed = strtof( optarg, NULL ); break;
+            case 'l': gMCHOST_LoadParam.load = strtof( optarg, NULL ); break;
+            case 'j': gMCHOST_LoadParam.jRatio = strtof( optarg, NULL ); break;
+            case 't': gMCHOST_LoadParam.time = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--speed rpm] [--load Nm] [--j-ratio r] [--time s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( ( gMCHOST_LoadParam.speed < (float)OPEN_LOOP_END_SPEED_RPM ) || ( gMCHOST_LoadParam.speed > MAX_SPEED_RPM ) )
+    {
+        fprintf( stderr, "--speed must be within %.0f and %.0f rpm\n", (float)OPEN_LOOP_END_SPEED_RPM, MAX_SPEED_RPM );
+        return -1;
+    }
+    if( gMCHOST_LoadParam.time <= 0.0f )
+    {
+        fprintf( stderr, "--time must be positive\n" );
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_STEP_RESULT_S stepRun;
+    uint64_t tick;
+    float iqLoad;
+    int result = 0;
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    tMCHOST_STEP_RESULT_S referenceRun;
+    float loadGain;
+#endif
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    gMCHOST_PlantParam.inertia = gMCHOST_LoadParam.jRatio * MCHOST_PLANT_INERTIA;
+    PMSM_FOC_Initialize();
+    gMCSPE_InputSignals.speedRef = gMCHOST_LoadParam.speed * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    /* Speed PI control alone: the load estimate stays at zero */
+    loadGain = gMCCTRL_LoadObserverParam.loadGain;
+    gMCCTRL_LoadObserverParam.loadGain = 0.0f;
+    MCHOST_LoadStepRun( &referenceRun );
+    gMCCTRL_LoadObserverParam.loadGain = loadGain;
+#endif
+    MCHOST_LoadStepRun( &stepRun );
+
+    /* q-axis current of the load torque step */
+    iqLoad = gMCHOST_LoadParam.load / ( 1.5f * gMCHOST_PlantParam.polePairs * gMCHOST_PlantParam.fluxLinkage );
+
+    printf( "Load torque step\n" );
+    printf( "%-28s : %.4f N m, %.2f A at %.0f rpm\n", "Load torque", gMCHOST_LoadParam.load, iqLoad, gMCHOST_LoadParam.speed );
+    printf( "%-28s : %.3g kg m^2\n", "Plant inertia", gMCHOST_PlantParam.inertia );
+    printf( "%-28s : %12s %11s\n", "Speed response", "dip", "recovery" );
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    MCHOST_LoadStepReport( "speed control", &referenceRun );
+    MCHOST_LoadStepReport( "load observer", &stepRun );
+    printf( "%-28s : %.3f A (%+.2f %%)\n", "Load current estimate", stepRun.iqLoad,
+            100.0f * ( stepRun.iqLoad - iqLoad ) / iqLoad );
+
+    if( !referenceRun.closedLoop || ( stepRun.speedDip >= referenceRun.speedDip ) )
+    {
+        result = 1;
+    }
+    if( fabsf( stepRun.iqLoad - iqLoad ) > ( MCHOST_LOAD_TOLERANCE * iqLoad ) )
+    {
+        result = 1;
+    }
+#else
+    MCHOST_LoadStepReport( "speed control", &stepRun );
+#endif
+
+    if( !stepRun.closedLoop || !stepRun.recovered )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,297 @@
+/*******************************************************************************
+ Maximum Torque Per Ampere Host Test source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_mtpa.c
+
+  Summary:
+    Runs the MTPA d-axis current control against a salient plant model
+
+  Description:
+    This file contains the host test of MTPA_CONTROL. The motor is started in
+    closed loop from standstill and settles at the speed reference, then the
+    plant load torque steps through MCHOST_LOAD_STEPS equal steps up to the
+    given value. At the end of each step the d- and q-axis currents and the
+    electromagnetic torque of the plant are averaged. The report lists for
+    each step the measured current, the current of the same torque with zero
+    d-axis current and the minimum current of the same torque, found by a
+    search over the current angle, and the copper loss saving against zero
+    d-axis current. The result fails if the motor leaves the closed loop or
+    the measured current exceeds the minimum by more than
+    MCHOST_CURRENT_TOLERANCE.
+
+    Usage: mc_host_mtpa [options]
+      --speed <rpm>           speed reference (default 1000)
+      --load <Nm>             load torque of the last step (default 0.24)
+      --time <s>              time of each load step (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_rotorposition.h"
+#include "mc_speed.h"
+#include "mc_lib.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+
+/* Time from the start to the first load step: alignment, open loop ramp and closed loop settling */
+#define     MCHOST_SETTLE_TIME_SEC                  (10.0f)
+
+/* Load steps, and the averaging time at the end of each step */
+#define     MCHOST_LOAD_STEPS                       (3U)
+#define     MCHOST_MEASURE_TIME_SEC                 (0.25f)
+
+/* Current angle search of the minimum current, and the tolerance of the measured current (relative) */
+#define     MCHOST_ANGLE_SEARCH_STEPS               (9000U)
+#define     MCHOST_CURRENT_TOLERANCE                (0.01f)
+
+typedef struct
+{
+    float                           speed;
+    float                           load;
+    float                           time;
+}tMCHOST_MTPA_PARAM_S;
+
+typedef struct
+{
+    double                          id;                 /* Sums of the averaged quantities                  */
+    double                          iq;
+    double                          torque;
+    uint64_t                        samples;
+}tMCHOST_MTPA_MEASUREMENT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static float MCHOST_MinimumCurrent( const float torque, float * const pId );
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_MTPA_PARAM_S gMCHOST_MtpaParam;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_MinimumCurrent                                       */
+/* Function parameters: torque - electromagnetic torque (N m),                */
+/*                      pId - d-axis current of the minimum                   */
+/* Function return: minimum current amplitude of the torque (A)               */
+/* Description: Searches the current angle from the q-axis towards negative   */
+/*              d-axis current: the current of the torque at each angle from  */
+/*              T = 1.5 p i^2 ( psi cos(b) / i - (Ld - Lq) sin(b) cos(b) )    */
+/******************************************************************************/
+static float MCHOST_MinimumCurrent( const float torque, float * const pId )
+{
+    const double kTorque = 1.5 * (double)gMCHOST_PlantParam.polePairs;
+    const double psi = (double)gMCHOST_PlantParam.fluxLinkage;
+    const double dL = (double)gMCHOST_PlantParam.ld - (double)gMCHOST_PlantParam.lq;
+    double minimum = (double)torque / ( kTorque * psi ), angle, a, b, current;
+    uint32_t step;
+
+    *pId = 0.0f;
+    for( step = 1U; step < MCHOST_ANGLE_SEARCH_STEPS; step++ )
+    {
+        /* Angle from the q-axis, torque / kTorque = a i + b i^2 */
+        angle = 0.5 * M_PI * (double)step / (double)MCHOST_ANGLE_SEARCH_STEPS;
+        a = psi * cos( angle );
+        b = -dL * sin( angle ) * cos( angle );
+        current = ( fabs( b ) > 1.0e-12 )
+                ? ( -a + sqrt( a * a + 4.0 * b * (double)torque / kTorque ) ) / ( 2.0 * b )
+                : (double)torque / ( kTorque * a );
+        if( current < minimum )
+        {
+            minimum = current;
+            *pId = (float)( -current * sin( angle ) );
+        }
+    }
+    return (float)minimum;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv - command line                             */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "speed",              required_argument, NULL, 's' },
+        { "load",               required_argument, NULL, 'l' },
+        { "time",               required_argument, NULL, 't' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_MtpaParam.speed = 1000.0f;
+    gMCHOST_MtpaParam.load = 0.24f;
+    gMCHOST_MtpaParam.time = 1.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 's': gMCHOST_MtpaParam.speed = strtof( optarg, NULL ); break;
+            case 'l': gMCHOST_MtpaParam.load = strtof( optarg, NULL ); break;
+            case 't': gMCHOST_MtpaParam.time = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--speed rpm] [--load Nm] [--time s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( ( gMCHOST_MtpaParam.speed < (float)OPEN_LOOP_END_SPEED_RPM ) || ( gMCHOST_MtpaParam.speed > MAX_SPEED_RPM ) )
+    {
+        fprintf( stderr, "--speed must be within %.0f and %.0f rpm\n", (float)OPEN_LOOP_END_SPEED_RPM, MAX_SPEED_RPM );
+        return -1;
+    }
+    if( gMCHOST_MtpaParam.time <= MCHOST_MEASURE_TIME_SEC )
+    {
+        fprintf( stderr, "--time must be longer than %.2f s\n", MCHOST_MEASURE_TIME_SEC );
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_MTPA_MEASUREMENT_S measurement;
+    uint64_t tick, ticks = (uint64_t)( MCHOST_SETTLE_TIME_SEC / FAST_LOOP_TIME_SEC );
+    uint64_t measureTick;
+    float id, iq, torque, current, currentId0, currentMin, idMin;
+    uint32_t step;
+    int result = 0;
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    PMSM_FOC_Initialize();
+    gMCSPE_InputSignals.speedRef = gMCHOST_MtpaParam.speed * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+    MCHOST_PlantReset();
+    PMSM_FOC_MotorStart();
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_Tick();
+    }
+
+    printf( "Maximum torque per ampere\n" );
+    printf( "%-28s : Ld %.3g H, Lq %.3g H, %.0f rpm\n", "Motor", gMCHOST_PlantParam.ld, gMCHOST_PlantParam.lq,
+            gMCHOST_MtpaParam.speed );
+    printf( "%-28s : %8s %8s %8s %8s %8s %8s %8s\n", "Load torque (N m)", "id", "iq", "|i|", "|i| id=0",
+            "|i| min", "id min", "loss" );
+
+    ticks = (uint64_t)( gMCHOST_MtpaParam.time / FAST_LOOP_TIME_SEC );
+    measureTick = (uint64_t)( ( gMCHOST_MtpaParam.time - MCHOST_MEASURE_TIME_SEC ) / FAST_LOOP_TIME_SEC );
+    for( step = 1U; step <= MCHOST_LOAD_STEPS; step++ )
+    {
+        memset( &measurement, 0, sizeof( measurement ) );
+        gMCHOST_PlantInput.loadTorque = gMCHOST_MtpaParam.load * (float)step / (float)MCHOST_LOAD_STEPS;
+        for( tick = 0U; tick < ticks; tick++ )
+        {
+            MCHOST_Tick();
+            if( tick >= measureTick )
+            {
+                measurement.id += (double)gMCHOST_PlantState.id;
+                measurement.iq += (double)gMCHOST_PlantState.iq;
+                measurement.torque += (double)gMCHOST_PlantOutput.torque;
+                measurement.samples++;
+            }
+        }
+
+        id = (float)( measurement.id / (double)measurement.samples );
+        iq = (float)( measurement.iq / (double)measurement.samples );
+        torque = (float)( measurement.torque / (double)measurement.samples );
+        current = sqrtf( ( id * id ) + ( iq * iq ) );
+        currentId0 = torque / ( 1.5f * gMCHOST_PlantParam.polePairs * gMCHOST_PlantParam.fluxLinkage );
+        currentMin = MCHOST_MinimumCurrent( torque, &idMin );
+
+        /* Copper loss change against zero d-axis current */
+        printf( "%-28.3f : %8.3f %8.3f %8.3f %8.3f %8.3f %8.3f %+7.2f%%\n", gMCHOST_PlantInput.loadTorque, id, iq,
+                current, currentId0, currentMin, idMin, 100.0f * ( ( current * current ) / ( currentId0 * currentId0 ) - 1.0f ) );
+
+        if( current > ( currentMin * ( 1.0f + MCHOST_CURRENT_TOLERANCE ) ) )
+        {
+            result = 1;
+        }
+    }
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+
+    if( MCAPP_CLOSED_LOOP != gMCCTRL_CtrlParam.mcState )
+    {
+        printf( "%-28s : %s\n", "Control state", "not in closed loop" );
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,259 @@
+/*******************************************************************************
+ Overmodulation Benchmark source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_overmodulation.c
+
+  Summary:
+    Fundamental, harmonic distortion and execution time of the voltage vector
+    limit
+
+  Description:
+    This file rotates a voltage reference vector with magnitudes from the
+    linear range to beyond six-step and passes it through MCPWM_VoltageLimit.
+    For every magnitude the fundamental and the total harmonic distortion of
+    the phase voltage are computed from the limited vector with a discrete
+    Fourier transform over one electrical period.
+    - The limited vector must stay inside the voltage hexagon.
+    - The fundamental must follow the reference up to the end of the selected
+      method: MCPWM mode I end for VOLTAGE_LIMIT_OVERMODULATION, six-step for
+      VOLTAGE_LIMIT_SIX_STEP.
+    - The average execution time of MCPWM_VoltageLimit per call is reported.
+
+    Usage: mc_host_overmodulation [--max-error <e>]
+      --max-error <e>   fail if the fundamental differs from the reference
+                        by more (default 0.005)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pwm.h"
+#include "mc_hal.h"
+#include "math.h"
+
+#if (VOLTAGE_LIMIT_METHOD == VOLTAGE_LIMIT_LINEAR)
+#error "mc_host_overmodulation needs VOLTAGE_LIMIT_OVERMODULATION or VOLTAGE_LIMIT_SIX_STEP"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_OVM_POINTS                       (3600U)
+#define     MCHOST_OVM_HARMONICS                    (49U)
+#define     MCHOST_OVM_STEPS                        (22U)
+#define     MCHOST_OVM_START                        (0.90)
+#define     MCHOST_OVM_END                          (1.11)
+#define     MCHOST_OVM_BENCH_ROUNDS                 (200U)
+
+/* End of overmodulation mode I and six-step operation */
+#define     MCHOST_OVM_MODE_I_END                   ( 6.0 / M_PI * log( sqrt( 3.0 ) ) )
+#define     MCHOST_OVM_SIX_STEP                     ( 2.0 * sqrt( 3.0 ) / M_PI )
+
+typedef struct
+{
+    double                          fundamental;
+    double                          thd;
+    double                          hexagon;
+}tMCHOST_OVM_RESULT_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static float gMCHOST_PhaseVoltage[MCHOST_OVM_POINTS];
+volatile float gMCHOST_BenchSink;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_OvmRotate                                            */
+/* Function parameters: magnitude - reference magnitude                       */
+/*                      pResult - fundamental, THD and hexagon peak           */
+/* Function return: None                                                      */
+/* Description: Limits a rotating reference and analyses the phase voltage    */
+/******************************************************************************/
+static void MCHOST_OvmRotate( const double magnitude, tMCHOST_OVM_RESULT_S * const pResult )
+{
+    uint32_t i, h;
+    double angle, a, b, sum = 0.0, projection;
+    float vAlpha, vBeta;
+
+    pResult->fundamental = 0.0;
+    pResult->hexagon = 0.0;
+    for( i = 0U; i < MCHOST_OVM_POINTS; i++ )
+    {
+        /* Half sample offset, no reference on a sector boundary */
+        angle = 2.0 * M_PI * ( (double)i + 0.5 ) / (double)MCHOST_OVM_POINTS;
+        vAlpha = (float)( magnitude * cos( angle ) );
+        vBeta = (float)( magnitude * sin( angle ) );
+        MCPWM_VoltageLimit( &vAlpha, &vBeta );
+        gMCHOST_PhaseVoltage[i] = vAlpha;
+
+        /* Distance to the three pairs of hexagon sides, 1 on the hexagon */
+        projection = fmax( fabs( (double)vBeta ), fmax( fabs( 0.5 * sqrt( 3.0 ) * vAlpha - 0.5 * vBeta ),
+                                                        fabs( 0.5 * sqrt( 3.0 ) * vAlpha + 0.5 * vBeta ) ) );
+        pResult->hexagon = fmax( pResult->hexagon, projection );
+    }
+
+    /* Phase U voltage is the alpha axis */
+    for( h = 1U; h <= MCHOST_OVM_HARMONICS; h++ )
+    {
+        a = 0.0;
+        b = 0.0;
+        for( i = 0U; i < MCHOST_OVM_POINTS; i++ )
+        {
+            angle = 2.0 * M_PI * (double)h * ( (double)i + 0.5 ) / (double)MCHOST_OVM_POINTS;
+            a += (double)gMCHOST_PhaseVoltage[i] * cos( angle );
+            b += (double)gMCHOST_PhaseVoltage[i] * sin( angle );
+        }
+        a *= 2.0 / (double)MCHOST_OVM_POINTS;
+        b *= 2.0 / (double)MCHOST_OVM_POINTS;
+        if( 1U == h )
+        {
+            pResult->fundamental = sqrt( a * a + b * b );
+        }
+        else
+        {
+            sum += a * a + b * b;
+        }
+    }
+    pResult->thd = sqrt( sum ) / pResult->fundamental;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_OvmBenchmark                                         */
+/* Function parameters: magnitude - reference magnitude                       */
+/* Function return: cycle counter ticks per call                              */
+/* Description: Average execution time of MCPWM_VoltageLimit                  */
+/******************************************************************************/
+static double MCHOST_OvmBenchmark( const double magnitude )
+{
+    uint32_t round, i, start, cycles, best = UINT32_MAX;
+    float vAlpha, vBeta, sum;
+    double angle;
+    static float alpha[MCHOST_OVM_POINTS], beta[MCHOST_OVM_POINTS];
+
+    for( i = 0U; i < MCHOST_OVM_POINTS; i++ )
+    {
+        angle = 2.0 * M_PI * ( (double)i + 0.5 ) / (double)MCHOST_OVM_POINTS;
+        alpha[i] = (float)( magnitude * cos( angle ) );
+        beta[i] = (float)( magnitude * sin( angle ) );
+    }
+
+    for( round = 0U; round < MCHOST_OVM_BENCH_ROUNDS; round++ )
+    {
+        sum = 0.0f;
+        start = MCHAL_CycleCounterGet();
+        for( i = 0U; i < MCHOST_OVM_POINTS; i++ )
+        {
+            vAlpha = alpha[i];
+            vBeta = beta[i];
+            MCPWM_VoltageLimit( &vAlpha, &vBeta );
+            sum += vAlpha + vBeta;
+        }
+        cycles = MCHAL_CycleCounterGet() - start;
+        gMCHOST_BenchSink = sum;
+
+        /* Best round, free from preemption */
+        if( cycles < best )
+        {
+            best = cycles;
+        }
+    }
+    return (double)best / (double)MCHOST_OVM_POINTS;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_OVM_RESULT_S ovm;
+    double maxError = 0.005, magnitude, expected, limit, cycles;
+    uint32_t step;
+    int result = 0;
+
+    if( ( argc == 3 ) && ( 0 == strcmp( argv[1], "--max-error" ) ) )
+    {
+        maxError = strtod( argv[2], NULL );
+    }
+    else if( argc != 1 )
+    {
+        fprintf( stderr, "usage: %s [--max-error e]\n", argv[0] );
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+
+#if (VOLTAGE_LIMIT_METHOD == VOLTAGE_LIMIT_SIX_STEP)
+    limit = MCHOST_OVM_SIX_STEP;
+    printf( "Voltage limit                : overmodulation mode I and II up to six-step\n" );
+#else
+    limit = MCHOST_OVM_MODE_I_END;
+    printf( "Voltage limit                : overmodulation mode I\n" );
+#endif
+    printf( "End of the voltage range     : %.4f of the linear range\n\n", limit );
+
+    printf( "%10s %12s %12s %10s %10s %10s\n", "reference", "fundamental", "expected", "THD %", "hexagon", "ns" );
+    for( step = 0U; step <= MCHOST_OVM_STEPS; step++ )
+    {
+        magnitude = MCHOST_OVM_START + ( MCHOST_OVM_END - MCHOST_OVM_START ) * (double)step / (double)MCHOST_OVM_STEPS;
+        expected = fmin( magnitude, limit );
+        MCHOST_OvmRotate( magnitude, &ovm );
+        cycles = MCHOST_OvmBenchmark( magnitude );
+
+        printf( "%10.4f %12.4f %12.4f %10.2f %10.4f %10.2f\n", magnitude, ovm.fundamental, expected,
+                100.0 * ovm.thd, ovm.hexagon, cycles * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ );
+
+        if( ( fabs( ovm.fundamental - expected ) > maxError ) || ( ovm.hexagon > 1.0 + 1.0e-5 ) )
+        {
+            result = 1;
+        }
+    }
+
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
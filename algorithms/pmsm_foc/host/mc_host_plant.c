@@ -0,0 +1,323 @@
+/*******************************************************************************
+ PMSM and Inverter Plant Model source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_plant.c
+
+  Summary:
+    Discrete time PMSM and voltage source inverter model
+
+  Description:
+    This file implements the plant model used by the host builds. The model
+    is integrated with a semi-implicit Euler method in MCHOST_PLANT_SUB_STEPS
+    steps per PWM period, using the phase voltages averaged over the period.
+    The default parameters are the motor and board parameters configured in
+    mc_userparams.h, so that the controller and the plant agree unless a
+    test deliberately changes the plant. The inverter is ideal unless a test
+    sets a dead time or a switch voltage drop, which reduce every phase
+    voltage in the direction of the phase current.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "mc_generic_lib.h"
+#include "math.h"
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+__STATIC_INLINE void MCHOST_PlantOutputUpdate( void );
+__STATIC_INLINE void MCHOST_PlantInverterError( const float id, const float iq, const float sine, const float cosine,
+                                                float * const ualpha, float * const ubeta );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCHOST_PLANT_PARAM_S        gMCHOST_PlantParam;
+tMCHOST_PLANT_INPUT_S        gMCHOST_PlantInput;
+tMCHOST_PLANT_STATE_S        gMCHOST_PlantState;
+tMCHOST_PLANT_OUTPUT_S       gMCHOST_PlantOutput;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_PlantOutputUpdate                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Phase currents and speed from the rotor frame state           */
+/******************************************************************************/
+__STATIC_INLINE void MCHOST_PlantOutputUpdate( void )
+{
+    float sine = sinf( gMCHOST_PlantState.thetaElec );
+    float cosine = cosf( gMCHOST_PlantState.thetaElec );
+    float ialpha, ibeta;
+
+    ialpha = gMCHOST_PlantState.id * cosine - gMCHOST_PlantState.iq * sine;
+    ibeta  = gMCHOST_PlantState.id * sine + gMCHOST_PlantState.iq * cosine;
+
+    gMCHOST_PlantOutput.iu = ialpha;
+    gMCHOST_PlantOutput.iv = -0.5f * ialpha + SQRT3_BY2 * ibeta;
+    gMCHOST_PlantOutput.iw = -gMCHOST_PlantOutput.iu - gMCHOST_PlantOutput.iv;
+
+    gMCHOST_PlantOutput.omegaElec = gMCHOST_PlantParam.polePairs * gMCHOST_PlantState.omegaMech;
+    gMCHOST_PlantOutput.speedRpm = gMCHOST_PlantState.omegaMech * ( 30.0f / (float)M_PI );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PlantInverterError                                   */
+/* Function parameters: id, iq - rotor frame currents                         */
+/*                      sine, cosine - of the electrical angle                */
+/*                      ualpha, ubeta - applied voltage, the error is added   */
+/* Function return: None                                                      */
+/* Description: Phase voltage lost during the dead time, when the current     */
+/*              flows through the diode of the opposite switch, and across    */
+/*              the switches, averaged over the PWM period. Within the current */
+/*              ripple of a zero crossing the current changes sign within the */
+/*              period and the error is proportional to the mean current.     */
+/******************************************************************************/
+__STATIC_INLINE void MCHOST_PlantInverterError( const float id, const float iq, const float sine, const float cosine,
+                                                float * const ualpha, float * const ubeta )
+{
+    const float drop = ( gMCHOST_PlantParam.udc * gMCHOST_PlantParam.deadTime / gMCHOST_PlantParam.deltaT )
+                     + gMCHOST_PlantParam.switchDrop;
+    float ialpha, ibeta, iu, iv, iw, eu, ev, ew;
+
+    ialpha = id * cosine - iq * sine;
+    ibeta  = id * sine + iq * cosine;
+    iu = ialpha;
+    iv = -0.5f * ialpha + SQRT3_BY2 * ibeta;
+    iw = -iu - iv;
+
+    if( gMCHOST_PlantParam.rippleCurrent > 0.0f )
+    {
+        eu = -drop * fmaxf( -1.0f, fminf( 1.0f, iu / gMCHOST_PlantParam.rippleCurrent ) );
+        ev = -drop * fmaxf( -1.0f, fminf( 1.0f, iv / gMCHOST_PlantParam.rippleCurrent ) );
+        ew = -drop * fmaxf( -1.0f, fminf( 1.0f, iw / gMCHOST_PlantParam.rippleCurrent ) );
+    }
+    else
+    {
+        eu = ( iu > 0.0f ) ? -drop : ( ( iu < 0.0f ) ? drop : 0.0f );
+        ev = ( iv > 0.0f ) ? -drop : ( ( iv < 0.0f ) ? drop : 0.0f );
+        ew = ( iw > 0.0f ) ? -drop : ( ( iw < 0.0f ) ? drop : 0.0f );
+    }
+
+    /* Clarke transform, the zero sequence does not drive a current */
+    *ualpha += ( 2.0f / 3.0f ) * ( eu - 0.5f * ( ev + ew ) );
+    *ubeta  += ( ev - ew ) * ONE_BY_SQRT3;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCHOST_PlantInitialize                                      */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Loads the configured motor and board parameters               */
+/******************************************************************************/
+void MCHOST_PlantInitialize( void )
+{
+    gMCHOST_PlantParam.rs           = MOTOR_PER_PHASE_RESISTANCE;
+    gMCHOST_PlantParam.ld           = MOTOR_PER_PHASE_INDUCTANCE;
+    gMCHOST_PlantParam.lq           = MOTOR_Q_AXIS_INDUCTANCE;
+    gMCHOST_PlantParam.fluxLinkage  = MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC;
+    gMCHOST_PlantParam.polePairs    = NUM_POLE_PAIRS;
+    gMCHOST_PlantParam.inertia      = MCHOST_PLANT_INERTIA;
+    gMCHOST_PlantParam.friction     = MCHOST_PLANT_FRICTION;
+    gMCHOST_PlantParam.udc          = DC_BUS_VOLTAGE;
+    gMCHOST_PlantParam.deadTime     = 0.0f;
+    gMCHOST_PlantParam.switchDrop   = 0.0f;
+    gMCHOST_PlantParam.rippleCurrent = 0.0f;
+    gMCHOST_PlantParam.deltaT       = FAST_LOOP_TIME_SEC;
+    gMCHOST_PlantParam.subSteps     = MCHOST_PLANT_SUB_STEPS;
+
+    MCHOST_PlantReset();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PlantReset                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Motor at standstill, inverter off                             */
+/******************************************************************************/
+void MCHOST_PlantReset( void )
+{
+    gMCHOST_PlantState.id = 0.0f;
+    gMCHOST_PlantState.iq = 0.0f;
+    gMCHOST_PlantState.omegaMech = 0.0f;
+    gMCHOST_PlantState.thetaElec = 0.0f;
+
+    gMCHOST_PlantInput.dutyU = 0.5f;
+    gMCHOST_PlantInput.dutyV = 0.5f;
+    gMCHOST_PlantInput.dutyW = 0.5f;
+    gMCHOST_PlantInput.outputEnabled = false;
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+
+    gMCHOST_PlantOutput.ualpha = 0.0f;
+    gMCHOST_PlantOutput.ubeta = 0.0f;
+    gMCHOST_PlantOutput.ud = 0.0f;
+    gMCHOST_PlantOutput.uq = 0.0f;
+    gMCHOST_PlantOutput.torque = 0.0f;
+    MCHOST_PlantOutputUpdate();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PlantStep                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Advances the plant by one PWM period                          */
+/******************************************************************************/
+void MCHOST_PlantStep( void )
+{
+    const tMCHOST_PLANT_PARAM_S * const param = &gMCHOST_PlantParam;
+    tMCHOST_PLANT_STATE_S * const state = &gMCHOST_PlantState;
+    float dt = param->deltaT / (float)param->subSteps;
+    float dutyMean, uu, uv, uw, ualpha, ubeta;
+    float sine, cosine, ud, uq, omegaElec, did, diq, torque, domega, ualphaStep, ubetaStep;
+    uint32_t step;
+
+    /* Period averaged phase to neutral voltages of the inverter */
+    dutyMean = ( gMCHOST_PlantInput.dutyU + gMCHOST_PlantInput.dutyV + gMCHOST_PlantInput.dutyW ) * ( 1.0f / 3.0f );
+    uu = param->udc * ( gMCHOST_PlantInput.dutyU - dutyMean );
+    uv = param->udc * ( gMCHOST_PlantInput.dutyV - dutyMean );
+    uw = param->udc * ( gMCHOST_PlantInput.dutyW - dutyMean );
+    ualpha = uu;
+    ubeta  = ( uv - uw ) * ONE_BY_SQRT3;
+
+    ud = 0.0f;
+    uq = 0.0f;
+    ualphaStep = ualpha;
+    ubetaStep = ubeta;
+    torque = 0.0f;
+    for( step = 0U; step < param->subSteps; step++ )
+    {
+        omegaElec = param->polePairs * state->omegaMech;
+
+        if( gMCHOST_PlantInput.outputEnabled )
+        {
+            sine = sinf( state->thetaElec );
+            cosine = cosf( state->thetaElec );
+            ualphaStep = ualpha;
+            ubetaStep = ubeta;
+            if( ( param->deadTime > 0.0f ) || ( param->switchDrop > 0.0f ) )
+            {
+                MCHOST_PlantInverterError( state->id, state->iq, sine, cosine, &ualphaStep, &ubetaStep );
+            }
+            ud =  ualphaStep * cosine + ubetaStep * sine;
+            uq = -ualphaStep * sine + ubetaStep * cosine;
+
+            did = ( ud - param->rs * state->id + omegaElec * param->lq * state->iq ) / param->ld;
+            diq = ( uq - param->rs * state->iq - omegaElec * ( param->ld * state->id + param->fluxLinkage ) ) / param->lq;
+            state->id += did * dt;
+            state->iq += diq * dt;
+        }
+        else
+        {
+            /* Inverter off: phases are open as long as the back EMF stays below the bus */
+            state->id = 0.0f;
+            state->iq = 0.0f;
+        }
+
+        torque = 1.5f * param->polePairs * ( param->fluxLinkage * state->iq + ( param->ld - param->lq ) * state->id * state->iq );
+        domega = ( torque - gMCHOST_PlantInput.loadTorque - param->friction * state->omegaMech ) / param->inertia;
+        state->omegaMech += domega * dt;
+
+        state->thetaElec += param->polePairs * state->omegaMech * dt;
+        if( state->thetaElec >= SINGLE_ELEC_ROT_RADS_PER_SEC )
+        {
+            state->thetaElec -= SINGLE_ELEC_ROT_RADS_PER_SEC;
+        }
+        else if( state->thetaElec < 0.0f )
+        {
+            state->thetaElec += SINGLE_ELEC_ROT_RADS_PER_SEC;
+        }
+        else
+        {
+            /* Do nothing */
+        }
+    }
+
+    gMCHOST_PlantOutput.ualpha = gMCHOST_PlantInput.outputEnabled ? ualphaStep : 0.0f;
+    gMCHOST_PlantOutput.ubeta = gMCHOST_PlantInput.outputEnabled ? ubetaStep : 0.0f;
+    gMCHOST_PlantOutput.ud = ud;
+    gMCHOST_PlantOutput.uq = uq;
+    gMCHOST_PlantOutput.torque = torque;
+    MCHOST_PlantOutputUpdate();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Tick                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: One PWM period: ADC conversion, control interrupt, main loop  */
+/*              tasks and plant update                                        */
+/******************************************************************************/
+void MCHOST_Tick( void )
+{
+    MCHOST_ADCConversion( gMCHOST_PlantOutput.iu, gMCHOST_PlantOutput.iv, gMCHOST_PlantParam.udc, 0.0f );
+    MCHOST_ADCInterrupt();
+    PMSM_FOC_Tasks();
+
+    MCHOST_PWMDutyGet( &gMCHOST_PlantInput.dutyU, &gMCHOST_PlantInput.dutyV, &gMCHOST_PlantInput.dutyW );
+    gMCHOST_PlantInput.outputEnabled = MCHOST_PWMOutputIsEnabled();
+    MCHOST_PlantStep();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_AngleDifference                                      */
+/* Function parameters: angle, reference - electrical angles                  */
+/* Function return: difference wrapped to [-pi, pi)                           */
+/* Description: Angle error of an estimator against the plant. The replayed   */
+/*              estimators do not all keep their angle in [0, 2pi), which     */
+/*              MCLIB_AngleDifference expects                                 */
+/******************************************************************************/
+float MCHOST_AngleDifference( float angle, float reference )
+{
+    angle = fmodf( angle, SINGLE_ELEC_ROT_RADS_PER_SEC );
+    reference = fmodf( reference, SINGLE_ELEC_ROT_RADS_PER_SEC );
+    MCLIB_WrapAngle( &angle );
+    MCLIB_WrapAngle( &reference );
+    return MCLIB_AngleDifference( angle, reference );
+}
+
+/*******************************************************************************
+ End of File
+*/
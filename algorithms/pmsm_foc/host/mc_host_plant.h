@@ -0,0 +1,161 @@
+/*******************************************************************************
+ PMSM and Inverter Plant Model interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_plant.h
+
+  Summary:
+    Discrete time PMSM and voltage source inverter model
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    plant model used by the host builds. The motor is modelled in the rotor
+    reference frame with separate d- and q-axis inductances, a permanent
+    magnet flux linkage and a single inertia mechanical load. The inverter
+    is modelled with the PWM period averaged phase voltages.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MCHOST_PLANT_H    // Guards against multiple inclusion
+#define MCHOST_PLANT_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stddef.h>
+#include "definitions.h"
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Mechanical parameters of the reference motor and coupled load */
+#define     MCHOST_PLANT_INERTIA                   (float)(8.0e-6)      /* kg m^2      */
+#define     MCHOST_PLANT_FRICTION                  (float)(5.0e-6)      /* N m s/rad   */
+
+/* Model integration steps per PWM period */
+#define     MCHOST_PLANT_SUB_STEPS                 (8U)
+
+typedef struct
+{
+    float                           rs;                 /* Phase resistance (Ohm)                          */
+    float                           ld;                 /* d-axis inductance (H)                           */
+    float                           lq;                 /* q-axis inductance (H)                           */
+    float                           fluxLinkage;        /* Magnet flux linkage (V peak phase per rad/s)    */
+    float                           polePairs;          /* Number of pole pairs                            */
+    float                           inertia;            /* Rotor and load inertia (kg m^2)                 */
+    float                           friction;           /* Viscous friction (N m s/rad)                    */
+    float                           udc;                /* DC bus voltage (V)                              */
+    float                           deadTime;           /* Inverter dead time (s)                          */
+    float                           switchDrop;         /* Switch and diode on state voltage (V)           */
+    float                           rippleCurrent;      /* Half the peak to peak phase current ripple (A)  */
+    float                           deltaT;             /* PWM period (s)                                  */
+    uint32_t                        subSteps;           /* Integration steps per PWM period                */
+}tMCHOST_PLANT_PARAM_S;
+
+typedef struct
+{
+    float                           dutyU;              /* High side duty ratio of phase U                 */
+    float                           dutyV;              /* High side duty ratio of phase V                 */
+    float                           dutyW;              /* High side duty ratio of phase W                 */
+    bool                            outputEnabled;      /* Inverter switching                              */
+    float                           loadTorque;         /* Load torque opposing rotation (N m)             */
+}tMCHOST_PLANT_INPUT_S;
+
+typedef struct
+{
+    float                           id;                 /* d-axis current (A)                              */
+    float                           iq;                 /* q-axis current (A)                              */
+    float                           omegaMech;          /* Mechanical speed (rad/s)                        */
+    float                           thetaElec;          /* Electrical angle of the d-axis [0, 2pi)         */
+}tMCHOST_PLANT_STATE_S;
+
+typedef struct
+{
+    float                           iu;                 /* Phase currents (A)                              */
+    float                           iv;
+    float                           iw;
+    float                           ualpha;             /* Applied stator voltage (V)                      */
+    float                           ubeta;
+    float                           ud;
+    float                           uq;
+    float                           torque;             /* Electromagnetic torque (N m)                    */
+    float                           omegaElec;          /* Electrical speed (rad/s)                        */
+    float                           speedRpm;           /* Mechanical speed (rpm)                          */
+}tMCHOST_PLANT_OUTPUT_S;
+
+extern tMCHOST_PLANT_PARAM_S        gMCHOST_PlantParam;
+extern tMCHOST_PLANT_INPUT_S        gMCHOST_PlantInput;
+extern tMCHOST_PLANT_STATE_S        gMCHOST_PlantState;
+extern tMCHOST_PLANT_OUTPUT_S       gMCHOST_PlantOutput;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+void MCHOST_PlantInitialize( void );
+void MCHOST_PlantReset( void );
+void MCHOST_PlantStep( void );
+void MCHOST_Tick( void );
+float MCHOST_AngleDifference( float angle, float reference );
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MCHOST_PLANT_H
+
+/**
+ End of File
+*/
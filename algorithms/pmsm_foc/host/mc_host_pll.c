@@ -0,0 +1,463 @@
+/*******************************************************************************
+ PLL Estimator Replay source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_pll.c
+
+  Summary:
+    Comparison of the PLL estimator with its reference implementation
+
+  Description:
+    This file replays an estimator input trace through MCRPOS_PositionMeasurement
+    and through the reference PLL estimator below, which evaluates the stator
+    voltage equations term by term, takes the sine and cosine of the estimated
+    angle from the lookup table in every period and selects the speed sign in
+    a branch tree. Both estimators run on the same parameter set. The control
+    angle seen by MCRPOS_PositionMeasurement at the start of a period is the
+    estimated angle in closed loop and the recorded control angle otherwise,
+    as in MCCTRL_MotorControl. It reports the largest deviation of the angle
+    and speed trajectories, the angle estimation error of both against the
+    rotor angle and the execution time per period of both implementations.
+    The folded coefficients round differently, so the trajectories agree to
+    a few units in the last place while the estimator is locked. Before
+    closed loop the unlocked estimator integrates these differences.
+
+    Without --trace the trace is recorded from the plant model, driven by a
+    speed and current control on the plant angle through a speed ramp to the
+    rated speed and a reversal through standstill. mc_host_sim --record
+    writes a trace of the closed loop simulation.
+
+    Usage: mc_host_pll [options]
+      --trace <file>                replay a trace written by mc_host_sim --record
+      --max-angle-deviation <rad>   fail if the angle trajectories differ by more
+                                    in closed loop (default 1e-4)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_generic_lib.h"
+#include "mc_lib.h"
+#include "mc_voltagemeasurement.h"
+#include "mc_rotorposition.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "mc_host_trace.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_PLL_BENCH_ROUNDS                 (20U)
+
+/* Time in closed loop before the angle estimation error is measured (s), as in mc_host_sim */
+#define     MCHOST_PLL_SETTLE_TIME                  (1.0f)
+
+/* Reference estimator signals */
+typedef struct
+{
+    float                           rhoOffset;
+    float                           bemfFilt;
+    float                           velEstim;
+    float                           omegaMr;
+    float                           ialphaLast;
+    float                           ibetaLast;
+    float                           ualphaLast;
+    float                           ubetaLast;
+    float                           esdf;
+    float                           esqf;
+    float                           rho;
+}tMCHOST_PLL_REFERENCE_S;
+
+/* Replay results of one estimator */
+typedef struct
+{
+    float *                         angle;
+    float *                         speed;
+    double                          angleErrorSqr;
+    uint32_t                        angleErrorSamples;
+}tMCHOST_PLL_RESULT_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCLIB_POSITION_S *          gMCHOST_ControlPosition;
+static tMCHOST_PLL_REFERENCE_S      gMCHOST_Reference;
+volatile float                      gMCHOST_BenchSink;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_ReferencePLL                                         */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: PLL estimator on the inputs of MCRPOS_ReadInputSignals,       */
+/*              evaluated as written in the equations                         */
+/******************************************************************************/
+static void MCHOST_ReferencePLL( void )
+{
+    tMCHOST_PLL_REFERENCE_S * const state = &gMCHOST_Reference;
+    const tMCRPOS_PARAMETERS_S * const param = &gMCRPOS_Parameters;
+    const float ialpha = gMCLIB_CurrentAlphaBeta.alphaAxis;
+    const float ibeta = gMCLIB_CurrentAlphaBeta.betaAxis;
+    float tempqVelEstim, esa, esb, esd, esq;
+    tMCLIB_POSITION_S position;
+#if(FIELD_WEAKENING == ENABLED)
+    float bemfAmp;
+#endif
+
+    if( state->velEstim < 0 )
+    {
+        tempqVelEstim = state->velEstim * (-1);
+    }
+    else
+    {
+        tempqVelEstim = state->velEstim;
+    }
+
+    esa = state->ualphaLast - ( param->rs * ialpha ) - ( param->lsDt * ( ialpha - state->ialphaLast ) );
+    esb = state->ubetaLast - ( param->rs * ibeta ) - ( param->lsDt * ( ibeta - state->ibetaLast ) );
+
+#if(FIELD_WEAKENING == ENABLED)
+    bemfAmp = sqrtf( ( esa * esa ) + ( esb * esb ) );
+    state->bemfFilt = state->bemfFilt + ( ( bemfAmp - state->bemfFilt ) * param->kFilterEsdq );
+#endif
+
+    position.angle = state->rho + state->rhoOffset;
+    MCLIB_WrapAngle( &position.angle );
+    MCLIB_SinCosCalc( position.angle, &position.sineAngle, &position.cosAngle );
+
+    esd = ( esa * position.cosAngle ) + ( esb * position.sineAngle );
+    esq = ( esb * position.cosAngle ) - ( esa * position.sineAngle );
+
+    state->esdf = state->esdf + ( ( esd - state->esdf ) * param->kFilterEsdq );
+    state->esqf = state->esqf + ( ( esq - state->esqf ) * param->kFilterEsdq );
+
+    if( tempqVelEstim > param->decimateRotorSpeed )
+    {
+        if( state->esqf > 0 )
+        {
+            state->omegaMr = param->invKFi * ( state->esqf - state->esdf );
+        }
+        else
+        {
+            state->omegaMr = param->invKFi * ( state->esqf + state->esdf );
+        }
+    }
+    else
+    {
+        if( state->velEstim > 0 )
+        {
+            state->omegaMr = param->invKFi * ( state->esqf - state->esdf );
+        }
+        else
+        {
+            state->omegaMr = param->invKFi * ( state->esqf + state->esdf );
+        }
+    }
+
+    state->rho = state->rho + ( state->omegaMr * param->deltaT );
+    MCLIB_WrapAngle( &state->rho );
+
+    state->velEstim = state->velEstim + ( ( state->omegaMr - state->velEstim ) * param->velEstimFilterK );
+
+    state->ialphaLast = ialpha;
+    state->ibetaLast = ibeta;
+    state->ualphaLast = gMCVOL_OutputSignals.umax * gMCLIB_VoltageAlphaBeta.alphaAxis;
+    state->ubetaLast = gMCVOL_OutputSignals.umax * gMCLIB_VoltageAlphaBeta.betaAxis;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_EstimatorReset                                       */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Both estimators and the control angle at standstill          */
+/******************************************************************************/
+static void MCHOST_EstimatorReset( void )
+{
+    MCRPOS_InitializeRotorPositionSensing();
+    gMCRPOS_OutputSignals.angle = 0.0f;
+    gMCRPOS_OutputSignals.speed = 0.0f;
+    memset( &gMCHOST_Reference, 0, sizeof( gMCHOST_Reference ) );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PeriodInputs                                         */
+/* Function parameters: record, control position                              */
+/* Function return: None                                                      */
+/* Description: Signals as the control interrupt finds them at the estimator  */
+/******************************************************************************/
+__STATIC_INLINE void MCHOST_PeriodInputs( const tMCHOST_TRACE_RECORD_S * const record,
+                                            const tMCLIB_POSITION_S * const position )
+{
+    gMCLIB_Position = *position;
+    gMCRPOS_StateSignals.rhoOffset = record->rhoOffset;
+    gMCHOST_Reference.rhoOffset = record->rhoOffset;
+    gMCLIB_CurrentAlphaBeta.alphaAxis = record->ialpha;
+    gMCLIB_CurrentAlphaBeta.betaAxis = record->ibeta;
+    gMCLIB_VoltageAlphaBeta.alphaAxis = record->ualpha;
+    gMCLIB_VoltageAlphaBeta.betaAxis = record->ubeta;
+    gMCVOL_OutputSignals.umax = record->umax;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Replay                                               */
+/* Function parameters: results of MCRPOS_PositionMeasurement and of the      */
+/*                      reference estimator                                   */
+/* Function return: periods in which the sine and cosine of the control       */
+/*                  angle are reused                                          */
+/* Description: Runs both estimators over the trace and keeps the control     */
+/*              positions for the benchmark                                   */
+/******************************************************************************/
+static uint32_t MCHOST_Replay( tMCHOST_PLL_RESULT_S * const estimator, tMCHOST_PLL_RESULT_S * const reference )
+{
+    const uint32_t settle = (uint32_t)( MCHOST_PLL_SETTLE_TIME / FAST_LOOP_TIME_SEC );
+    const tMCHOST_TRACE_RECORD_S * record;
+    tMCLIB_POSITION_S * position;
+    float angle, error;
+    uint32_t i, closedLoopPeriods = 0U, reused = 0U;
+
+    MCHOST_EstimatorReset();
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        record = &gMCHOST_Trace.record[i];
+
+        /* Control angle of the previous period with its sine and cosine */
+        position = &gMCHOST_ControlPosition[i];
+        position->angle = ( 0U != record->closedLoop ) ? gMCRPOS_OutputSignals.angle : record->controlAngle;
+        MCLIB_SinCosCalc( position->angle, &position->sineAngle, &position->cosAngle );
+
+        MCHOST_PeriodInputs( record, position );
+        angle = gMCRPOS_StateSignals.rho + record->rhoOffset;
+        MCLIB_WrapAngle( &angle );
+        if( angle == position->angle )
+        {
+            reused++;
+        }
+
+        MCRPOS_PositionMeasurement();
+        MCHOST_ReferencePLL();
+
+        estimator->angle[i] = gMCRPOS_OutputSignals.angle;
+        estimator->speed[i] = gMCRPOS_OutputSignals.speed;
+        reference->angle[i] = gMCHOST_Reference.rho;
+        reference->speed[i] = gMCHOST_Reference.velEstim;
+
+        closedLoopPeriods = ( 0U != record->closedLoop ) ? ( closedLoopPeriods + 1U ) : 0U;
+        if( closedLoopPeriods > settle )
+        {
+            error = MCHOST_AngleDifference( estimator->angle[i], record->rotorAngle );
+            estimator->angleErrorSqr += (double)error * (double)error;
+            estimator->angleErrorSamples++;
+            error = MCHOST_AngleDifference( reference->angle[i], record->rotorAngle );
+            reference->angleErrorSqr += (double)error * (double)error;
+            reference->angleErrorSamples++;
+        }
+    }
+    return reused;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Benchmark                                            */
+/* Function parameters: reference - reference estimator or                    */
+/*                      MCRPOS_PositionMeasurement                            */
+/* Function return: cycle counter ticks per PWM period                        */
+/* Description: Best round over the trace with the control positions of      */
+/*              the replay                                                    */
+/******************************************************************************/
+static double MCHOST_Benchmark( const bool reference )
+{
+    uint32_t round, i, start, cycles, best = UINT32_MAX;
+
+    for( round = 0U; round < MCHOST_PLL_BENCH_ROUNDS; round++ )
+    {
+        MCHOST_EstimatorReset();
+        start = MCHAL_CycleCounterGet();
+        if( reference )
+        {
+            for( i = 0U; i < gMCHOST_Trace.length; i++ )
+            {
+                MCHOST_PeriodInputs( &gMCHOST_Trace.record[i], &gMCHOST_ControlPosition[i] );
+                MCHOST_ReferencePLL();
+            }
+        }
+        else
+        {
+            for( i = 0U; i < gMCHOST_Trace.length; i++ )
+            {
+                MCHOST_PeriodInputs( &gMCHOST_Trace.record[i], &gMCHOST_ControlPosition[i] );
+                MCRPOS_PositionMeasurement();
+            }
+        }
+        cycles = MCHAL_CycleCounterGet() - start;
+        gMCHOST_BenchSink = gMCRPOS_OutputSignals.angle + gMCHOST_Reference.rho;
+
+        /* Best round, free from preemption */
+        if( cycles < best )
+        {
+            best = cycles;
+        }
+    }
+    return (double)best / (double)gMCHOST_Trace.length;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "trace",                  required_argument, NULL, 't' },
+        { "max-angle-deviation",    required_argument, NULL, 'a' },
+        { NULL,                     0,                 NULL,  0  }
+    };
+    const char * traceFile = NULL;
+    float maxAngleDeviation = 1.0e-4f;
+    tMCHOST_PLL_RESULT_S estimator, reference;
+    double angleDeviation = 0.0, closedLoopDeviation = 0.0, speedDeviation = 0.0, deviation;
+    double referenceCycles, estimatorCycles;
+    uint32_t i, exact = 0U, reused;
+    int option, result = 0;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 't': traceFile = optarg; break;
+            case 'a': maxAngleDeviation = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--trace file] [--max-angle-deviation rad]\n", argv[0] );
+                return 2;
+            }
+        }
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+    MCHOST_PlantInitialize();
+
+    if( NULL != traceFile )
+    {
+        if( 0 != MCHOST_TraceRead( traceFile ) )
+        {
+            return 2;
+        }
+        if( fabsf( gMCHOST_Trace.deltaT - FAST_LOOP_TIME_SEC ) > ( 1.0e-6f * FAST_LOOP_TIME_SEC ) )
+        {
+            fprintf( stderr, "%s: recorded with a PWM period of %g s, the build uses %g s\n", traceFile,
+                     (double)gMCHOST_Trace.deltaT, (double)FAST_LOOP_TIME_SEC );
+            return 2;
+        }
+    }
+    else if( 0 != MCHOST_TraceRecord() )
+    {
+        return 2;
+    }
+
+    memset( &estimator, 0, sizeof( estimator ) );
+    memset( &reference, 0, sizeof( reference ) );
+    estimator.angle = calloc( gMCHOST_Trace.length + 1U, sizeof( float ) );
+    estimator.speed = calloc( gMCHOST_Trace.length + 1U, sizeof( float ) );
+    reference.angle = calloc( gMCHOST_Trace.length + 1U, sizeof( float ) );
+    reference.speed = calloc( gMCHOST_Trace.length + 1U, sizeof( float ) );
+    gMCHOST_ControlPosition = calloc( gMCHOST_Trace.length + 1U, sizeof( tMCLIB_POSITION_S ) );
+    if( ( NULL == estimator.angle ) || ( NULL == estimator.speed ) || ( NULL == reference.angle )
+     || ( NULL == reference.speed ) || ( NULL == gMCHOST_ControlPosition ) )
+    {
+        fprintf( stderr, "out of memory\n" );
+        return 2;
+    }
+
+    reused = MCHOST_Replay( &estimator, &reference );
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        deviation = fabs( (double)MCHOST_AngleDifference( estimator.angle[i], reference.angle[i] ) );
+        if( deviation > angleDeviation )
+        {
+            angleDeviation = deviation;
+        }
+        if( ( 0U != gMCHOST_Trace.record[i].closedLoop ) && ( deviation > closedLoopDeviation ) )
+        {
+            closedLoopDeviation = deviation;
+        }
+        deviation = fabs( (double)estimator.speed[i] - (double)reference.speed[i] );
+        if( deviation > speedDeviation )
+        {
+            speedDeviation = deviation;
+        }
+        if( estimator.angle[i] == reference.angle[i] )
+        {
+            exact++;
+        }
+    }
+
+    referenceCycles = MCHOST_Benchmark( true );
+    estimatorCycles = MCHOST_Benchmark( false );
+
+    printf( "Trace                        : %s, %u PWM periods (%.3f s)\n", ( NULL != traceFile ) ? traceFile : "plant model",
+            (unsigned)gMCHOST_Trace.length, (double)gMCHOST_Trace.length * FAST_LOOP_TIME_SEC );
+    printf( "Control sine/cosine reused   : %u periods (%.1f %%)\n", (unsigned)reused,
+            100.0 * (double)reused / (double)gMCHOST_Trace.length );
+    printf( "Bit exact angle              : %u\n", (unsigned)exact );
+    printf( "Max angle deviation          : %.3e rad, %.3e rad in closed loop (limit %.1e)\n", angleDeviation,
+            closedLoopDeviation, (double)maxAngleDeviation );
+    printf( "Max speed deviation          : %.3e rad/s\n", speedDeviation );
+    printf( "Angle estimation error       : %.3f deg RMS (reference %.3f deg RMS)\n",
+            sqrt( estimator.angleErrorSqr / (double)( estimator.angleErrorSamples + 1U ) ) * 180.0 / M_PI,
+            sqrt( reference.angleErrorSqr / (double)( reference.angleErrorSamples + 1U ) ) * 180.0 / M_PI );
+    printf( "%-28s %10s %10s\n", "Implementation", "counts", "ns" );
+    printf( "%-28s %10.1f %10.2f\n", "Reference estimator", referenceCycles, referenceCycles * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ );
+    printf( "%-28s %10.1f %10.2f\n", "MCRPOS_PositionMeasurement", estimatorCycles, estimatorCycles * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ );
+
+    if( closedLoopDeviation > (double)maxAngleDeviation )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,323 @@
+/*******************************************************************************
+ PLL Estimator Speed Sweep source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_pll_speed.c
+
+  Summary:
+    Angle and speed estimation error of the PLL estimator over speed
+
+  Description:
+    This file compares the PLL estimator with fixed filters against the speed
+    scheduled filters with angle lag compensation (PLL_SPEED_SCHEDULING). For
+    each speed point a trace is recorded from the plant model, driven by a
+    speed and current control on the plant angle: a ramp to the speed, a
+    hold, a speed dip of 10 % and back at the ramp acceleration and a second
+    hold. The phase currents are quantized to the ADC resolution. Both
+    variants of MCRPOS_PositionMeasurement run on the same trace in closed
+    loop; the fixed variant is the scheduled one with zero speed coefficients
+    and lag time, which leaves KFILTER_ESDQ and KFILTER_VELESTIM in effect.
+
+    The table lists per speed and variant the mean and RMS angle error in the
+    first hold, the largest angle error through the speed dip and the RMS
+    error of the estimated speed against the plant speed over both. The
+    result fails when the scheduled filters have a larger RMS angle error in
+    the hold or a larger angle error through the dip than the fixed ones.
+
+    Usage: mc_host_pll_speed [options]
+      --esdq-ratio <r>              esd/esq filter bandwidth per electrical
+                                    speed (default PLL_ESDQ_BANDWIDTH_RATIO)
+      --velestim-ratio <r>          speed filter bandwidth per electrical
+                                    speed (default PLL_VELESTIM_BANDWIDTH_RATIO)
+      --lag-periods <n>             compensated estimation delay in PWM
+                                    periods (default PLL_ANGLE_LAG_PERIODS)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_generic_lib.h"
+#include "mc_lib.h"
+#include "mc_voltagemeasurement.h"
+#include "mc_rotorposition.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "mc_host_trace.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#if( ENABLED != PLL_SPEED_SCHEDULING )
+#error "mc_host_pll_speed needs PLL_SPEED_SCHEDULING"
+#endif
+
+/* Speed profile: ramp and dip acceleration (mechanical rad/s^2), hold and dip times (s) */
+#define     MCHOST_PLL_SPEED_ACCELERATION           (RATED_SPEED_RPM * ( (float)M_PI / 30.0f ) / 0.25f)
+#define     MCHOST_PLL_SPEED_HOLD_TIME              (0.5f)
+#define     MCHOST_PLL_SPEED_DIP                    (0.1f)
+#define     MCHOST_PLL_SPEED_SETTLE_TIME            (0.1f)
+
+/* Speed points relative to the rated speed */
+#define     MCHOST_PLL_SPEED_POINTS                 (6U)
+
+#define     MCHOST_RAD_PER_SEC_ELEC_TO_RPM          (float)( 60.0f / ( 2.0f * (float)M_PI * NUM_POLE_PAIRS ) )
+
+/* Estimation errors of one variant at one speed */
+typedef struct
+{
+    double                          holdErrorSum;
+    double                          holdErrorSqr;
+    uint32_t                        holdSamples;
+    double                          dipErrorMax;
+    double                          speedErrorSqr;
+    uint32_t                        speedSamples;
+}tMCHOST_PLL_SPEED_RESULT_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static const float                  gMCHOST_SpeedPoints[MCHOST_PLL_SPEED_POINTS] = { 0.1f, 0.2f, 0.4f, 0.6f, 0.8f, 1.0f };
+static float                        gMCHOST_Speed;
+static float                        gMCHOST_RampTime;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_SpeedProfile                                         */
+/* Function parameters: t - time (s)                                          */
+/* Function return: mechanical speed reference (rad/s)                        */
+/* Description: Ramp to gMCHOST_Speed, hold, dip and hold                     */
+/******************************************************************************/
+static float MCHOST_SpeedProfile( const float t )
+{
+    const float dipTime = MCHOST_PLL_SPEED_DIP * gMCHOST_Speed / MCHOST_PLL_SPEED_ACCELERATION;
+    float speedRef;
+
+    if( t < gMCHOST_RampTime )
+    {
+        speedRef = MCHOST_PLL_SPEED_ACCELERATION * t;
+    }
+    else if( t < ( gMCHOST_RampTime + MCHOST_PLL_SPEED_HOLD_TIME ) )
+    {
+        speedRef = gMCHOST_Speed;
+    }
+    else if( t < ( gMCHOST_RampTime + MCHOST_PLL_SPEED_HOLD_TIME + dipTime ) )
+    {
+        speedRef = gMCHOST_Speed - ( MCHOST_PLL_SPEED_ACCELERATION * ( t - gMCHOST_RampTime - MCHOST_PLL_SPEED_HOLD_TIME ) );
+    }
+    else if( t < ( gMCHOST_RampTime + MCHOST_PLL_SPEED_HOLD_TIME + ( 2.0f * dipTime ) ) )
+    {
+        speedRef = gMCHOST_Speed * ( 1.0f - MCHOST_PLL_SPEED_DIP )
+                 + ( MCHOST_PLL_SPEED_ACCELERATION * ( t - gMCHOST_RampTime - MCHOST_PLL_SPEED_HOLD_TIME - dipTime ) );
+    }
+    else
+    {
+        speedRef = gMCHOST_Speed;
+    }
+    return speedRef;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_QuantizeCurrents                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Phase currents of the trace in ADC_CURRENT_SCALE steps        */
+/******************************************************************************/
+static void MCHOST_QuantizeCurrents( void )
+{
+    tMCHOST_TRACE_RECORD_S * record;
+    float iu, iv;
+    uint32_t i;
+
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        record = &gMCHOST_Trace.record[i];
+        iu = roundf( record->ialpha / ADC_CURRENT_SCALE ) * ADC_CURRENT_SCALE;
+        iv = roundf( ( ( -0.5f * record->ialpha ) + ( SQRT3_BY2 * record->ibeta ) ) / ADC_CURRENT_SCALE ) * ADC_CURRENT_SCALE;
+        record->ialpha = iu;
+        record->ibeta = ( iu * ONE_BY_SQRT3 ) + ( iv * TWO_BY_SQRT3 );
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Run                                                  */
+/* Function parameters: parameters - estimator parameters, result - errors    */
+/* Function return: None                                                      */
+/* Description: MCRPOS_PositionMeasurement over the trace in closed loop      */
+/******************************************************************************/
+static void MCHOST_Run( const tMCRPOS_PARAMETERS_S * const parameters, tMCHOST_PLL_SPEED_RESULT_S * const result )
+{
+    const float dipTime = MCHOST_PLL_SPEED_DIP * gMCHOST_Speed / MCHOST_PLL_SPEED_ACCELERATION;
+    const uint32_t holdStart = (uint32_t)( ( gMCHOST_RampTime + MCHOST_PLL_SPEED_SETTLE_TIME ) / FAST_LOOP_TIME_SEC );
+    const uint32_t dipStart = (uint32_t)( ( gMCHOST_RampTime + MCHOST_PLL_SPEED_HOLD_TIME ) / FAST_LOOP_TIME_SEC );
+    const uint32_t dipEnd = (uint32_t)( ( gMCHOST_RampTime + MCHOST_PLL_SPEED_HOLD_TIME + ( 2.0f * dipTime ) + MCHOST_PLL_SPEED_SETTLE_TIME )
+                                      / FAST_LOOP_TIME_SEC );
+    const tMCHOST_TRACE_RECORD_S * record;
+    float previousAngle = 0.0f;
+    double error, speed;
+    uint32_t i;
+
+    memset( result, 0, sizeof( *result ) );
+    MCRPOS_InitializeRotorPositionSensing();
+    gMCRPOS_Parameters = *parameters;
+    gMCRPOS_StateSignals.rhoOffset = 0.0f;
+    gMCRPOS_OutputSignals.angle = 0.0f;
+    gMCRPOS_OutputSignals.speed = 0.0f;
+
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        record = &gMCHOST_Trace.record[i];
+        gMCLIB_Position.angle = gMCRPOS_OutputSignals.angle;
+        MCLIB_SinCosCalc( gMCLIB_Position.angle, &gMCLIB_Position.sineAngle, &gMCLIB_Position.cosAngle );
+        gMCLIB_CurrentAlphaBeta.alphaAxis = record->ialpha;
+        gMCLIB_CurrentAlphaBeta.betaAxis = record->ibeta;
+        gMCLIB_VoltageAlphaBeta.alphaAxis = record->ualpha;
+        gMCLIB_VoltageAlphaBeta.betaAxis = record->ubeta;
+        gMCVOL_OutputSignals.umax = record->umax;
+        MCRPOS_PositionMeasurement();
+
+        /* Plant speed of the period from the rotor angle */
+        speed = (double)MCHOST_AngleDifference( record->rotorAngle, previousAngle ) / (double)FAST_LOOP_TIME_SEC;
+        previousAngle = record->rotorAngle;
+
+        error = (double)MCHOST_AngleDifference( gMCRPOS_OutputSignals.angle, record->rotorAngle );
+        if( ( i >= holdStart ) && ( i < dipStart ) )
+        {
+            result->holdErrorSum += error;
+            result->holdErrorSqr += error * error;
+            result->holdSamples++;
+        }
+        if( ( i >= dipStart ) && ( i < dipEnd ) )
+        {
+            result->dipErrorMax = fmax( result->dipErrorMax, fabs( error ) );
+        }
+        if( ( i >= holdStart ) && ( i < dipEnd ) )
+        {
+            speed = (double)gMCRPOS_OutputSignals.speed - speed;
+            result->speedErrorSqr += speed * speed;
+            result->speedSamples++;
+        }
+    }
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "esdq-ratio",             required_argument, NULL, 'e' },
+        { "velestim-ratio",         required_argument, NULL, 'v' },
+        { "lag-periods",            required_argument, NULL, 'l' },
+        { NULL,                     0,                 NULL,  0  }
+    };
+    static const char * const variantName[2] = { "fixed", "scheduled" };
+    tMCRPOS_PARAMETERS_S variant[2];
+    tMCHOST_PLL_SPEED_RESULT_S result[2];
+    float esdqRatio = PLL_ESDQ_BANDWIDTH_RATIO, velEstimRatio = PLL_VELESTIM_BANDWIDTH_RATIO, lagPeriods = PLL_ANGLE_LAG_PERIODS;
+    float dipTime;
+    uint32_t point, k;
+    int option, status = 0;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 'e': esdqRatio = strtof( optarg, NULL ); break;
+            case 'v': velEstimRatio = strtof( optarg, NULL ); break;
+            case 'l': lagPeriods = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--esdq-ratio r] [--velestim-ratio r] [--lag-periods n]\n", argv[0] );
+                return 2;
+            }
+        }
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+    MCHOST_PlantInitialize();
+
+    /* Fixed filters: the scheduled coefficients never exceed the fixed ones */
+    MCRPOS_InitializeRotorPositionSensing();
+    variant[1] = gMCRPOS_Parameters;
+    variant[1].kFilterEsdqPerSpeed = esdqRatio * FAST_LOOP_TIME_SEC;
+    variant[1].velEstimFilterKPerSpeed = velEstimRatio * FAST_LOOP_TIME_SEC;
+    variant[1].angleLagTime = lagPeriods * FAST_LOOP_TIME_SEC;
+    variant[0] = variant[1];
+    variant[0].kFilterEsdqPerSpeed = 0.0f;
+    variant[0].velEstimFilterKPerSpeed = 0.0f;
+    variant[0].angleLagTime = 0.0f;
+
+    printf( "Filters                      : esd/esq %.2f, speed %.2f x electrical speed, lag %.2f PWM periods\n",
+            (double)esdqRatio, (double)velEstimRatio, (double)lagPeriods );
+    printf( "%-10s %-17s %10s %10s %10s %10s\n", "Speed rpm", "Filters", "mean deg", "RMS deg", "dip deg", "speed rpm" );
+    for( point = 0U; point < MCHOST_PLL_SPEED_POINTS; point++ )
+    {
+        gMCHOST_Speed = gMCHOST_SpeedPoints[point] * RATED_SPEED_RPM * ( (float)M_PI / 30.0f );
+        gMCHOST_RampTime = gMCHOST_Speed / MCHOST_PLL_SPEED_ACCELERATION;
+        dipTime = MCHOST_PLL_SPEED_DIP * gMCHOST_Speed / MCHOST_PLL_SPEED_ACCELERATION;
+        if( 0 != MCHOST_TraceRecordProfile( MCHOST_SpeedProfile, gMCHOST_RampTime + ( 2.0f * MCHOST_PLL_SPEED_HOLD_TIME ) + ( 2.0f * dipTime ) ) )
+        {
+            return 2;
+        }
+        MCHOST_QuantizeCurrents();
+
+        for( k = 0U; k < 2U; k++ )
+        {
+            MCHOST_Run( &variant[k], &result[k] );
+            printf( "%-10.0f %-17s %10.3f %10.3f %10.3f %10.2f\n", (double)( gMCHOST_SpeedPoints[point] * RATED_SPEED_RPM ), variantName[k],
+                    result[k].holdErrorSum / (double)result[k].holdSamples * 180.0 / M_PI,
+                    sqrt( result[k].holdErrorSqr / (double)result[k].holdSamples ) * 180.0 / M_PI,
+                    result[k].dipErrorMax * 180.0 / M_PI,
+                    sqrt( result[k].speedErrorSqr / (double)result[k].speedSamples ) * MCHOST_RAD_PER_SEC_ELEC_TO_RPM );
+        }
+        if( ( result[1].holdErrorSqr > result[0].holdErrorSqr ) || ( result[1].dipErrorMax > result[0].dipErrorMax ) )
+        {
+            status = 1;
+        }
+    }
+    printf( "Result                       : %s\n", ( 0 == status ) ? "PASS" : "FAIL" );
+    return status;
+}
@@ -0,0 +1,671 @@
+/*******************************************************************************
+ Fixed Point Backend Benchmark source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_q14.c
+
+  Summary:
+    Accuracy and execution time of the Q2.14 modules against the floating
+    point modules
+
+  Description:
+    This file runs the floating point modules of the component and their
+    Q2.14 counterparts of mc_foc_q14.c and mc_q14_lib.c on identical inputs:
+    Clarke and Park transform, sine and cosine, PI controller, inverse Park
+    transform with the sector based SVPWM and the PLL estimator. For every
+    module the maximum error of both implementations against a double
+    precision reference and the execution time per call are reported. The
+    PLL estimators follow a synthetic constant speed trajectory of the
+    reference motor, the error is the estimated angle error after settling.
+    The floating point PLL is the equation set of MCRPOS_PLLEstimator, which
+    is not accessible from outside pos_pll.c.
+
+    Host timing uses a processor with a floating point unit, the savings of
+    the integer modules on Cortex-M0+ have to be measured on the target.
+
+    Usage: mc_host_q14
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_generic_lib.h"
+#include "mc_lib.h"
+#include "mc_picontrol.h"
+#include "mc_pwm.h"
+#include "mc_rotorposition.h"
+#include "mc_foc_q14.h"
+#include "mc_hal.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_Q14_SAMPLES                      (4096U)
+#define     MCHOST_Q14_PLL_SAMPLES                  (20000U)
+#define     MCHOST_Q14_BENCH_ROUNDS                 (200U)
+#define     MCHOST_Q14_PLL_SPEED_RPM                (2000.0)
+#define     MCHOST_Q14_PLL_CURRENT                  (1.0)
+#define     MCHOST_Q14_PLL_ANGLE_OFFSET             (20.0 * M_PI / 180.0)
+#define     MCHOST_Q14_PI_PERIOD                    (400.0)
+#define     MCHOST_Q14_PLL_OMEGA                    ( MCHOST_Q14_PLL_SPEED_RPM * ( 2.0 * M_PI / 60.0 ) * NUM_POLE_PAIRS )
+
+typedef void (*MCHOST_Q14_KERNEL)( const uint32_t index );
+typedef double (*MCHOST_Q14_ERROR)( const bool fixedPoint );
+
+typedef struct
+{
+    const char *                    name;
+    const char *                    unit;
+    uint32_t                        samples;
+    MCHOST_Q14_KERNEL               floatKernel;
+    MCHOST_Q14_KERNEL               fixedKernel;
+    MCHOST_Q14_ERROR                error;
+    double                          maxError;
+}tMCHOST_Q14_MODULE_S;
+
+/* Floating point PLL, equations of MCRPOS_PLLEstimator */
+typedef struct
+{
+    float                           ialphaLast;
+    float                           ibetaLast;
+    float                           ualphaLast;
+    float                           ubetaLast;
+    float                           esdf;
+    float                           esqf;
+    float                           velEstim;
+    float                           rho;
+}tMCHOST_PLL_STATE_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCHOST_ParkFloat( const uint32_t index );
+static void MCHOST_ParkQ14( const uint32_t index );
+static double MCHOST_ParkError( const bool fixedPoint );
+static void MCHOST_SinCosFloat( const uint32_t index );
+static void MCHOST_SinCosQ14( const uint32_t index );
+static double MCHOST_SinCosError( const bool fixedPoint );
+static void MCHOST_PIFloat( const uint32_t index );
+static void MCHOST_PIQ14( const uint32_t index );
+static double MCHOST_PIError( const bool fixedPoint );
+static void MCHOST_ModulatorFloat( const uint32_t index );
+static void MCHOST_ModulatorQ14( const uint32_t index );
+static double MCHOST_ModulatorError( const bool fixedPoint );
+static void MCHOST_PLLFloat( const uint32_t index );
+static void MCHOST_PLLQ14( const uint32_t index );
+static double MCHOST_PLLError( const bool fixedPoint );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static const tMCHOST_Q14_MODULE_S gMCHOST_Q14Modules[] =
+{
+    { "Clarke + Park",          "A",        MCHOST_Q14_SAMPLES,     MCHOST_ParkFloat,       MCHOST_ParkQ14,         MCHOST_ParkError,       0.05 },
+    { "Sine + cosine",          "1",        MCHOST_Q14_SAMPLES,     MCHOST_SinCosFloat,     MCHOST_SinCosQ14,       MCHOST_SinCosError,     0.01 },
+    { "PI controller",          "umax",     MCHOST_Q14_SAMPLES,     MCHOST_PIFloat,         MCHOST_PIQ14,           MCHOST_PIError,         0.005 },
+    { "Inverse Park + SVPWM",   "counts",   MCHOST_Q14_SAMPLES,     MCHOST_ModulatorFloat,  MCHOST_ModulatorQ14,    MCHOST_ModulatorError,  24.0 },
+    { "PLL estimator",          "deg",      MCHOST_Q14_PLL_SAMPLES, MCHOST_PLLFloat,        MCHOST_PLLQ14,          MCHOST_PLLError,        1.0 },
+};
+
+/* Inputs */
+static float gMCHOST_CurrentU[MCHOST_Q14_SAMPLES];
+static float gMCHOST_CurrentV[MCHOST_Q14_SAMPLES];
+static float gMCHOST_Angle[MCHOST_Q14_SAMPLES];
+static float gMCHOST_Error[MCHOST_Q14_SAMPLES];
+static vec3_t gMCHOST_CurrentQ14[MCHOST_Q14_SAMPLES];
+static uint16_t gMCHOST_AngleQ14[MCHOST_Q14_SAMPLES];
+static int16_t gMCHOST_ErrorQ14[MCHOST_Q14_SAMPLES];
+static float gMCHOST_PLLCurrent[MCHOST_Q14_PLL_SAMPLES][2];
+static float gMCHOST_PLLVoltage[MCHOST_Q14_PLL_SAMPLES][2];
+static vec2_t gMCHOST_PLLCurrentQ14[MCHOST_Q14_PLL_SAMPLES];
+static vec2_t gMCHOST_PLLVoltageQ14[MCHOST_Q14_PLL_SAMPLES];
+static double gMCHOST_PLLAngle[MCHOST_Q14_PLL_SAMPLES];
+static float gMCHOST_Umax;
+static int16_t gMCHOST_UmaxQ14;
+
+/* Outputs */
+static float gMCHOST_OutFloat[MCHOST_Q14_PLL_SAMPLES][3];
+static int32_t gMCHOST_OutQ14[MCHOST_Q14_PLL_SAMPLES][3];
+
+/* States */
+static tMCLIB_PICONTROLLER_S gMCHOST_PIFloat;
+static pi_cntrl_t gMCHOST_PIQ14;
+static tMCPWM_SVPWM_S gMCHOST_SvmFloat;
+static tMCPWM_SVPWM_S gMCHOST_SvmQ14;
+static tMCHOST_PLL_STATE_S gMCHOST_PLLState;
+static tMCQ14_PLL_STATE_S gMCHOST_PLLStateQ14;
+static uint32_t gMCHOST_Seed = 12345U;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_Random                                               */
+/* Function parameters: None                                                  */
+/* Function return: pseudo random value in [-1, 1)                            */
+/* Description: Linear congruential generator                                 */
+/******************************************************************************/
+static double MCHOST_Random( void )
+{
+    gMCHOST_Seed = ( gMCHOST_Seed * 1664525U ) + 1013904223U;
+    return ( (double)( gMCHOST_Seed >> 8 ) * ( 2.0 / 16777216.0 ) ) - 1.0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_AngleError                                           */
+/* Function parameters: angle, reference in radians                           */
+/* Function return: absolute difference wrapped to [0, pi]                    */
+/* Description: Angle difference                                              */
+/******************************************************************************/
+static double MCHOST_AngleError( const double angle, const double reference )
+{
+    double error = fmod( angle - reference, 2.0 * M_PI );
+
+    if( error > M_PI )
+    {
+        error -= 2.0 * M_PI;
+    }
+    else if( error < -M_PI )
+    {
+        error += 2.0 * M_PI;
+    }
+    return fabs( error );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParkFloat, MCHOST_ParkQ14, MCHOST_ParkError          */
+/* Description: Clarke and Park transform of random phase currents            */
+/******************************************************************************/
+static void MCHOST_ParkFloat( const uint32_t index )
+{
+    tMCCUR_PHASE_CURRENTS_S phaseCurrents;
+    tMCLIB_CLARK_TRANSFORM_S alphaBeta;
+    tMCLIB_PARK_TRANSFORM_S directQuadrature;
+    tMCLIB_POSITION_S position;
+
+    phaseCurrents.iu = gMCHOST_CurrentU[index];
+    phaseCurrents.iv = gMCHOST_CurrentV[index];
+    phaseCurrents.iw = -phaseCurrents.iu - phaseCurrents.iv;
+    position.angle = gMCHOST_Angle[index];
+    MCLIB_SinCosCalc( position.angle, &position.sineAngle, &position.cosAngle );
+    MCLIB_ClarkeTransform( &phaseCurrents, &alphaBeta );
+    MCLIB_ParkTransform( &alphaBeta, &position, &directQuadrature );
+    gMCHOST_OutFloat[index][0] = directQuadrature.directAxis;
+    gMCHOST_OutFloat[index][1] = directQuadrature.quadratureAxis;
+}
+
+static void MCHOST_ParkQ14( const uint32_t index )
+{
+    ang_sincos_t position;
+    vec2_t alphaBeta, directQuadrature;
+
+    position.ang = gMCHOST_AngleQ14[index];
+    library_sincos( &position );
+    library_uvw_ab( &gMCHOST_CurrentQ14[index], &alphaBeta );
+    library_ab_dq( &position, &alphaBeta, &directQuadrature );
+    gMCHOST_OutQ14[index][0] = directQuadrature.x;
+    gMCHOST_OutQ14[index][1] = directQuadrature.y;
+}
+
+static double MCHOST_ParkError( const bool fixedPoint )
+{
+    uint32_t i;
+    double ialpha, ibeta, id, iq, error, maxError = 0.0;
+
+    for( i = 0U; i < MCHOST_Q14_SAMPLES; i++ )
+    {
+        ialpha = gMCHOST_CurrentU[i];
+        ibeta = ( (double)gMCHOST_CurrentU[i] + 2.0 * (double)gMCHOST_CurrentV[i] ) / sqrt( 3.0 );
+        id = ialpha * cos( gMCHOST_Angle[i] ) + ibeta * sin( gMCHOST_Angle[i] );
+        iq = ibeta * cos( gMCHOST_Angle[i] ) - ialpha * sin( gMCHOST_Angle[i] );
+        if( fixedPoint )
+        {
+            error = fmax( fabs( MCQ14_TO_FLOAT( gMCHOST_OutQ14[i][0], MCQ14_CURRENT_BASE ) - id ),
+                          fabs( MCQ14_TO_FLOAT( gMCHOST_OutQ14[i][1], MCQ14_CURRENT_BASE ) - iq ) );
+        }
+        else
+        {
+            error = fmax( fabs( gMCHOST_OutFloat[i][0] - id ), fabs( gMCHOST_OutFloat[i][1] - iq ) );
+        }
+        maxError = fmax( maxError, error );
+    }
+    return maxError;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SinCosFloat, MCHOST_SinCosQ14, MCHOST_SinCosError    */
+/* Description: Sine and cosine of random angles                              */
+/******************************************************************************/
+static void MCHOST_SinCosFloat( const uint32_t index )
+{
+    MCLIB_SinCosCalc( gMCHOST_Angle[index], &gMCHOST_OutFloat[index][0], &gMCHOST_OutFloat[index][1] );
+}
+
+static void MCHOST_SinCosQ14( const uint32_t index )
+{
+    ang_sincos_t position;
+
+    position.ang = gMCHOST_AngleQ14[index];
+    library_sincos( &position );
+    gMCHOST_OutQ14[index][0] = position.sin;
+    gMCHOST_OutQ14[index][1] = position.cos;
+}
+
+static double MCHOST_SinCosError( const bool fixedPoint )
+{
+    uint32_t i;
+    double sine, cosine, maxError = 0.0;
+
+    for( i = 0U; i < MCHOST_Q14_SAMPLES; i++ )
+    {
+        if( fixedPoint )
+        {
+            sine = (double)gMCHOST_OutQ14[i][0] / Q14_BASE_VALUE;
+            cosine = (double)gMCHOST_OutQ14[i][1] / Q14_BASE_VALUE;
+        }
+        else
+        {
+            sine = gMCHOST_OutFloat[i][0];
+            cosine = gMCHOST_OutFloat[i][1];
+        }
+        maxError = fmax( maxError, fabs( sine - sin( gMCHOST_Angle[i] ) ) );
+        maxError = fmax( maxError, fabs( cosine - cos( gMCHOST_Angle[i] ) ) );
+    }
+    return maxError;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PIFloat, MCHOST_PIQ14, MCHOST_PIError                */
+/* Description: Q axis current controller driven by an error sequence which   */
+/*              stays inside the output limits                                */
+/******************************************************************************/
+static void MCHOST_PIFloat( const uint32_t index )
+{
+    if( 0U == index )
+    {
+        MCLIB_ResetPIParameters( &gMCHOST_PIFloat );
+    }
+    gMCHOST_PIFloat.inRef = gMCHOST_Error[index];
+    gMCHOST_PIFloat.inMeas = 0.0f;
+    MCLIB_PIControl( &gMCHOST_PIFloat );
+    gMCHOST_OutFloat[index][0] = gMCHOST_PIFloat.out;
+}
+
+static void MCHOST_PIQ14( const uint32_t index )
+{
+    if( 0U == index )
+    {
+        gMCHOST_PIQ14.imem = 0;
+    }
+    gMCHOST_OutQ14[index][0] = library_pi_control( gMCHOST_ErrorQ14[index], &gMCHOST_PIQ14 );
+}
+
+static double MCHOST_PIError( const bool fixedPoint )
+{
+    uint32_t i;
+    double output, integral = 0.0, maxError = 0.0;
+
+    for( i = 0U; i < MCHOST_Q14_SAMPLES; i++ )
+    {
+        output = integral + Q_CURRCNTR_PTERM * (double)gMCHOST_Error[i];
+        integral += Q_CURRCNTR_ITERM * (double)gMCHOST_Error[i];
+        if( fixedPoint )
+        {
+            maxError = fmax( maxError, fabs( MCQ14_TO_FLOAT( gMCHOST_OutQ14[i][0], 1.0f ) - output ) );
+        }
+        else
+        {
+            maxError = fmax( maxError, fabs( gMCHOST_OutFloat[i][0] - output ) );
+        }
+    }
+    return maxError;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ModulatorFloat, MCHOST_ModulatorQ14,                 */
+/*                MCHOST_ModulatorError                                       */
+/* Description: Inverse Park transform and SVPWM of random d-q voltages in    */
+/*              the linear range. The d-q voltages reuse the current inputs.  */
+/******************************************************************************/
+static void MCHOST_ModulatorFloat( const uint32_t index )
+{
+    tMCLIB_PARK_TRANSFORM_S directQuadrature;
+    tMCLIB_CLARK_TRANSFORM_S alphaBeta;
+    tMCLIB_POSITION_S position;
+
+    directQuadrature.directAxis = gMCHOST_CurrentU[index] / MCQ14_CURRENT_BASE;
+    directQuadrature.quadratureAxis = gMCHOST_CurrentV[index] / MCQ14_CURRENT_BASE;
+    position.angle = gMCHOST_Angle[index];
+    MCLIB_SinCosCalc( position.angle, &position.sineAngle, &position.cosAngle );
+    MCLIB_InvParkTransform( &directQuadrature, &position, &alphaBeta );
+    MCPWM_SVPWMSectorTree( &alphaBeta, &gMCHOST_SvmFloat );
+    gMCHOST_OutFloat[index][0] = (float)gMCHOST_SvmFloat.dPwm1;
+    gMCHOST_OutFloat[index][1] = (float)gMCHOST_SvmFloat.dPwm2;
+    gMCHOST_OutFloat[index][2] = (float)gMCHOST_SvmFloat.dPwm3;
+}
+
+static void MCHOST_ModulatorQ14( const uint32_t index )
+{
+    ang_sincos_t position;
+    vec2_t directQuadrature, alphaBeta;
+
+    directQuadrature.x = gMCHOST_CurrentQ14[index].u;
+    directQuadrature.y = gMCHOST_CurrentQ14[index].v;
+    position.ang = gMCHOST_AngleQ14[index];
+    library_sincos( &position );
+    library_dq_ab( &position, &directQuadrature, &alphaBeta );
+    MCQ14_SpaceVectorModulation( &alphaBeta, gMCQ14_Parameters.period, &gMCHOST_SvmQ14 );
+    gMCHOST_OutQ14[index][0] = (int32_t)gMCHOST_SvmQ14.dPwm1;
+    gMCHOST_OutQ14[index][1] = (int32_t)gMCHOST_SvmQ14.dPwm2;
+    gMCHOST_OutQ14[index][2] = (int32_t)gMCHOST_SvmQ14.dPwm3;
+}
+
+static double MCHOST_ModulatorError( const bool fixedPoint )
+{
+    uint32_t i, phase;
+    double vd, vq, valpha, vbeta, v[3], common, duty, maxError = 0.0;
+
+    for( i = 0U; i < MCHOST_Q14_SAMPLES; i++ )
+    {
+        vd = gMCHOST_CurrentU[i] / MCQ14_CURRENT_BASE;
+        vq = gMCHOST_CurrentV[i] / MCQ14_CURRENT_BASE;
+        valpha = vd * cos( gMCHOST_Angle[i] ) - vq * sin( gMCHOST_Angle[i] );
+        vbeta = vd * sin( gMCHOST_Angle[i] ) + vq * cos( gMCHOST_Angle[i] );
+
+        /* Centered space vector modulation: phase voltage plus the mean of
+           the largest and the smallest phase voltage */
+        v[0] = valpha;
+        v[1] = -0.5 * valpha + 0.5 * sqrt( 3.0 ) * vbeta;
+        v[2] = -0.5 * valpha - 0.5 * sqrt( 3.0 ) * vbeta;
+        common = 0.5 * ( fmax( v[0], fmax( v[1], v[2] ) ) + fmin( v[0], fmin( v[1], v[2] ) ) );
+        for( phase = 0U; phase < 3U; phase++ )
+        {
+            duty = (double)gMCQ14_Parameters.period * ( 0.5 + ( v[phase] - common ) / sqrt( 3.0 ) );
+            maxError = fmax( maxError, fabs( ( fixedPoint ? (double)gMCHOST_OutQ14[i][phase]
+                                                          : (double)gMCHOST_OutFloat[i][phase] ) - duty ) );
+        }
+    }
+    return maxError;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PLLFloat, MCHOST_PLLQ14, MCHOST_PLLError             */
+/* Description: PLL estimators on a constant speed trajectory                 */
+/******************************************************************************/
+static void MCHOST_PLLFloat( const uint32_t index )
+{
+    tMCHOST_PLL_STATE_S * const pState = &gMCHOST_PLLState;
+    const float rs = MOTOR_PER_PHASE_RESISTANCE;
+    const float lsDt = (float)( MOTOR_PER_PHASE_INDUCTANCE / FAST_LOOP_TIME_SEC );
+    const float invKFi = (float)( 1.0 / MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC );
+    float ialpha = gMCHOST_PLLCurrent[index][0], ibeta = gMCHOST_PLLCurrent[index][1];
+    float esa, esb, esd, esq, esdf, sine, cosine;
+
+    if( 0U == index )
+    {
+        /* Estimator locked to the speed with an angle offset, as after the open loop start */
+        memset( pState, 0, sizeof( *pState ) );
+        pState->rho = (float)MCHOST_Q14_PLL_ANGLE_OFFSET;
+        pState->velEstim = (float)MCHOST_Q14_PLL_OMEGA;
+        pState->esqf = (float)( MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC * MCHOST_Q14_PLL_OMEGA );
+    }
+
+    esa = pState->ualphaLast - rs * ialpha - lsDt * ( ialpha - pState->ialphaLast );
+    esb = pState->ubetaLast - rs * ibeta - lsDt * ( ibeta - pState->ibetaLast );
+    MCLIB_SinCosCalc( pState->rho, &sine, &cosine );
+    esd = esa * cosine + esb * sine;
+    esq = esb * cosine - esa * sine;
+    pState->esdf += ( esd - pState->esdf ) * KFILTER_ESDQ;
+    pState->esqf += ( esq - pState->esqf ) * KFILTER_ESDQ;
+
+    if( fabsf( pState->velEstim ) > DECIMATE_RATED_SPEED )
+    {
+        esdf = ( pState->esqf > 0.0f ) ? pState->esdf : -pState->esdf;
+    }
+    else
+    {
+        esdf = ( pState->velEstim > 0.0f ) ? pState->esdf : -pState->esdf;
+    }
+    esdf = invKFi * ( pState->esqf - esdf );
+    pState->rho += esdf * FAST_LOOP_TIME_SEC;
+    MCLIB_WrapAngle( &pState->rho );
+    pState->velEstim += ( esdf - pState->velEstim ) * KFILTER_VELESTIM;
+
+    pState->ialphaLast = ialpha;
+    pState->ibetaLast = ibeta;
+    pState->ualphaLast = gMCHOST_Umax * gMCHOST_PLLVoltage[index][0];
+    pState->ubetaLast = gMCHOST_Umax * gMCHOST_PLLVoltage[index][1];
+    gMCHOST_OutFloat[index][0] = pState->rho;
+    gMCHOST_OutFloat[index][1] = pState->velEstim;
+}
+
+static void MCHOST_PLLQ14( const uint32_t index )
+{
+    if( 0U == index )
+    {
+        MCQ14_PLLReset( &gMCHOST_PLLStateQ14 );
+        gMCHOST_PLLStateQ14.rhoOffset = 0;
+        gMCHOST_PLLStateQ14.rho = (uint32_t)( MCHOST_Q14_PLL_ANGLE_OFFSET * ( 4294967296.0 / ( 2.0 * M_PI ) ) );
+        gMCHOST_PLLStateQ14.velEstim = MCQ14_FROM_FLOAT( MCHOST_Q14_PLL_OMEGA, MCQ14_SPEED_BASE );
+        gMCHOST_PLLStateQ14.velState = (int32_t)gMCHOST_PLLStateQ14.velEstim << 16;
+        gMCHOST_PLLStateQ14.esqf = MCQ14_FROM_FLOAT( MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC * MCHOST_Q14_PLL_OMEGA,
+                                                     MCQ14_VOLTAGE_BASE );
+        gMCHOST_PLLStateQ14.esqState = (int32_t)gMCHOST_PLLStateQ14.esqf << 16;
+    }
+    MCQ14_PLLEstimator( &gMCHOST_PLLCurrentQ14[index], &gMCHOST_PLLVoltageQ14[index], gMCHOST_UmaxQ14,
+                        &gMCQ14_PLLParam, &gMCHOST_PLLStateQ14 );
+    gMCHOST_OutQ14[index][0] = (int32_t)( gMCHOST_PLLStateQ14.rho >> 16 );
+    gMCHOST_OutQ14[index][1] = gMCHOST_PLLStateQ14.velEstim;
+}
+
+static double MCHOST_PLLError( const bool fixedPoint )
+{
+    uint32_t i;
+    double angle, maxError = 0.0;
+
+    /* Last quarter of the trajectory, after the estimators settled */
+    for( i = ( 3U * MCHOST_Q14_PLL_SAMPLES ) / 4U; i < MCHOST_Q14_PLL_SAMPLES; i++ )
+    {
+        if( fixedPoint )
+        {
+            angle = (double)gMCHOST_OutQ14[i][0] * ( 2.0 * M_PI / 65536.0 );
+        }
+        else
+        {
+            angle = gMCHOST_OutFloat[i][0];
+        }
+        /* The estimated angle is integrated to the next PWM period */
+        maxError = fmax( maxError, MCHOST_AngleError( angle, gMCHOST_PLLAngle[i] + MCHOST_Q14_PLL_OMEGA * FAST_LOOP_TIME_SEC )
+                                   * ( 180.0 / M_PI ) );
+    }
+    return maxError;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Q14Inputs                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Random module inputs and the PLL trajectory, rounded to       */
+/*              Q2.14 so that both implementations see the same values        */
+/******************************************************************************/
+static void MCHOST_Q14Inputs( void )
+{
+    const double omega = MCHOST_Q14_PLL_OMEGA;
+    const double lsDt = MOTOR_PER_PHASE_INDUCTANCE / FAST_LOOP_TIME_SEC;
+    double theta, current[2], currentNext[2], voltage;
+    uint32_t i, axis;
+
+    for( i = 0U; i < MCHOST_Q14_SAMPLES; i++ )
+    {
+        /* Currents within 0.6 of the base keep the d-q voltages in the linear range */
+        gMCHOST_CurrentQ14[i].u = MCQ14_FROM_FLOAT( 0.6 * MCHOST_Random(), 1.0f );
+        gMCHOST_CurrentQ14[i].v = MCQ14_FROM_FLOAT( 0.6 * MCHOST_Random(), 1.0f );
+        gMCHOST_CurrentQ14[i].w = -gMCHOST_CurrentQ14[i].u - gMCHOST_CurrentQ14[i].v;
+        gMCHOST_CurrentU[i] = MCQ14_TO_FLOAT( gMCHOST_CurrentQ14[i].u, MCQ14_CURRENT_BASE );
+        gMCHOST_CurrentV[i] = MCQ14_TO_FLOAT( gMCHOST_CurrentQ14[i].v, MCQ14_CURRENT_BASE );
+
+        gMCHOST_AngleQ14[i] = (uint16_t)( gMCHOST_Seed >> 16 );
+        gMCHOST_Angle[i] = (float)( (double)gMCHOST_AngleQ14[i] * ( 2.0 * M_PI / 65536.0 ) );
+        (void)MCHOST_Random();
+
+        /* Q axis current error, sine wave with noise */
+        gMCHOST_ErrorQ14[i] = MCQ14_FROM_FLOAT( 0.5 * sin( 2.0 * M_PI * (double)i / MCHOST_Q14_PI_PERIOD )
+                                                + 0.1 * MCHOST_Random(), 1.0f );
+        gMCHOST_Error[i] = MCQ14_TO_FLOAT( gMCHOST_ErrorQ14[i], MCQ14_CURRENT_BASE );
+    }
+
+    /* Constant speed, q axis current. The voltage applied in cycle k is seen
+       by the estimator in cycle k + 1 together with the resulting current */
+    gMCHOST_UmaxQ14 = MCQ14_FROM_FLOAT( DC_BUS_VOLTAGE / SQRT3, MCQ14_VOLTAGE_BASE );
+    gMCHOST_Umax = MCQ14_TO_FLOAT( gMCHOST_UmaxQ14, MCQ14_VOLTAGE_BASE );
+    for( i = 0U; i < MCHOST_Q14_PLL_SAMPLES; i++ )
+    {
+        theta = fmod( omega * FAST_LOOP_TIME_SEC * (double)i, 2.0 * M_PI );
+        gMCHOST_PLLAngle[i] = theta;
+        current[0] = -MCHOST_Q14_PLL_CURRENT * sin( theta );
+        current[1] = MCHOST_Q14_PLL_CURRENT * cos( theta );
+        currentNext[0] = -MCHOST_Q14_PLL_CURRENT * sin( theta + omega * FAST_LOOP_TIME_SEC );
+        currentNext[1] = MCHOST_Q14_PLL_CURRENT * cos( theta + omega * FAST_LOOP_TIME_SEC );
+        for( axis = 0U; axis < 2U; axis++ )
+        {
+            voltage = MOTOR_PER_PHASE_RESISTANCE * currentNext[axis] + lsDt * ( currentNext[axis] - current[axis] )
+                    + MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC * omega * currentNext[axis] / MCHOST_Q14_PLL_CURRENT;
+            gMCHOST_PLLVoltageQ14[i].x = ( 0U == axis ) ? MCQ14_FROM_FLOAT( voltage / gMCHOST_Umax, 1.0f ) : gMCHOST_PLLVoltageQ14[i].x;
+            gMCHOST_PLLVoltageQ14[i].y = ( 1U == axis ) ? MCQ14_FROM_FLOAT( voltage / gMCHOST_Umax, 1.0f ) : gMCHOST_PLLVoltageQ14[i].y;
+        }
+        gMCHOST_PLLCurrentQ14[i].x = MCQ14_FROM_FLOAT( current[0], MCQ14_CURRENT_BASE );
+        gMCHOST_PLLCurrentQ14[i].y = MCQ14_FROM_FLOAT( current[1], MCQ14_CURRENT_BASE );
+        gMCHOST_PLLCurrent[i][0] = MCQ14_TO_FLOAT( gMCHOST_PLLCurrentQ14[i].x, MCQ14_CURRENT_BASE );
+        gMCHOST_PLLCurrent[i][1] = MCQ14_TO_FLOAT( gMCHOST_PLLCurrentQ14[i].y, MCQ14_CURRENT_BASE );
+        gMCHOST_PLLVoltage[i][0] = MCQ14_TO_FLOAT( gMCHOST_PLLVoltageQ14[i].x, 1.0f );
+        gMCHOST_PLLVoltage[i][1] = MCQ14_TO_FLOAT( gMCHOST_PLLVoltageQ14[i].y, 1.0f );
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Q14Benchmark                                         */
+/* Function parameters: kernel, samples                                       */
+/* Function return: cycle counter ticks per call                              */
+/* Description: Best round execution time over all samples                    */
+/******************************************************************************/
+static double MCHOST_Q14Benchmark( MCHOST_Q14_KERNEL kernel, const uint32_t samples )
+{
+    uint32_t round, i, start, cycles, best = UINT32_MAX;
+
+    for( round = 0U; round < MCHOST_Q14_BENCH_ROUNDS; round++ )
+    {
+        start = MCHAL_CycleCounterGet();
+        for( i = 0U; i < samples; i++ )
+        {
+            kernel( i );
+        }
+        cycles = MCHAL_CycleCounterGet() - start;
+
+        /* Best round, free from preemption */
+        if( cycles < best )
+        {
+            best = cycles;
+        }
+    }
+    return (double)best / (double)samples;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    const tMCHOST_Q14_MODULE_S * pModule;
+    double floatError, fixedError, floatNs, fixedNs, speedError;
+    uint32_t i;
+    int result = 0;
+
+    if( argc != 1 )
+    {
+        fprintf( stderr, "usage: %s\n", argv[0] );
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+    MCQ14_InitializeControl();
+
+    /* Controllers and modulators with the configuration of the control loop */
+    gMCHOST_PIFloat.kp = Q_CURRCNTR_PTERM;
+    gMCHOST_PIFloat.ki = Q_CURRCNTR_ITERM;
+    gMCHOST_PIFloat.kc = Q_CURRCNTR_CTERM;
+    gMCHOST_PIFloat.outMax = Q_CURRCNTR_OUTMAX;
+    gMCHOST_PIFloat.outMin = -Q_CURRCNTR_OUTMAX;
+    gMCHOST_PIQ14 = gMCQ14_IqPIController;
+    gMCHOST_SvmFloat.period = (float)gMCQ14_Parameters.period;
+
+    MCHOST_Q14Inputs();
+
+    printf( "%-24s %12s %12s %8s %10s %10s\n", "Module", "float error", "Q14 error", "unit", "float ns", "Q14 ns" );
+    for( i = 0U; i < ( sizeof( gMCHOST_Q14Modules ) / sizeof( gMCHOST_Q14Modules[0] ) ); i++ )
+    {
+        pModule = &gMCHOST_Q14Modules[i];
+        floatNs = MCHOST_Q14Benchmark( pModule->floatKernel, pModule->samples ) * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ;
+        fixedNs = MCHOST_Q14Benchmark( pModule->fixedKernel, pModule->samples ) * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ;
+        floatError = pModule->error( false );
+        fixedError = pModule->error( true );
+
+        printf( "%-24s %12.3e %12.3e %8s %10.2f %10.2f%s\n", pModule->name, floatError, fixedError, pModule->unit,
+                floatNs, fixedNs, ( fixedError > pModule->maxError ) ? "  (limit exceeded)" : "" );
+        if( fixedError > pModule->maxError )
+        {
+            result = 1;
+        }
+    }
+
+    /* The PLL outputs are those of the last benchmark round */
+    speedError = fabs( MCQ14_TO_FLOAT( gMCHOST_OutQ14[MCHOST_Q14_PLL_SAMPLES - 1U][1], MCQ14_SPEED_BASE )
+                       - gMCHOST_OutFloat[MCHOST_Q14_PLL_SAMPLES - 1U][1] );
+    printf( "PLL speed, float / Q14    : %.2f / %.2f rpm, difference %.2f rpm\n",
+            gMCHOST_OutFloat[MCHOST_Q14_PLL_SAMPLES - 1U][1] * ( 60.0 / ( 2.0 * M_PI * NUM_POLE_PAIRS ) ),
+            MCQ14_TO_FLOAT( gMCHOST_OutQ14[MCHOST_Q14_PLL_SAMPLES - 1U][1], MCQ14_SPEED_BASE ) * ( 60.0 / ( 2.0 * M_PI * NUM_POLE_PAIRS ) ),
+            speedError * ( 60.0 / ( 2.0 * M_PI * NUM_POLE_PAIRS ) ) );
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
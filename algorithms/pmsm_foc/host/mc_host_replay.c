@@ -0,0 +1,607 @@
+/*******************************************************************************
+ Estimator Trace Replay source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_replay.c
+
+  Summary:
+    Replays recorded estimator inputs through the rotor position estimators
+
+  Description:
+    This file replays a trace through the rotor position estimators at full
+    speed: the PLL estimator of the generated component
+    (MCRPOS_PositionMeasurement), the sliding mode observer of the SAM E70
+    SMO application and the Q14 reduced order Luenberger observer of
+    q14_mclib. All of them are set up for the motor of the build. For every
+    estimator it reports the execution time per PWM period, how many times
+    faster than real time the trace is replayed, the speed ripple (RMS
+    deviation of the estimated speed from its 10 ms moving average) after the
+    settling time and, when the trace has a rotor angle (encoder) channel,
+    the RMS, largest and mean angle error after the settling time and the
+    lock time, the start of the first 100 ms within the lock band. The angle
+    error is taken in closed loop only, from 100 ms after the speed reference
+    reaches the open loop end speed: below it the control runs on the open
+    loop angle and the back EMF estimators are not expected to track. The
+    sliding mode observer is restarted and the Luenberger observer aligned
+    there as in their applications. The
+    estimated angles and speeds can be written to a CSV file. The run time
+    tuning parameters of the estimators are set with --set; mc_host_sweep.py
+    runs parameter sweeps over sets of traces.
+
+    The trace is a binary file of mc_host_sim --record, a CSV capture such
+    as an X2CScope export or the trace of mc_host_sim --trace (see
+    mc_host_trace.c for the units) or, by default, a trace recorded from the
+    plant model. The PLL estimator is compiled for the PWM period of the
+    build and only replays traces with this period. The sliding mode
+    observer needs a speed reference; without one in the trace it is taken
+    from the rotor angle. Like its application it does not follow a speed
+    reversal through standstill, which the plant model trace contains, and
+    is restarted after it.
+
+    Usage: mc_host_replay [options]
+      --trace <file>            replay a binary trace of mc_host_sim --record
+      --csv <file>              replay a CSV trace
+      --column <signal>=<name>  CSV column of a signal: time, ialpha, ibeta, ualpha,
+                                ubeta, angle or speedRef (default: the signal name)
+      --estimator <name>        pll, smo, rolo or all (default all)
+      --set <name>.<parameter>=<value>
+                                tuning parameter of an estimator: pll.kFilterEsdq,
+                                pll.kFilterBEMFAmp, pll.velEstimFilterK, smo.boundaryI,
+                                smo.m, smo.lambda, smo.wcSpeedFil, smo.speedRefTime
+      --output <file>           write the estimated angles (rad) and speeds (rpm)
+      --settle <s>              time before the angle error and speed ripple are
+                                measured (default 1)
+      --lock-band <deg>         angle error band of the lock time (default 10)
+      --max-angle-error <deg>   fail if an RMS angle error is larger (default: the
+                                limit of the estimator, pll 5, smo 6, rolo 3)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_generic_lib.h"
+#include "mc_lib.h"
+#include "mc_voltagemeasurement.h"
+#include "mc_rotorposition.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "mc_host_trace.h"
+#include "mc_host_estimator.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* PWM periods timed at once, well inside the range of the cycle counter */
+#define     MCHOST_REPLAY_BLOCK                     (4096U)
+
+#define     MCHOST_REPLAY_ESTIMATORS                (3U)
+
+/* Default limit of the RMS angle error of the PLL estimator (deg) */
+#define     MCHOST_PLL_MAX_ANGLE_ERROR              (5.0f)
+
+/* Time within the lock band which counts as locked and moving average window of the speed ripple (s) */
+#define     MCHOST_REPLAY_LOCK_HOLD_TIME            (0.1f)
+#define     MCHOST_REPLAY_RIPPLE_WINDOW             (0.01f)
+
+/* Open loop time after the end speed is reached, in which the observers start (s) */
+#define     MCHOST_REPLAY_START_TIME                (0.1f)
+#define     MCHOST_RAD_PER_SEC_ELEC_TO_RPM          (float)( 30.0f / ( (float)M_PI * NUM_POLE_PAIRS ) )
+
+/* Replay results of one estimator */
+typedef struct
+{
+    const tMCHOST_ESTIMATOR_S *     estimator;
+    tMCHOST_ESTIMATE_S *            estimate;
+    uint64_t                        cycles;
+    double                          angleErrorSum;
+    double                          angleErrorSqr;
+    double                          angleErrorMax;
+    uint32_t                        angleErrorSamples;
+    double                          lockTime;           /* Negative when the estimator does not lock      */
+    double                          speedRippleSqr;
+    uint32_t                        speedRippleSamples;
+}tMCHOST_REPLAY_RESULT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static int MCHOST_PllInitialize( void );
+static void MCHOST_PllStep( const tMCHOST_TRACE_RECORD_S * const record, tMCHOST_ESTIMATE_S * const estimate );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCRPOS_PARAMETERS_S         gMCHOST_PllTuning =
+{
+    .kFilterEsdq = KFILTER_ESDQ,
+    .kFilterBEMFAmp = KFILTER_BEMF_AMPLITUDE,
+    .velEstimFilterK = KFILTER_VELESTIM,
+};
+static const tMCHOST_ESTIMATOR_PARAMETER_S gMCHOST_PllParameters[] =
+{
+    { "kFilterEsdq",        &gMCHOST_PllTuning.kFilterEsdq },
+    { "kFilterBEMFAmp",     &gMCHOST_PllTuning.kFilterBEMFAmp },
+    { "velEstimFilterK",    &gMCHOST_PllTuning.velEstimFilterK },
+    { NULL,                 NULL }
+};
+static const tMCHOST_ESTIMATOR_S    gMCHOST_PllEstimator = { "pll", gMCHOST_PllParameters, MCHOST_PLL_MAX_ANGLE_ERROR,
+                                                       MCHOST_PllInitialize, MCHOST_PllStep };
+static const tMCHOST_ESTIMATOR_S *  gMCHOST_Estimators[MCHOST_REPLAY_ESTIMATORS] =
+{
+    &gMCHOST_PllEstimator, &gMCHOST_SmoEstimator, &gMCHOST_RoloEstimator
+};
+static const char * const           gMCHOST_CsvSignalName[MCHOST_TRACE_CSV_SIGNALS] =
+{
+    "time", "ialpha", "ibeta", "ualpha", "ubeta", "angle", "speedRef"
+};
+static tMCHOST_REPLAY_RESULT_S      gMCHOST_Results[MCHOST_REPLAY_ESTIMATORS];
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_PllInitialize                                        */
+/* Function parameters: None                                                  */
+/* Function return: 0 on success                                              */
+/* Description: Estimator with the tuning parameters and control angle at    */
+/*              standstill                                                    */
+/******************************************************************************/
+static int MCHOST_PllInitialize( void )
+{
+    if( fabsf( gMCHOST_Trace.deltaT - FAST_LOOP_TIME_SEC ) > ( 1.0e-6f * FAST_LOOP_TIME_SEC ) )
+    {
+        fprintf( stderr, "pll: trace PWM period %g s, the build uses %g s\n",
+                 (double)gMCHOST_Trace.deltaT, (double)FAST_LOOP_TIME_SEC );
+        return -1;
+    }
+    MCRPOS_InitializeRotorPositionSensing();
+    gMCRPOS_Parameters.kFilterEsdq = gMCHOST_PllTuning.kFilterEsdq;
+    gMCRPOS_Parameters.kFilterBEMFAmp = gMCHOST_PllTuning.kFilterBEMFAmp;
+    gMCRPOS_Parameters.velEstimFilterK = gMCHOST_PllTuning.velEstimFilterK;
+    gMCRPOS_OutputSignals.angle = 0.0f;
+    gMCRPOS_OutputSignals.speed = 0.0f;
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PllStep                                              */
+/* Function parameters: record - inputs of the period, estimate - output      */
+/* Function return: None                                                      */
+/* Description: MCRPOS_PositionMeasurement with the signals as the control    */
+/*              interrupt finds them; the control angle is the estimated      */
+/*              angle in closed loop and the recorded one otherwise           */
+/******************************************************************************/
+static void MCHOST_PllStep( const tMCHOST_TRACE_RECORD_S * const record, tMCHOST_ESTIMATE_S * const estimate )
+{
+    gMCLIB_Position.angle = ( 0U != record->closedLoop ) ? gMCRPOS_OutputSignals.angle : record->controlAngle;
+    MCLIB_SinCosCalc( gMCLIB_Position.angle, &gMCLIB_Position.sineAngle, &gMCLIB_Position.cosAngle );
+    gMCRPOS_StateSignals.rhoOffset = record->rhoOffset;
+    gMCLIB_CurrentAlphaBeta.alphaAxis = record->ialpha;
+    gMCLIB_CurrentAlphaBeta.betaAxis = record->ibeta;
+    gMCLIB_VoltageAlphaBeta.alphaAxis = record->ualpha;
+    gMCLIB_VoltageAlphaBeta.betaAxis = record->ubeta;
+    gMCVOL_OutputSignals.umax = record->umax;
+
+    MCRPOS_PositionMeasurement();
+    estimate->angle = gMCRPOS_OutputSignals.angle;
+    estimate->speed = gMCRPOS_OutputSignals.speed;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Replay                                               */
+/* Function parameters: result - estimator and its estimates                 */
+/* Function return: 0 on success                                              */
+/* Description: Runs the estimator over the trace, timed in blocks of PWM     */
+/*              periods                                                       */
+/******************************************************************************/
+static int MCHOST_Replay( tMCHOST_REPLAY_RESULT_S * const result )
+{
+    const tMCHOST_ESTIMATOR_S * const estimator = result->estimator;
+    uint32_t i, block, end, start;
+
+    if( 0 != estimator->initialize() )
+    {
+        return -1;
+    }
+    for( block = 0U; block < gMCHOST_Trace.length; block += MCHOST_REPLAY_BLOCK )
+    {
+        end = ( ( gMCHOST_Trace.length - block ) > MCHOST_REPLAY_BLOCK ) ? ( block + MCHOST_REPLAY_BLOCK ) : gMCHOST_Trace.length;
+        start = MCHAL_CycleCounterGet();
+        for( i = block; i < end; i++ )
+        {
+            estimator->step( &gMCHOST_Trace.record[i], &result->estimate[i] );
+        }
+        result->cycles += (uint32_t)( MCHAL_CycleCounterGet() - start );
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Evaluate                                             */
+/* Function parameters: result - estimates and their figures, settle - time   */
+/*                      before the errors are taken (s), lockBand - angle     */
+/*                      error band of the lock time (rad)                     */
+/* Function return: 0 on success                                              */
+/* Description: Angle error and lock time against the rotor angle in closed  */
+/*              loop, speed ripple against the centered moving average of the */
+/*              speed                                                         */
+/******************************************************************************/
+static int MCHOST_Evaluate( tMCHOST_REPLAY_RESULT_S * const result, const float settle, const float lockBand )
+{
+    const uint32_t first = (uint32_t)( settle / gMCHOST_Trace.deltaT );
+    const uint32_t hold = (uint32_t)( MCHOST_REPLAY_LOCK_HOLD_TIME / gMCHOST_Trace.deltaT );
+    const uint32_t half = (uint32_t)( 0.5f * MCHOST_REPLAY_RIPPLE_WINDOW / gMCHOST_Trace.deltaT );
+    const uint32_t start = (uint32_t)( MCHOST_REPLAY_START_TIME / gMCHOST_Trace.deltaT );
+    double * sum;
+    double error, ripple;
+    uint32_t i, locked = 0U, closedLoop = 0U;
+
+    result->lockTime = -1.0;
+    if( gMCHOST_Trace.rotorAngle )
+    {
+        for( i = 0U; i < gMCHOST_Trace.length; i++ )
+        {
+            closedLoop = ( fabsf( gMCHOST_Trace.record[i].speedRef ) < MCHOST_ESTIMATOR_MIN_SPEED ) ? 0U : ( closedLoop + 1U );
+            if( closedLoop <= start )
+            {
+                continue;
+            }
+            error = (double)MCHOST_AngleDifference( result->estimate[i].angle, gMCHOST_Trace.record[i].rotorAngle );
+            if( i >= first )
+            {
+                result->angleErrorSum += error;
+                result->angleErrorSqr += error * error;
+                result->angleErrorMax = fmax( result->angleErrorMax, fabs( error ) );
+                result->angleErrorSamples++;
+            }
+            locked = ( fabs( error ) < (double)lockBand ) ? ( locked + 1U ) : 0U;
+            if( ( locked > hold ) && ( result->lockTime < 0.0 ) )
+            {
+                result->lockTime = (double)( i - hold ) * (double)gMCHOST_Trace.deltaT;
+            }
+        }
+    }
+
+    /* Running sum of the speed for the moving average over 2 * half + 1 periods */
+    sum = malloc( ( gMCHOST_Trace.length + 1U ) * sizeof( double ) );
+    if( NULL == sum )
+    {
+        fprintf( stderr, "out of memory\n" );
+        return -1;
+    }
+    sum[0] = 0.0;
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        sum[i + 1U] = sum[i] + (double)result->estimate[i].speed;
+    }
+    for( i = ( first > half ) ? first : half; ( i + half ) < gMCHOST_Trace.length; i++ )
+    {
+        ripple = (double)result->estimate[i].speed - ( ( sum[i + half + 1U] - sum[i - half] ) / (double)( ( 2U * half ) + 1U ) );
+        result->speedRippleSqr += ripple * ripple;
+        result->speedRippleSamples++;
+    }
+    free( sum );
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SetParameter                                         */
+/* Function parameters: text - <estimator>.<parameter>=<value>                */
+/* Function return: 0 on success                                              */
+/* Description: Tuning parameter from the parameter table of an estimator    */
+/******************************************************************************/
+static int MCHOST_SetParameter( const char * const text )
+{
+    const char * const dot = strchr( text, '.' );
+    const char * const equal = strchr( text, '=' );
+    const tMCHOST_ESTIMATOR_PARAMETER_S * parameter;
+    uint32_t k;
+
+    if( ( NULL == dot ) || ( NULL == equal ) || ( equal < dot ) )
+    {
+        return -1;
+    }
+    for( k = 0U; k < MCHOST_REPLAY_ESTIMATORS; k++ )
+    {
+        if( ( strlen( gMCHOST_Estimators[k]->name ) != (size_t)( dot - text ) )
+         || ( 0 != strncmp( text, gMCHOST_Estimators[k]->name, (size_t)( dot - text ) ) ) )
+        {
+            continue;
+        }
+        for( parameter = gMCHOST_Estimators[k]->parameters; NULL != parameter->name; parameter++ )
+        {
+            if( ( strlen( parameter->name ) == (size_t)( equal - dot - 1 ) )
+             && ( 0 == strncmp( dot + 1, parameter->name, (size_t)( equal - dot - 1 ) ) ) )
+            {
+                *parameter->value = strtof( equal + 1, NULL );
+                return 0;
+            }
+        }
+    }
+    return -1;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_WriteOutput                                          */
+/* Function parameters: file name                                             */
+/* Function return: 0 on success                                              */
+/* Description: CSV of the rotor angle and the estimates of every period      */
+/******************************************************************************/
+static int MCHOST_WriteOutput( const char * const fileName )
+{
+    const tMCHOST_REPLAY_RESULT_S * result;
+    FILE * file;
+    uint32_t i, k;
+
+    file = fopen( fileName, "w" );
+    if( NULL == file )
+    {
+        perror( fileName );
+        return -1;
+    }
+    fprintf( file, "time%s", gMCHOST_Trace.rotorAngle ? ",angle" : "" );
+    for( k = 0U; k < MCHOST_REPLAY_ESTIMATORS; k++ )
+    {
+        result = &gMCHOST_Results[k];
+        if( NULL != result->estimate )
+        {
+            fprintf( file, ",%sAngle,%sSpeed", result->estimator->name, result->estimator->name );
+        }
+    }
+    fprintf( file, "\n" );
+
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        fprintf( file, "%.6f", (double)i * (double)gMCHOST_Trace.deltaT );
+        if( gMCHOST_Trace.rotorAngle )
+        {
+            fprintf( file, ",%.5f", (double)gMCHOST_Trace.record[i].rotorAngle );
+        }
+        for( k = 0U; k < MCHOST_REPLAY_ESTIMATORS; k++ )
+        {
+            result = &gMCHOST_Results[k];
+            if( NULL != result->estimate )
+            {
+                fprintf( file, ",%.5f,%.2f", (double)result->estimate[i].angle,
+                         (double)( result->estimate[i].speed * MCHOST_RAD_PER_SEC_ELEC_TO_RPM ) );
+            }
+        }
+        fprintf( file, "\n" );
+    }
+    fclose( file );
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "trace",              required_argument, NULL, 't' },
+        { "csv",                required_argument, NULL, 'c' },
+        { "column",             required_argument, NULL, 'k' },
+        { "estimator",          required_argument, NULL, 'e' },
+        { "output",             required_argument, NULL, 'o' },
+        { "set",                required_argument, NULL, 'p' },
+        { "settle",             required_argument, NULL, 's' },
+        { "lock-band",          required_argument, NULL, 'l' },
+        { "max-angle-error",    required_argument, NULL, 'a' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    const char * traceFile = NULL, * csvFile = NULL, * outputFile = NULL, * estimatorName = "all";
+    const char * speedRefSource;
+    float settle = 1.0f, lockBand = 10.0f, maxAngleError = NAN;
+    tMCHOST_REPLAY_RESULT_S * result;
+    double seconds, rmsError;
+    uint32_t k, selected = 0U;
+    char * name;
+    int option, signal, status = 0;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 't': traceFile = optarg; break;
+            case 'c': csvFile = optarg; break;
+            case 'e': estimatorName = optarg; break;
+            case 'o': outputFile = optarg; break;
+            case 's': settle = strtof( optarg, NULL ); break;
+            case 'l': lockBand = strtof( optarg, NULL ); break;
+            case 'p':
+            {
+                if( 0 != MCHOST_SetParameter( optarg ) )
+                {
+                    fprintf( stderr, "--set %s: no such estimator parameter\n", optarg );
+                    return 2;
+                }
+                break;
+            }
+            case 'a': maxAngleError = strtof( optarg, NULL ); break;
+            case 'k':
+            {
+                name = strchr( optarg, '=' );
+                for( signal = 0; ( NULL != name ) && ( signal < (int)MCHOST_TRACE_CSV_SIGNALS ); signal++ )
+                {
+                    if( ( strlen( gMCHOST_CsvSignalName[signal] ) == (size_t)( name - optarg ) )
+                     && ( 0 == strncmp( optarg, gMCHOST_CsvSignalName[signal], (size_t)( name - optarg ) ) ) )
+                    {
+                        gMCHOST_TraceCsvColumn[signal] = name + 1;
+                        break;
+                    }
+                }
+                if( ( NULL == name ) || ( (int)MCHOST_TRACE_CSV_SIGNALS == signal ) )
+                {
+                    fprintf( stderr, "--column %s: expected <signal>=<name>\n", optarg );
+                    return 2;
+                }
+                break;
+            }
+            default:
+            {
+                fprintf( stderr, "usage: %s [--trace file | --csv file [--column signal=name ...]]\n"
+                                 "       [--estimator pll|smo|rolo|all] [--set name.parameter=value ...]\n"
+                                 "       [--output file] [--settle s] [--lock-band deg] [--max-angle-error deg]\n", argv[0] );
+                return 2;
+            }
+        }
+    }
+    for( k = 0U; k < MCHOST_REPLAY_ESTIMATORS; k++ )
+    {
+        if( ( 0 == strcmp( estimatorName, "all" ) ) || ( 0 == strcmp( estimatorName, gMCHOST_Estimators[k]->name ) ) )
+        {
+            gMCHOST_Results[k].estimator = gMCHOST_Estimators[k];
+            selected++;
+        }
+    }
+    if( 0U == selected )
+    {
+        fprintf( stderr, "--estimator %s: expected pll, smo, rolo or all\n", estimatorName );
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+    MCHOST_PlantInitialize();
+
+    if( NULL != traceFile )
+    {
+        status = MCHOST_TraceRead( traceFile );
+    }
+    else if( NULL != csvFile )
+    {
+        status = MCHOST_TraceReadCsv( csvFile );
+    }
+    else
+    {
+        status = MCHOST_TraceRecord();
+    }
+    if( 0 != status )
+    {
+        return 2;
+    }
+    speedRefSource = gMCHOST_Trace.speedRef ? "recorded" : ( gMCHOST_Trace.rotorAngle ? "from the rotor angle" : "none" );
+    MCHOST_TraceSpeedFromAngle();
+
+    printf( "Trace                        : %s, %u PWM periods of %.2f us (%.3f s)\n",
+            ( NULL != traceFile ) ? traceFile : ( ( NULL != csvFile ) ? csvFile : "plant model" ),
+            (unsigned)gMCHOST_Trace.length, (double)gMCHOST_Trace.deltaT * 1.0e6,
+            (double)gMCHOST_Trace.length * (double)gMCHOST_Trace.deltaT );
+    printf( "Rotor angle                  : %s\n", gMCHOST_Trace.rotorAngle ? "recorded" : "none, no angle error" );
+    printf( "Speed reference              : %s\n", speedRefSource );
+    printf( "%-28s %10s %10s %10s %10s %10s %10s %10s\n", "Estimator", "ns", "x realtime", "RMS deg", "max deg", "mean deg",
+            "lock s", "ripple rpm" );
+
+    for( k = 0U; k < MCHOST_REPLAY_ESTIMATORS; k++ )
+    {
+        result = &gMCHOST_Results[k];
+        if( NULL == result->estimator )
+        {
+            continue;
+        }
+        result->estimate = calloc( gMCHOST_Trace.length + 1U, sizeof( tMCHOST_ESTIMATE_S ) );
+        if( NULL == result->estimate )
+        {
+            fprintf( stderr, "out of memory\n" );
+            return 2;
+        }
+        if( 0 != MCHOST_Replay( result ) )
+        {
+            /* An estimator which was asked for by name has to run */
+            printf( "%-28s %10s\n", result->estimator->name, "skipped" );
+            free( result->estimate );
+            result->estimate = NULL;
+            status = ( 1U == selected ) ? 1 : status;
+            continue;
+        }
+        if( 0 != MCHOST_Evaluate( result, settle, lockBand * (float)( M_PI / 180.0 ) ) )
+        {
+            return 2;
+        }
+
+        seconds = (double)result->cycles / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ;
+        printf( "%-28s %10.2f %10.0f", result->estimator->name, seconds * 1.0e9 / (double)gMCHOST_Trace.length,
+                (double)gMCHOST_Trace.length * (double)gMCHOST_Trace.deltaT / seconds );
+        if( 0U != result->angleErrorSamples )
+        {
+            rmsError = sqrt( result->angleErrorSqr / (double)result->angleErrorSamples ) * 180.0 / M_PI;
+            printf( " %10.3f %10.3f %10.3f", rmsError, result->angleErrorMax * 180.0 / M_PI,
+                    result->angleErrorSum / (double)result->angleErrorSamples * 180.0 / M_PI );
+            if( rmsError > (double)( isnan( maxAngleError ) ? result->estimator->maxAngleError : maxAngleError ) )
+            {
+                status = 1;
+            }
+        }
+        else
+        {
+            printf( " %10s %10s %10s", "-", "-", "-" );
+        }
+        if( result->lockTime >= 0.0 )
+        {
+            printf( " %10.3f", result->lockTime );
+        }
+        else
+        {
+            printf( " %10s", "-" );
+        }
+        if( 0U != result->speedRippleSamples )
+        {
+            printf( " %10.2f\n", sqrt( result->speedRippleSqr / (double)result->speedRippleSamples ) * MCHOST_RAD_PER_SEC_ELEC_TO_RPM );
+        }
+        else
+        {
+            printf( " %10s\n", "-" );
+        }
+    }
+
+    if( ( NULL != outputFile ) && ( 0 != MCHOST_WriteOutput( outputFile ) ) )
+    {
+        return 2;
+    }
+    printf( "Result                       : %s\n", ( 0 == status ) ? "PASS" : "FAIL" );
+    return status;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,190 @@
+/*******************************************************************************
+ Reduced Order Luenberger Observer Replay source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_rolo.c
+
+  Summary:
+    Q14 reduced order Luenberger observer of q14_mclib on a trace
+
+  Description:
+    This file runs position_and_speed_estimation of algorithms/q14_mclib on
+    the records of gMCHOST_Trace, as the control interrupt of the SAM C21
+    ROLO applications does with the voltage of the previous period and the
+    measured current. The base speed is the maximum speed of the motor, the
+    base current the larger of the maximum motor current and the peak
+    current of the trace and the base voltage the peak voltage of the trace,
+    so that the Q14 signals stay in range. The reference speed, of which the
+    observer uses the sign, is the speed reference of the trace or else the
+    estimated speed. Below the open loop end speed the observer is aligned
+    with estimation_alignment like in the start up of the applications. The
+    library_* primitives are those of mc_q14_lib.c,
+    the same tables and integer operations as q14_generic_mcLib.c.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_host_estimator.h"
+#include "q14_generic_mcLib.h"
+#include "q14_rolo_mcLib.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_ROLO_ANGLE_TO_RAD                (float)( 2.0 * M_PI / 65536.0 )
+
+/* Default limit of the RMS angle error (deg) */
+#define     MCHOST_ROLO_MAX_ANGLE_ERROR             (3.0f)
+
+/* Q14 signals of the trace */
+typedef struct
+{
+    float                           baseSpeed;          /* Electrical speed (rad/s)                        */
+    float                           speedScale;         /* Q14 per rad/s                                   */
+    float                           voltageScale;       /* Q14 per V                                       */
+    float                           currentScale;       /* Q14 per A                                       */
+    int16_t                         speed;              /* Estimated speed of the previous period          */
+    vec2_t                          voltage;            /* Voltage reference of the previous period        */
+}tMCHOST_ROLO_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_ROLO_S               gMCHOST_Rolo;
+
+/* The observer gain OBS_H_GAIN is a build option of the library */
+static const tMCHOST_ESTIMATOR_PARAMETER_S gMCHOST_RoloParameters[] =
+{
+    { NULL,             NULL }
+};
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_RoloQ14                                              */
+/* Function parameters: value, scale - Q14 units per unit of value            */
+/* Function return: saturated Q14 value                                       */
+/* Description: Conversion of a signal to the internal units                  */
+/******************************************************************************/
+static int16_t MCHOST_RoloQ14( const float value, const float scale )
+{
+    const float q14 = value * scale;
+
+    return (int16_t)fmaxf( -32767.0f, fminf( 32767.0f, q14 ) );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RoloInitialize                                       */
+/* Function parameters: None                                                  */
+/* Function return: 0 on success                                              */
+/* Description: Base values from the motor and the trace, observer reset      */
+/******************************************************************************/
+static int MCHOST_RoloInitialize( void )
+{
+    const tMCHOST_TRACE_RECORD_S * record;
+    float baseVoltage = 0.0f, baseCurrent = MAX_MOTOR_CURRENT, amplitude;
+    uint32_t i;
+
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        record = &gMCHOST_Trace.record[i];
+        amplitude = record->umax * sqrtf( ( record->ualpha * record->ualpha ) + ( record->ubeta * record->ubeta ) );
+        baseVoltage = fmaxf( baseVoltage, fmaxf( amplitude, record->umax ) );
+        amplitude = sqrtf( ( record->ialpha * record->ialpha ) + ( record->ibeta * record->ibeta ) );
+        baseCurrent = fmaxf( baseCurrent, amplitude );
+    }
+
+    gMCHOST_Rolo.baseSpeed = MAX_SPEED_RPM * ( (float)M_PI / 30.0f ) * NUM_POLE_PAIRS;
+    gMCHOST_Rolo.speedScale = BASE_VALUE_FL / gMCHOST_Rolo.baseSpeed;
+    gMCHOST_Rolo.voltageScale = BASE_VALUE_FL / baseVoltage;
+    gMCHOST_Rolo.currentScale = BASE_VALUE_FL / baseCurrent;
+    gMCHOST_Rolo.speed = 0;
+    gMCHOST_Rolo.voltage.x = 0;
+    gMCHOST_Rolo.voltage.y = 0;
+
+    estimation_set_base_values( 1.0f / gMCHOST_Trace.deltaT, gMCHOST_Rolo.baseSpeed, baseVoltage, baseCurrent );
+    estimation_set_parameters( MOTOR_PER_PHASE_RESISTANCE, MOTOR_PER_PHASE_INDUCTANCE );
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RoloStep                                             */
+/* Function parameters: record - inputs of the period, estimate - output      */
+/* Function return: None                                                      */
+/* Description: position_and_speed_estimation on the signals of one period,  */
+/*              estimation_alignment below the open loop end speed            */
+/******************************************************************************/
+static void MCHOST_RoloStep( const tMCHOST_TRACE_RECORD_S * const record, tMCHOST_ESTIMATE_S * const estimate )
+{
+    vec2_t voltage, current;
+    int16_t speedRef;
+
+    /* The application feeds the voltage reference of the previous period (prev_outvab) */
+    voltage = gMCHOST_Rolo.voltage;
+    gMCHOST_Rolo.voltage.x = MCHOST_RoloQ14( record->umax * record->ualpha, gMCHOST_Rolo.voltageScale );
+    gMCHOST_Rolo.voltage.y = MCHOST_RoloQ14( record->umax * record->ubeta, gMCHOST_Rolo.voltageScale );
+    current.x = MCHOST_RoloQ14( record->ialpha, gMCHOST_Rolo.currentScale );
+    current.y = MCHOST_RoloQ14( record->ibeta, gMCHOST_Rolo.currentScale );
+    speedRef = gMCHOST_Trace.speedRef ? MCHOST_RoloQ14( record->speedRef, gMCHOST_Rolo.speedScale ) : gMCHOST_Rolo.speed;
+
+    if( fabsf( record->speedRef ) < MCHOST_ESTIMATOR_MIN_SPEED )
+    {
+        /* The application aligns the observer to the reference during the open loop ramp */
+        estimation_alignment( speedRef, &voltage, &current );
+    }
+    else
+    {
+        position_and_speed_estimation( speedRef, &voltage, &current );
+    }
+    gMCHOST_Rolo.speed = get_angular_speed();
+    estimate->angle = (float)get_angular_position() * MCHOST_ROLO_ANGLE_TO_RAD;
+    estimate->speed = (float)gMCHOST_Rolo.speed / gMCHOST_Rolo.speedScale;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+const tMCHOST_ESTIMATOR_S           gMCHOST_RoloEstimator = { "rolo", gMCHOST_RoloParameters, MCHOST_ROLO_MAX_ANGLE_ERROR,
+                                                                 MCHOST_RoloInitialize, MCHOST_RoloStep };
+
+/*******************************************************************************
+ End of File
+*/
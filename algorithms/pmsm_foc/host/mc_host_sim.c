@@ -0,0 +1,1022 @@
+/*******************************************************************************
+ Closed Loop Host Simulation source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_sim.c
+
+  Summary:
+    Runs the generated pmsm_foc component against the plant model
+
+  Description:
+    This file contains the host simulation driver. Each PWM period the plant
+    currents and DC bus voltage are converted by the simulated ADC, the
+    registered ADC interrupt handler (MCCTRL_CurrentLoopTasks once the
+    current offset calibration is done) is executed and timed, the main loop
+    tasks run once and the plant is advanced with the duty ratios written by
+    the control. At the end a report with the execution time per interrupt
+    and the speed, current and angle tracking errors is printed. The total
+    harmonic distortion of the PWM period averaged phase voltage and of the
+    phase current is taken over whole electrical periods at the end of the
+    simulation, which shows the cost of overmodulation. With TASK_SCHEDULER
+    the software interrupt pended by the control interrupt runs right after
+    it and the start latency and execution time of the slow tasks are added
+    to the report; overruns fail the run.
+
+    Usage: mc_host_sim [options]
+      --time <s>              simulated time (default 12)
+      --speed <rpm>           speed reference (default SPEED_REF_RPM)
+      --load <Nm>             load torque (default 0)
+      --load-time <s>         time at which the load torque is applied (default 0)
+      --settle <s>            time in closed loop before errors are measured (default 1)
+      --max-speed-error <rpm> fail if the RMS speed error is larger
+      --max-iq-error <A>      fail if the RMS q-axis current error is larger
+      --max-angle-error <deg> fail if the RMS angle estimation error is larger
+      --max-current-thd <%>   fail if the phase current THD is larger
+      --trace <file>          write a CSV trace of the simulation
+      --trace-decimation <n>  write every n-th PWM period to the trace (default 10)
+      --record <file>         write the estimator inputs of every PWM period to a
+                              binary trace for mc_host_pll and mc_host_replay
+                              (floating point only)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <getopt.h>
+#include <time.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_currmeasurement.h"
+#include "mc_rotorposition.h"
+#include "mc_speed.h"
+#include "mc_lib.h"
+#include "mc_profiler.h"
+#include "mc_scheduler.h"
+#include "mc_parameters.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "mc_host_trace.h"
+#include "mc_foc_q14.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+#define     MCHOST_THD_POINTS                       (16384U)
+#define     MCHOST_THD_HARMONICS                    (49U)
+#define     MCHOST_RETUNE_FIELDS                    (9U)
+#define     MCHOST_RETUNE_PERIOD_TICKS              (1000U)
+
+/* Defaults of the command line options, a target can build in a loaded case */
+#ifndef MCHOST_SIM_TIME
+#define     MCHOST_SIM_TIME                         (12.0f)
+#endif
+#ifndef MCHOST_SIM_LOAD
+#define     MCHOST_SIM_LOAD                         (0.0f)
+#endif
+#ifndef MCHOST_SIM_LOAD_TIME
+#define     MCHOST_SIM_LOAD_TIME                    (0.0f)
+#endif
+#ifndef MCHOST_SIM_SETTLE
+#define     MCHOST_SIM_SETTLE                       (1.0f)
+#endif
+#ifndef MCHOST_SIM_MAX_IQ_ERROR
+#define     MCHOST_SIM_MAX_IQ_ERROR                 (-1.0f)
+#endif
+#ifndef MCHOST_SIM_MAX_CURRENT_THD
+#define     MCHOST_SIM_MAX_CURRENT_THD              (-1.0f)
+#endif
+
+/* Control signals for the metrics and the trace. The fixed point backend
+   does not update the floating point signals of the control modules */
+#if (ARITHMETIC == ARITHMETIC_Q14)
+#define     MCHOST_IQ_REF                           MCQ14_TO_FLOAT( gMCQ14_CtrlSignals.iqRef, MCQ14_CURRENT_BASE )
+#define     MCHOST_ANGLE_ESTIM                      MCQ14_ANGLE_TO_FLOAT( gMCQ14_PLLState.rho )
+#define     MCHOST_SPEED_ESTIM                      MCQ14_TO_FLOAT( gMCQ14_PLLState.velEstim, MCQ14_SPEED_BASE )
+#define     MCHOST_IALPHA                           MCQ14_TO_FLOAT( gMCQ14_CtrlSignals.iab.x, MCQ14_CURRENT_BASE )
+#define     MCHOST_IBETA                            MCQ14_TO_FLOAT( gMCQ14_CtrlSignals.iab.y, MCQ14_CURRENT_BASE )
+#else
+#define     MCHOST_IQ_REF                           gMCCTRL_CtrlParam.iqRef
+#define     MCHOST_ANGLE_ESTIM                      gMCRPOS_OutputSignals.angle
+#define     MCHOST_SPEED_ESTIM                      gMCRPOS_OutputSignals.speed
+#define     MCHOST_IALPHA                           gMCLIB_CurrentAlphaBeta.alphaAxis
+#define     MCHOST_IBETA                            gMCLIB_CurrentAlphaBeta.betaAxis
+#endif
+
+typedef struct
+{
+    float                           time;
+    float                           speedRpm;
+    float                           loadTorque;
+    float                           loadTime;
+    float                           settleTime;
+    float                           maxSpeedError;
+    float                           maxIqError;
+    float                           maxAngleError;
+    float                           maxCurrentThd;
+    const char *                    traceFile;
+    uint32_t                        traceDecimation;
+    const char *                    recordFile;
+    float                           retuneTime;
+}tMCHOST_SIM_PARAM_S;
+
+typedef struct
+{
+    uint64_t                        ticks;
+    uint64_t                        isrCalls;
+    double                          isrTimeNs;
+    double                          isrMaxNs;
+    double                          timerOverheadNs;
+    uint64_t                        samples;
+    double                          speedErrorSqr;
+    double                          speedErrorMax;
+    double                          iqErrorSqr;
+    double                          angleErrorSqr;
+    double                          angleErrorMax;
+    double                          closedLoopTime;
+    uint64_t                        thdSamples;
+    double                          currentThd;
+}tMCHOST_SIM_STATE_S;
+
+/* Main loop which alternates between two parameter sets, one parameter
+   per PWM period, so that the control interrupt runs between the writes */
+typedef struct
+{
+    tMCPAR_BLOCK_S                  set[2];
+    float *                         target[MCHOST_RETUNE_FIELDS];
+    uint32_t                        fields;
+    uint32_t                        field;
+    uint32_t                        setIndex;
+    bool                            writing;
+    uint64_t                        lastTick;
+    uint64_t                        updates;
+    uint64_t                        checks;
+    uint64_t                        retuned;
+    uint64_t                        torn;
+}tMCHOST_RETUNE_S;
+
+typedef struct
+{
+    double                          fundamental;
+    double                          harmonics;
+    double                          thd;
+}tMCHOST_HARMONICS_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+__STATIC_INLINE double MCHOST_TimeNs( void );
+static void MCHOST_TimerCalibration( void );
+static void MCHOST_SimTick( void );
+static void MCHOST_SimMetrics( void );
+static void MCHOST_Harmonics( const float * const signal, const double frequency, tMCHOST_HARMONICS_S * const result );
+static void MCHOST_SimReport( void );
+#if (ENABLED == ISR_PROFILER)
+static uint32_t MCHOST_ProfilerPercentile( const tMCPROF_STAGE_S * const pStage, const uint32_t percent );
+static void MCHOST_ProfilerReport( void );
+#endif
+#if (ENABLED == TASK_SCHEDULER)
+static int MCHOST_SchedulerReport( void );
+#endif
+static uint32_t MCHOST_RetuneFields( tMCPAR_BLOCK_S * const pBlock, float * fields[] );
+static uint32_t MCHOST_RetuneLiveFields( float * fields[] );
+static void MCHOST_RetuneInitialize( void );
+static void MCHOST_RetuneStep( double time );
+static void MCHOST_RetuneCheck( void );
+static int MCHOST_RetuneReport( void );
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCHOST_SIM_PARAM_S          gMCHOST_SimParam;
+tMCHOST_SIM_STATE_S          gMCHOST_SimState;
+static float                 gMCHOST_ThdVoltage[MCHOST_THD_POINTS];
+static float                 gMCHOST_ThdCurrent[MCHOST_THD_POINTS];
+static tMCHOST_RETUNE_S      gMCHOST_Retune;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+__STATIC_INLINE double MCHOST_TimeNs( void )
+{
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+    return ( (double)now.tv_sec * 1.0e9 ) + (double)now.tv_nsec;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_TimerCalibration                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Measures the cost of a back to back time stamp pair, which is */
+/*              removed from every interrupt measurement                      */
+/******************************************************************************/
+static void MCHOST_TimerCalibration( void )
+{
+    double start, overhead, minimum = 1.0e9;
+    uint32_t i;
+
+    for( i = 0U; i < 10000U; i++ )
+    {
+        start = MCHOST_TimeNs();
+        overhead = MCHOST_TimeNs() - start;
+        if( overhead < minimum )
+        {
+            minimum = overhead;
+        }
+    }
+    gMCHOST_SimState.timerOverheadNs = minimum;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SimTick                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: One PWM period: ADC conversion, control interrupt, main loop  */
+/*              tasks and plant update                                        */
+/******************************************************************************/
+static void MCHOST_SimTick( void )
+{
+    double start, elapsed;
+
+    /* Currents are sampled at the PWM period boundary */
+    MCHOST_ADCConversion( gMCHOST_PlantOutput.iu, gMCHOST_PlantOutput.iv, gMCHOST_PlantParam.udc, 0.0f );
+
+    start = MCHOST_TimeNs();
+    MCHOST_ADCInterrupt();
+    elapsed = MCHOST_TimeNs() - start - gMCHOST_SimState.timerOverheadNs;
+
+    if( MCCTRL_CurrentLoopTasks == gMCHOST_Hal.adcCallback )
+    {
+        gMCHOST_SimState.isrCalls++;
+        gMCHOST_SimState.isrTimeNs += elapsed;
+        if( elapsed > gMCHOST_SimState.isrMaxNs )
+        {
+            gMCHOST_SimState.isrMaxNs = elapsed;
+        }
+    }
+
+    /* Slow tasks released by the control interrupt */
+    MCHOST_SwInterrupt();
+
+    /* Main loop */
+    PMSM_FOC_Tasks();
+
+    /* Duty ratios are applied from the next PWM period */
+    MCHOST_PWMDutyGet( &gMCHOST_PlantInput.dutyU, &gMCHOST_PlantInput.dutyV, &gMCHOST_PlantInput.dutyW );
+    gMCHOST_PlantInput.outputEnabled = MCHOST_PWMOutputIsEnabled();
+    MCHOST_PlantStep();
+
+    gMCHOST_SimState.ticks++;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SimMetrics                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Accumulates the tracking errors in closed loop                */
+/******************************************************************************/
+static void MCHOST_SimMetrics( void )
+{
+    double speedError, iqError, angleError;
+
+    if( MCAPP_CLOSED_LOOP != gMCCTRL_CtrlParam.mcState )
+    {
+        gMCHOST_SimState.closedLoopTime = 0.0;
+        return;
+    }
+    gMCHOST_SimState.closedLoopTime += FAST_LOOP_TIME_SEC;
+    if( gMCHOST_SimState.closedLoopTime < gMCHOST_SimParam.settleTime )
+    {
+        return;
+    }
+
+    speedError = ( gMCSPE_OutputSignals.commandSpeed / MCHOST_RPM_TO_RAD_PER_SEC_ELEC ) - gMCHOST_PlantOutput.speedRpm;
+    iqError = MCHOST_IQ_REF - gMCHOST_PlantState.iq;
+    angleError = MCHOST_AngleDifference( MCHOST_ANGLE_ESTIM, gMCHOST_PlantState.thetaElec );
+
+    /* Last phase voltage and current samples for the harmonic analysis */
+    gMCHOST_ThdVoltage[gMCHOST_SimState.thdSamples % MCHOST_THD_POINTS] = gMCHOST_PlantOutput.ualpha;
+    gMCHOST_ThdCurrent[gMCHOST_SimState.thdSamples % MCHOST_THD_POINTS] = gMCHOST_PlantOutput.iu;
+    gMCHOST_SimState.thdSamples++;
+
+    gMCHOST_SimState.samples++;
+    gMCHOST_SimState.speedErrorSqr += speedError * speedError;
+    gMCHOST_SimState.iqErrorSqr += iqError * iqError;
+    gMCHOST_SimState.angleErrorSqr += angleError * angleError;
+    if( fabs( speedError ) > gMCHOST_SimState.speedErrorMax )
+    {
+        gMCHOST_SimState.speedErrorMax = fabs( speedError );
+    }
+    if( fabs( angleError ) > gMCHOST_SimState.angleErrorMax )
+    {
+        gMCHOST_SimState.angleErrorMax = fabs( angleError );
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_Harmonics                                            */
+/* Function parameters: signal - ring buffer of the last samples              */
+/*                      frequency - fundamental frequency in Hz               */
+/*                      result - fundamental amplitude and THD                */
+/* Function return: None                                                      */
+/* Description: Fourier coefficients of the fundamental and its harmonics up  */
+/*              to MCHOST_THD_HARMONICS or half the PWM frequency, over the   */
+/*              largest whole number of fundamental periods in the buffer.    */
+/*              The RMS of the harmonics is reported as well, as the THD of a */
+/*              motor without load relates them to a small fundamental.       */
+/******************************************************************************/
+static void MCHOST_Harmonics( const float * const signal, const double frequency, tMCHOST_HARMONICS_S * const result )
+{
+    uint64_t available = ( gMCHOST_SimState.thdSamples < MCHOST_THD_POINTS ) ? gMCHOST_SimState.thdSamples : MCHOST_THD_POINTS;
+    uint64_t start;
+    uint32_t points, periods, harmonic, n;
+    double phase, real, imaginary, amplitude, distortion = 0.0;
+
+    result->fundamental = 0.0;
+    result->harmonics = 0.0;
+    result->thd = 0.0;
+    periods = (uint32_t)( (double)available * frequency * FAST_LOOP_TIME_SEC );
+    if( 0U == periods )
+    {
+        return;
+    }
+    points = (uint32_t)( ( (double)periods / ( frequency * FAST_LOOP_TIME_SEC ) ) + 0.5 );
+    points = ( points < available ) ? points : (uint32_t)available;
+    start = gMCHOST_SimState.thdSamples - points;
+
+    for( harmonic = 1U; ( harmonic <= MCHOST_THD_HARMONICS ) && ( ( 2.0 * harmonic * frequency * FAST_LOOP_TIME_SEC ) < 1.0 ); harmonic++ )
+    {
+        real = 0.0;
+        imaginary = 0.0;
+        for( n = 0U; n < points; n++ )
+        {
+            phase = 2.0 * M_PI * (double)harmonic * frequency * FAST_LOOP_TIME_SEC * (double)n;
+            real += (double)signal[( start + n ) % MCHOST_THD_POINTS] * cos( phase );
+            imaginary += (double)signal[( start + n ) % MCHOST_THD_POINTS] * sin( phase );
+        }
+        amplitude = 2.0 * sqrt( ( real * real ) + ( imaginary * imaginary ) ) / (double)points;
+        if( 1U == harmonic )
+        {
+            result->fundamental = amplitude;
+        }
+        else
+        {
+            distortion += amplitude * amplitude;
+        }
+    }
+    result->harmonics = sqrt( 0.5 * distortion );
+    result->thd = ( result->fundamental > 0.0 ) ? ( sqrt( distortion ) / result->fundamental ) : 0.0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SimReport                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Prints execution time and tracking errors                     */
+/******************************************************************************/
+static void MCHOST_SimReport( void )
+{
+    double samples = ( gMCHOST_SimState.samples > 0U ) ? (double)gMCHOST_SimState.samples : 1.0;
+    double isrCalls = ( gMCHOST_SimState.isrCalls > 0U ) ? (double)gMCHOST_SimState.isrCalls : 1.0;
+    double isrAverage = gMCHOST_SimState.isrTimeNs / isrCalls;
+    double frequency = fabs( gMCHOST_PlantOutput.omegaElec ) / ( 2.0 * M_PI );
+    tMCHOST_HARMONICS_S voltage, current;
+
+    printf( "PWM periods simulated        : %llu (%.3f s)\n", (unsigned long long)gMCHOST_SimState.ticks,
+            (double)gMCHOST_SimState.ticks * FAST_LOOP_TIME_SEC );
+    printf( "MCCTRL_CurrentLoopTasks      : %.1f ns/iteration average, %.1f ns max (%.2f M iterations/s)\n",
+            isrAverage, gMCHOST_SimState.isrMaxNs, ( isrAverage > 0.0 ) ? ( 1.0e3 / isrAverage ) : 0.0 );
+    printf( "Final state                  : %s\n", ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState ) ? "closed loop" : "not in closed loop" );
+    printf( "Speed reference / actual     : %.1f / %.1f rpm\n",
+            gMCSPE_OutputSignals.commandSpeed / MCHOST_RPM_TO_RAD_PER_SEC_ELEC, gMCHOST_PlantOutput.speedRpm );
+    printf( "Speed error                  : %.2f rpm RMS, %.2f rpm max\n",
+            sqrt( gMCHOST_SimState.speedErrorSqr / samples ), gMCHOST_SimState.speedErrorMax );
+    printf( "Iq tracking error            : %.4f A RMS\n", sqrt( gMCHOST_SimState.iqErrorSqr / samples ) );
+    printf( "Angle estimation error       : %.3f deg RMS, %.3f deg max\n",
+            sqrt( gMCHOST_SimState.angleErrorSqr / samples ) * 180.0 / M_PI, gMCHOST_SimState.angleErrorMax * 180.0 / M_PI );
+
+    MCHOST_Harmonics( gMCHOST_ThdVoltage, frequency, &voltage );
+    MCHOST_Harmonics( gMCHOST_ThdCurrent, frequency, &current );
+    printf( "Phase voltage fundamental    : %.2f V peak, %.3f of the linear range, THD %.2f %%\n",
+            voltage.fundamental, voltage.fundamental * sqrt( 3.0 ) / gMCHOST_PlantParam.udc, 100.0 * voltage.thd );
+    printf( "Phase current fundamental    : %.3f A peak, THD %.2f %%, harmonics %.3f A RMS\n",
+            current.fundamental, 100.0 * current.thd, current.harmonics );
+    gMCHOST_SimState.currentThd = current.thd;
+}
+
+#if (ENABLED == ISR_PROFILER)
+/******************************************************************************/
+/* Function name: MCHOST_ProfilerPercentile                                   */
+/* Function parameters: pStage - stage statistics, percent                    */
+/* Function return: upper edge of the histogram bin holding the percentile   */
+/* Description: Percentile from the stage histogram                           */
+/******************************************************************************/
+static uint32_t MCHOST_ProfilerPercentile( const tMCPROF_STAGE_S * const pStage, const uint32_t percent )
+{
+    uint32_t bin, cumulative = 0U;
+
+    for( bin = 0U; bin < ( MCPROF_HISTOGRAM_BINS - 1U ); bin++ )
+    {
+        cumulative += pStage->histogram[bin];
+        if( ( (uint64_t)cumulative * 100U ) >= ( (uint64_t)pStage->count * percent ) )
+        {
+            return ( bin + 1U ) << gMCPROF_Data.binShift;
+        }
+    }
+    return pStage->maxCycles;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ProfilerReport                                       */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Prints the stage statistics collected in gMCPROF_Data, the    */
+/*              histogram of the complete interrupt and the PWM frequency     */
+/*              headroom                                                      */
+/******************************************************************************/
+static void MCHOST_ProfilerReport( void )
+{
+    static const char * const stageName[MCPROF_STAGES] =
+    {
+        "MCCUR_CurrentMeasurement",
+        "MCVOL_VoltageMeasurement",
+        "MCCTRL_SignalTransformation",
+        "MCRPOS_PositionMeasurement",
+        "MCCTRL_MotorControl",
+        "MCCTRL_LoopSynchronization",
+        "MCCTRL_CurrentLoopTasks",
+    };
+    const tMCPROF_STAGE_S * pStage;
+    double nsPerCycle = 1.0e9 / (double)gMCPROF_Data.clockHz;
+    uint32_t stage, bin, binWidth = 1U << gMCPROF_Data.binShift;
+    uint32_t percentile;
+
+    printf( "\nControl ISR stage profile (%u Hz counter, %u counts per PWM period, %u counts read overhead removed)\n",
+            (unsigned)gMCPROF_Data.clockHz, (unsigned)gMCPROF_Data.periodCycles, (unsigned)gMCPROF_Data.overheadCycles );
+    printf( "%-28s %10s %10s %10s %10s %10s %8s\n", "Stage", "min", "avg", "p99", "max", "avg ns", "% PWM" );
+    for( stage = 0U; stage < (uint32_t)MCPROF_STAGES; stage++ )
+    {
+        pStage = &gMCPROF_Data.stage[stage];
+        if( 0U == pStage->count )
+        {
+            continue;
+        }
+
+        percentile = MCHOST_ProfilerPercentile( pStage, 99U );
+        printf( "%-28s %10u %10.1f %10u %10u %10.1f %8.2f\n", stageName[stage],
+                (unsigned)pStage->minCycles, (double)pStage->sumCycles / (double)pStage->count,
+                (unsigned)percentile, (unsigned)pStage->maxCycles,
+                nsPerCycle * (double)pStage->sumCycles / (double)pStage->count,
+                100.0 * (double)pStage->sumCycles / ( (double)pStage->count * (double)gMCPROF_Data.periodCycles ) );
+    }
+
+    pStage = &gMCPROF_Data.stage[MCPROF_CURRENT_LOOP_TASKS];
+    printf( "\nMCCTRL_CurrentLoopTasks histogram (%u counts per bin)\n", (unsigned)binWidth );
+    for( bin = 0U; bin < MCPROF_HISTOGRAM_BINS; bin++ )
+    {
+        if( 0U != pStage->histogram[bin] )
+        {
+            if( bin < ( MCPROF_HISTOGRAM_BINS - 1U ) )
+            {
+                printf( "  %6u .. %6u : %10u\n", (unsigned)( bin * binWidth ), (unsigned)( ( ( bin + 1U ) * binWidth ) - 1U ),
+                        (unsigned)pStage->histogram[bin] );
+            }
+            else
+            {
+                printf( "  %6u .. %6s : %10u\n", (unsigned)( bin * binWidth ), "", (unsigned)pStage->histogram[bin] );
+            }
+        }
+    }
+    if( 0U != pStage->count )
+    {
+        /* On the host the maximum includes operating system preemption, the 99th percentile is the useful bound */
+        printf( "Maximum PWM frequency        : %.1f kHz at average, %.1f kHz at 99th percentile, %.1f kHz at worst case ISR load\n",
+                1.0e-3 * (double)gMCPROF_Data.clockHz * (double)pStage->count / (double)pStage->sumCycles,
+                1.0e-3 * (double)gMCPROF_Data.clockHz / (double)MCHOST_ProfilerPercentile( pStage, 99U ),
+                1.0e-3 * (double)gMCPROF_Data.clockHz / (double)pStage->maxCycles );
+    }
+}
+#endif
+
+#if (ENABLED == TASK_SCHEDULER)
+/******************************************************************************/
+/* Function name: MCHOST_SchedulerReport                                      */
+/* Function parameters: None                                                  */
+/* Function return: 0 if every release was dispatched without overrun         */
+/* Description: Prints the start latency, start jitter and execution time of  */
+/*              the slow tasks collected in gMCSCH_Data                       */
+/******************************************************************************/
+static int MCHOST_SchedulerReport( void )
+{
+    static const char * const taskName[MCSCH_TASKS] =
+    {
+        "PMSM_FOC_SpeedLoop",
+        "PMSM_FOC_ButtonPolling",
+        "PMSM_FOC_PositionLoop",
+    };
+    const tMCSCH_TASK_STATE_S * pTask;
+    double nsPerCycle = 1.0e9 / (double)gMCSCH_Data.clockHz;
+    uint32_t task;
+    int result = 0;
+
+    printf( "\nSlow task schedule (%u Hz counter, %u counts read overhead removed, times in ns)\n",
+            (unsigned)gMCSCH_Data.clockHz, (unsigned)gMCSCH_Data.overheadCycles );
+    printf( "%-28s %6s %6s %8s %8s %10s %10s %10s %10s %10s\n", "Task", "period", "phase", "runs", "overruns",
+            "lat avg", "lat max", "jitter", "exec avg", "exec max" );
+    for( task = 0U; task < (uint32_t)MCSCH_TASKS; task++ )
+    {
+        pTask = &gMCSCH_Data.task[task];
+        if( ( pTask->overruns > 0U ) || ( pTask->runs + 1U < pTask->releases ) )
+        {
+            result = 1;
+        }
+        if( 0U == pTask->runs )
+        {
+            printf( "%-28s %6u %6u %8u %8u\n", taskName[task], (unsigned)gMCSCH_TaskTable[task].periodTicks,
+                    (unsigned)gMCSCH_TaskTable[task].phaseTicks, 0U, (unsigned)pTask->overruns );
+            continue;
+        }
+
+        /* Start jitter is the spread of the start latency */
+        printf( "%-28s %6u %6u %8u %8u %10.1f %10.1f %10.1f %10.1f %10.1f\n", taskName[task],
+                (unsigned)gMCSCH_TaskTable[task].periodTicks, (unsigned)gMCSCH_TaskTable[task].phaseTicks,
+                (unsigned)pTask->runs, (unsigned)pTask->overruns,
+                nsPerCycle * (double)pTask->sumLatencyCycles / (double)pTask->runs,
+                nsPerCycle * (double)pTask->maxLatencyCycles,
+                nsPerCycle * (double)( pTask->maxLatencyCycles - pTask->minLatencyCycles ),
+                nsPerCycle * (double)pTask->sumExecCycles / (double)pTask->runs,
+                nsPerCycle * (double)pTask->maxExecCycles );
+    }
+    return result;
+}
+#endif
+
+/******************************************************************************/
+/* Function name: MCHOST_RetuneFields                                         */
+/* Function parameters: pBlock - parameter block, fields - field addresses    */
+/* Function return: Number of fields                                          */
+/* Description: Parameters written by the retuning main loop, in the order of */
+/*              writing.                                                      */
+/******************************************************************************/
+static uint32_t MCHOST_RetuneFields( tMCPAR_BLOCK_S * const pBlock, float * fields[] )
+{
+    uint32_t n = 0U;
+
+    fields[n++] = &pBlock->iqController.kp;
+    fields[n++] = &pBlock->iqController.ki;
+    fields[n++] = &pBlock->idController.kp;
+    fields[n++] = &pBlock->idController.ki;
+    fields[n++] = &pBlock->speedController.kp;
+    fields[n++] = &pBlock->speedController.ki;
+    fields[n++] = &pBlock->positionEstimator.rs;
+    fields[n++] = &pBlock->positionEstimator.lsDt;
+    fields[n++] = &pBlock->positionEstimator.invKFi;
+    return n;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RetuneLiveFields                                     */
+/* Function parameters: fields - field addresses                              */
+/* Function return: Number of fields                                          */
+/* Description: The same parameters as used by the control interrupt          */
+/******************************************************************************/
+static uint32_t MCHOST_RetuneLiveFields( float * fields[] )
+{
+    uint32_t n = 0U;
+
+    fields[n++] = &gMCLIB_IqPIController.kp;
+    fields[n++] = &gMCLIB_IqPIController.ki;
+    fields[n++] = &gMCLIB_IdPIController.kp;
+    fields[n++] = &gMCLIB_IdPIController.ki;
+    fields[n++] = &gMCLIB_SpeedPIController.kp;
+    fields[n++] = &gMCLIB_SpeedPIController.ki;
+    fields[n++] = &gMCRPOS_Parameters.rs;
+    fields[n++] = &gMCRPOS_Parameters.lsDt;
+    fields[n++] = &gMCRPOS_Parameters.invKFi;
+    return n;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RetuneInitialize                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: The configured parameters and a second set with higher gains */
+/*              and motor parameters which are off by some percent            */
+/******************************************************************************/
+static void MCHOST_RetuneInitialize( void )
+{
+    float * live[MCHOST_RETUNE_FIELDS];
+    float * configured[MCHOST_RETUNE_FIELDS];
+    float * retuned[MCHOST_RETUNE_FIELDS];
+    uint32_t field;
+
+    memset( &gMCHOST_Retune, 0, sizeof( gMCHOST_Retune ) );
+    gMCHOST_Retune.fields = MCHOST_RetuneLiveFields( live );
+    (void)MCHOST_RetuneFields( &gMCHOST_Retune.set[0], configured );
+    (void)MCHOST_RetuneFields( &gMCHOST_Retune.set[1], retuned );
+    for( field = 0U; field < gMCHOST_Retune.fields; field++ )
+    {
+        *configured[field] = *live[field];
+        *retuned[field] = 1.1f * *live[field];
+    }
+    gMCHOST_Retune.set[1].positionEstimator.rs = 1.02f * gMCHOST_Retune.set[0].positionEstimator.rs;
+    gMCHOST_Retune.set[1].positionEstimator.lsDt = 1.02f * gMCHOST_Retune.set[0].positionEstimator.lsDt;
+    gMCHOST_Retune.set[1].positionEstimator.invKFi = 0.99f * gMCHOST_Retune.set[0].positionEstimator.invKFi;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RetuneStep                                           */
+/* Function parameters: time - simulated time in s                            */
+/* Function return: None                                                      */
+/* Description: Main loop part of the retuning, one parameter per PWM period. */
+/*              Without the parameter channel the parameters are written in   */
+/*              place, as from X2CScope.                                      */
+/******************************************************************************/
+static void MCHOST_RetuneStep( double time )
+{
+    float * source[MCHOST_RETUNE_FIELDS];
+#if (ENABLED == PARAMETER_CHANNEL)
+    tMCPAR_BLOCK_S * pShadow;
+#endif
+
+    if( ( gMCHOST_SimParam.retuneTime < 0.0f ) || ( time < gMCHOST_SimParam.retuneTime ) )
+    {
+        return;
+    }
+
+    if( !gMCHOST_Retune.writing )
+    {
+        if( ( gMCHOST_SimState.ticks - gMCHOST_Retune.lastTick ) < MCHOST_RETUNE_PERIOD_TICKS )
+        {
+            return;
+        }
+#if (ENABLED == PARAMETER_CHANNEL)
+        pShadow = MCPAR_Edit();
+        if( NULL == pShadow )
+        {
+            return;
+        }
+        (void)MCHOST_RetuneFields( pShadow, gMCHOST_Retune.target );
+#else
+        (void)MCHOST_RetuneLiveFields( gMCHOST_Retune.target );
+#endif
+        gMCHOST_Retune.setIndex ^= 1U;
+        gMCHOST_Retune.field = 0U;
+        gMCHOST_Retune.writing = true;
+    }
+
+    (void)MCHOST_RetuneFields( &gMCHOST_Retune.set[gMCHOST_Retune.setIndex], source );
+    *gMCHOST_Retune.target[gMCHOST_Retune.field] = *source[gMCHOST_Retune.field];
+    gMCHOST_Retune.field++;
+    if( gMCHOST_Retune.field >= gMCHOST_Retune.fields )
+    {
+#if (ENABLED == PARAMETER_CHANNEL)
+        MCPAR_Publish();
+#endif
+        gMCHOST_Retune.writing = false;
+        gMCHOST_Retune.lastTick = gMCHOST_SimState.ticks;
+        gMCHOST_Retune.updates++;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RetuneCheck                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Counts the control interrupts which ran with a mix of the two */
+/*              parameter sets or with a PLL term rsLsDt which does not       */
+/*              follow the written resistance and inductance                  */
+/******************************************************************************/
+static void MCHOST_RetuneCheck( void )
+{
+    float * live[MCHOST_RETUNE_FIELDS];
+    float * set[2][MCHOST_RETUNE_FIELDS];
+    bool match[2] = { true, true };
+    uint32_t field, index;
+
+    if( ( gMCHOST_SimParam.retuneTime < 0.0f ) || ( 0U == gMCHOST_Retune.fields ) )
+    {
+        return;
+    }
+
+    (void)MCHOST_RetuneLiveFields( live );
+    for( index = 0U; index < 2U; index++ )
+    {
+        (void)MCHOST_RetuneFields( &gMCHOST_Retune.set[index], set[index] );
+        for( field = 0U; field < gMCHOST_Retune.fields; field++ )
+        {
+            match[index] = match[index] && ( *live[field] == *set[index][field] );
+        }
+    }
+    gMCHOST_Retune.checks++;
+    if( match[1] )
+    {
+        gMCHOST_Retune.retuned++;
+    }
+    if( ( !match[0] && !match[1] )
+     || ( gMCRPOS_Parameters.rsLsDt != ( gMCRPOS_Parameters.rs + gMCRPOS_Parameters.lsDt ) ) )
+    {
+        gMCHOST_Retune.torn++;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RetuneReport                                         */
+/* Function parameters: None                                                  */
+/* Function return: 0 if the retuned set was applied and no interrupt ran     */
+/*                  with a torn parameter set                                 */
+/* Description: Prints the number of parameter updates, the interrupts which  */
+/*              ran with the retuned set and the torn interrupts              */
+/******************************************************************************/
+static int MCHOST_RetuneReport( void )
+{
+    if( gMCHOST_SimParam.retuneTime < 0.0f )
+    {
+        return 0;
+    }
+
+    printf( "Parameter updates            : %llu written, %llu of %llu control interrupts with the retuned set, %llu with a torn set (%s)\n",
+            (unsigned long long)gMCHOST_Retune.updates, (unsigned long long)gMCHOST_Retune.retuned,
+            (unsigned long long)gMCHOST_Retune.checks, (unsigned long long)gMCHOST_Retune.torn,
+            ( ENABLED == PARAMETER_CHANNEL ) ? "double buffered" : "written in place" );
+#if (ENABLED == PARAMETER_CHANNEL)
+    return ( ( 0U == gMCHOST_Retune.updates ) || ( 0U == gMCHOST_Retune.retuned ) || ( gMCHOST_Retune.torn > 0U ) ) ? 1 : 0;
+#else
+    return 0;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv                                            */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "time",               required_argument, NULL, 't' },
+        { "speed",              required_argument, NULL, 's' },
+        { "load",               required_argument, NULL, 'l' },
+        { "load-time",          required_argument, NULL, 'L' },
+        { "settle",             required_argument, NULL, 'S' },
+        { "max-speed-error",    required_argument, NULL, 'e' },
+        { "max-iq-error",       required_argument, NULL, 'i' },
+        { "max-angle-error",    required_argument, NULL, 'a' },
+        { "max-current-thd",    required_argument, NULL, 'c' },
+        { "trace",              required_argument, NULL, 'o' },
+        { "trace-decimation",   required_argument, NULL, 'd' },
+        { "record",             required_argument, NULL, 'r' },
+        { "retune",             required_argument, NULL, 'p' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_SimParam.time = MCHOST_SIM_TIME;
+    gMCHOST_SimParam.speedRpm = SPEED_REF_RPM;
+    gMCHOST_SimParam.loadTorque = MCHOST_SIM_LOAD;
+    gMCHOST_SimParam.loadTime = MCHOST_SIM_LOAD_TIME;
+    gMCHOST_SimParam.settleTime = MCHOST_SIM_SETTLE;
+    gMCHOST_SimParam.maxSpeedError = -1.0f;
+    gMCHOST_SimParam.maxIqError = MCHOST_SIM_MAX_IQ_ERROR;
+    gMCHOST_SimParam.maxAngleError = -1.0f;
+    gMCHOST_SimParam.maxCurrentThd = MCHOST_SIM_MAX_CURRENT_THD;
+    gMCHOST_SimParam.traceFile = NULL;
+    gMCHOST_SimParam.traceDecimation = 10U;
+    gMCHOST_SimParam.recordFile = NULL;
+    gMCHOST_SimParam.retuneTime = ( ENABLED == PARAMETER_CHANNEL ) ? 4.0f : -1.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 't': gMCHOST_SimParam.time = strtof( optarg, NULL ); break;
+            case 's': gMCHOST_SimParam.speedRpm = strtof( optarg, NULL ); break;
+            case 'l': gMCHOST_SimParam.loadTorque = strtof( optarg, NULL ); break;
+            case 'L': gMCHOST_SimParam.loadTime = strtof( optarg, NULL ); break;
+            case 'S': gMCHOST_SimParam.settleTime = strtof( optarg, NULL ); break;
+            case 'e': gMCHOST_SimParam.maxSpeedError = strtof( optarg, NULL ); break;
+            case 'i': gMCHOST_SimParam.maxIqError = strtof( optarg, NULL ); break;
+            case 'a': gMCHOST_SimParam.maxAngleError = strtof( optarg, NULL ); break;
+            case 'c': gMCHOST_SimParam.maxCurrentThd = strtof( optarg, NULL ); break;
+            case 'o': gMCHOST_SimParam.traceFile = optarg; break;
+            case 'd': gMCHOST_SimParam.traceDecimation = (uint32_t)strtoul( optarg, NULL, 0 ); break;
+            case 'r': gMCHOST_SimParam.recordFile = optarg; break;
+            case 'p': gMCHOST_SimParam.retuneTime = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--time s] [--speed rpm] [--load Nm] [--load-time s] [--settle s]\n"
+                                 "       [--max-speed-error rpm] [--max-iq-error A] [--max-angle-error deg]\n"
+                                 "       [--max-current-thd %%]\n"
+                                 "       [--trace file] [--trace-decimation n] [--record file] [--retune s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( 0U == gMCHOST_SimParam.traceDecimation )
+    {
+        gMCHOST_SimParam.traceDecimation = 1U;
+    }
+#if (ARITHMETIC == ARITHMETIC_Q14)
+    if( NULL != gMCHOST_SimParam.recordFile )
+    {
+        fprintf( stderr, "--record needs the floating point estimator\n" );
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    FILE * trace = NULL;
+    FILE * record = NULL;
+    tMCHOST_TRACE_HEADER_S recordHeader = { MCHOST_TRACE_MAGIC, sizeof( tMCHOST_TRACE_RECORD_S ), FAST_LOOP_TIME_SEC, 0U };
+    tMCHOST_TRACE_RECORD_S recordEntry;
+    uint64_t tick, ticks;
+    double time;
+    int result = 0;
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+    if( NULL != gMCHOST_SimParam.traceFile )
+    {
+        trace = fopen( gMCHOST_SimParam.traceFile, "w" );
+        if( NULL == trace )
+        {
+            perror( gMCHOST_SimParam.traceFile );
+            return 2;
+        }
+        fprintf( trace, "time,state,speedRef,speed,speedEstim,iqRef,id,iq,angle,angleEstim,ialpha,ibeta,ualpha,ubeta\n" );
+    }
+    if( NULL != gMCHOST_SimParam.recordFile )
+    {
+        record = fopen( gMCHOST_SimParam.recordFile, "wb" );
+        if( NULL == record )
+        {
+            perror( gMCHOST_SimParam.recordFile );
+            return 2;
+        }
+        fwrite( &recordHeader, sizeof( recordHeader ), 1U, record );
+    }
+
+    memset( &gMCHOST_SimState, 0, sizeof( gMCHOST_SimState ) );
+    MCHOST_TimerCalibration();
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    PMSM_FOC_Initialize();
+    MCHOST_RetuneInitialize();
+    gMCSPE_InputSignals.speedRef = gMCHOST_SimParam.speedRpm * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_SimTick();
+    }
+    PMSM_FOC_MotorStart();
+
+    ticks = (uint64_t)( gMCHOST_SimParam.time / FAST_LOOP_TIME_SEC );
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        time = (double)tick * FAST_LOOP_TIME_SEC;
+        gMCHOST_PlantInput.loadTorque = ( time >= gMCHOST_SimParam.loadTime ) ? gMCHOST_SimParam.loadTorque : 0.0f;
+
+        if( NULL != record )
+        {
+            /* Signals the estimator finds at the start of the interrupt */
+            recordEntry.rhoOffset = gMCRPOS_StateSignals.rhoOffset;
+            recordEntry.controlAngle = gMCLIB_Position.angle;
+            recordEntry.closedLoop = ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState ) ? 1U : 0U;
+            recordEntry.speedRef = gMCSPE_OutputSignals.commandSpeed;
+        }
+
+        MCHOST_RetuneStep( time );
+        MCHOST_SimTick();
+        MCHOST_RetuneCheck();
+        MCHOST_SimMetrics( );
+
+        if( NULL != record )
+        {
+            /* Inputs read by the estimator in the interrupt */
+            recordEntry.ialpha = gMCRPOS_InputSignals.ialpha;
+            recordEntry.ibeta = gMCRPOS_InputSignals.ibeta;
+            recordEntry.ualpha = gMCRPOS_InputSignals.ualpha;
+            recordEntry.ubeta = gMCRPOS_InputSignals.ubeta;
+            recordEntry.umax = gMCRPOS_InputSignals.umax;
+            recordEntry.rotorAngle = gMCHOST_PlantState.thetaElec;
+            fwrite( &recordEntry, sizeof( recordEntry ), 1U, record );
+        }
+
+        if( ( NULL != trace ) && ( 0U == ( tick % gMCHOST_SimParam.traceDecimation ) ) )
+        {
+            fprintf( trace, "%.6f,%d,%.2f,%.2f,%.2f,%.4f,%.4f,%.4f,%.5f,%.5f,%.4f,%.4f,%.4f,%.4f\n",
+                     time, (int)gMCCTRL_CtrlParam.mcState,
+                     gMCSPE_OutputSignals.commandSpeed / MCHOST_RPM_TO_RAD_PER_SEC_ELEC, gMCHOST_PlantOutput.speedRpm,
+                     MCHOST_SPEED_ESTIM / MCHOST_RPM_TO_RAD_PER_SEC_ELEC,
+                     MCHOST_IQ_REF, gMCHOST_PlantState.id, gMCHOST_PlantState.iq,
+                     gMCHOST_PlantState.thetaElec, MCHOST_ANGLE_ESTIM,
+                     MCHOST_IALPHA, MCHOST_IBETA,
+                     gMCHOST_PlantOutput.ualpha, gMCHOST_PlantOutput.ubeta );
+        }
+    }
+
+    if( NULL != trace )
+    {
+        fclose( trace );
+    }
+    if( NULL != record )
+    {
+        fclose( record );
+    }
+    MCHOST_SimReport();
+#if (ENABLED == ISR_PROFILER)
+    MCHOST_ProfilerReport();
+#endif
+#if (ENABLED == TASK_SCHEDULER)
+    result |= MCHOST_SchedulerReport();
+#endif
+    result |= MCHOST_RetuneReport();
+
+    if( MCAPP_CLOSED_LOOP != gMCCTRL_CtrlParam.mcState )
+    {
+        result = 1;
+    }
+    /* A diverged plant or a run without a settled closed loop sample has no errors to compare */
+    if( ( 0U == gMCHOST_SimState.samples ) || !isfinite( gMCHOST_PlantOutput.speedRpm ) )
+    {
+        result = 1;
+    }
+    if( ( gMCHOST_SimParam.maxSpeedError >= 0.0f )
+     && ( sqrt( gMCHOST_SimState.speedErrorSqr / (double)( gMCHOST_SimState.samples + 1U ) ) > gMCHOST_SimParam.maxSpeedError ) )
+    {
+        result = 1;
+    }
+    if( ( gMCHOST_SimParam.maxIqError >= 0.0f )
+     && ( sqrt( gMCHOST_SimState.iqErrorSqr / (double)( gMCHOST_SimState.samples + 1U ) ) > gMCHOST_SimParam.maxIqError ) )
+    {
+        result = 1;
+    }
+    if( ( gMCHOST_SimParam.maxAngleError >= 0.0f )
+     && ( ( sqrt( gMCHOST_SimState.angleErrorSqr / (double)( gMCHOST_SimState.samples + 1U ) ) * 180.0 / M_PI ) > gMCHOST_SimParam.maxAngleError ) )
+    {
+        result = 1;
+    }
+    if( ( gMCHOST_SimParam.maxCurrentThd >= 0.0f )
+     && !( ( 100.0 * gMCHOST_SimState.currentThd ) <= gMCHOST_SimParam.maxCurrentThd ) )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,213 @@
+/*******************************************************************************
+ Sine Cosine Benchmark source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_sincos.c
+
+  Summary:
+    Accuracy and execution time of the MCLIB sine and cosine methods
+
+  Description:
+    This file compares the sine and cosine calculation methods of
+    mc_generic_lib.c, which are all compiled in by MCLIB_SINCOS_ALL_METHODS.
+    For every method the maximum absolute error of the sine and the cosine
+    against the double precision library over [-2pi, 4pi), the average
+    execution time per call and the table memory are reported.
+
+    Usage: mc_host_sincos [--max-error <e>]
+      --max-error <e>   fail if the error of the method selected by
+                        SINCOS_METHOD is larger (default 1e-4)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_generic_lib.h"
+#include "mc_hal.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_SINCOS_ERROR_POINTS              (2000000U)
+#define     MCHOST_SINCOS_BENCH_ANGLES              (4096U)
+#define     MCHOST_SINCOS_BENCH_ROUNDS              (2000U)
+
+typedef void (*MCHOST_SINCOS_FUNCTION)( float const rotor_angle, float* sineAngle, float* cosAngle );
+
+typedef struct
+{
+    const char *                    name;
+    uint32_t                        method;
+    MCHOST_SINCOS_FUNCTION          function;
+    uint32_t                        tableBytes;
+}tMCHOST_SINCOS_METHOD_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static const tMCHOST_SINCOS_METHOD_S gMCHOST_SinCosMethods[] =
+{
+    { "Interpolated tables",        SINCOS_INTERPOLATED_TABLE,  MCLIB_SinCosTable,        2U * TABLE_SIZE * sizeof(float) },
+    { "Minimax polynomial",         SINCOS_POLYNOMIAL,          MCLIB_SinCosPolynomial,   0U },
+    { "Quarter wave table",         SINCOS_QUARTER_WAVE_TABLE,  MCLIB_SinCosQuarterWave,  ( QUARTER_TABLE_SIZE + 1U ) * sizeof(float) },
+    { "CORDIC",                     SINCOS_CORDIC,              MCLIB_SinCosCordic,       CORDIC_ITERATIONS * sizeof(int32_t) },
+};
+
+static float gMCHOST_BenchAngles[MCHOST_SINCOS_BENCH_ANGLES];
+volatile float gMCHOST_BenchSink;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_SinCosError                                          */
+/* Function parameters: function, maximum sine and cosine error              */
+/* Function return: None                                                      */
+/* Description: Maximum absolute error over [-2pi, 4pi)                       */
+/******************************************************************************/
+static void MCHOST_SinCosError( MCHOST_SINCOS_FUNCTION function, double * const sineError, double * const cosError )
+{
+    uint32_t i;
+    float angle, sine, cosine;
+    double error;
+
+    *sineError = 0.0;
+    *cosError = 0.0;
+    for( i = 0U; i < MCHOST_SINCOS_ERROR_POINTS; i++ )
+    {
+        angle = (float)( -2.0 * M_PI + ( 6.0 * M_PI * (double)i / (double)MCHOST_SINCOS_ERROR_POINTS ) );
+        function( angle, &sine, &cosine );
+
+        error = fabs( (double)sine - sin( (double)angle ) );
+        if( error > *sineError )
+        {
+            *sineError = error;
+        }
+        error = fabs( (double)cosine - cos( (double)angle ) );
+        if( error > *cosError )
+        {
+            *cosError = error;
+        }
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SinCosBenchmark                                      */
+/* Function parameters: function                                              */
+/* Function return: cycle counter ticks per call                              */
+/* Description: Average execution time over pseudo random angles in [0, 2pi)  */
+/******************************************************************************/
+static double MCHOST_SinCosBenchmark( MCHOST_SINCOS_FUNCTION function )
+{
+    uint32_t round, i, start, cycles, best = UINT32_MAX;
+    float sine, cosine, sum;
+
+    for( round = 0U; round < MCHOST_SINCOS_BENCH_ROUNDS; round++ )
+    {
+        sum = 0.0f;
+        start = MCHAL_CycleCounterGet();
+        for( i = 0U; i < MCHOST_SINCOS_BENCH_ANGLES; i++ )
+        {
+            function( gMCHOST_BenchAngles[i], &sine, &cosine );
+            sum += sine + cosine;
+        }
+        cycles = MCHAL_CycleCounterGet() - start;
+        gMCHOST_BenchSink = sum;
+
+        /* Best round, free from preemption */
+        if( cycles < best )
+        {
+            best = cycles;
+        }
+    }
+    return (double)best / (double)MCHOST_SINCOS_BENCH_ANGLES;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    const tMCHOST_SINCOS_METHOD_S * pMethod;
+    double maxError = 1.0e-4, sineError, cosError, cycles;
+    uint32_t i, seed = 12345U;
+    int result = 0;
+
+    if( ( argc == 3 ) && ( 0 == strcmp( argv[1], "--max-error" ) ) )
+    {
+        maxError = strtod( argv[2], NULL );
+    }
+    else if( argc != 1 )
+    {
+        fprintf( stderr, "usage: %s [--max-error e]\n", argv[0] );
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+    for( i = 0U; i < MCHOST_SINCOS_BENCH_ANGLES; i++ )
+    {
+        seed = ( seed * 1664525U ) + 1013904223U;
+        gMCHOST_BenchAngles[i] = TOTAL_SINE_TABLE_ANGLE * ( (float)( seed >> 8 ) * ( 1.0f / 16777216.0f ) );
+    }
+
+    printf( "%-24s %12s %12s %10s %10s %12s\n", "Method", "sin error", "cos error", "counts", "ns", "table bytes" );
+    for( i = 0U; i < ( sizeof( gMCHOST_SinCosMethods ) / sizeof( gMCHOST_SinCosMethods[0] ) ); i++ )
+    {
+        pMethod = &gMCHOST_SinCosMethods[i];
+        MCHOST_SinCosError( pMethod->function, &sineError, &cosError );
+        cycles = MCHOST_SinCosBenchmark( pMethod->function );
+
+        printf( "%-24s %12.3e %12.3e %10.1f %10.2f %12u%s\n", pMethod->name, sineError, cosError, cycles,
+                cycles * 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ, (unsigned)pMethod->tableBytes,
+                ( SINCOS_METHOD == pMethod->method ) ? "  (selected)" : "" );
+
+        if( ( SINCOS_METHOD == pMethod->method ) && ( ( sineError > maxError ) || ( cosError > maxError ) ) )
+        {
+            result = 1;
+        }
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,204 @@
+/*******************************************************************************
+ Sliding Mode Observer Replay source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_smo.c
+
+  Summary:
+    Sliding mode observer of the SAM E70 SMO application on a trace
+
+  Description:
+    This file runs motionEstimator of apps/pmsm_foc_smo_sam_e70 on the
+    records of gMCHOST_Trace. The observer tuning is that of the userparams.h
+    of the application (RL_* values) unless it is changed through the
+    parameter table, the motor parameters and the PWM
+    period are those of the build and the trace. The BEMF observer and the
+    BEMF filter are driven by the speed reference as in the control interrupt
+    of the application, which starts the observer when the open loop ramp
+    reaches its end speed (OPEN_LOOP_END_SPEED_RPM here) and does not pass
+    through standstill in closed loop; the observer is stopped below the end
+    speed and started again above it. As in the application the observer
+    gets the voltage reference of the previous period. The estimated angle
+    is TH and the estimated speed WeHat.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_host_estimator.h"
+#include "positionEstimator.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Default observer tuning, that of the application userparams.h */
+#define     MCHOST_SMO_BOUNDARY_I                   (0.5f)      /* RL_BOUNDARY_I */
+#define     MCHOST_SMO_M                            (8000.0f)   /* RL_M */
+#define     MCHOST_SMO_LAMBDA                       (-1000.0f)  /* RL_LAMBDA */
+#define     MCHOST_SMO_WC_SPEED_FIL                 (200.0f)    /* RL_WC_SPEED_FIL */
+#define     MCHOST_SMO_SPEEDREF_TIME                (0.2f)      /* RL_SPEEDREF_TIME */
+
+/* The speed FIFO holds the phase changes of 1 ms */
+#define     MCHOST_SMO_MIN_PERIOD                   (0.001f / (float)( SPEED_FIFO_COUNT - 1U ))
+
+/* Default limit of the RMS angle error (deg) */
+#define     MCHOST_SMO_MAX_ANGLE_ERROR              (6.0f)
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+/* Observer signals, defined in mc_app.c in the application */
+tagPosition                         positionData;
+tagSpeed                            speedData;
+tagObserverInput                    observerInput;
+static tagInputPara                 gMCHOST_SmoPara;
+static bool                         gMCHOST_SmoStarted;
+static float                        gMCHOST_SmoLastUalpha;
+static float                        gMCHOST_SmoLastUbeta;
+static tagInputPara                 gMCHOST_SmoTuning =
+{
+    .boundaryI = MCHOST_SMO_BOUNDARY_I,
+    .m = MCHOST_SMO_M,
+    .lambda = MCHOST_SMO_LAMBDA,
+    .wcSpeedFil = MCHOST_SMO_WC_SPEED_FIL,
+    .speedRefTime = MCHOST_SMO_SPEEDREF_TIME,
+};
+static const tMCHOST_ESTIMATOR_PARAMETER_S gMCHOST_SmoParameters[] =
+{
+    { "boundaryI",      &gMCHOST_SmoTuning.boundaryI },
+    { "m",              &gMCHOST_SmoTuning.m },
+    { "lambda",         &gMCHOST_SmoTuning.lambda },
+    { "wcSpeedFil",     &gMCHOST_SmoTuning.wcSpeedFil },
+    { "speedRefTime",   &gMCHOST_SmoTuning.speedRefTime },
+    { NULL,             NULL }
+};
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_SmoInitialize                                        */
+/* Function parameters: None                                                  */
+/* Function return: 0 on success                                              */
+/* Description: Observer parameters for the motor and the trace period and    */
+/*              reset of the observer                                         */
+/******************************************************************************/
+static int MCHOST_SmoInitialize( void )
+{
+    if( !gMCHOST_Trace.speedRef )
+    {
+        fprintf( stderr, "smo: needs a speed reference or a rotor angle in the trace\n" );
+        return -1;
+    }
+    if( gMCHOST_Trace.deltaT < MCHOST_SMO_MIN_PERIOD )
+    {
+        fprintf( stderr, "smo: PWM period %g s below the %g s of the speed FIFO\n",
+                 (double)gMCHOST_Trace.deltaT, (double)MCHOST_SMO_MIN_PERIOD );
+        return -1;
+    }
+
+    gMCHOST_SmoPara = gMCHOST_SmoTuning;
+    gMCHOST_SmoPara.pwmFreq = 1.0f / gMCHOST_Trace.deltaT;
+    gMCHOST_SmoPara.rs = MOTOR_PER_PHASE_RESISTANCE;
+    gMCHOST_SmoPara.ls = MOTOR_PER_PHASE_INDUCTANCE;
+    gMCHOST_SmoPara.P = NUM_POLE_PAIRS;
+    gMCHOST_SmoPara.expRsLsTs = expf( -MOTOR_PER_PHASE_RESISTANCE / MOTOR_PER_PHASE_INDUCTANCE * gMCHOST_Trace.deltaT );
+
+    memset( &positionData, 0, sizeof( positionData ) );
+    memset( &speedData, 0, sizeof( speedData ) );
+    memset( &observerInput, 0, sizeof( observerInput ) );
+    observerInput.positionDataP = &positionData;
+    observerInput.speedDataP = &speedData;
+    observerInput.para = &gMCHOST_SmoPara;
+    resetEstimator( &observerInput );
+    gMCHOST_SmoStarted = false;
+    gMCHOST_SmoLastUalpha = 0.0f;
+    gMCHOST_SmoLastUbeta = 0.0f;
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SmoStep                                              */
+/* Function parameters: record - inputs of the period, estimate - output      */
+/* Function return: None                                                      */
+/* Description: motionEstimator on the signals of one period, started above  */
+/*              the open loop end speed and stopped below it                  */
+/******************************************************************************/
+static void MCHOST_SmoStep( const tMCHOST_TRACE_RECORD_S * const record, tMCHOST_ESTIMATE_S * const estimate )
+{
+    observerInput.Ialpha = record->ialpha;
+    observerInput.Ibeta = record->ibeta;
+    /* The application feeds the voltage reference of the previous period (lastValpha) */
+    observerInput.Ualpha = gMCHOST_SmoLastUalpha;
+    observerInput.Ubeta = gMCHOST_SmoLastUbeta;
+    gMCHOST_SmoLastUalpha = record->umax * record->ualpha;
+    gMCHOST_SmoLastUbeta = record->umax * record->ubeta;
+    observerInput.WeRef = record->speedRef;
+    if( !gMCHOST_SmoStarted && ( fabsf( record->speedRef ) >= MCHOST_ESTIMATOR_MIN_SPEED ) )
+    {
+        observerInput.startObs = 2U;
+        gMCHOST_SmoStarted = true;
+    }
+    else if( gMCHOST_SmoStarted && ( fabsf( record->speedRef ) < MCHOST_ESTIMATOR_MIN_SPEED ) )
+    {
+        /* Stop, the application restarts through the open loop ramp. The
+           observer reset leaves the speed sum of the FIFO, cleared here */
+        observerInput.startObs = 1U;
+        speedData.SUMdTH = 0.0f;
+        gMCHOST_SmoStarted = false;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+    motionEstimator( &observerInput );
+    estimate->angle = positionData.TH;
+    estimate->speed = speedData.WeHat;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+const tMCHOST_ESTIMATOR_S           gMCHOST_SmoEstimator = { "smo", gMCHOST_SmoParameters, MCHOST_SMO_MAX_ANGLE_ERROR,
+                                                                MCHOST_SmoInitialize, MCHOST_SmoStep };
+
+/*******************************************************************************
+ End of File
+*/
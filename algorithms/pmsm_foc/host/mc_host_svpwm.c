@@ -0,0 +1,469 @@
+/*******************************************************************************
+ Space Vector Modulation Benchmark source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_svpwm.c
+
+  Summary:
+    Volt-second balance, switching events and execution time jitter of the
+    SVPWM methods
+
+  Description:
+    This file compares the space vector modulation methods of mc_pwm.c, which
+    are all compiled in by MCPWM_SVPWM_ALL_METHODS, with the sector based
+    modulation.
+    - Volt-second balance: the line to line duty cycles of every method must
+      match the sector based modulation inside the linear range. The phase
+      duty cycles of the continuous methods must match as well.
+    - Switching events: the number of PWM edges and of changed duty registers
+      per PWM period for a rotating voltage vector below and above
+      DPWM_MIN_MODULATION_INDEX. Discontinuous PWM saves a third of the edges
+      above and falls back to continuous modulation below.
+    - Execution time: every call is timed with the cycle counter for a
+      rotating voltage vector, which keeps the branch predictor trained, and
+      for random voltage vectors, which do not. The mean, the standard
+      deviation (jitter) without the 0.1 % longest calls, which are host
+      operating system interrupts, the minimum, the 99th percentile and the
+      maximum are reported.
+
+    Usage: mc_host_svpwm [--max-duty-error <counts>]
+      --max-duty-error <counts>   fail if a duty cycle differs from the
+                                  sector based modulation by more (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_lib.h"
+#include "mc_pwm.h"
+#include "mc_hal.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_SVPWM_CHECK_POINTS               (1000000U)
+#define     MCHOST_SVPWM_BENCH_POINTS               (65536U)
+#define     MCHOST_SVPWM_BENCH_ROUNDS               (16U)
+#define     MCHOST_SVPWM_STATISTICS_POINTS          ( ( MCHOST_SVPWM_BENCH_POINTS * 999U ) / 1000U )
+
+/* Electrical frequency of the rotating voltage vector */
+#define     MCHOST_SVPWM_ROTATING_FREQUENCY         (100.0f)
+#define     MCHOST_SVPWM_ROTATING_AMPLITUDE         (0.8f)
+#define     MCHOST_SVPWM_ROTATING_CYCLES            (10U)
+#define     MCHOST_SVPWM_HIGH_INDEX                 (0.9f)
+
+typedef void (*MCHOST_SVPWM_FUNCTION)( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm );
+
+typedef struct
+{
+    const char *                    name;
+    uint32_t                        method;
+    MCHOST_SVPWM_FUNCTION           function;
+    bool                            continuous;
+}tMCHOST_SVPWM_METHOD_S;
+
+typedef struct
+{
+    double                          mean;
+    double                          deviation;
+    uint32_t                        minimum;
+    uint32_t                        percentile99;
+    uint32_t                        maximum;
+}tMCHOST_SVPWM_TIMING_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static const tMCHOST_SVPWM_METHOD_S gMCHOST_SvpwmMethods[] =
+{
+    { "Sector tree",                SVPWM_SECTOR_TREE,          MCPWM_SVPWMSectorTree,    true },
+    { "Min-max injection",          SVPWM_MIN_MAX,              MCPWM_SVPWMMinMax,        true },
+    { "DPWM negative rail",         SVPWM_DPWM_MIN,             MCPWM_SVPWMDpwmMin,       false },
+    { "DPWM60",                     SVPWM_DPWM60,               MCPWM_SVPWMDpwm60,        false },
+    { "DPWM30",                     SVPWM_DPWM30,               MCPWM_SVPWMDpwm30,        false },
+};
+
+#define MCHOST_SVPWM_METHODS            ( sizeof( gMCHOST_SvpwmMethods ) / sizeof( gMCHOST_SvpwmMethods[0] ) )
+
+static tMCLIB_CLARK_TRANSFORM_S gMCHOST_BenchVoltages[MCHOST_SVPWM_BENCH_POINTS];
+static uint32_t gMCHOST_BenchCycles[MCHOST_SVPWM_BENCH_POINTS];
+static uint32_t gMCHOST_Seed = 12345U;
+static uint32_t gMCHOST_Overhead;
+volatile uint32_t gMCHOST_BenchSink;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_Random                                               */
+/* Function parameters: None                                                  */
+/* Function return: Pseudo random value in [0, 1)                             */
+/* Description: Linear congruential generator                                 */
+/******************************************************************************/
+static float MCHOST_Random( void )
+{
+    gMCHOST_Seed = ( gMCHOST_Seed * 1664525U ) + 1013904223U;
+    return (float)( gMCHOST_Seed >> 8 ) * ( 1.0f / 16777216.0f );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_RandomVoltage                                        */
+/* Function parameters: voltage                                               */
+/* Function return: None                                                      */
+/* Description: Uniformly distributed inside the linear range, i.e. the       */
+/*              circle inscribed in the voltage hexagon                       */
+/******************************************************************************/
+static void MCHOST_RandomVoltage( tMCLIB_CLARK_TRANSFORM_S * const voltage )
+{
+    float magnitude = sqrtf( MCHOST_Random() );
+    float angle = 2.0f * (float)M_PI * MCHOST_Random();
+
+    voltage->alphaAxis = magnitude * cosf( angle );
+    voltage->betaAxis = magnitude * sinf( angle );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SvpwmInitialize                                      */
+/* Function parameters: svm                                                   */
+/* Function return: None                                                      */
+/* Description: PWM period of the configuration                               */
+/******************************************************************************/
+static void MCHOST_SvpwmInitialize( tMCPWM_SVPWM_S * const svm )
+{
+    memset( svm, 0, sizeof( *svm ) );
+    svm->period = (float)MCHAL_PWMPrimaryPeriodGet( MCHAL_PWM_PH_U );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_DutyDeviation                                        */
+/* Function parameters: reference, value, maximum deviation                   */
+/* Function return: None                                                      */
+/* Description: Tracks the largest duty cycle deviation in counts             */
+/******************************************************************************/
+static void MCHOST_DutyDeviation( const uint32_t reference, const uint32_t value, uint32_t * const maxDeviation )
+{
+    uint32_t deviation = ( value > reference ) ? ( value - reference ) : ( reference - value );
+
+    if( deviation > *maxDeviation )
+    {
+        *maxDeviation = deviation;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_LineDeviation                                        */
+/* Function parameters: reference, value, maximum deviation                   */
+/* Function return: None                                                      */
+/* Description: Tracks the largest deviation of the line to line duty cycles  */
+/******************************************************************************/
+static void MCHOST_LineDeviation( const tMCPWM_SVPWM_S * const reference, const tMCPWM_SVPWM_S * const value,
+                                  uint32_t * const maxDeviation )
+{
+    int32_t deviation[3];
+    uint32_t i, magnitude;
+
+    deviation[0] = ( (int32_t)value->dPwm1 - (int32_t)value->dPwm2 ) - ( (int32_t)reference->dPwm1 - (int32_t)reference->dPwm2 );
+    deviation[1] = ( (int32_t)value->dPwm2 - (int32_t)value->dPwm3 ) - ( (int32_t)reference->dPwm2 - (int32_t)reference->dPwm3 );
+    deviation[2] = ( (int32_t)value->dPwm3 - (int32_t)value->dPwm1 ) - ( (int32_t)reference->dPwm3 - (int32_t)reference->dPwm1 );
+    for( i = 0U; i < 3U; i++ )
+    {
+        magnitude = (uint32_t)abs( deviation[i] );
+        if( magnitude > *maxDeviation )
+        {
+            *maxDeviation = magnitude;
+        }
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_PhaseEdges                                           */
+/* Function parameters: svm                                                   */
+/* Function return: PWM edges in one period                                   */
+/* Description: Every phase which is not clamped to a rail switches twice     */
+/******************************************************************************/
+static uint32_t MCHOST_PhaseEdges( const tMCPWM_SVPWM_S * const svm )
+{
+    uint32_t period = (uint32_t)svm->period;
+
+    return ( ( ( 0U < svm->dPwm1 ) && ( svm->dPwm1 < period ) ) ? 2U : 0U )
+         + ( ( ( 0U < svm->dPwm2 ) && ( svm->dPwm2 < period ) ) ? 2U : 0U )
+         + ( ( ( 0U < svm->dPwm3 ) && ( svm->dPwm3 < period ) ) ? 2U : 0U );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SwitchingEvents                                      */
+/* Function parameters: function, amplitude, edges, writes                    */
+/* Function return: None                                                      */
+/* Description: PWM edges and changed duty registers per PWM period for a     */
+/*              rotating voltage vector                                       */
+/******************************************************************************/
+static void MCHOST_SwitchingEvents( MCHOST_SVPWM_FUNCTION function, const float amplitude,
+                                    double * const edges, double * const writes )
+{
+    tMCLIB_CLARK_TRANSFORM_S voltage;
+    tMCPWM_SVPWM_S svm;
+    uint32_t i, points, edgeCount = 0U, writeCount = 0U;
+    float angle;
+
+    MCHOST_SvpwmInitialize( &svm );
+    points = MCHOST_SVPWM_ROTATING_CYCLES * (uint32_t)( (float)PWM_FREQUENCY / MCHOST_SVPWM_ROTATING_FREQUENCY );
+    for( i = 0U; i < points; i++ )
+    {
+        angle = fmodf( 2.0f * (float)M_PI * MCHOST_SVPWM_ROTATING_FREQUENCY * (float)i / (float)PWM_FREQUENCY, 2.0f * (float)M_PI );
+        voltage.alphaAxis = amplitude * cosf( angle );
+        voltage.betaAxis = amplitude * sinf( angle );
+        function( &voltage, &svm );
+
+        edgeCount += MCHOST_PhaseEdges( &svm );
+        writeCount += ( svm.dPwm1 != svm.lastPwm1 ) ? 1U : 0U;
+        writeCount += ( svm.dPwm2 != svm.lastPwm2 ) ? 1U : 0U;
+        writeCount += ( svm.dPwm3 != svm.lastPwm3 ) ? 1U : 0U;
+        svm.lastPwm1 = svm.dPwm1;
+        svm.lastPwm2 = svm.dPwm2;
+        svm.lastPwm3 = svm.dPwm3;
+    }
+    *edges = (double)edgeCount / (double)points;
+    *writes = (double)writeCount / (double)points;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_CompareCycles                                        */
+/* Function parameters: a, b                                                  */
+/* Function return: qsort order                                               */
+/* Description: Ascending order of cycle counts                               */
+/******************************************************************************/
+static int MCHOST_CompareCycles( const void * a, const void * b )
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return ( x > y ) - ( x < y );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SvpwmTiming                                          */
+/* Function parameters: function, timing                                      */
+/* Function return: None                                                      */
+/* Description: Times every call over the benchmark voltages. The round with  */
+/*              the lowest 99th percentile is kept, as the others are         */
+/*              disturbed by the host operating system.                       */
+/******************************************************************************/
+static void MCHOST_SvpwmTiming( MCHOST_SVPWM_FUNCTION function, tMCHOST_SVPWM_TIMING_S * const timing )
+{
+    tMCPWM_SVPWM_S svm;
+    tMCHOST_SVPWM_TIMING_S round;
+    uint32_t r, i, start, cycles;
+    double sum, sumSquares;
+
+    MCHOST_SvpwmInitialize( &svm );
+    memset( timing, 0, sizeof( *timing ) );
+
+    for( r = 0U; r < MCHOST_SVPWM_BENCH_ROUNDS; r++ )
+    {
+        for( i = 0U; i < MCHOST_SVPWM_BENCH_POINTS; i++ )
+        {
+            start = MCHAL_CycleCounterGet();
+            function( &gMCHOST_BenchVoltages[i], &svm );
+            cycles = MCHAL_CycleCounterGet() - start;
+            gMCHOST_BenchCycles[i] = ( cycles > gMCHOST_Overhead ) ? ( cycles - gMCHOST_Overhead ) : 0U;
+        }
+        gMCHOST_BenchSink = svm.dPwm1;
+        qsort( gMCHOST_BenchCycles, MCHOST_SVPWM_BENCH_POINTS, sizeof( uint32_t ), MCHOST_CompareCycles );
+
+        /* Mean and standard deviation without the 0.1 % longest calls */
+        sum = 0.0;
+        sumSquares = 0.0;
+        for( i = 0U; i < MCHOST_SVPWM_STATISTICS_POINTS; i++ )
+        {
+            sum += (double)gMCHOST_BenchCycles[i];
+            sumSquares += (double)gMCHOST_BenchCycles[i] * (double)gMCHOST_BenchCycles[i];
+        }
+        round.mean = sum / (double)MCHOST_SVPWM_STATISTICS_POINTS;
+        round.deviation = sqrt( fmax( 0.0, ( sumSquares / (double)MCHOST_SVPWM_STATISTICS_POINTS ) - ( round.mean * round.mean ) ) );
+        round.minimum = gMCHOST_BenchCycles[0];
+        round.percentile99 = gMCHOST_BenchCycles[( MCHOST_SVPWM_BENCH_POINTS * 99U ) / 100U];
+        round.maximum = gMCHOST_BenchCycles[MCHOST_SVPWM_BENCH_POINTS - 1U];
+
+        if( ( 0U == r ) || ( round.percentile99 < timing->percentile99 ) )
+        {
+            *timing = round;
+        }
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_SvpwmReport                                          */
+/* Function parameters: pattern - name of the voltage sequence                */
+/* Function return: None                                                      */
+/* Description: Execution time of all methods for the benchmark voltages      */
+/******************************************************************************/
+static void MCHOST_SvpwmReport( const char * pattern )
+{
+    const tMCHOST_SVPWM_METHOD_S * pMethod;
+    tMCHOST_SVPWM_TIMING_S timing;
+    double nsPerCount = 1.0e9 / (double)MCHAL_CYCLE_COUNTER_CLOCK_HZ;
+    uint32_t i;
+
+    printf( "\n%s voltage vector (counts, %.3f ns per count)\n", pattern, nsPerCount );
+    printf( "%-24s %8s %8s %8s %8s %8s %10s\n", "Method", "mean", "jitter", "min", "p99", "max", "mean ns" );
+    for( i = 0U; i < MCHOST_SVPWM_METHODS; i++ )
+    {
+        pMethod = &gMCHOST_SvpwmMethods[i];
+        MCHOST_SvpwmTiming( pMethod->function, &timing );
+        printf( "%-24s %8.1f %8.2f %8u %8u %8u %10.2f%s\n", pMethod->name, timing.mean, timing.deviation,
+                (unsigned)timing.minimum, (unsigned)timing.percentile99, (unsigned)timing.maximum,
+                timing.mean * nsPerCount, ( SVPWM_METHOD == pMethod->method ) ? "  (selected)" : "" );
+    }
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    const tMCHOST_SVPWM_METHOD_S * pMethod;
+    tMCLIB_CLARK_TRANSFORM_S voltage;
+    tMCPWM_SVPWM_S reference, svm;
+    uint32_t i, m, start, cycles, maxDutyError = 1U, lineDeviation, phaseDeviation, clamped;
+    double lowEdges, lowWrites, highEdges, highWrites;
+    float angle;
+    int result = 0;
+
+    if( ( argc == 3 ) && ( 0 == strcmp( argv[1], "--max-duty-error" ) ) )
+    {
+        maxDutyError = (uint32_t)strtoul( argv[2], NULL, 0 );
+    }
+    else if( argc != 1 )
+    {
+        fprintf( stderr, "usage: %s [--max-duty-error counts]\n", argv[0] );
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHAL_CycleCounterStart();
+    MCHOST_SvpwmInitialize( &svm );
+    printf( "PWM period                   : %.0f counts\n", (double)svm.period );
+    printf( "Duty deviation limit         : %u counts phase, %u counts line to line\n\n",
+            (unsigned)maxDutyError, (unsigned)( 2U * maxDutyError ) );
+
+    /* Back to back counter reads */
+    gMCHOST_Overhead = UINT32_MAX;
+    for( i = 0U; i < 1024U; i++ )
+    {
+        start = MCHAL_CycleCounterGet();
+        cycles = MCHAL_CycleCounterGet() - start;
+        if( cycles < gMCHOST_Overhead )
+        {
+            gMCHOST_Overhead = cycles;
+        }
+    }
+
+    /* Volt-second balance inside the linear range */
+    printf( "%-24s %14s %14s %14s\n", "Method", "line counts", "phase counts", "clamped %" );
+    for( m = 0U; m < MCHOST_SVPWM_METHODS; m++ )
+    {
+        pMethod = &gMCHOST_SvpwmMethods[m];
+        MCHOST_SvpwmInitialize( &reference );
+        MCHOST_SvpwmInitialize( &svm );
+        lineDeviation = 0U;
+        phaseDeviation = 0U;
+        clamped = 0U;
+        gMCHOST_Seed = 12345U;
+        for( i = 0U; i < MCHOST_SVPWM_CHECK_POINTS; i++ )
+        {
+            MCHOST_RandomVoltage( &voltage );
+            MCPWM_SVPWMSectorTree( &voltage, &reference );
+            pMethod->function( &voltage, &svm );
+            MCHOST_LineDeviation( &reference, &svm, &lineDeviation );
+            MCHOST_DutyDeviation( reference.dPwm1, svm.dPwm1, &phaseDeviation );
+            MCHOST_DutyDeviation( reference.dPwm2, svm.dPwm2, &phaseDeviation );
+            MCHOST_DutyDeviation( reference.dPwm3, svm.dPwm3, &phaseDeviation );
+            clamped += ( MCHOST_PhaseEdges( &svm ) < 6U ) ? 1U : 0U;
+        }
+        /* Discontinuous methods shift the zero sequence, only the line to line duty cycles compare */
+        printf( "%-24s %14u %14u %14.1f\n", pMethod->name, (unsigned)lineDeviation, (unsigned)phaseDeviation,
+                100.0 * (double)clamped / (double)MCHOST_SVPWM_CHECK_POINTS );
+        if( ( lineDeviation > ( 2U * maxDutyError ) ) || ( pMethod->continuous && ( phaseDeviation > maxDutyError ) ) )
+        {
+            result = 1;
+        }
+    }
+
+    /* Switching events below and above the minimum modulation index of DPWM */
+    printf( "\nSwitching per PWM period   %10s %10s %10s %10s\n", "edges", "writes", "edges", "writes" );
+    printf( "%-24s %21.2f %21.2f\n", "Modulation index", (double)( DPWM_MIN_MODULATION_INDEX * 0.6f ),
+            (double)MCHOST_SVPWM_HIGH_INDEX );
+    for( m = 0U; m < MCHOST_SVPWM_METHODS; m++ )
+    {
+        pMethod = &gMCHOST_SvpwmMethods[m];
+        MCHOST_SwitchingEvents( pMethod->function, DPWM_MIN_MODULATION_INDEX * 0.6f, &lowEdges, &lowWrites );
+        MCHOST_SwitchingEvents( pMethod->function, MCHOST_SVPWM_HIGH_INDEX, &highEdges, &highWrites );
+        printf( "%-24s %10.2f %10.2f %10.2f %10.2f\n", pMethod->name, lowEdges, lowWrites, highEdges, highWrites );
+
+        /* Continuous below the minimum index, a third fewer edges above */
+        if( ( lowEdges < 5.99 ) || ( !pMethod->continuous && ( highEdges > 4.01 ) ) )
+        {
+            result = 1;
+        }
+    }
+
+    /* Execution time for a predictable and an unpredictable sector sequence */
+    for( i = 0U; i < MCHOST_SVPWM_BENCH_POINTS; i++ )
+    {
+        angle = fmodf( 2.0f * (float)M_PI * MCHOST_SVPWM_ROTATING_FREQUENCY * (float)i / (float)PWM_FREQUENCY, 2.0f * (float)M_PI );
+        gMCHOST_BenchVoltages[i].alphaAxis = MCHOST_SVPWM_ROTATING_AMPLITUDE * cosf( angle );
+        gMCHOST_BenchVoltages[i].betaAxis = MCHOST_SVPWM_ROTATING_AMPLITUDE * sinf( angle );
+    }
+    MCHOST_SvpwmReport( "Rotating" );
+
+    for( i = 0U; i < MCHOST_SVPWM_BENCH_POINTS; i++ )
+    {
+        MCHOST_RandomVoltage( &gMCHOST_BenchVoltages[i] );
+    }
+    MCHOST_SvpwmReport( "Random" );
+
+    printf( "\nResult                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,202 @@
+# coding: utf-8
+"""*****************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*****************************************************************************"""
+
+###################################################################################################
+########################### Estimator parameter sweep #############################################
+###################################################################################################
+#
+# Runs mc_host_replay over every combination of captured trace and estimator parameter set and
+# collects the angle error, lock time and speed ripple of each run into one table. A run passes
+# when mc_host_replay passes (RMS angle error within the limit of the estimator or maxAngleError)
+# and, on traces with a rotor angle, the estimator locks within maxLockTime. The mean of a
+# parameter set is taken over its passing runs only and is "-" when none passes. The sweep is
+# described by a JSON file (see mc_host_sweep.json):
+#
+#   {
+#     "traces"    : [ "plant", "captures/*.bin", "captures/run1.csv" ],
+#     "columns"   : { "angle" : "theta" },          CSV column names, optional
+#     "settle"    : 1.0,                            optional, s
+#     "lockBand"  : 10.0,                           optional, deg
+#     "maxAngleError" : 5.0,                        optional, deg, RMS
+#     "maxLockTime" : 0.5,                          optional, s
+#     "sweeps"    : [ { "estimator" : "pll",
+#                       "parameters" : { "pll.kFilterEsdq" : [ 0.0015, 0.003 ] } },
+#                     { "estimator" : "rolo",
+#                       "parameters" : { "OBS_H_GAIN" : [ 0.2, 0.3, 0.5 ] } } ]
+#   }
+#
+# "plant" is the trace mc_host_replay records from the plant model. Each sweep expands to the
+# cartesian product of its parameter values. Parameters named <estimator>.<parameter> are runtime
+# tuning values of mc_host_replay (--set), upper case names are compile time options of the
+# estimator sources and get one build of mc_host_replay per distinct combination. The estimator
+# sources (pos_pll.c.ftl, positionEstimator.c, q14_rolo_mcLib.c) are compiled unchanged.
+#
+#   python3 mc_host_sweep.py [-o <output folder>] [-j <jobs>] [--csv <result file>] <sweep.json>
+#
+# Builds and runs are spread over all cores (-j, default: number of CPUs).
+
+import argparse
+import concurrent.futures
+import csv
+import glob
+import itertools
+import json
+import os
+import subprocess
+import sys
+
+from mc_host_build import mcHostBuild
+
+# Columns of the mc_host_replay result table used in the sweep table
+mcSweepColumns = ["RMS deg", "max deg", "lock s", "ripple rpm"]
+
+# Default lock time limit of a run (s)
+mcSweepMaxLockTime = 0.5
+
+def mcSweepTraces(spec, specPath):
+    traces = []
+    for pattern in spec["traces"]:
+        if pattern == "plant":
+            traces.append(pattern)
+            continue
+        if not os.path.isabs(pattern):
+            pattern = os.path.join(os.path.dirname(os.path.abspath(specPath)), pattern)
+        found = sorted(glob.glob(pattern))
+        if not found:
+            raise ValueError("no trace matches " + pattern)
+        traces += found
+    return traces
+
+def mcSweepSets(spec):
+    # (estimator, runtime settings, compile time defines) per parameter set
+    sets = []
+    for sweep in spec["sweeps"]:
+        names = sorted(sweep.get("parameters", {}).keys())
+        for values in itertools.product(*[sweep["parameters"][name] for name in names]):
+            settings = tuple((name, value) for name, value in zip(names, values) if "." in name)
+            defines = tuple((name, value) for name, value in zip(names, values) if "." not in name)
+            sets.append((sweep["estimator"], settings, defines))
+    return sets
+
+def mcSweepDefineFlag(name, value):
+    # Float literals keep the single precision arithmetic of the target
+    if isinstance(value, float):
+        return "-D%s=%rf" % (name, value)
+    return "-D%s=%s" % (name, value)
+
+def mcSweepBuild(outputPath, defines, index):
+    buildPath = os.path.join(outputPath, "build%d" % index)
+    cflags = [mcSweepDefineFlag(name, value) for name, value in defines]
+    return mcHostBuild(buildPath, "mc_host_replay", {}, cflags)
+
+def mcSweepRun(executable, trace, parameterSet, spec):
+    estimator, settings, defines = parameterSet
+    command = [executable, "--estimator", estimator]
+    if trace != "plant":
+        command += ["--csv" if trace.lower().endswith(".csv") else "--trace", trace]
+    for signal, column in sorted(spec.get("columns", {}).items()):
+        command += ["--column", "%s=%s" % (signal, column)]
+    command += ["--settle", str(spec.get("settle", 1.0)), "--lock-band", str(spec.get("lockBand", 10.0))]
+    if "maxAngleError" in spec:
+        command += ["--max-angle-error", str(spec["maxAngleError"])]
+    for name, value in settings:
+        command += ["--set", "%s=%s" % (name, value)]
+
+    process = subprocess.run(command, stdout = subprocess.PIPE, stderr = subprocess.STDOUT, universal_newlines = True)
+    lines = process.stdout.splitlines()
+    header = [line for line in lines if line.startswith("Estimator")]
+    rows = [line.split() for line in lines if line.split()[:1] == [estimator]]
+    if process.returncode > 1 or not header or not rows:
+        raise RuntimeError(" ".join(command) + "\n" + process.stdout)
+
+    # Header fields are separated by at least one blank and right aligned to the 10 character columns
+    fields = header[0][28:]
+    names = [fields[i:i + 11].strip() for i in range(0, len(fields), 11)]
+    result = dict(zip(names, rows[0][1:]))
+
+    # Without a rotor angle in the trace there is no angle error and no lock time to check
+    locked = result.get("RMS deg", "-") == "-" or \
+             (result.get("lock s", "-") != "-" and float(result["lock s"]) <= spec.get("maxLockTime", mcSweepMaxLockTime))
+    result["result"] = "PASS" if process.returncode == 0 and locked else "FAIL"
+    return result
+
+def mcSweepLabel(parameterSet):
+    estimator, settings, defines = parameterSet
+    label = " ".join("%s=%s" % (name, value) for name, value in settings + defines)
+    return label if label else "default"
+
+def mcSweepMean(values):
+    numbers = [float(value) for value in values if value != "-"]
+    return "%.3f" % (sum(numbers) / len(numbers)) if len(numbers) == len(values) and numbers else "-"
+
+def mcSweepRowFormat(columns):
+    return "%-20s %-6s %-40s" + " %10s" * columns
+
+def main():
+    parser = argparse.ArgumentParser(description = "Estimator parameter sweep over captured traces")
+    parser.add_argument("-o", "--output", default = "mc_host_sweep", help = "output folder of the builds")
+    parser.add_argument("-j", "--jobs", type = int, default = os.cpu_count(), help = "parallel builds and runs")
+    parser.add_argument("--csv", help = "write the results to this CSV file")
+    parser.add_argument("spec", help = "sweep description (JSON)")
+    args = parser.parse_args()
+
+    with open(args.spec) as f:
+        spec = json.load(f)
+    traces = mcSweepTraces(spec, args.spec)
+    sets = mcSweepSets(spec)
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers = args.jobs) as executor:
+        defineSets = sorted(set(defines for estimator, settings, defines in sets))
+        builds = dict(zip(defineSets, executor.map(lambda item: mcSweepBuild(args.output, item[1], item[0]),
+                                                   enumerate(defineSets))))
+        jobs = [(trace, parameterSet) for parameterSet in sets for trace in traces]
+        results = list(executor.map(lambda job: mcSweepRun(builds[job[1][2]], job[0], job[1], spec), jobs))
+
+    rows = []
+    for (trace, parameterSet), result in zip(jobs, results):
+        rows.append([os.path.basename(trace), parameterSet[0], mcSweepLabel(parameterSet)] +
+                    [result.get(column, "-") for column in mcSweepColumns] + [result["result"]])
+
+    rowFormat = mcSweepRowFormat(len(mcSweepColumns) + 1)
+    print(rowFormat % tuple(["Trace", "Est.", "Parameters"] + mcSweepColumns + ["result"]))
+    for row in rows:
+        print(rowFormat % tuple(row))
+    print("")
+    print("Mean over the passing runs of %d traces" % len(traces))
+    for parameterSet in sets:
+        selected = [row for row in rows if row[1] == parameterSet[0] and row[2] == mcSweepLabel(parameterSet)]
+        passed = [row for row in selected if row[-1] == "PASS"]
+        print(rowFormat % tuple(["", parameterSet[0], mcSweepLabel(parameterSet)] +
+              [mcSweepMean([row[3 + k] for row in passed]) for k in range(len(mcSweepColumns))] +
+              ["%d/%d" % (len(passed), len(selected))]))
+
+    if args.csv:
+        with open(args.csv, "w", newline = "") as f:
+            writer = csv.writer(f)
+            writer.writerow(["trace", "estimator", "parameters"] + mcSweepColumns + ["result"])
+            writer.writerows(rows)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,486 @@
+/*******************************************************************************
+ Estimator Input Trace source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_trace.c
+
+  Summary:
+    Loading and recording of rotor position estimator input traces
+
+  Description:
+    This file loads the binary traces written by mc_host_sim --record and
+    CSV captures, such as X2CScope exports or the trace of mc_host_sim
+    --trace, into gMCHOST_Trace. Without a trace file a trace is recorded
+    from the plant model, driven by a speed and current control on the plant
+    angle through a speed ramp to the rated speed and a reversal through
+    standstill.
+
+    A CSV trace has a header line with the signal names and one line per PWM
+    period. The currents are in A, the voltages in V, the optional rotor
+    angle in electrical radians and the optional speed reference in
+    mechanical rpm. The PWM period is taken from the time column when there
+    is one.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_generic_lib.h"
+#include "mc_host_plant.h"
+#include "mc_host_trace.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+/* Recorded speed profile, mechanical speed relative to the rated speed */
+#define     MCHOST_TRACE_RAMP_UP_TIME               (1.0f)
+#define     MCHOST_TRACE_HOLD_TIME                  (0.5f)
+#define     MCHOST_TRACE_REVERSAL_TIME              (1.5f)
+#define     MCHOST_TRACE_REVERSE_SPEED              (-0.5f)
+
+/* Control of the recording: speed loop bandwidth (rad/s) and current loop time constant (PWM periods) */
+#define     MCHOST_TRACE_SPEED_BANDWIDTH            (50.0f)
+#define     MCHOST_TRACE_CURRENT_PERIODS            (5.0f)
+
+/* Filter time constant of the speed taken from the rotor angle (s) */
+#define     MCHOST_TRACE_SPEED_FILTER_TIME          (0.005f)
+
+#define     MCHOST_TRACE_CSV_LINE                   (4096U)
+#define     MCHOST_TRACE_CSV_SEPARATORS             ",;\t"
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCHOST_TRACE_S                     gMCHOST_Trace;
+
+/* Column names of the CSV signals, those of mc_host_sim --trace by default */
+const char *                        gMCHOST_TraceCsvColumn[MCHOST_TRACE_CSV_SIGNALS] =
+{
+    "time", "ialpha", "ibeta", "ualpha", "ubeta", "angle", "speedRef"
+};
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_TraceAllocate                                        */
+/* Function parameters: length - number of records                           */
+/* Function return: 0 on success                                              */
+/* Description: Zeroed records, one more than needed for the callers which    */
+/*              look one period ahead                                         */
+/******************************************************************************/
+static int MCHOST_TraceAllocate( const uint32_t length )
+{
+    free( gMCHOST_Trace.record );
+    memset( &gMCHOST_Trace, 0, sizeof( gMCHOST_Trace ) );
+    gMCHOST_Trace.record = calloc( length + 1U, sizeof( tMCHOST_TRACE_RECORD_S ) );
+    if( NULL == gMCHOST_Trace.record )
+    {
+        fprintf( stderr, "out of memory\n" );
+        return -1;
+    }
+    gMCHOST_Trace.length = length;
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_TraceCsvField                                        */
+/* Function parameters: text - field, trimmed in place                        */
+/* Function return: field without blanks and quotes                           */
+/* Description: Header and value field of a CSV line                          */
+/******************************************************************************/
+static char * MCHOST_TraceCsvField( char * text )
+{
+    char * end;
+
+    while( ( ' ' == *text ) || ( '"' == *text ) )
+    {
+        text++;
+    }
+    end = text + strlen( text );
+    while( ( end > text ) && ( ( ' ' == end[-1] ) || ( '"' == end[-1] ) || ( '\r' == end[-1] ) || ( '\n' == end[-1] ) ) )
+    {
+        end--;
+    }
+    *end = '\0';
+    return text;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_TraceReferenceProfile                                */
+/* Function parameters: t - time (s)                                          */
+/* Function return: mechanical speed reference (rad/s)                        */
+/* Description: Speed ramp to the rated speed and reversal through standstill */
+/******************************************************************************/
+static float MCHOST_TraceReferenceProfile( const float t )
+{
+    const float ratedSpeed = RATED_SPEED_RPM * ( (float)M_PI / 30.0f );
+    float speedRef;
+
+    if( t < MCHOST_TRACE_RAMP_UP_TIME )
+    {
+        speedRef = ratedSpeed * ( t / MCHOST_TRACE_RAMP_UP_TIME );
+    }
+    else if( t < ( MCHOST_TRACE_RAMP_UP_TIME + MCHOST_TRACE_HOLD_TIME ) )
+    {
+        speedRef = ratedSpeed;
+    }
+    else if( t < ( MCHOST_TRACE_RAMP_UP_TIME + MCHOST_TRACE_HOLD_TIME + MCHOST_TRACE_REVERSAL_TIME ) )
+    {
+        speedRef = ratedSpeed * ( 1.0f + ( MCHOST_TRACE_REVERSE_SPEED - 1.0f )
+                                * ( ( t - MCHOST_TRACE_RAMP_UP_TIME - MCHOST_TRACE_HOLD_TIME ) / MCHOST_TRACE_REVERSAL_TIME ) );
+    }
+    else
+    {
+        speedRef = ratedSpeed * MCHOST_TRACE_REVERSE_SPEED;
+    }
+    return speedRef;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_TraceRecord                                          */
+/* Function parameters: None                                                  */
+/* Function return: 0 on success                                              */
+/* Description: Records the reference speed profile of the estimator replays  */
+/******************************************************************************/
+int MCHOST_TraceRecord( void )
+{
+    return MCHOST_TraceRecordProfile( MCHOST_TraceReferenceProfile, MCHOST_TRACE_RAMP_UP_TIME + MCHOST_TRACE_HOLD_TIME
+                                                                  + MCHOST_TRACE_REVERSAL_TIME + MCHOST_TRACE_HOLD_TIME );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_TraceRecordProfile                                   */
+/* Function parameters: speedProfile - mechanical speed reference (rad/s)     */
+/*                      over time (s), time - length of the trace (s)         */
+/* Function return: 0 on success                                              */
+/* Description: Records the estimator inputs of the plant model under speed   */
+/*              and current control on the plant angle                        */
+/******************************************************************************/
+int MCHOST_TraceRecordProfile( const tMCHOST_TRACE_SPEED_PROFILE_F speedProfile, const float time )
+{
+    const tMCHOST_PLANT_PARAM_S * const param = &gMCHOST_PlantParam;
+    const float kSpeed = param->inertia * MCHOST_TRACE_SPEED_BANDWIDTH / ( 1.5f * param->polePairs * param->fluxLinkage );
+    const float kCurrent = param->ld / ( MCHOST_TRACE_CURRENT_PERIODS * param->deltaT );
+    const float umax = param->udc * ONE_BY_SQRT3;
+    tMCHOST_TRACE_RECORD_S * record;
+    float t, speedRef, iqRef, omegaElec, ud, uq, amplitude, sine, cosine;
+    float ualpha, ubeta, uu, uv, uw, zero;
+    uint32_t i;
+
+    if( 0 != MCHOST_TraceAllocate( (uint32_t)( time / param->deltaT ) ) )
+    {
+        return -1;
+    }
+    gMCHOST_Trace.deltaT = param->deltaT;
+    gMCHOST_Trace.rotorAngle = true;
+    gMCHOST_Trace.speedRef = true;
+
+    MCHOST_PlantReset();
+    gMCHOST_PlantInput.outputEnabled = true;
+
+    for( i = 0U; i < gMCHOST_Trace.length; i++ )
+    {
+        t = (float)i * param->deltaT;
+        speedRef = speedProfile( t );
+
+        /* Speed control */
+        iqRef = kSpeed * ( speedRef - gMCHOST_PlantState.omegaMech );
+        MCLIB_ImposeLimits( &iqRef, -MAX_MOTOR_CURRENT, MAX_MOTOR_CURRENT );
+
+        /* Current control with back EMF and cross coupling feed forward, no d-axis current */
+        omegaElec = param->polePairs * gMCHOST_PlantState.omegaMech;
+        ud = -kCurrent * gMCHOST_PlantState.id - omegaElec * param->lq * gMCHOST_PlantState.iq;
+        uq = ( param->rs * iqRef ) + ( kCurrent * ( iqRef - gMCHOST_PlantState.iq ) )
+           + ( omegaElec * ( ( param->ld * gMCHOST_PlantState.id ) + param->fluxLinkage ) );
+        amplitude = sqrtf( ( ud * ud ) + ( uq * uq ) );
+        if( amplitude > umax )
+        {
+            ud *= umax / amplitude;
+            uq *= umax / amplitude;
+        }
+        sine = sinf( gMCHOST_PlantState.thetaElec );
+        cosine = cosf( gMCHOST_PlantState.thetaElec );
+        ualpha = ( ud * cosine ) - ( uq * sine );
+        ubeta = ( ud * sine ) + ( uq * cosine );
+
+        /* Signals of the period */
+        record = &gMCHOST_Trace.record[i];
+        record->ialpha = gMCHOST_PlantOutput.iu;
+        record->ibeta = ( gMCHOST_PlantOutput.iu * ONE_BY_SQRT3 ) + ( gMCHOST_PlantOutput.iv * TWO_BY_SQRT3 );
+        record->ualpha = ualpha / umax;
+        record->ubeta = ubeta / umax;
+        record->umax = umax;
+        record->rhoOffset = 0.0f;
+        record->controlAngle = 0.0f;
+        record->closedLoop = 1U;
+        record->speedRef = param->polePairs * speedRef;
+
+        /* Min-max modulation of the voltage vector */
+        uu = ualpha;
+        uv = ( -0.5f * ualpha ) + ( SQRT3_BY2 * ubeta );
+        uw = -uu - uv;
+        zero = 0.5f * ( fmaxf( uu, fmaxf( uv, uw ) ) + fminf( uu, fminf( uv, uw ) ) );
+        gMCHOST_PlantInput.dutyU = 0.5f + ( ( uu - zero ) / param->udc );
+        gMCHOST_PlantInput.dutyV = 0.5f + ( ( uv - zero ) / param->udc );
+        gMCHOST_PlantInput.dutyW = 0.5f + ( ( uw - zero ) / param->udc );
+        MCHOST_PlantStep();
+        record->rotorAngle = gMCHOST_PlantState.thetaElec;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_TraceRead                                            */
+/* Function parameters: file name                                             */
+/* Function return: 0 on success                                              */
+/* Description: Loads a trace written by mc_host_sim --record                 */
+/******************************************************************************/
+int MCHOST_TraceRead( const char * const fileName )
+{
+    tMCHOST_TRACE_HEADER_S header;
+    FILE * file;
+    long size;
+
+    file = fopen( fileName, "rb" );
+    if( NULL == file )
+    {
+        perror( fileName );
+        return -1;
+    }
+    if( ( 1U != fread( &header, sizeof( header ), 1U, file ) )
+     || ( MCHOST_TRACE_MAGIC != header.magic ) || ( sizeof( tMCHOST_TRACE_RECORD_S ) != header.recordSize ) )
+    {
+        fprintf( stderr, "%s: not an estimator trace of this host\n", fileName );
+        fclose( file );
+        return -1;
+    }
+
+    fseek( file, 0L, SEEK_END );
+    size = ftell( file ) - (long)sizeof( header );
+    fseek( file, (long)sizeof( header ), SEEK_SET );
+    if( 0 != MCHOST_TraceAllocate( (uint32_t)( size / (long)sizeof( tMCHOST_TRACE_RECORD_S ) ) ) )
+    {
+        fclose( file );
+        return -1;
+    }
+    if( gMCHOST_Trace.length != fread( gMCHOST_Trace.record, sizeof( tMCHOST_TRACE_RECORD_S ), gMCHOST_Trace.length, file ) )
+    {
+        fprintf( stderr, "%s: read error\n", fileName );
+        fclose( file );
+        return -1;
+    }
+    fclose( file );
+    gMCHOST_Trace.deltaT = header.deltaT;
+    gMCHOST_Trace.rotorAngle = true;
+    gMCHOST_Trace.speedRef = true;
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_TraceReadCsv                                         */
+/* Function parameters: file name                                             */
+/* Function return: 0 on success                                              */
+/* Description: Loads a CSV trace with the columns of gMCHOST_TraceCsvColumn. */
+/*              The currents and voltages are required, the other signals     */
+/*              are optional                                                  */
+/******************************************************************************/
+int MCHOST_TraceReadCsv( const char * const fileName )
+{
+    static char line[MCHOST_TRACE_CSV_LINE];
+    int column[MCHOST_TRACE_CSV_SIGNALS];
+    float value[MCHOST_TRACE_CSV_SIGNALS];
+    double firstTime = 0.0, lastTime = 0.0;
+    tMCHOST_TRACE_RECORD_S * record;
+    uint32_t length = 0U, capacity = 0U, lineNumber = 1U;
+    char * field, * save;
+    int signal, index, result = 0;
+    FILE * file;
+
+    file = fopen( fileName, "r" );
+    if( NULL == file )
+    {
+        perror( fileName );
+        return -1;
+    }
+    if( NULL == fgets( line, sizeof( line ), file ) )
+    {
+        fprintf( stderr, "%s: empty file\n", fileName );
+        fclose( file );
+        return -1;
+    }
+
+    /* Columns of the signals in the header line */
+    for( signal = 0; signal < (int)MCHOST_TRACE_CSV_SIGNALS; signal++ )
+    {
+        column[signal] = -1;
+    }
+    for( index = 0, field = strtok_r( line, MCHOST_TRACE_CSV_SEPARATORS, &save ); NULL != field;
+         index++, field = strtok_r( NULL, MCHOST_TRACE_CSV_SEPARATORS, &save ) )
+    {
+        field = MCHOST_TraceCsvField( field );
+        for( signal = 0; signal < (int)MCHOST_TRACE_CSV_SIGNALS; signal++ )
+        {
+            if( ( -1 == column[signal] ) && ( 0 == strcmp( field, gMCHOST_TraceCsvColumn[signal] ) ) )
+            {
+                column[signal] = index;
+            }
+        }
+    }
+    for( signal = MCHOST_TRACE_CSV_IALPHA; signal <= MCHOST_TRACE_CSV_UBETA; signal++ )
+    {
+        if( -1 == column[signal] )
+        {
+            fprintf( stderr, "%s: no column %s\n", fileName, gMCHOST_TraceCsvColumn[signal] );
+            result = -1;
+        }
+    }
+    if( 0 != result )
+    {
+        fclose( file );
+        return -1;
+    }
+
+    free( gMCHOST_Trace.record );
+    memset( &gMCHOST_Trace, 0, sizeof( gMCHOST_Trace ) );
+    while( NULL != fgets( line, sizeof( line ), file ) )
+    {
+        lineNumber++;
+        memset( value, 0, sizeof( value ) );
+        for( index = 0, field = strtok_r( line, MCHOST_TRACE_CSV_SEPARATORS, &save ); NULL != field;
+             index++, field = strtok_r( NULL, MCHOST_TRACE_CSV_SEPARATORS, &save ) )
+        {
+            for( signal = 0; signal < (int)MCHOST_TRACE_CSV_SIGNALS; signal++ )
+            {
+                if( index == column[signal] )
+                {
+                    value[signal] = strtof( MCHOST_TraceCsvField( field ), NULL );
+                }
+            }
+        }
+        if( index <= column[MCHOST_TRACE_CSV_UBETA] )
+        {
+            /* Blank or truncated line */
+            continue;
+        }
+
+        if( length == capacity )
+        {
+            capacity = ( 0U == capacity ) ? 65536U : ( 2U * capacity );
+            record = realloc( gMCHOST_Trace.record, ( capacity + 1U ) * sizeof( tMCHOST_TRACE_RECORD_S ) );
+            if( NULL == record )
+            {
+                fprintf( stderr, "out of memory\n" );
+                fclose( file );
+                return -1;
+            }
+            gMCHOST_Trace.record = record;
+        }
+
+        /* Voltages in volts, the estimators see them relative to a limit of 1 V */
+        record = &gMCHOST_Trace.record[length];
+        memset( record, 0, sizeof( tMCHOST_TRACE_RECORD_S ) );
+        record->ialpha = value[MCHOST_TRACE_CSV_IALPHA];
+        record->ibeta = value[MCHOST_TRACE_CSV_IBETA];
+        record->ualpha = value[MCHOST_TRACE_CSV_UALPHA];
+        record->ubeta = value[MCHOST_TRACE_CSV_UBETA];
+        record->umax = 1.0f;
+        record->closedLoop = 1U;
+        record->rotorAngle = value[MCHOST_TRACE_CSV_ANGLE];
+        record->speedRef = value[MCHOST_TRACE_CSV_SPEED_REF] * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+        if( 0U == length )
+        {
+            firstTime = (double)value[MCHOST_TRACE_CSV_TIME];
+        }
+        lastTime = (double)value[MCHOST_TRACE_CSV_TIME];
+        length++;
+    }
+    fclose( file );
+
+    if( 2U > length )
+    {
+        fprintf( stderr, "%s: less than two PWM periods\n", fileName );
+        return -1;
+    }
+    memset( &gMCHOST_Trace.record[length], 0, sizeof( tMCHOST_TRACE_RECORD_S ) );
+    gMCHOST_Trace.length = length;
+    gMCHOST_Trace.deltaT = ( -1 != column[MCHOST_TRACE_CSV_TIME] ) ? (float)( ( lastTime - firstTime ) / (double)( length - 1U ) )
+                                                                    : FAST_LOOP_TIME_SEC;
+    gMCHOST_Trace.rotorAngle = ( -1 != column[MCHOST_TRACE_CSV_ANGLE] );
+    gMCHOST_Trace.speedRef = ( -1 != column[MCHOST_TRACE_CSV_SPEED_REF] );
+    return 0;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_TraceSpeedFromAngle                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Speed reference of a trace without one, the filtered rate of  */
+/*              change of the rotor angle                                     */
+/******************************************************************************/
+void MCHOST_TraceSpeedFromAngle( void )
+{
+    const float k = gMCHOST_Trace.deltaT / ( MCHOST_TRACE_SPEED_FILTER_TIME + gMCHOST_Trace.deltaT );
+    float speed = 0.0f, change;
+    uint32_t i;
+
+    if( gMCHOST_Trace.speedRef || !gMCHOST_Trace.rotorAngle )
+    {
+        return;
+    }
+    for( i = 1U; i < gMCHOST_Trace.length; i++ )
+    {
+        change = gMCHOST_Trace.record[i].rotorAngle - gMCHOST_Trace.record[i - 1U].rotorAngle;
+        change -= ( 2.0f * (float)M_PI ) * floorf( ( change / ( 2.0f * (float)M_PI ) ) + 0.5f );
+        speed += ( ( change / gMCHOST_Trace.deltaT ) - speed ) * k;
+        gMCHOST_Trace.record[i].speedRef = speed;
+    }
+    gMCHOST_Trace.record[0].speedRef = gMCHOST_Trace.record[1].speedRef;
+    gMCHOST_Trace.speedRef = true;
+}
+
+/*******************************************************************************
+ End of File
+*/
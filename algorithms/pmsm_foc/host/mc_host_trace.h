@@ -0,0 +1,158 @@
+/*******************************************************************************
+ Estimator Input Trace interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_trace.h
+
+  Summary:
+    Binary trace of the rotor position estimator inputs
+
+  Description:
+    This file contains the record layout of the estimator traces written by
+    mc_host_sim --record and replayed by mc_host_pll and mc_host_replay. A
+    trace file is a tMCHOST_TRACE_HEADER_S followed by one
+    tMCHOST_TRACE_RECORD_S per PWM period, in the byte order of the host
+    which wrote it. The record holds the signals which
+    MCRPOS_ReadInputSignals copies in that period and the control signals the
+    estimator depends on at its start. mc_host_trace.c loads these files and
+    CSV captures into the same records, or records a trace from the plant
+    model.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MCHOST_TRACE_H    // Guards against multiple inclusion
+#define MCHOST_TRACE_H
+
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+/*  This section lists the other files that are included in this file.
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_TRACE_MAGIC                     (0x5243544DU)        /* "MTCR" */
+
+typedef struct
+{
+    uint32_t                        magic;              /* MCHOST_TRACE_MAGIC                              */
+    uint32_t                        recordSize;         /* sizeof( tMCHOST_TRACE_RECORD_S )                */
+    float                           deltaT;             /* PWM period (s)                                  */
+    uint32_t                        reserved;
+}tMCHOST_TRACE_HEADER_S;
+
+typedef struct
+{
+    float                           ialpha;             /* Alpha-beta current (A)                          */
+    float                           ibeta;
+    float                           ualpha;             /* Alpha-beta voltage reference, relative to umax  */
+    float                           ubeta;
+    float                           umax;               /* Phase voltage limit (V)                         */
+    float                           rhoOffset;          /* Estimator angle offset                          */
+    float                           controlAngle;       /* Control angle of the previous period            */
+    float                           rotorAngle;         /* Electrical rotor angle at the end of the period */
+    uint32_t                        closedLoop;         /* Control angle is the estimated angle            */
+    float                           speedRef;           /* Electrical speed reference (rad/s)              */
+}tMCHOST_TRACE_RECORD_S;
+
+/* Loaded trace */
+typedef struct
+{
+    tMCHOST_TRACE_RECORD_S *        record;
+    uint32_t                        length;             /* Number of records                               */
+    float                           deltaT;             /* PWM period (s)                                  */
+    bool                            rotorAngle;         /* rotorAngle holds a measured angle               */
+    bool                            speedRef;           /* speedRef holds a speed reference                */
+}tMCHOST_TRACE_S;
+
+/* Signals of a CSV trace */
+typedef enum
+{
+    MCHOST_TRACE_CSV_TIME,
+    MCHOST_TRACE_CSV_IALPHA,
+    MCHOST_TRACE_CSV_IBETA,
+    MCHOST_TRACE_CSV_UALPHA,
+    MCHOST_TRACE_CSV_UBETA,
+    MCHOST_TRACE_CSV_ANGLE,
+    MCHOST_TRACE_CSV_SPEED_REF,
+    MCHOST_TRACE_CSV_SIGNALS
+}tMCHOST_TRACE_CSV_SIGNAL_E;
+
+/* Mechanical speed reference (rad/s) of a recording over time (s) */
+typedef float ( *tMCHOST_TRACE_SPEED_PROFILE_F )( const float t );
+
+extern tMCHOST_TRACE_S                  gMCHOST_Trace;
+extern const char *                     gMCHOST_TraceCsvColumn[MCHOST_TRACE_CSV_SIGNALS];
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+int MCHOST_TraceRecord( void );
+int MCHOST_TraceRecordProfile( const tMCHOST_TRACE_SPEED_PROFILE_F speedProfile, const float time );
+int MCHOST_TraceRead( const char * const fileName );
+int MCHOST_TraceReadCsv( const char * const fileName );
+void MCHOST_TraceSpeedFromAngle( void );
+
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif //MCHOST_TRACE_H
+
+/**
+ End of File
+*/
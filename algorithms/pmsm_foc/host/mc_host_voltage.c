@@ -0,0 +1,357 @@
+/*******************************************************************************
+ Stator Voltage Reconstruction Host Test source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_host_voltage.c
+
+  Summary:
+    Compares the reconstructed and the commanded stator voltage with the plant
+
+  Description:
+    This file contains the host test of the stator voltage reconstruction. The
+    plant inverter loses the dead time in the direction of every phase
+    current and its DC bus ripples at the given frequency. The motor is run
+    at low speed, where the dead time is a large part of the stator voltage,
+    and at high modulation, where the modulation follows the bus ripple. In
+    every PWM period the voltage which MCRPOS_ReadInputSignals copies, which
+    is the reconstructed voltage, and the voltage reference scaled by the
+    measured DC bus, which the estimator used before, are compared with the
+    voltage the plant applied in that period. The errors are RMS values
+    relative to the RMS applied voltage. The angle error compares the
+    estimated angle with the rotor angle at the current sampling, the target
+    enables the PLL speed scheduling so that the lag of the estimator does
+    not hide the voltage error. The result fails if the motor leaves the
+    closed loop, the reconstruction does not reduce the voltage error or the
+    angle error exceeds the limit at either speed.
+
+    Usage: mc_host_voltage [options]
+      --ripple <ratio>        peak DC bus ripple relative to the DC bus (default 0.1)
+      --frequency <Hz>        DC bus ripple frequency (default 100)
+      --load <Nm>             load torque (default 0.01)
+      --time <s>              measurement time (default 1)
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_pmsm_foc.h"
+#include "mc_control_loop.h"
+#include "mc_rotorposition.h"
+#include "mc_voltagemeasurement.h"
+#include "mc_speed.h"
+#include "mc_pwm.h"
+#include "mc_lib.h"
+#include "mc_hal.h"
+#include "mc_host_plant.h"
+#include "math.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     MCHOST_RPM_TO_RAD_PER_SEC_ELEC          (float)((2.0f * (float)M_PI / 60.0f) * NUM_POLE_PAIRS)
+#define     MCHOST_CALIBRATION_TICKS                (2U * CURRENTS_OFFSET_SAMPLES)
+
+/* Time from the start to the measurement: alignment, open loop ramp and closed loop settling */
+#define     MCHOST_SETTLE_TIME_SEC                  (10.0f)
+
+/* Low speed, just above the end of the open loop startup */
+#define     MCHOST_VOLTAGE_LOW_SPEED_RPM            ( 1.2f * (float)OPEN_LOOP_END_SPEED_RPM )
+
+/* High modulation, back EMF relative to the phase voltage limit at the bottom of the bus ripple */
+#define     MCHOST_VOLTAGE_MODULATION               (0.85f)
+
+/* RMS angle error limit, the commanded voltage misses it by the dead time at low speed */
+#define     MCHOST_VOLTAGE_ANGLE_LIMIT_DEG          (3.0f)
+
+#if (ENABLED != VOLTAGE_RECONSTRUCTION)
+#error "mc_host_voltage tests the stator voltage reconstruction, enable VOLTAGE_RECONSTRUCTION"
+#endif
+
+typedef struct
+{
+    float                           ripple;
+    float                           frequency;
+    float                           load;
+    float                           time;
+}tMCHOST_VOLTAGE_PARAM_S;
+
+typedef struct
+{
+    bool                            closedLoop;
+    float                           speed;              /* Speed reference (rpm)                            */
+    float                           voltage;            /* RMS applied voltage (V)                          */
+    float                           referenceError;     /* RMS error of the scaled voltage reference        */
+    float                           reconstructionError;/* RMS error of the reconstructed voltage           */
+    float                           angleError;         /* RMS angle estimation error (rad)                 */
+}tMCHOST_VOLTAGE_RESULT_S;
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCHOST_VoltageTick( void );
+static void MCHOST_VoltageRun( const float speed, tMCHOST_VOLTAGE_RESULT_S * const pResult );
+static void MCHOST_VoltageReport( const char * name, const tMCHOST_VOLTAGE_RESULT_S * const pResult );
+static int MCHOST_ParseArguments( int argc, char * argv[] );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static tMCHOST_VOLTAGE_PARAM_S      gMCHOST_VoltageParam;
+static uint64_t                     gMCHOST_Tick;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCHOST_VoltageTick                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: One PWM period: ADC conversion, control interrupt, main loop  */
+/*              tasks and plant update. The ADC samples the DC bus at the     */
+/*              start of the period, the plant applies its mean.              */
+/******************************************************************************/
+static void MCHOST_VoltageTick( void )
+{
+    const float t = (float)gMCHOST_Tick * FAST_LOOP_TIME_SEC;
+    const float omega = 2.0f * (float)M_PI * gMCHOST_VoltageParam.frequency;
+    const float ripple = DC_BUS_VOLTAGE * gMCHOST_VoltageParam.ripple;
+
+    MCHOST_ADCConversion( gMCHOST_PlantOutput.iu, gMCHOST_PlantOutput.iv, DC_BUS_VOLTAGE + ( ripple * sinf( omega * t ) ),
+                          0.0f );
+    MCHOST_ADCInterrupt();
+    PMSM_FOC_Tasks();
+
+    MCHOST_PWMDutyGet( &gMCHOST_PlantInput.dutyU, &gMCHOST_PlantInput.dutyV, &gMCHOST_PlantInput.dutyW );
+    gMCHOST_PlantInput.outputEnabled = MCHOST_PWMOutputIsEnabled();
+    gMCHOST_PlantParam.udc = DC_BUS_VOLTAGE + ( ripple * sinf( omega * ( t + ( 0.5f * FAST_LOOP_TIME_SEC ) ) ) );
+    MCHOST_PlantStep();
+    gMCHOST_Tick++;
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_VoltageRun                                           */
+/* Function parameters: speed - speed reference (rpm), pResult - run          */
+/* Function return: None                                                      */
+/* Description: Starts the motor from standstill, measures after the         */
+/*              settling time and stops the motor again                       */
+/******************************************************************************/
+static void MCHOST_VoltageRun( const float speed, tMCHOST_VOLTAGE_RESULT_S * const pResult )
+{
+    uint64_t tick, ticks = (uint64_t)( MCHOST_SETTLE_TIME_SEC / FAST_LOOP_TIME_SEC );
+    double voltageSqr = 0.0, referenceErrorSqr = 0.0, reconstructionErrorSqr = 0.0, angleErrorSqr = 0.0;
+    double angleError, samples;
+    float ualpha, ubeta, valpha, vbeta, ealpha, ebeta, theta;
+
+    memset( pResult, 0, sizeof( *pResult ) );
+    pResult->speed = speed;
+    MCHOST_PlantReset();
+    gMCHOST_PlantInput.loadTorque = gMCHOST_VoltageParam.load;
+    gMCSPE_InputSignals.speedRef = speed * MCHOST_RPM_TO_RAD_PER_SEC_ELEC;
+    PMSM_FOC_MotorStart();
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        MCHOST_VoltageTick();
+    }
+
+    ticks = (uint64_t)( gMCHOST_VoltageParam.time / FAST_LOOP_TIME_SEC );
+    for( tick = 0U; tick < ticks; tick++ )
+    {
+        /* Voltage applied by the plant, voltage reference and rotor angle at the current sampling */
+        ualpha = gMCHOST_PlantOutput.ualpha;
+        ubeta = gMCHOST_PlantOutput.ubeta;
+        valpha = gMCLIB_VoltageAlphaBeta.alphaAxis;
+        vbeta = gMCLIB_VoltageAlphaBeta.betaAxis;
+        theta = gMCHOST_PlantState.thetaElec;
+        MCHOST_VoltageTick();
+
+        voltageSqr += (double)( ( ualpha * ualpha ) + ( ubeta * ubeta ) );
+        ealpha = ( gMCVOL_OutputSignals.umax * valpha ) - ualpha;
+        ebeta = ( gMCVOL_OutputSignals.umax * vbeta ) - ubeta;
+        referenceErrorSqr += (double)( ( ealpha * ealpha ) + ( ebeta * ebeta ) );
+        ealpha = ( gMCRPOS_InputSignals.umax * gMCRPOS_InputSignals.ualpha ) - ualpha;
+        ebeta = ( gMCRPOS_InputSignals.umax * gMCRPOS_InputSignals.ubeta ) - ubeta;
+        reconstructionErrorSqr += (double)( ( ealpha * ealpha ) + ( ebeta * ebeta ) );
+        angleError = (double)MCHOST_AngleDifference( gMCRPOS_OutputSignals.angle, theta );
+        angleErrorSqr += angleError * angleError;
+    }
+    gMCHOST_PlantInput.loadTorque = 0.0f;
+
+    samples = (double)ticks;
+    pResult->closedLoop = ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState );
+    pResult->voltage = (float)sqrt( voltageSqr / samples );
+    pResult->referenceError = (float)sqrt( referenceErrorSqr / voltageSqr );
+    pResult->reconstructionError = (float)sqrt( reconstructionErrorSqr / voltageSqr );
+    pResult->angleError = (float)sqrt( angleErrorSqr / samples );
+
+    PMSM_FOC_MotorStop();
+    MCHOST_VoltageTick();
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_VoltageReport                                        */
+/* Function parameters: name - run, pResult - voltage run                     */
+/* Function return: None                                                      */
+/* Description: One line of the voltage table                                 */
+/******************************************************************************/
+static void MCHOST_VoltageReport( const char * name, const tMCHOST_VOLTAGE_RESULT_S * const pResult )
+{
+    printf( "%-28s : %6.0f rpm %7.3f V %8.2f %% %8.2f %% %8.3f deg%s\n", name, pResult->speed, pResult->voltage,
+            100.0f * pResult->referenceError, 100.0f * pResult->reconstructionError,
+            pResult->angleError * ( 180.0f / (float)M_PI ), pResult->closedLoop ? "" : " (not in closed loop)" );
+}
+
+/******************************************************************************/
+/* Function name: MCHOST_ParseArguments                                       */
+/* Function parameters: argc, argv - command line                             */
+/* Function return: 0 on success                                              */
+/* Description: Command line options                                          */
+/******************************************************************************/
+static int MCHOST_ParseArguments( int argc, char * argv[] )
+{
+    static const struct option options[] =
+    {
+        { "ripple",             required_argument, NULL, 'r' },
+        { "frequency",          required_argument, NULL, 'f' },
+        { "load",               required_argument, NULL, 'l' },
+        { "time",               required_argument, NULL, 't' },
+        { NULL,                 0,                 NULL,  0  }
+    };
+    int option;
+
+    gMCHOST_VoltageParam.ripple = 0.1f;
+    gMCHOST_VoltageParam.frequency = 100.0f;
+    gMCHOST_VoltageParam.load = 0.01f;
+    gMCHOST_VoltageParam.time = 1.0f;
+
+    while( -1 != ( option = getopt_long( argc, argv, "", options, NULL ) ) )
+    {
+        switch( option )
+        {
+            case 'r': gMCHOST_VoltageParam.ripple = strtof( optarg, NULL ); break;
+            case 'f': gMCHOST_VoltageParam.frequency = strtof( optarg, NULL ); break;
+            case 'l': gMCHOST_VoltageParam.load = strtof( optarg, NULL ); break;
+            case 't': gMCHOST_VoltageParam.time = strtof( optarg, NULL ); break;
+            default:
+            {
+                fprintf( stderr, "usage: %s [--ripple ratio] [--frequency Hz] [--load Nm] [--time s]\n", argv[0] );
+                return -1;
+            }
+        }
+    }
+    if( ( gMCHOST_VoltageParam.ripple < 0.0f ) || ( gMCHOST_VoltageParam.ripple > 0.5f ) )
+    {
+        fprintf( stderr, "--ripple must be within 0 and 0.5\n" );
+        return -1;
+    }
+    if( ( gMCHOST_VoltageParam.frequency < 0.0f ) || ( gMCHOST_VoltageParam.time <= 0.0f ) )
+    {
+        fprintf( stderr, "--frequency must not be negative and --time must be positive\n" );
+        return -1;
+    }
+    return 0;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    tMCHOST_VOLTAGE_RESULT_S lowSpeedRun, highSpeedRun;
+    float highSpeed;
+    uint64_t tick;
+    int result = 0;
+
+    if( 0 != MCHOST_ParseArguments( argc, argv ) )
+    {
+        return 2;
+    }
+
+    MCHOST_HalInitialize( PWM_FREQUENCY );
+    MCHOST_PlantInitialize();
+    gMCHOST_PlantParam.deadTime = PWM_DEAD_TIME_SEC;
+    gMCHOST_PlantParam.switchDrop = SWITCH_VOLTAGE_DROP;
+    gMCHOST_PlantParam.rippleCurrent = DEADTIME_COMP_CURRENT_BAND;
+    PMSM_FOC_Initialize();
+
+    /* Current sensor offset calibration with the inverter off */
+    for( tick = 0U; tick < MCHOST_CALIBRATION_TICKS; tick++ )
+    {
+        MCHOST_VoltageTick();
+    }
+
+    highSpeed = MCHOST_VOLTAGE_MODULATION * ( 1.0f - gMCHOST_VoltageParam.ripple ) * DC_BUS_VOLTAGE * ONE_BY_SQRT3
+              / MOTOR_BEMF_CONST_V_PEAK_PHASE_PER_RPM_MECH;
+    highSpeed = fminf( highSpeed, MAX_SPEED_RPM );
+    MCHOST_VoltageRun( MCHOST_VOLTAGE_LOW_SPEED_RPM, &lowSpeedRun );
+    MCHOST_VoltageRun( highSpeed, &highSpeedRun );
+
+    printf( "Stator voltage reconstruction\n" );
+    printf( "%-28s : %.2f us, %.2f V, %.3f A ripple\n", "Plant inverter", 1.0e6f * gMCHOST_PlantParam.deadTime,
+            gMCHOST_PlantParam.switchDrop, gMCHOST_PlantParam.rippleCurrent );
+    printf( "%-28s : %.1f V +/- %.1f %% at %.0f Hz\n", "Plant DC bus", DC_BUS_VOLTAGE, 100.0f * gMCHOST_VoltageParam.ripple,
+            gMCHOST_VoltageParam.frequency );
+    printf( "%-28s : %.4f N m\n", "Load", gMCHOST_VoltageParam.load );
+    printf( "%-28s : %10s %9s %10s %10s %12s\n", "Run", "speed", "voltage", "reference", "rebuilt", "angle error" );
+    MCHOST_VoltageReport( "low speed", &lowSpeedRun );
+    MCHOST_VoltageReport( "high modulation", &highSpeedRun );
+
+    /* Written to fail also on a diverged, not a number, result */
+    if( !lowSpeedRun.closedLoop || !highSpeedRun.closedLoop )
+    {
+        result = 1;
+    }
+    if( !( lowSpeedRun.reconstructionError < lowSpeedRun.referenceError )
+     || !( highSpeedRun.reconstructionError < highSpeedRun.referenceError ) )
+    {
+        result = 1;
+    }
+    if( !( lowSpeedRun.angleError < ( MCHOST_VOLTAGE_ANGLE_LIMIT_DEG * (float)M_PI / 180.0f ) )
+     || !( highSpeedRun.angleError < ( MCHOST_VOLTAGE_ANGLE_LIMIT_DEG * (float)M_PI / 180.0f ) ) )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
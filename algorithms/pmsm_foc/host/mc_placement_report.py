@@ -0,0 +1,155 @@
+# coding: utf-8
+"""*****************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*****************************************************************************"""
+
+###################################################################################################
+########################### Hot path placement report #############################################
+###################################################################################################
+#
+# Reads the symbol table of a linked image, looks up the functions and data of the hot path profile
+# (mcPmsmFocPlacementProfileDict in config/pmsm_foc.py) and reports where they are placed. For the
+# code the flash wait state stalls per PWM period are estimated as
+#
+#   calls * ceil(size / flash line) * wait states
+#
+# which is the cost of fetching the whole function once from flash without cache or prefetch hits,
+# an upper bound for the mostly straight line code of the control interrupt. The stalls of the
+# functions in RAM or TCM are avoided, the others remain.
+#
+#   python3 mc_placement_report.py [--series SAME70] [--pwm-freq 20000] [--userparams <mc_userparams.h>] <image>
+#
+# With the generated mc_userparams.h only the entries whose IF condition holds are reported,
+# otherwise all entries found in the image.
+# The symbol table is read with $OBJDUMP (default objdump), xc32-objdump for the target images.
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+
+from mc_host_build import mcHostLoadConfigDicts
+
+# Sections of code and data moved out of flash or system RAM
+mcPlacementSection = re.compile(r'ramfunc|tcm', re.IGNORECASE)
+
+def mcPlacementSymbols(image):
+    symbols = {}
+    output = subprocess.check_output([os.environ.get("OBJDUMP", "objdump"), "-t", image])
+    for line in output.decode().splitlines():
+        parts = line.split("\t")
+        if len(parts) != 2 or len(parts[0].split()) < 3:
+            continue
+        section = parts[0].split()[-1]
+        fields = parts[1].split()
+        if len(fields) < 2:
+            continue
+        symbols[fields[-1]] = (section, int(fields[0], 16))
+    return symbols
+
+def mcPlacementDefines(userparams):
+    # Object like macros of mc_pmsm_foc_common.h and mc_userparams.h with a numeric or symbolic value
+    defines = {}
+    define = re.compile(r'^\s*#define\s+(\w+)\s+\(?\s*(\w+?)U?\s*\)?\s*(?:/[*/].*)?$')
+    for path in [os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "templates", "mc_pmsm_foc_common.h"), userparams]:
+        with open(path) as f:
+            for line in f:
+                match = define.match(line)
+                if match:
+                    defines[match.group(1)] = match.group(2)
+    return defines
+
+def mcPlacementCondition(condition, defines):
+    if not condition:
+        return True
+    expression = condition.replace("&&", " and ").replace("||", " or ")
+    for _ in range(4):
+        expression = re.sub(r'\b[A-Za-z_]\w*\b', lambda m: defines.get(m.group(0), m.group(0)) if m.group(0) not in ["and", "or", "not"] else m.group(0), expression)
+    return bool(eval(expression, {"__builtins__": {}}, {}))
+
+def main():
+    dicts = mcHostLoadConfigDicts()
+    parser = argparse.ArgumentParser(description = "Hot path placement report")
+    parser.add_argument("--series", default = "SAME70", choices = sorted(dicts['mcPmsmFocPlacementDict'].keys()), help = "device series")
+    parser.add_argument("--pwm-freq", type = float, default = float(dicts['mcPmsmFocMclv2PwmDict']['MCLV2']['SAME70']['PWM_FREQ']), help = "PWM frequency (Hz)")
+    parser.add_argument("--userparams", help = "generated mc_userparams.h of the image")
+    parser.add_argument("image", help = "linked image")
+    args = parser.parse_args()
+    defines = mcPlacementDefines(args.userparams) if args.userparams else None
+
+    device = dicts['mcPmsmFocPlacementDict'][args.series]
+    profile = dicts['mcPmsmFocPlacementProfileDict']
+    symbols = mcPlacementSymbols(args.image)
+    periodCycles = device['CPU_CLOCK'] / args.pwm_freq
+
+    print("Series %s, %d MHz, %d flash wait states, %d byte flash line, %.0f cycles per PWM period"
+          % (args.series, device['CPU_CLOCK'] // 1000000, device['FLASH_WAIT_STATES'], device['FLASH_LINE_BYTES'], periodCycles))
+    print("%-30s %-10s %6s %5s %7s %8s %8s" % ("Function", "Section", "Bytes", "Calls", "Budget", "Stalls", "Placed"))
+
+    codeBytes = 0
+    avoided = 0
+    remaining = 0
+    for entry in profile['CODE']:
+        if entry['NAME'] not in symbols:
+            continue
+        if defines is not None and not mcPlacementCondition(entry['IF'], defines):
+            continue
+        section, size = symbols[entry['NAME']]
+        placed = mcPlacementSection.search(section) is not None
+        lines = (size + device['FLASH_LINE_BYTES'] - 1) // device['FLASH_LINE_BYTES']
+        stalls = entry['CALLS'] * lines * device['FLASH_WAIT_STATES']
+        if placed:
+            codeBytes += size
+            avoided += stalls
+        else:
+            remaining += stalls
+        print("%-30s %-10s %6d %5d %7d %8d %8s" % (entry['NAME'], section, size, entry['CALLS'], entry['BUDGET'], stalls, "yes" if placed else "no"))
+
+    print("%-30s %-10s %6s" % ("Data", "Section", "Bytes"))
+    dataBytes = 0
+    for entry in profile['DATA']:
+        if entry['NAME'] not in symbols:
+            continue
+        if defines is not None and not mcPlacementCondition(entry['IF'], defines):
+            continue
+        section, size = symbols[entry['NAME']]
+        if mcPlacementSection.search(section) is not None:
+            dataBytes += size
+        print("%-30s %-10s %6d" % (entry['NAME'], section, size))
+
+    result = 0
+    if codeBytes > device['CODE_BYTES']:
+        result = 1
+    if dataBytes > device['DATA_BYTES'] and dataBytes > 0:
+        result = 1
+    print("Placed code                  : %d of %d bytes" % (codeBytes, device['CODE_BYTES']))
+    print("Placed data                  : %d of %d bytes" % (dataBytes, device['DATA_BYTES']))
+    budget = profile['CODE'][0]['BUDGET']
+    print("Interrupt budget             : %d cycles, %.1f %% of the PWM period" % (budget, 100.0 * budget / periodCycles))
+    print("Flash stalls avoided         : %d cycles, %.1f %% of the PWM period" % (avoided, 100.0 * avoided / periodCycles))
+    print("Flash stalls remaining       : %d cycles, %.1f %% of the PWM period" % (remaining, 100.0 * remaining / periodCycles))
+    print("Result                       : %s" % ("PASS" if 0 == result else "FAIL"))
+    return result
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -58,7 +58,14 @@
 #include "mc_pwm.h"
 #include "mc_speed.h"
 #include "mc_picontrol.h"
+#include "mc_profiler.h"
+#include "mc_scheduler.h"
+#include "mc_parameters.h"
+#include "mc_identification.h"
+#include "mc_foc_kernel.h"
+#include "mc_foc_q14.h"
 #include "math.h"
+#include "mc_placement.h"
 
 
 /******************************************************************************/
@@ -84,11 +91,27 @@ static void MCCTRL_InitiaizeInfrastructure( void );
 
 #if (ENABLED == FIELD_WEAKENING )
 static void MCCTRL_InitializeFieldWeakening( void );
+#if (FIELD_WEAKENING_METHOD == FW_FEED_FORWARD)
 __STATIC_INLINE void MCCTRL_FieldWeakening(const tMCCTRL_FW_INPUT_SIGNALS_S  * const fieldWeakeningInput,
                                    tMCCTRL_FW_OUTPUT_SIGNALS_S * const fieldWeakeningOutput );
+#else
+__STATIC_INLINE void MCCTRL_FieldWeakeningVoltageLoop( const tMCCTRL_FW_INPUT_SIGNALS_S * const fieldWeakeningInput,
+                                                       tMCCTRL_FW_OUTPUT_SIGNALS_S * const fieldWeakeningOutput );
+#endif
+#if (FIELD_WEAKENING_METHOD == FW_MAP_VOLTAGE_LOOP)
+__STATIC_INLINE float MCCTRL_FieldWeakeningMap( const float speed, const float iqRef );
+#endif
 static void MCCTRL_ResetFieldWeakening( void );
 #endif
 
+#if (ENABLED == MTPA_CONTROL)
+__STATIC_INLINE float MCCTRL_MtpaIdref( const float iqRef );
+#endif
+
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+__STATIC_INLINE void MCCTRL_LoadObserver( const float speed, const float iq, const float iqMax );
+static void MCCTRL_ResetLoadObserver( const float speed );
+#endif
 
 /******************************************************************************/
 /*                   Global Variables                                         */
@@ -99,6 +122,32 @@ tMCCTRL_FW_INPUT_SIGNALS_S              gMCCTRL_FieldWeakeningInput;
 tMCCTRL_FW_OUTPUT_SIGNALS_S             gMCCTRL_FieldWeakeningOutput;
 tMCCTRL_FW_STATE_SIGNALS_S              gMCCTRL_FieldWeakeningState;
 tMCCTRL_FW_PARAM_S                      gMCCTRL_FieldWeakeningParam;
+#if (FIELD_WEAKENING_METHOD == FW_MAP_VOLTAGE_LOOP)
+/* Field weakening d-axis current at evenly spaced speeds from 0 to MAX_SPEED_RAD_PER_SEC_ELEC (rows) and
+   q-axis currents from 0 to MAX_MOTOR_CURRENT (columns), generated by mcPmsmFocFieldWeakeningMap in pmsm_foc.py */
+#define MCCTRL_FW_MAP_CURRENTS          (9U)
+const float gMCCTRL_FieldWeakeningMap[][MCCTRL_FW_MAP_CURRENTS] =
+{
+${MCPMSMFOC_FW_MAP}
+};
+#define MCCTRL_FW_MAP_SPEEDS            ( sizeof( gMCCTRL_FieldWeakeningMap ) / sizeof( gMCCTRL_FieldWeakeningMap[0] ) )
+#define MCCTRL_FW_MAP_POINTS_PER_RAD    (float)( (float)( MCCTRL_FW_MAP_SPEEDS - 1U ) / MAX_SPEED_RAD_PER_SEC_ELEC )
+#define MCCTRL_FW_MAP_POINTS_PER_AMP    (float)( (float)( MCCTRL_FW_MAP_CURRENTS - 1U ) / MAX_MOTOR_CURRENT )
+#endif
+#endif
+#if (ENABLED == MTPA_CONTROL)
+/* MTPA d-axis current at evenly spaced q-axis currents from 0 to MAX_MOTOR_CURRENT,
+   generated from Ld, Lq and the back EMF constant at configuration time */
+const float gMCCTRL_MtpaTable[] =
+{
+${MCPMSMFOC_MTPA_TABLE}
+};
+#define MCCTRL_MTPA_INTERVALS           ( ( sizeof( gMCCTRL_MtpaTable ) / sizeof( gMCCTRL_MtpaTable[0] ) ) - 1U )
+#define MCCTRL_MTPA_INTERVALS_PER_AMP   (float)( (float)MCCTRL_MTPA_INTERVALS / MAX_MOTOR_CURRENT )
+#endif
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+tMCCTRL_LOAD_OBSERVER_PARAM_S           gMCCTRL_LoadObserverParam;
+tMCCTRL_LOAD_OBSERVER_STATE_S           gMCCTRL_LoadObserverState;
 #endif
 <#if MCPMSMFOC_POSITION_FB != "SENSORED_ENCODER">
 tMCCTRL_CLOSING_LOOP_STATE_SIGNALS_S    gMCCTRL_ClosingLoopState;
@@ -151,6 +200,34 @@ tMCLIB_PICONTROLLER_S gMCLIB_SpeedPIController =
     .dSum = 0,
     .out = 0
 };
+#if (ENABLED == FIELD_WEAKENING) && (FIELD_WEAKENING_METHOD != FW_FEED_FORWARD)
+/* Field weakening voltage loop PI controller, executed with the speed controller. Its limits
+   are set before each execution */
+tMCLIB_PICONTROLLER_S gMCLIB_FieldWeakeningPIController =
+{
+    .kp = FW_VOLTAGE_LOOP_PTERM,
+    .ki = FW_VOLTAGE_LOOP_ITERM,
+    .kc = 0.5f,
+    .outMax = 0.0f,
+    .outMin = MAX_FW_NEGATIVE_ID_REF,
+    .dSum = 0,
+    .out = 0
+};
+#endif
+
+#if (ENABLED == FUSED_FOC_KERNEL)
+/* Signals and controllers of the fused current control kernel */
+const tMCFOC_KERNEL_S gMCCTRL_FocKernel =
+{
+    .pIdController = &gMCLIB_IdPIController,
+    .pIqController = &gMCLIB_IqPIController,
+    .pPosition = &gMCLIB_Position,
+    .pCurrentDQ = &gMCLIB_CurrentDQ,
+    .pVoltageDQ = &gMCLIB_VoltageDQ,
+    .pVoltageAlphaBeta = &gMCLIB_VoltageAlphaBeta,
+    .pSvm = &gMCPWM_SVPWM
+};
+#endif
 
 /*****************************************************************************/
 /*                   LOCAL FUNCTIONS                                         */
@@ -231,6 +308,8 @@ static void MCCTRL_InitializeFieldWeakening( void )
     gMCCTRL_FieldWeakeningParam.rs              =     MOTOR_PER_PHASE_RESISTANCE ;
     gMCCTRL_FieldWeakeningParam.fs              =     PWM_FREQUENCY;
     gMCCTRL_FieldWeakeningParam.idmax           =     MAX_FW_NEGATIVE_ID_REF;
+    gMCCTRL_FieldWeakeningParam.uRef            =     FW_VOLTAGE_MARGIN * MAX_STATOR_VOLT;
+    gMCCTRL_FieldWeakeningParam.invTwoURef      =     0.5f / gMCCTRL_FieldWeakeningParam.uRef;
 
     /* Reset the state variables of field weakening */
     gMCCTRL_FieldWeakeningState.uQrefFilt       =     0.0f;
@@ -239,7 +318,7 @@ static void MCCTRL_InitializeFieldWeakening( void )
 
 }
 
-
+#if (FIELD_WEAKENING_METHOD == FW_FEED_FORWARD)
 /******************************************************************************/
 /* Function name: MCCTRL_FieldWeakening                                       */
 /* Function parameters:  tMCCTRL_FW_INPUT_SIGNALS_S input                     */
@@ -296,6 +375,82 @@ __STATIC_INLINE void MCCTRL_FieldWeakening( const tMCCTRL_FW_INPUT_SIGNALS_S * c
         fieldWeakeningOutput->idref = 0;
     }
 }
+#else
+/******************************************************************************/
+/* Function name: MCCTRL_FieldWeakeningVoltageLoop                            */
+/* Function parameters:  tMCCTRL_FW_INPUT_SIGNALS_S input                     */
+/*                       tMCCTRL_FW_OUTPUT_SIGNALS_S output                   */
+/* Function return: None                                                      */
+/* Description: Field weakening by PI control of the voltage margin: the      */
+/*              d-axis current decreases while the voltage magnitude exceeds  */
+/*              its reference. The error (uRef^2 - |u|^2) / (2 uRef) is       */
+/*              uRef - |u| close to the reference and needs no square root,   */
+/*              and no motor parameter is used. With the map the controller   */
+/*              only trims the d-axis current of the map.                     */
+/******************************************************************************/
+__STATIC_INLINE void MCCTRL_FieldWeakeningVoltageLoop( const tMCCTRL_FW_INPUT_SIGNALS_S * const fieldWeakeningInput,
+                                                       tMCCTRL_FW_OUTPUT_SIGNALS_S * const fieldWeakeningOutput )
+{
+    float idMap = 0.0f;
+    float uSquare = ( fieldWeakeningInput->ud * fieldWeakeningInput->ud ) + ( fieldWeakeningInput->uq * fieldWeakeningInput->uq );
+
+#if (FIELD_WEAKENING_METHOD == FW_MAP_VOLTAGE_LOOP)
+    /* The map follows the filtered q-axis reference, so that a step of the speed
+       controller output does not step the d-axis current past the voltage limit */
+    gMCCTRL_FieldWeakeningState.iQrefFilt += KFILTER_POT
+                                           * ( fieldWeakeningInput->iqref - gMCCTRL_FieldWeakeningState.iQrefFilt );
+    idMap = MCCTRL_FieldWeakeningMap( fieldWeakeningInput->ws, gMCCTRL_FieldWeakeningState.iQrefFilt );
+#endif
+
+    /* The sum with the map stays within the maximum negative d-axis current and zero */
+    gMCLIB_FieldWeakeningPIController.outMax = -idMap;
+    gMCLIB_FieldWeakeningPIController.outMin = gMCCTRL_FieldWeakeningParam.idmax - idMap;
+
+    gMCLIB_FieldWeakeningPIController.inRef  = 0.5f * gMCCTRL_FieldWeakeningParam.uRef;
+    gMCLIB_FieldWeakeningPIController.inMeas = uSquare * gMCCTRL_FieldWeakeningParam.invTwoURef;
+    MCLIB_PIControl( &gMCLIB_FieldWeakeningPIController );
+
+    fieldWeakeningOutput->idref = idMap + gMCLIB_FieldWeakeningPIController.out;
+}
+#endif
+
+#if (FIELD_WEAKENING_METHOD == FW_MAP_VOLTAGE_LOOP)
+/******************************************************************************/
+/* Function name: MCCTRL_FieldWeakeningMap                                    */
+/* Function parameters: speed - electrical speed magnitude (rad/s)            */
+/*                      iqRef - q-axis reference current magnitude            */
+/* Function return: d-axis reference current of the map                       */
+/* Description: Bilinear interpolation of the field weakening map, limited to */
+/*              its last row and column                                       */
+/******************************************************************************/
+__STATIC_INLINE float MCCTRL_FieldWeakeningMap( const float speed, const float iqRef )
+{
+    float speedPosition = speed * MCCTRL_FW_MAP_POINTS_PER_RAD;
+    float currentPosition = iqRef * MCCTRL_FW_MAP_POINTS_PER_AMP;
+    uint32_t row, column;
+    float low, high;
+
+    if( speedPosition >= (float)( MCCTRL_FW_MAP_SPEEDS - 1U ) )
+    {
+        speedPosition = (float)( MCCTRL_FW_MAP_SPEEDS - 1U ) - 1.0e-3f;
+    }
+    if( currentPosition >= (float)( MCCTRL_FW_MAP_CURRENTS - 1U ) )
+    {
+        currentPosition = (float)( MCCTRL_FW_MAP_CURRENTS - 1U ) - 1.0e-3f;
+    }
+    row = (uint32_t)speedPosition;
+    column = (uint32_t)currentPosition;
+    speedPosition -= (float)row;
+    currentPosition -= (float)column;
+
+    low = gMCCTRL_FieldWeakeningMap[row][column]
+        + ( currentPosition * ( gMCCTRL_FieldWeakeningMap[row][column + 1U] - gMCCTRL_FieldWeakeningMap[row][column] ) );
+    high = gMCCTRL_FieldWeakeningMap[row + 1U][column]
+         + ( currentPosition * ( gMCCTRL_FieldWeakeningMap[row + 1U][column + 1U] - gMCCTRL_FieldWeakeningMap[row + 1U][column] ) );
+
+    return low + ( speedPosition * ( high - low ) );
+}
+#endif
 
 /*****************************************************************************/
 /* Function name: MCCTRL_ResetFieldWeakening                                 */
@@ -309,7 +464,85 @@ static void MCCTRL_ResetFieldWeakening( void )
     gMCCTRL_FieldWeakeningState.uQrefFilt     =       0.0f;
     gMCCTRL_FieldWeakeningState.iQrefFilt     =       0.0f;
     gMCCTRL_FieldWeakeningState.iQrefLast     =       0.0f;
+#if (FIELD_WEAKENING_METHOD != FW_FEED_FORWARD)
+    MCLIB_ResetPIParameters( &gMCLIB_FieldWeakeningPIController );
+#endif
+
+}
+#endif
+
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+/******************************************************************************/
+/* Function name: MCCTRL_LoadObserver                                         */
+/* Function parameters: speed - measured electrical speed                     */
+/*                      iq - measured q-axis current                          */
+/*                      iqMax - q-axis current limit                          */
+/* Function return: None                                                      */
+/* Description: Observer of the speed and of the load current, the q-axis     */
+/*              current that balances the load torque:                        */
+/*              w' = 1.5 p^2 Ke / J * ( iq - iqLoad ),  iqLoad' = 0           */
+/******************************************************************************/
+__STATIC_INLINE void MCCTRL_LoadObserver( const float speed, const float iq, const float iqMax )
+{
+    float speedError = speed - gMCCTRL_LoadObserverState.speed;
+
+    gMCCTRL_LoadObserverState.speed += gMCCTRL_LoadObserverParam.currentGain * ( iq - gMCCTRL_LoadObserverState.iqLoad )
+                                     + gMCCTRL_LoadObserverParam.speedGain * speedError;
+    gMCCTRL_LoadObserverState.iqLoad -= gMCCTRL_LoadObserverParam.loadGain * speedError;
+
+    /* The feed-forward stays within the current limit */
+    if( gMCCTRL_LoadObserverState.iqLoad > iqMax )
+    {
+        gMCCTRL_LoadObserverState.iqLoad = iqMax;
+    }
+    else if( gMCCTRL_LoadObserverState.iqLoad < -iqMax )
+    {
+        gMCCTRL_LoadObserverState.iqLoad = -iqMax;
+    }
+    else
+    {
+        /* Within the limit */
+    }
+}
 
+/******************************************************************************/
+/* Function name: MCCTRL_ResetLoadObserver                                    */
+/* Function parameters: speed - electrical speed to start from                */
+/* Function return: None                                                      */
+/* Description: Reset the load observer state                                 */
+/******************************************************************************/
+static void MCCTRL_ResetLoadObserver( const float speed )
+{
+    gMCCTRL_LoadObserverState.speed = speed;
+    gMCCTRL_LoadObserverState.iqLoad = 0.0f;
+}
+#endif
+
+#if (ENABLED == MTPA_CONTROL)
+/******************************************************************************/
+/* Function name: MCCTRL_MtpaIdref                                            */
+/* Function parameters: iqRef - q-axis reference current                      */
+/* Function return: d-axis current of maximum torque per ampere               */
+/* Description: Linear interpolation of the MTPA table, the last entry holds  */
+/*              above MAX_MOTOR_CURRENT                                       */
+/******************************************************************************/
+__STATIC_INLINE float MCCTRL_MtpaIdref( const float iqRef )
+{
+    float position = fabsf( iqRef ) * MCCTRL_MTPA_INTERVALS_PER_AMP;
+    uint32_t index;
+    float idRef;
+
+    if( position < (float)MCCTRL_MTPA_INTERVALS )
+    {
+        index = (uint32_t)position;
+        idRef = gMCCTRL_MtpaTable[index]
+              + ( ( position - (float)index ) * ( gMCCTRL_MtpaTable[index + 1U] - gMCCTRL_MtpaTable[index] ) );
+    }
+    else
+    {
+        idRef = gMCCTRL_MtpaTable[MCCTRL_MTPA_INTERVALS];
+    }
+    return idRef;
 }
 #endif
 
@@ -341,8 +574,10 @@ __STATIC_INLINE void MCCTRL_SignalTransformation(void )
     /* Clarke transform */
     MCLIB_ClarkeTransform(&gMCCUR_OutputSignals.phaseCurrents, &gMCLIB_CurrentAlphaBeta);
 
-    /* Park transform */
+#if (DISABLED == FUSED_FOC_KERNEL)
+    /* Park transform. The fused kernel does it in MCCTRL_MotorControl */
     MCLIB_ParkTransform(&gMCLIB_CurrentAlphaBeta, &gMCLIB_Position, &gMCLIB_CurrentDQ);
+#endif
 }
 
 /*******************************************************************************/
@@ -369,11 +604,23 @@ __STATIC_INLINE float MCCTRL_IqrefCalculation( void )
         gMCLIB_SpeedPIController.outMin = 0.0f;
     }
 
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    /* Load current estimate from the measured q-axis current, which is the
+       torque also when the current control is voltage limited. The
+       controller limits leave room for its feed-forward */
+    MCCTRL_LoadObserver( gMCRPOS_OutputSignals.speed, gMCLIB_CurrentDQ.quadratureAxis, gMCLIB_SpeedPIController.outMax );
+    gMCLIB_SpeedPIController.outMax -= gMCCTRL_LoadObserverState.iqLoad;
+    gMCLIB_SpeedPIController.outMin -= gMCCTRL_LoadObserverState.iqLoad;
+#endif
+
     /* Execute the velocity control loop */
     gMCLIB_SpeedPIController.inMeas = gMCRPOS_OutputSignals.speed;
     gMCLIB_SpeedPIController.inRef  = ( gMCCTRL_CtrlParam.rotationSign * gMCSPE_OutputSignals.commandSpeed );
     MCLIB_PIControl(&gMCLIB_SpeedPIController);
     iqRef = gMCLIB_SpeedPIController.out;
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    iqRef += gMCCTRL_LoadObserverState.iqLoad;
+#endif
 
 
   #else
@@ -392,19 +639,32 @@ __STATIC_INLINE float MCCTRL_IqrefCalculation( void )
 __STATIC_INLINE float MCCTRL_IdrefCalculation( void )
 {
     static float idRef;
-#if(FIELD_WEAKENING == ENABLED)
     float VqRefSquare;
+#if(FIELD_WEAKENING == ENABLED)
+    float idRefTarget;
+#endif
+#if (ENABLED == MTPA_CONTROL)
+    /* Reluctance torque: MTPA d-axis current for the q-axis reference of the last period */
+    float idRefMtpa = MCCTRL_MtpaIdref( gMCCTRL_CtrlParam.iqRef );
+#endif
 
-    /* Dynamic d-q adjustment with d component priority */
+    /* Dynamic d-q adjustment with d component priority, which keeps the voltage
+       vector inside the range of the configured VOLTAGE_LIMIT_METHOD. The separate
+       limits of the d- and q-axis controllers alone let the vector leave it */
     VqRefSquare = MAX_STATOR_VOLT_SQUARE - gMCLIB_IdPIController.out * gMCLIB_IdPIController.out;
 
     gMCLIB_IqPIController.outMax = sqrtf((float)(VqRefSquare));
+#if(FIELD_WEAKENING == DISABLED)
+    gMCLIB_IqPIController.outMin = -gMCLIB_IqPIController.outMax;
+#endif
 
+#if(FIELD_WEAKENING == ENABLED)
     /* Read inputs for field weakening  */
     gMCCTRL_FieldWeakeningInput.yd = gMCLIB_IdPIController.out;
-    gMCCTRL_FieldWeakeningInput.ws = gMCSPE_OutputSignals.commandSpeed;
     gMCCTRL_FieldWeakeningInput.iqref =  ( gMCCTRL_CtrlParam.iqRef >= 0.0f )? (gMCCTRL_CtrlParam.iqRef):(-gMCCTRL_CtrlParam.iqRef);
     gMCCTRL_FieldWeakeningInput.ud =  gMCLIB_VoltageDQ.directAxis;
+#if (FIELD_WEAKENING_METHOD == FW_FEED_FORWARD)
+    gMCCTRL_FieldWeakeningInput.ws = gMCSPE_OutputSignals.commandSpeed;
     gMCCTRL_FieldWeakeningInput.umax = gMCVOL_OutputSignals.umax;
 <#if MCPMSMFOC_POSITION_FB == "SENSORED_ENCODER">
     gMCCTRL_FieldWeakeningInput.esFilt = MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC * gMCSPE_OutputSignals.commandSpeed;
@@ -413,10 +673,30 @@ __STATIC_INLINE float MCCTRL_IdrefCalculation( void )
 </#if>
 
     MCCTRL_FieldWeakening(&gMCCTRL_FieldWeakeningInput, &gMCCTRL_FieldWeakeningOutput);
+#else
+    gMCCTRL_FieldWeakeningInput.ws = ( gMCRPOS_OutputSignals.speed >= 0.0f ) ? gMCRPOS_OutputSignals.speed : -gMCRPOS_OutputSignals.speed;
+    gMCCTRL_FieldWeakeningInput.uq = gMCLIB_VoltageDQ.quadratureAxis;
+
+    MCCTRL_FieldWeakeningVoltageLoop(&gMCCTRL_FieldWeakeningInput, &gMCCTRL_FieldWeakeningOutput);
+#endif
+
+#if (ENABLED == MTPA_CONTROL)
+    /* The more negative d-axis current: MTPA below base speed, field weakening above */
+    idRefTarget = ( idRefMtpa < gMCCTRL_FieldWeakeningOutput.idref ) ? idRefMtpa : gMCCTRL_FieldWeakeningOutput.idref;
+#else
+    idRefTarget = gMCCTRL_FieldWeakeningOutput.idref;
+#endif
 
+#if (FIELD_WEAKENING_METHOD == FW_FEED_FORWARD)
     /* Write field weakening output */
-    idRef = idRef + KFILTER_POT * ( gMCCTRL_FieldWeakeningOutput.idref -  idRef);
+    idRef = idRef + KFILTER_POT * ( idRefTarget -  idRef);
+#else
+    /* The voltage loop sets the dynamics of the d-axis reference, it is not filtered */
+    idRef = idRefTarget;
+#endif
 
+#elif (ENABLED == MTPA_CONTROL)
+    idRef = idRefMtpa;
 #else
     idRef = 0;
 #endif
@@ -454,7 +734,16 @@ __STATIC_INLINE void MCCTRL_StateMachine( void )
             /* Read inputs for initial rotor position detection */
             if( MCAPP_SUCCESS == MCRPOS_InitialRotorPositonDetection(&gMCRPOS_RotorAlignOutput))
             {
+            #if (ENABLED == HF_INJECTION)
+                /* Injection estimate from standstill, no open loop startup */
+                gMCCTRL_CtrlParam.mcStateLast = gMCCTRL_CtrlParam.mcState;
+                gMCCTRL_CtrlParam.mcState = MCAPP_CLOSED_LOOP;
+              #if (ENABLED == LOAD_TORQUE_OBSERVER)
+                MCCTRL_ResetLoadObserver( 0.0f );
+              #endif
+            #else
                 gMCCTRL_CtrlParam.mcState = MCAPP_OPEN_LOOP;
+            #endif
             }
             </#if>
             gMCCTRL_CtrlParam.iqRef =  gMCCTRL_CtrlParam.rotationSign * gMCRPOS_RotorAlignOutput.iqRef;
@@ -487,6 +776,9 @@ __STATIC_INLINE void MCCTRL_StateMachine( void )
                   #if(OPEN_LOOP_FUNCTIONING == DISABLED)
                     gMCCTRL_CtrlParam.mcState = MCAPP_CLOSED_LOOP;
                     gMCCTRL_ClosingLoopState.stabilizationCounter = 0;
+                  #if (ENABLED == LOAD_TORQUE_OBSERVER)
+                    MCCTRL_ResetLoadObserver( gMCRPOS_OutputSignals.speed );
+                  #endif
                   #endif
                 }
             }
@@ -513,6 +805,19 @@ __STATIC_INLINE void MCCTRL_StateMachine( void )
             gMCCTRL_CtrlParam.iqRef = MCCTRL_IqrefCalculation();
         }
         break;
+#if (ENABLED == MOTOR_IDENTIFICATION)
+        case MCAPP_IDENTIFICATION:
+        {
+            /* Motor parameter identification, PWM outputs off when finished */
+            if( MCAPP_IN_PROGRESS != MCID_Identification() )
+            {
+                MCPWM_PWMOutputDisable();
+                gMCCTRL_CtrlParam.mcStateLast = gMCCTRL_CtrlParam.mcState;
+                gMCCTRL_CtrlParam.mcState = MCAPP_IDLE;
+            }
+        }
+        break;
+#endif
         default:
         {
             /* Undefined state: Should never come here */
@@ -552,12 +857,40 @@ __STATIC_INLINE void MCCTRL_CurrentControl( void )
  ******************************************************************************/
 __STATIC_INLINE void MCCTRL_MotorControl( void )
 {
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#if (ENABLED == HF_INJECTION)
+    if( gMCRPOS_HfiState.active )
+    {
+        /* Injection response removed from the controlled currents */
+        gMCLIB_CurrentDQ.directAxis = gMCRPOS_HfiOutput.idFilt;
+        gMCLIB_CurrentDQ.quadratureAxis = gMCRPOS_HfiOutput.iqFilt;
+    }
+#endif
+</#if>
     /* Control state machine */
     MCCTRL_StateMachine();
 
+#if (ENABLED == FUSED_FOC_KERNEL)
+    /* Park, Id and Iq control, sine/cosine, inverse Park and SVPWM in one pass */
+    MCFOC_CurrentLoopKernel(&gMCCUR_OutputSignals.phaseCurrents, gMCCTRL_CtrlParam.idRef,
+                            gMCCTRL_CtrlParam.iqRef, &gMCCTRL_FocKernel);
+    MCPWM_PWMDutyUpdate(&gMCPWM_SVPWM);
+#else
     /* Direct and Quadrature axis current control */
     MCCTRL_CurrentControl();
 
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#if (ENABLED == HF_INJECTION)
+    /* Pulsating voltage on the estimated d- axis, zero after the handoff */
+    gMCLIB_VoltageDQ.directAxis += gMCRPOS_HfiOutput.vdInjection;
+#endif
+</#if>
+
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    /* Voltage pulses of the inductance identification */
+    MCID_VoltageOverride(&gMCLIB_VoltageDQ);
+#endif
+
     /* Calculate qSin,qCos from qAngle  */
     MCLIB_SinCosCalc(gMCLIB_Position.angle, &gMCLIB_Position.sineAngle, &gMCLIB_Position.cosAngle );
 
@@ -566,6 +899,7 @@ __STATIC_INLINE void MCCTRL_MotorControl( void )
 
     /* PWM modulation */
     MCPWM_PWMModulator();
+#endif
 
     /* X2C scope update */
     MCHAL_X2C_Update();
@@ -619,14 +953,45 @@ __STATIC_INLINE void  MCCTRL_LoopSynchronization(void)
 #if (ENABLED == FIELD_WEAKENING )
     MCCTRL_InitializeFieldWeakening();
 #endif
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    MCCTRL_InitializeLoadObserver( MOTOR_INERTIA, MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC );
+#endif
 
     gMCPWM_SVPWM.period = MCHAL_PWMPrimaryPeriodGet(MCHAL_PWM_PH_U);
     gMCPWM_SVPWM.neutralPWM = (uint32_t)(0.5f * gMCPWM_SVPWM.period );
+
+#if (ARITHMETIC == ARITHMETIC_Q14)
+    /* Integer coefficients of the fixed point backend */
+    MCQ14_InitializeControl();
+#endif
 }
 
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+/******************************************************************************/
+/* Function name: MCCTRL_InitializeLoadObserver                               */
+/* Function parameters: inertia - rotor and load inertia (kg m^2)             */
+/*                      ke - back EMF constant (V peak phase per rad/s elec)  */
+/* Function return: None                                                      */
+/* Description: Observer gains for a double pole at LOAD_OBSERVER_BANDWIDTH,  */
+/*              the observer runs with the speed controller                   */
+/******************************************************************************/
+void MCCTRL_InitializeLoadObserver( const float inertia, const float ke )
+{
+    float deltaT = FAST_LOOP_TIME_SEC;
+    float pole = LOAD_OBSERVER_BANDWIDTH * deltaT;
+
+    gMCCTRL_LoadObserverParam.currentGain = 1.5f * NUM_POLE_PAIRS * NUM_POLE_PAIRS * ke * deltaT / inertia;
+    gMCCTRL_LoadObserverParam.speedGain = 2.0f * pole;
+    gMCCTRL_LoadObserverParam.loadGain = pole * pole / gMCCTRL_LoadObserverParam.currentGain;
+}
+#endif
 
 void MCCTRL_CurrentOffsetCalibration( uint32_t status, uintptr_t context )
 {
+    /* ADC callback arguments not used */
+    (void)status;
+    (void)context;
+
     /* Current sense amplifiers offset calculation */
     if(gMCCUR_OutputSignals.calibDone == 0U)
     {
@@ -634,6 +999,9 @@ void MCCTRL_CurrentOffsetCalibration( uint32_t status, uintptr_t context )
     }
     else
     {
+#if (ARITHMETIC == ARITHMETIC_Q14)
+        MCQ14_ReadCurrentOffsets();
+#endif
         MCHAL_ADCCallbackRegister( MCHAL_ADC_PH_U, MCCTRL_CurrentLoopTasks, (uintptr_t)NULL );
     }
 }
@@ -646,24 +1014,74 @@ void MCCTRL_CurrentOffsetCalibration( uint32_t status, uintptr_t context )
 /******************************************************************************/
 void MCCTRL_CurrentLoopTasks( uint32_t status, uintptr_t context )
 {
+    /* ADC callback arguments not used */
+    (void)status;
+    (void)context;
+
+    MCPROF_ISR_ENTRY();
+
+#if (ENABLED == PARAMETER_CHANNEL)
+    /* Parameters published by the application */
+    MCPAR_Update( );
+#endif
+
+#if (ARITHMETIC == ARITHMETIC_Q14)
+    /* Current Measurement */
+    MCQ14_CurrentMeasurement( );
+    MCPROF_STAGE_END( MCPROF_CURRENT_MEASUREMENT );
+
+    /* Voltage measurement */
+    MCQ14_VoltageMeasurement( );
+    MCPROF_STAGE_END( MCPROF_VOLTAGE_MEASUREMENT );
+
+    /* Clarke, Park transform */
+    MCQ14_SignalTransformation();
+    MCPROF_STAGE_END( MCPROF_SIGNAL_TRANSFORMATION );
+
+    /* Rotor position estimation */
+    MCQ14_PositionMeasurement( );
+    MCPROF_STAGE_END( MCPROF_POSITION_MEASUREMENT );
+
+    /* Motor control */
+    MCQ14_MotorControl( );
+    MCPROF_STAGE_END( MCPROF_MOTOR_CONTROL );
+#else
     /* Current Measurement */
     MCCUR_CurrentMeasurement( );
+    MCPROF_STAGE_END( MCPROF_CURRENT_MEASUREMENT );
 
     /* Voltage measurement */
     MCVOL_VoltageMeasurement( );
+#if (ENABLED == VOLTAGE_RECONSTRUCTION)
+    /* Stator voltage applied in the last PWM period */
+    MCPWM_VoltageReconstruction( gMCVOL_OutputSignals.udc, gMCCUR_OutputSignals.phaseCurrents.iu,
+                                 gMCCUR_OutputSignals.phaseCurrents.iv );
+#endif
+    MCPROF_STAGE_END( MCPROF_VOLTAGE_MEASUREMENT );
 
     /* Clarke, Park transform */
     MCCTRL_SignalTransformation();
+    MCPROF_STAGE_END( MCPROF_SIGNAL_TRANSFORMATION );
 
     /* Rotor position estimation */
     MCRPOS_PositionMeasurement( );
+    MCPROF_STAGE_END( MCPROF_POSITION_MEASUREMENT );
 
     /* Motor control */
     MCCTRL_MotorControl( );
+    MCPROF_STAGE_END( MCPROF_MOTOR_CONTROL );
+#endif
 
+#if (ENABLED == TASK_SCHEDULER)
+    /* Release the slow tasks due in this PWM period */
+    MCSCH_Tick();
+#else
      /* sync count for slow control loop execution */
     MCCTRL_LoopSynchronization();
+#endif
+    MCPROF_STAGE_END( MCPROF_LOOP_SYNCHRONIZATION );
 
+    MCPROF_ISR_EXIT();
 }
 
 /******************************************************************************/
@@ -686,9 +1104,16 @@ void MCCTRL_CurrentLoopTasks( uint32_t status, uintptr_t context )
 #if (ENABLED == FIELD_WEAKENING )
     MCCTRL_ResetFieldWeakening();
 #endif
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    MCCTRL_ResetLoadObserver( 0.0f );
+#endif
 
     gMCPWM_SVPWM.period = MCHAL_PWMPrimaryPeriodGet(MCHAL_PWM_PH_U);
     gMCPWM_SVPWM.neutralPWM = (uint32_t)(0.5f * gMCPWM_SVPWM.period );
+
+#if (ARITHMETIC == ARITHMETIC_Q14)
+    MCQ14_ResetControl();
+#endif
 }
 
 
@@ -54,6 +54,7 @@
 
 #include <stddef.h>
 #include "mc_lib.h"
+#include "mc_picontrol.h"
 #include "mc_pmsm_foc_common.h"
 
 // DOM-IGNORE-BEGIN
@@ -90,6 +91,7 @@ typedef struct
 {
     float             yd;                                        /*   D- axis controller output                 */
     float             ud;                                        /*   D- axis voltage                           */
+    float             uq;                                        /*   Q- axis voltage                           */
     float             ws;                                        /*   mechanical speed of motor in RPM          */
     float             iqref;                                     /*   Q-axis reference current                  */
     float             esFilt;                                    /*   Filtered back emf magnitude               */
@@ -105,6 +107,8 @@ typedef struct
     float              rs;                                       /*      Per phase resistance                   */
     float              fs;                                       /*      PWM frequency                          */
     float              idmax;                                    /*      maximum d- axis current                */
+    float              uRef;                                     /*      Voltage loop reference, relative       */
+    float              invTwoURef;                               /*      Inverse of twice the reference         */
 }tMCCTRL_FW_PARAM_S;
 
 typedef struct
@@ -122,6 +126,23 @@ typedef struct
 
 /*----------------------------------------------------------------------------*/
 
+/* Load torque observer of the speed loop. The load torque is estimated as the
+   q-axis current which balances it and fed forward to the q-axis reference */
+typedef struct
+{
+    float            currentGain;                               /*   Speed change per q-axis current and period */
+    float            speedGain;                                 /*   Speed estimate correction gain             */
+    float            loadGain;                                  /*   Load current estimate correction gain      */
+}tMCCTRL_LOAD_OBSERVER_PARAM_S;
+
+typedef struct
+{
+    float            speed;                                     /*   Estimated electrical speed (rad/s)         */
+    float            iqLoad;                                    /*   Estimated load current (A)                 */
+}tMCCTRL_LOAD_OBSERVER_STATE_S;
+
+/*----------------------------------------------------------------------------*/
+
 typedef struct
 {
     uint32_t         stabilizationCounter;
@@ -155,6 +176,20 @@ typedef struct
 
 extern tMCCTRL_TASK_STATE_SIGNALS_S gMCCTRL_TaskStateSignals;
 
+extern tMCLIB_PICONTROLLER_S gMCLIB_IqPIController;
+extern tMCLIB_PICONTROLLER_S gMCLIB_IdPIController;
+extern tMCLIB_PICONTROLLER_S gMCLIB_SpeedPIController;
+#if (ENABLED == FIELD_WEAKENING )
+extern tMCCTRL_FW_PARAM_S gMCCTRL_FieldWeakeningParam;
+#if (FIELD_WEAKENING_METHOD != FW_FEED_FORWARD)
+extern tMCLIB_PICONTROLLER_S gMCLIB_FieldWeakeningPIController;
+#endif
+#endif
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+extern tMCCTRL_LOAD_OBSERVER_PARAM_S gMCCTRL_LoadObserverParam;
+extern tMCCTRL_LOAD_OBSERVER_STATE_S gMCCTRL_LoadObserverState;
+#endif
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -166,6 +201,9 @@ void MCCTRL_InitializeMotorControl(void);
 void MCCTRL_ResetMotorControl(void);
 void MCCTRL_CurrentLoopTasks( uint32_t status, uintptr_t context );
 void MCCTRL_CurrentOffsetCalibration( uint32_t status, uintptr_t context );
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+void MCCTRL_InitializeLoadObserver( const float inertia, const float ke );
+#endif
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
@@ -53,6 +53,7 @@
 #include "mc_generic_lib.h"
 #include "assert.h"
 #include "mc_hal.h"
+#include "mc_placement.h"
 
 // *****************************************************************************
 // *****************************************************************************
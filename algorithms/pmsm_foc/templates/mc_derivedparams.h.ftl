@@ -73,7 +73,22 @@ Derived Parameters interface file
 #define LOCK_COUNT_FOR_LOCK_TIME                          (uint32_t)((float)LOCK_TIME_IN_SEC/(float)FAST_LOOP_TIME_SEC)
 #define OPEN_LOOP_END_SPEED_RPS                           ((float)OPEN_LOOP_END_SPEED_RPM/60)
 
-#define MAX_STATOR_VOLT_SQUARE                           (float)(0.98 * 0.98)
+/* Largest fundamental voltage, relative to the linear modulation range */
+#if (VOLTAGE_LIMIT_METHOD == VOLTAGE_LIMIT_SIX_STEP)
+#define MAX_STATOR_VOLT                                  (1.1026577908)   /* Six-step, 2*sqrt(3)/pi */
+#elif (VOLTAGE_LIMIT_METHOD == VOLTAGE_LIMIT_OVERMODULATION)
+#define MAX_STATOR_VOLT                                  (1.0490974577)   /* Voltage hexagon, 6/pi*ln(sqrt(3)) */
+#else
+#define MAX_STATOR_VOLT                                  (0.98)
+#endif
+#define MAX_STATOR_VOLT_SQUARE                           (float)(MAX_STATOR_VOLT * MAX_STATOR_VOLT)
+
+#if (ENABLED == DEADTIME_COMPENSATION) || (ENABLED == VOLTAGE_RECONSTRUCTION)
+/* Phase voltage lost during the dead time and across the switches, relative to the DC bus */
+#define DEADTIME_COMP_DUTY                               (float)((PWM_DEAD_TIME_SEC * (float)PWM_FREQUENCY) + (SWITCH_VOLTAGE_DROP / DC_BUS_VOLTAGE))
+#define DEADTIME_COMP_INV_BAND                           (float)(1.0f / DEADTIME_COMP_CURRENT_BAND)
+#endif
+
 #define POT_ADC_COUNT_FW_SPEED_RATIO                     (float)(MAX_SPEED_RAD_PER_SEC_ELEC/MAX_ADC_COUNT)
 
 <#if MCPMSMFOC_SPEED_REF_INPUT != "Potentiometer Analog Input">
@@ -109,6 +124,12 @@ Derived Parameters interface file
 #define OPEN_LOOP_END_SPEED_RADS_PER_SEC_ELEC_IN_LOOPTIME (float)(OPEN_LOOP_END_SPEED_RADS_PER_SEC_ELEC * FAST_LOOP_TIME_SEC)
 #define OPEN_LOOP_RAMPSPEED_INCREASERATE                  (float)(OPEN_LOOP_END_SPEED_RADS_PER_SEC_ELEC_IN_LOOPTIME/(OPEN_LOOP_RAMP_TIME_IN_SEC/FAST_LOOP_TIME_SEC))
 </#if>
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#if (ENABLED == HF_INJECTION)
+/*_____________________________ High frequency injection handoff speed __________________________________ */
+#define HFI_HANDOFF_SPEED_RADS_PER_SEC_ELEC               (float)(((HFI_HANDOFF_SPEED_RPM/60)*2*(float)M_PI)*NUM_POLE_PAIRS)
+#endif
+</#if>
 
 /*________________________________ BEMF constant___________________________________________________ */
 <#if MCPMSMFOC_MOTOR_CONNECTION == "STAR">
@@ -103,6 +103,10 @@ void MCERR_ErrorClear( void )
 
 void MCERR_FaultControlISR(uint32_t status, uintptr_t context)
 {
+    /* PIO callback arguments not used */
+    (void)status;
+    (void)context;
+
    /* Indicate the failure status by glowing LED D2 */
     MCHAL_FAULT_LED_SET();
     gMCERR_StateSignals.errorCode |= (1 << MCERR_OVERCURRENT);
@@ -0,0 +1,301 @@
+/*******************************************************************************
+ Fused Current Control Kernel source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_foc_kernel.c
+
+  Summary:
+    Current control from phase currents to duty cycles in one function
+
+  Description:
+    This file contains the fused current control kernel. The operations and
+    their order are the same as in MCLIB_ClarkeTransform, MCLIB_ParkTransform,
+    MCLIB_PIControl, MCLIB_InvParkTransform and MCPWM_SVPWMGen, so the results
+    match the reference chain. The intermediate signals stay in registers and
+    the results are stored once at the end. With the sector based modulation
+    the space vector time calculation is done once after the sector decision
+    instead of in every sector branch. The other modulation methods use the
+    same inline functions of mc_pwm.h as MCPWM_SVPWMGen.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"                // SYS function prototypes
+#include "device.h"
+#include "mc_derivedparams.h"
+#include "mc_foc_kernel.h"
+#include "mc_generic_lib.h"
+#include "mc_placement.h"
+
+#if (ENABLED == FUSED_FOC_KERNEL)
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+#if (SVPWM_METHOD == SVPWM_SECTOR_TREE)
+/* Order of the ta, tb and tc times on the U, V and W phases */
+typedef enum
+{
+    MCFOC_SECTOR_ABC,
+    MCFOC_SECTOR_CAB,
+    MCFOC_SECTOR_BAC,
+    MCFOC_SECTOR_BCA,
+    MCFOC_SECTOR_ACB,
+    MCFOC_SECTOR_CBA
+}tMCFOC_SECTOR_E;
+#endif
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCFOC_PIControl                                             */
+/* Function parameters: pParm - PI parameter structure                        */
+/*                      inRef, inMeas - reference and measurement             */
+/* Function return: PI output                                                 */
+/* Description: Same computation as MCLIB_PIControl                           */
+/******************************************************************************/
+__STATIC_INLINE float MCFOC_PIControl( tMCLIB_PICONTROLLER_S * const pParm, const float inRef, const float inMeas )
+{
+    float err;
+    float out;
+    float limited;
+
+    err = inRef - inMeas;
+    out = pParm->dSum + pParm->kp * err;
+
+    /* Limit checking for PI output */
+    if( out > pParm->outMax )
+    {
+        limited = pParm->outMax;
+    }
+    else if( out < pParm->outMin )
+    {
+        limited = pParm->outMin;
+    }
+    else
+    {
+        limited = out;
+    }
+
+    pParm->dSum = pParm->dSum + pParm->ki * err - pParm->kc * ( out - limited );
+    pParm->inRef = inRef;
+    pParm->inMeas = inMeas;
+    pParm->out = limited;
+
+    return limited;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCFOC_CurrentLoopKernel                                     */
+/* Function parameters: current - phase currents                              */
+/*                      idRef, iqRef - current references                     */
+/*                      kernel - signals and controllers                      */
+/* Function return: None                                                      */
+/* Description: Clarke, Park, Iq and Id PI control, sine/cosine of the new    */
+/*              angle, inverse Park and space vector modulation. The duty     */
+/*              cycles are written to the SVPWM structure, the PWM registers  */
+/*              are updated by MCPWM_PWMDutyUpdate.                           */
+/******************************************************************************/
+void MCFOC_CurrentLoopKernel( const tMCCUR_PHASE_CURRENTS_S * const current, const float idRef,
+                              const float iqRef, const tMCFOC_KERNEL_S * const kernel )
+{
+    tMCLIB_POSITION_S * const pPosition = kernel->pPosition;
+    tMCPWM_SVPWM_S * const svm = kernel->pSvm;
+    float alpha, beta, id, iq, vd, vq;
+    float sine, cosine, vAlpha, vBeta;
+#if (SVPWM_METHOD == SVPWM_SECTOR_TREE)
+    tMCFOC_SECTOR_E sector;
+    float vr1, vr2, vr3, t1, t2, ta, tb, tc;
+#endif
+
+    /* Clarke transform */
+    alpha = current->iu;
+    beta = (current->iu * ONE_BY_SQRT3) + (current->iv * TWO_BY_SQRT3);
+
+    /* Park transform with the sine and cosine of the previous cycle */
+    sine = pPosition->sineAngle;
+    cosine = pPosition->cosAngle;
+    id =  alpha * cosine + beta * sine;
+    iq = -alpha * sine + beta * cosine;
+
+    /* PI control for Iq torque control loop and Id flux control loop */
+    vq = MCFOC_PIControl( kernel->pIqController, iqRef, iq );
+    vd = MCFOC_PIControl( kernel->pIdController, idRef, id );
+
+    /* Sine and cosine of the new angle */
+    MCLIB_SinCosCalc( pPosition->angle, &sine, &cosine );
+
+    /* Inverse Park transform */
+    vAlpha = vd * cosine - vq * sine;
+    vBeta  = vd * sine + vq * cosine;
+
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+    /* Overmodulation */
+    MCPWM_VoltageLimit( &vAlpha, &vBeta );
+
+#endif
+    /* Write back the signals */
+    kernel->pCurrentDQ->directAxis = id;
+    kernel->pCurrentDQ->quadratureAxis = iq;
+    kernel->pVoltageDQ->directAxis = vd;
+    kernel->pVoltageDQ->quadratureAxis = vq;
+    kernel->pVoltageAlphaBeta->alphaAxis = vAlpha;
+    kernel->pVoltageAlphaBeta->betaAxis = vBeta;
+    pPosition->sineAngle = sine;
+    pPosition->cosAngle = cosine;
+
+#if (ENABLED == DEADTIME_COMPENSATION)
+    /* Modulated voltage only, the estimator keeps the voltage applied to the motor */
+    MCPWM_DeadTimeCompensation( alpha, beta, &vAlpha, &vBeta );
+#endif
+
+#if (SVPWM_METHOD == SVPWM_MIN_MAX)
+    /* Min-max zero sequence injection */
+    MCPWM_MinMaxDuty( vAlpha, vBeta, svm );
+#elif (SVPWM_METHOD != SVPWM_SECTOR_TREE)
+    /* Discontinuous PWM */
+    MCPWM_DiscontinuousDuty( vAlpha, vBeta, svm, SVPWM_METHOD );
+#else
+    /* Reference vectors and sector */
+    vr1 = vBeta;
+    vr2 = (-vBeta/2 + SQRT3_BY2 * vAlpha);
+    vr3 = (-vBeta/2 - SQRT3_BY2 * vAlpha);
+
+    if( vr1 >= 0 )
+    {
+        if( vr2 >= 0 )
+        {
+            /* Sector 3: 0-60 degrees */
+            t1 = vr2;
+            t2 = vr1;
+            sector = MCFOC_SECTOR_ABC;
+        }
+        else if( vr3 >= 0 )
+        {
+            /* Sector 5: 120-180 degrees */
+            t1 = vr1;
+            t2 = vr3;
+            sector = MCFOC_SECTOR_CAB;
+        }
+        else
+        {
+            /* Sector 1: 60-120 degrees */
+            t1 = -vr2;
+            t2 = -vr3;
+            sector = MCFOC_SECTOR_BAC;
+        }
+    }
+    else
+    {
+        if( vr2 >= 0 )
+        {
+            if( vr3 >= 0 )
+            {
+                /* Sector 6: 240-300 degrees */
+                t1 = vr3;
+                t2 = vr2;
+                sector = MCFOC_SECTOR_BCA;
+            }
+            else
+            {
+                /* Sector 2: 300-0 degrees */
+                t1 = -vr3;
+                t2 = -vr1;
+                sector = MCFOC_SECTOR_ACB;
+            }
+        }
+        else
+        {
+            /* Sector 4: 180-240 degrees */
+            t1 = -vr1;
+            t2 = -vr2;
+            sector = MCFOC_SECTOR_CBA;
+        }
+    }
+
+    /* Space vector times */
+    t1 = svm->period * t1;
+    t2 = svm->period * t2;
+    tc = (svm->period - t1 - t2)/2;
+    tb = tc + t2;
+    ta = tb + t1;
+
+    switch( sector )
+    {
+        case MCFOC_SECTOR_ABC:
+            svm->dPwm1 = (uint32_t)ta;
+            svm->dPwm2 = (uint32_t)tb;
+            svm->dPwm3 = (uint32_t)tc;
+            break;
+        case MCFOC_SECTOR_CAB:
+            svm->dPwm1 = (uint32_t)tc;
+            svm->dPwm2 = (uint32_t)ta;
+            svm->dPwm3 = (uint32_t)tb;
+            break;
+        case MCFOC_SECTOR_BAC:
+            svm->dPwm1 = (uint32_t)tb;
+            svm->dPwm2 = (uint32_t)ta;
+            svm->dPwm3 = (uint32_t)tc;
+            break;
+        case MCFOC_SECTOR_BCA:
+            svm->dPwm1 = (uint32_t)tb;
+            svm->dPwm2 = (uint32_t)tc;
+            svm->dPwm3 = (uint32_t)ta;
+            break;
+        case MCFOC_SECTOR_ACB:
+            svm->dPwm1 = (uint32_t)ta;
+            svm->dPwm2 = (uint32_t)tc;
+            svm->dPwm3 = (uint32_t)tb;
+            break;
+        default:
+            svm->dPwm1 = (uint32_t)tc;
+            svm->dPwm2 = (uint32_t)tb;
+            svm->dPwm3 = (uint32_t)ta;
+            break;
+    }
+#endif
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ Fused Current Control Kernel interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_foc_kernel.h
+
+  Summary:
+    Header file for mc_foc_kernel.c
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    fused current control kernel. The kernel computes Clarke, Park, the Id and
+    Iq PI controllers, inverse Park and the space vector modulation in one
+    function, keeping the intermediate signals in local variables. It produces
+    the same results as the chain of MCLIB and MCPWM functions, which remain
+    the reference implementation.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_FOC_KERNEL_H
+#define MC_FOC_KERNEL_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include "mc_lib.h"
+#include "mc_picontrol.h"
+#include "mc_pwm.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Signals and controllers the kernel reads and updates */
+typedef struct
+{
+    tMCLIB_PICONTROLLER_S *     pIdController;
+    tMCLIB_PICONTROLLER_S *     pIqController;
+    tMCLIB_POSITION_S *         pPosition;          /* In: angle, sin/cos of the previous cycle. Out: sin/cos of angle */
+    tMCLIB_PARK_TRANSFORM_S *   pCurrentDQ;         /* Out: measured Id, Iq                                           */
+    tMCLIB_PARK_TRANSFORM_S *   pVoltageDQ;         /* Out: PI controller outputs                                     */
+    tMCLIB_CLARK_TRANSFORM_S *  pVoltageAlphaBeta;  /* Out: voltage reference for the estimator                       */
+    tMCPWM_SVPWM_S *            pSvm;               /* In: period. Out: dPwm1, dPwm2, dPwm3                           */
+}tMCFOC_KERNEL_S;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: MCFOC_CurrentLoopKernel                                     */
+/* Function parameters: current - phase currents                              */
+/*                      idRef, iqRef - current references                     */
+/*                      kernel - signals and controllers                      */
+/* Function return: None                                                      */
+/* Description: Phase currents to duty cycles in one pass                     */
+/******************************************************************************/
+void MCFOC_CurrentLoopKernel( const tMCCUR_PHASE_CURRENTS_S * const current, const float idRef,
+                              const float iqRef, const tMCFOC_KERNEL_S * const kernel );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif    /* MC_FOC_KERNEL_H */
+
+/**
+ End of File
+*/
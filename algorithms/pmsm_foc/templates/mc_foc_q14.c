@@ -0,0 +1,825 @@
+/*******************************************************************************
+ Q2.14 Fixed Point Control Backend source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_foc_q14.c
+
+  Summary:
+    Current loop tasks in Q2.14 fixed point arithmetic
+
+  Description:
+    This file contains the fixed point implementation of the stages of
+    MCCTRL_CurrentLoopTasks: current and voltage measurement, Clarke and Park
+    transform, PLL estimator, the control state machine, the speed and current
+    PI controllers, inverse Park and the sector based space vector
+    modulation. The operations follow the floating point modules, using the
+    library_* primitives of mc_q14_lib.c. Only the initialization converts the
+    floating point configuration to integer coefficients, the interrupt path
+    has no floating point operations.
+
+    The backend supports the sensorless PLL with dual shunt measurement,
+    sector based SVPWM in the linear range, without field weakening. The
+    PI controllers use the clamping anti-windup of library_pi_control instead
+    of the back calculation of MCLIB_PIControl.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"                // SYS function prototypes
+#include "device.h"
+#include "mc_derivedparams.h"
+#include "mc_control_loop.h"
+#include "mc_currmeasurement.h"
+#include "mc_rotorposition.h"
+#include "mc_hal.h"
+#include "mc_pwm.h"
+#include "mc_foc_q14.h"
+#include "mc_placement.h"
+
+#if (ARITHMETIC == ARITHMETIC_Q14)
+
+#if (POSITION_FEEDBACK != SENSORLESS_PLL)
+#error "ARITHMETIC_Q14 supports the sensorless PLL position feedback"
+#elif (CURRENT_MEASUREMENT != DUAL_SHUNT)
+#error "ARITHMETIC_Q14 supports dual shunt current measurement"
+#elif (ENABLED == FIELD_WEAKENING)
+#error "ARITHMETIC_Q14 does not support field weakening"
+#elif (ENABLED == MTPA_CONTROL)
+#error "ARITHMETIC_Q14 does not support MTPA"
+#elif (SVPWM_METHOD != SVPWM_SECTOR_TREE) || (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+#error "ARITHMETIC_Q14 supports sector based SVPWM in the linear modulation range"
+#elif (ENABLED == FUSED_FOC_KERNEL)
+#error "The fused current control kernel is floating point, disable it with ARITHMETIC_Q14"
+#elif (ENABLED == LOAD_TORQUE_OBSERVER)
+#error "The load torque observer feeds the floating point speed control, disable it with ARITHMETIC_Q14"
+#elif (ENABLED == DEADTIME_COMPENSATION)
+#error "ARITHMETIC_Q14 does not support dead time compensation"
+#elif (ENABLED == VOLTAGE_RECONSTRUCTION)
+#error "ARITHMETIC_Q14 does not support the stator voltage reconstruction"
+#elif (ENABLED == HF_INJECTION)
+#error "ARITHMETIC_Q14 does not support the high frequency injection"
+#endif
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Largest mantissa shift of the gains and PI controllers. With 16 bit limits
+   the PI output limit shifted up stays below 2^31 */
+#define MCQ14_MAX_SHIFT             (15U)
+
+/* 32 bit angles */
+#define MCQ14_ANGLE_PI_HALVES       (0x40000000U)
+#define MCQ14_ANGLE_THREE_PI_HALVES (0xC0000000U)
+#define MCQ14_RAD_TO_ANGLE          ( 4294967296.0 / ( 2.0 * 3.14159265358979323846 ) )
+
+/* Angle step of the 256 entry quarter wave table of library_sincos */
+#define MCQ14_SH_SINCOS_STEP        (6U)
+#define MCQ14_SINCOS_STEP           ( (uint16_t)1U << MCQ14_SH_SINCOS_STEP )
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCQ14_PARAMETERS_S         gMCQ14_Parameters;
+tMCQ14_CONTROL_SIGNALS_S    gMCQ14_CtrlSignals;
+tMCQ14_PLL_PARAM_S          gMCQ14_PLLParam;
+tMCQ14_PLL_STATE_S          gMCQ14_PLLState;
+pi_cntrl_t                  gMCQ14_IdPIController;
+pi_cntrl_t                  gMCQ14_IqPIController;
+pi_cntrl_t                  gMCQ14_SpeedPIController;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCQ14_Saturate                                              */
+/* Function parameters: x - 32 bit value                                      */
+/* Function return: x limited to the 16 bit range                             */
+/* Description: Saturation to int16_t                                         */
+/******************************************************************************/
+__STATIC_INLINE int16_t MCQ14_Saturate( const int32_t x )
+{
+    int16_t y;
+
+    if( x > INT16_MAX )
+    {
+        y = INT16_MAX;
+    }
+    else if( x < -INT16_MAX )
+    {
+        y = -INT16_MAX;
+    }
+    else
+    {
+        y = (int16_t)x;
+    }
+    return y;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_Gain                                                  */
+/* Function parameters: x - input, pGain - gain                               */
+/* Function return: ( x * k ) >> sh, rounded and saturated                    */
+/* Description: Multiplication with a gain in mantissa and shift form. The    */
+/*              rounding keeps the offset of the shift out of the current     */
+/*              measurement and the PLL voltage equations.                    */
+/******************************************************************************/
+__STATIC_INLINE int16_t MCQ14_Gain( const int16_t x, const tMCQ14_GAIN_S * const pGain )
+{
+    return MCQ14_Saturate( ( (int32_t)x * (int32_t)pGain->k + ( ( (int32_t)1 << pGain->sh ) >> 1 ) ) >> pGain->sh );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_Filter                                                */
+/* Function parameters: pState - filter state, Q14 << 16                      */
+/*                      x - input, k - coefficient, Q16, k < 2^15             */
+/* Function return: filter output                                             */
+/* Description: First order filter y = y + ( x - y ) * k                      */
+/******************************************************************************/
+__STATIC_INLINE int16_t MCQ14_Filter( int32_t * const pState, const int16_t x, const int32_t k )
+{
+    *pState += ( (int32_t)x - ( *pState >> 16 ) ) * k;
+    return (int16_t)( *pState >> 16 );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_SinCos                                                */
+/* Function parameters: t - angle structure                                   */
+/* Function return: None                                                      */
+/* Description: t->sin and t->cos from t->ang, linear interpolation between   */
+/*              the table points of library_sincos. The table alone steps the */
+/*              angle by 0.35 degrees, which adds harmonics of up to 0.6 % of */
+/*              the vector to the Park transforms.                            */
+/******************************************************************************/
+__STATIC_INLINE void MCQ14_SinCos( ang_sincos_t * const t )
+{
+    const uint16_t angle = t->ang;
+    const int32_t fraction = (int32_t)( angle & ( MCQ14_SINCOS_STEP - 1U ) );
+    ang_sincos_t next;
+
+    t->ang = (uint16_t)( angle - (uint16_t)fraction );
+    library_sincos( t );
+    next.ang = (uint16_t)( t->ang + MCQ14_SINCOS_STEP );
+    library_sincos( &next );
+    t->sin = (int16_t)( t->sin + ( ( ( (int32_t)next.sin - t->sin ) * fraction ) >> MCQ14_SH_SINCOS_STEP ) );
+    t->cos = (int16_t)( t->cos + ( ( ( (int32_t)next.cos - t->cos ) * fraction ) >> MCQ14_SH_SINCOS_STEP ) );
+    t->ang = angle;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_OpenLoopControl                                       */
+/* Function parameters: rotationSign                                          */
+/* Function return: status                                                    */
+/* Description: Open loop speed ramp, same sequence as MCCTRL_OpenLoopControl */
+/******************************************************************************/
+__STATIC_INLINE tMCAPP_STATUS_E MCQ14_OpenLoopControl( const int16_t rotationSign )
+{
+    tMCAPP_STATUS_E status = MCAPP_IN_PROGRESS;
+    int32_t increment;
+
+    if( gMCQ14_CtrlSignals.openLoopSpeed < gMCQ14_Parameters.openLoopEndSpeed )
+    {
+        gMCQ14_CtrlSignals.openLoopSpeed += gMCQ14_Parameters.openLoopSpeedRate;
+    }
+    else
+    {
+        status = MCAPP_SUCCESS;
+    }
+
+    /* Set open loop reference current */
+    gMCQ14_CtrlSignals.iqRef = rotationSign * gMCQ14_Parameters.openLoopCurrent;
+    gMCQ14_CtrlSignals.idRef = 0;
+
+    gMCQ14_CtrlSignals.velRef = (int16_t)( gMCQ14_CtrlSignals.openLoopSpeed >> 16 );
+    increment = (int32_t)gMCQ14_CtrlSignals.velRef * gMCQ14_PLLParam.angleIncrement;
+    gMCQ14_CtrlSignals.angle += (uint32_t)( rotationSign * increment );
+    return status;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_FieldAlignment                                        */
+/* Function parameters: rotationSign                                          */
+/* Function return: status                                                    */
+/* Description: Q axis alignment, same sequence as MCRPOS_FieldAlignment      */
+/******************************************************************************/
+__STATIC_INLINE tMCAPP_STATUS_E MCQ14_FieldAlignment( const int16_t rotationSign )
+{
+    tMCAPP_STATUS_E status = MCAPP_IN_PROGRESS;
+
+    if( gMCQ14_CtrlSignals.alignCount < ( gMCQ14_Parameters.lockTimeCount >> 1 ) )
+    {
+        /* Current ramp in the first half of the alignment time */
+        gMCQ14_CtrlSignals.alignCurrent += gMCQ14_Parameters.lockCurrentStep;
+        gMCQ14_CtrlSignals.alignCount++;
+    }
+    else if( gMCQ14_CtrlSignals.alignCount < gMCQ14_Parameters.lockTimeCount )
+    {
+        gMCQ14_CtrlSignals.alignCurrent = (int32_t)gMCQ14_Parameters.openLoopCurrent << 16;
+        gMCQ14_CtrlSignals.alignCount++;
+    }
+    else
+    {
+        gMCQ14_CtrlSignals.alignCount = 0U;
+        status = MCAPP_SUCCESS;
+    }
+
+    gMCQ14_CtrlSignals.iqRef = (int16_t)( rotationSign * ( gMCQ14_CtrlSignals.alignCurrent >> 16 ) );
+    gMCQ14_CtrlSignals.idRef = 0;
+    gMCQ14_CtrlSignals.angle = ( rotationSign > 0 ) ? MCQ14_ANGLE_THREE_PI_HALVES : MCQ14_ANGLE_PI_HALVES;
+    return status;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_StateMachine                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Motor control state machine, same states as                  */
+/*              MCCTRL_StateMachine                                           */
+/******************************************************************************/
+__STATIC_INLINE void MCQ14_StateMachine( void )
+{
+    const int16_t rotationSign = gMCCTRL_CtrlParam.rotationSign;
+    int32_t increment;
+
+    switch( gMCCTRL_CtrlParam.mcState )
+    {
+        case MCAPP_IDLE:
+        {
+            /* Do not do anything */
+            gMCQ14_CtrlSignals.alignCurrent = 0;
+        }
+        break;
+
+        case MCAPP_FIELD_ALIGNMENT:
+        {
+            if( MCAPP_SUCCESS == MCQ14_FieldAlignment( rotationSign ) )
+            {
+                /* PLL initialization with the angle offset */
+                MCQ14_PLLReset( &gMCQ14_PLLState );
+                gMCQ14_PLLState.rhoOffset = rotationSign * gMCQ14_Parameters.angleOffset;
+                gMCCTRL_CtrlParam.mcState = MCAPP_OPEN_LOOP;
+            }
+        }
+        break;
+
+        case MCAPP_OPEN_LOOP:
+        {
+            if( MCAPP_SUCCESS == MCQ14_OpenLoopControl( rotationSign ) )
+            {
+                /* Bumpless transfer to the speed controller */
+                gMCQ14_SpeedPIController.imem = (int32_t)gMCQ14_CtrlSignals.iqRef << gMCQ14_SpeedPIController.shp;
+                gMCCTRL_CtrlParam.mcState = MCAPP_CLOSING_LOOP;
+            }
+        }
+        break;
+
+        case MCAPP_CLOSING_LOOP:
+        {
+            if( gMCQ14_CtrlSignals.closingLoopCount < CLOSING_LOOP_TIME_COUNTS )
+            {
+                gMCQ14_CtrlSignals.closingLoopCount++;
+            }
+            else
+            {
+                /* Switch to closed loop */
+              #if(OPEN_LOOP_FUNCTIONING == DISABLED)
+                gMCCTRL_CtrlParam.mcState = MCAPP_CLOSED_LOOP;
+                gMCQ14_CtrlSignals.closingLoopCount = 0U;
+              #endif
+            }
+
+            /* The angle set depends on startup ramp */
+            increment = (int32_t)gMCQ14_CtrlSignals.velRef * gMCQ14_PLLParam.angleIncrement;
+            gMCQ14_CtrlSignals.angle += (uint32_t)( rotationSign * increment );
+        }
+        break;
+
+        case MCAPP_CLOSED_LOOP:
+        {
+            gMCQ14_CtrlSignals.angle = gMCQ14_PLLState.rho;
+
+            /* Linearly ramp the rhoOffset to zero */
+            if( gMCQ14_PLLState.rhoOffset > gMCQ14_Parameters.angleOffsetStep )
+            {
+                gMCQ14_PLLState.rhoOffset -= gMCQ14_Parameters.angleOffsetStep;
+            }
+            else if( gMCQ14_PLLState.rhoOffset < -gMCQ14_Parameters.angleOffsetStep )
+            {
+                gMCQ14_PLLState.rhoOffset += gMCQ14_Parameters.angleOffsetStep;
+            }
+            else
+            {
+                gMCQ14_PLLState.rhoOffset = 0;
+            }
+
+            /* Dynamic d-q adjustment with d component priority */
+            gMCQ14_CtrlSignals.idRef = 0;
+            gMCQ14_IqPIController.hlim = library_scat( gMCQ14_Parameters.maxStatorVolt, gMCQ14_CtrlSignals.vdq.x );
+            gMCQ14_IqPIController.llim = -gMCQ14_IqPIController.hlim;
+
+          #if( DISABLED == TORQUE_MODE )
+            /* Quadrature axis reference current limitation and speed control */
+            gMCQ14_SpeedPIController.hlim = library_scat( gMCQ14_Parameters.maxMotorCurrent, gMCQ14_CtrlSignals.idRef );
+            gMCQ14_SpeedPIController.llim = -gMCQ14_SpeedPIController.hlim;
+            gMCQ14_CtrlSignals.iqRef = library_pi_control( (int32_t)( rotationSign * gMCQ14_CtrlSignals.speedRef )
+                                                           - gMCQ14_PLLState.velEstim, &gMCQ14_SpeedPIController );
+          #else
+            gMCQ14_CtrlSignals.iqRef = rotationSign * gMCQ14_Parameters.torqueCurrent;
+          #endif
+        }
+        break;
+
+        default:
+        {
+            /* Undefined state: Should never come here */
+        }
+    }
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCQ14_GainInitialize                                        */
+/* Function parameters: pGain - gain, gain - value                            */
+/* Function return: None                                                      */
+/* Description: Largest shift which keeps the mantissa in 16 bits             */
+/******************************************************************************/
+void MCQ14_GainInitialize( tMCQ14_GAIN_S * const pGain, const float gain )
+{
+    uint16_t shift = MCQ14_MAX_SHIFT;
+    float magnitude = ( gain < 0.0f ) ? -gain : gain;
+
+    while( ( shift > 0U ) && ( ( magnitude * (float)( 1UL << shift ) ) > (float)INT16_MAX ) )
+    {
+        shift--;
+    }
+    pGain->sh = shift;
+    pGain->k = (int16_t)( gain * (float)( 1UL << shift ) + ( ( gain < 0.0f ) ? -0.5f : 0.5f ) );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_PIInitialize                                          */
+/* Function parameters: pPI - controller, kp, ki - per unit gains per PWM     */
+/*                      period, limit - output limit                          */
+/* Function return: None                                                      */
+/* Description: Mantissas and shifts of library_pi_control, where the         */
+/*              proportional gain is kp / 2^shp and the integral gain is      */
+/*              ki / 2^(shi + shp)                                            */
+/******************************************************************************/
+void MCQ14_PIInitialize( pi_cntrl_t * const pPI, const float kp, const float ki, const int16_t limit )
+{
+    uint16_t shp = MCQ14_MAX_SHIFT;
+    uint16_t shi = MCQ14_MAX_SHIFT;
+
+    while( ( shp > 0U ) && ( ( kp * (float)( 1UL << shp ) ) > (float)INT16_MAX ) )
+    {
+        shp--;
+    }
+    while( ( shi > 0U ) && ( ( ki * (float)( 1UL << ( shi + shp ) ) ) > (float)INT16_MAX ) )
+    {
+        shi--;
+    }
+    pPI->kp = (int16_t)( kp * (float)( 1UL << shp ) + 0.5f );
+    pPI->shp = shp;
+    pPI->ki = (int16_t)( ki * (float)( 1UL << ( shi + shp ) ) + 0.5f );
+    pPI->shi = shi;
+    pPI->hlim = limit;
+    pPI->llim = -limit;
+    pPI->imem = 0;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_PLLInitialize                                         */
+/* Function parameters: pParam - PLL parameters                               */
+/* Function return: None                                                      */
+/* Description: Per unit PLL coefficients, same parameters as                 */
+/*              MCRPOS_InitializePLLEstimator                                 */
+/******************************************************************************/
+void MCQ14_PLLInitialize( tMCQ14_PLL_PARAM_S * const pParam )
+{
+    MCQ14_GainInitialize( &pParam->rs, (float)( MOTOR_PER_PHASE_RESISTANCE * MCQ14_CURRENT_BASE / MCQ14_VOLTAGE_BASE ) );
+    MCQ14_GainInitialize( &pParam->lsDt, (float)( ( MOTOR_PER_PHASE_INDUCTANCE / FAST_LOOP_TIME_SEC )
+                                                  * MCQ14_CURRENT_BASE / MCQ14_VOLTAGE_BASE ) );
+    MCQ14_GainInitialize( &pParam->invKFi, (float)( MCQ14_VOLTAGE_BASE
+                                                    / ( MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC * MCQ14_SPEED_BASE ) ) );
+    pParam->kFilterEsdq = (int32_t)( KFILTER_ESDQ * 65536.0f + 0.5f );
+    pParam->kFilterVel = (int32_t)( KFILTER_VELESTIM * 65536.0f + 0.5f );
+    pParam->decimateSpeed = MCQ14_FROM_FLOAT( DECIMATE_RATED_SPEED, MCQ14_SPEED_BASE );
+    pParam->angleIncrement = (int32_t)( (float)( MCQ14_SPEED_BASE * FAST_LOOP_TIME_SEC / Q14_BASE_VALUE * MCQ14_RAD_TO_ANGLE ) + 0.5f );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_PLLReset                                              */
+/* Function parameters: pState - PLL state                                    */
+/* Function return: None                                                      */
+/* Description: Reset PLL estimator state                                     */
+/******************************************************************************/
+void MCQ14_PLLReset( tMCQ14_PLL_STATE_S * const pState )
+{
+    pState->iLast.x = 0;
+    pState->iLast.y = 0;
+    pState->uLast.x = 0;
+    pState->uLast.y = 0;
+    pState->esdState = 0;
+    pState->esqState = 0;
+    pState->velState = 0;
+    pState->esdf = 0;
+    pState->esqf = 0;
+    pState->omegaMr = 0;
+    pState->velEstim = 0;
+    pState->rho = 0U;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_PLLEstimator                                          */
+/* Function parameters: iab - alpha-beta current                              */
+/*                      uab - alpha-beta voltage reference, relative to umax  */
+/*                      umax - DC bus voltage / DC_BUS_VOLTAGE                */
+/*                      pParam, pState - PLL parameters and state             */
+/* Function return: None                                                      */
+/* Description: PLL estimator, same equations as MCRPOS_PLLEstimator          */
+/******************************************************************************/
+void MCQ14_PLLEstimator( const vec2_t * const iab, const vec2_t * const uab, const int16_t umax,
+                         const tMCQ14_PLL_PARAM_S * const pParam, tMCQ14_PLL_STATE_S * const pState )
+{
+    ang_sincos_t position;
+    vec2_t es, esdq;
+    int16_t velAbs, esdf;
+
+    velAbs = ( pState->velEstim < 0 ) ? -pState->velEstim : pState->velEstim;
+
+    /* Stator voltage equations: Es = Us - Rs is - Ls dis/dt */
+    es.x = MCQ14_Saturate( (int32_t)pState->uLast.x - MCQ14_Gain( iab->x, &pParam->rs )
+                           - MCQ14_Gain( MCQ14_Saturate( (int32_t)iab->x - pState->iLast.x ), &pParam->lsDt ) );
+    es.y = MCQ14_Saturate( (int32_t)pState->uLast.y - MCQ14_Gain( iab->y, &pParam->rs )
+                           - MCQ14_Gain( MCQ14_Saturate( (int32_t)iab->y - pState->iLast.y ), &pParam->lsDt ) );
+
+    /* Park transform of the BEMF with the estimated angle and the offset */
+    position.ang = (uint16_t)( ( pState->rho + (uint32_t)pState->rhoOffset ) >> 16 );
+    MCQ14_SinCos( &position );
+    library_ab_dq( &position, &es, &esdq );
+
+    /* First order filters of Esd and Esq */
+    pState->esdf = MCQ14_Filter( &pState->esdState, esdq.x, pParam->kFilterEsdq );
+    pState->esqf = MCQ14_Filter( &pState->esqState, esdq.y, pParam->kFilterEsdq );
+
+    /* OmegaMr = InvKfi * (Esqf - sgn(Esqf) * Esdf), below 10% of the rated
+       speed the sign of the estimated speed is used for stability */
+    if( velAbs > pParam->decimateSpeed )
+    {
+        esdf = ( pState->esqf > 0 ) ? pState->esdf : -pState->esdf;
+    }
+    else
+    {
+        esdf = ( pState->velEstim > 0 ) ? pState->esdf : -pState->esdf;
+    }
+    pState->omegaMr = MCQ14_Gain( MCQ14_Saturate( (int32_t)pState->esqf - esdf ), &pParam->invKFi );
+
+    /* The integral of the speed is the angle, which wraps at 2pi */
+    pState->rho += (uint32_t)( (int32_t)pState->omegaMr * pParam->angleIncrement );
+
+    /* Estimated speed */
+    pState->velEstim = MCQ14_Filter( &pState->velState, pState->omegaMr, pParam->kFilterVel );
+
+    /* State for the next cycle */
+    pState->iLast = *iab;
+    pState->uLast.x = (int16_t)( ( (int32_t)umax * uab->x ) >> Q14_SH_BASE_VALUE );
+    pState->uLast.y = (int16_t)( ( (int32_t)umax * uab->y ) >> Q14_SH_BASE_VALUE );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_SpaceVectorModulation                                 */
+/* Function parameters: vab - alpha-beta voltage, relative to umax            */
+/*                      period - PWM period, counts, below 2^16               */
+/*                      svm - duty cycle output                               */
+/* Function return: None                                                      */
+/* Description: Sector based SVPWM, same sectors as MCPWM_SVPWMGen            */
+/******************************************************************************/
+void MCQ14_SpaceVectorModulation( const vec2_t * const vab, const int32_t period, tMCPWM_SVPWM_S * const svm )
+{
+    int32_t vr1, vr2, vr3, t1, t2, ta, tb, tc;
+
+    /* Reference vectors */
+    vr1 = vab->y;
+    vr2 = ( (int32_t)vab->x * Q14_SQRT3_BY2 - ( (int32_t)vab->y << ( Q14_SH_BASE_VALUE - 1U ) ) ) >> Q14_SH_BASE_VALUE;
+    vr3 = -vr1 - vr2;
+
+    /* Space vector times of the sector */
+    if( vr1 >= 0 )
+    {
+        if( vr2 >= 0 )
+        {
+            /* Sector 3: 0-60 degrees */
+            t1 = vr2;
+            t2 = vr1;
+        }
+        else if( vr3 >= 0 )
+        {
+            /* Sector 5: 120-180 degrees */
+            t1 = vr1;
+            t2 = vr3;
+        }
+        else
+        {
+            /* Sector 1: 60-120 degrees */
+            t1 = -vr2;
+            t2 = -vr3;
+        }
+    }
+    else
+    {
+        if( vr2 >= 0 )
+        {
+            if( vr3 >= 0 )
+            {
+                /* Sector 6: 240-300 degrees */
+                t1 = vr3;
+                t2 = vr2;
+            }
+            else
+            {
+                /* Sector 2: 300-0 degrees */
+                t1 = -vr3;
+                t2 = -vr1;
+            }
+        }
+        else
+        {
+            /* Sector 4: 180-240 degrees */
+            t1 = -vr1;
+            t2 = -vr2;
+        }
+    }
+
+    t1 = ( period * t1 ) >> Q14_SH_BASE_VALUE;
+    t2 = ( period * t2 ) >> Q14_SH_BASE_VALUE;
+    tc = ( period - t1 - t2 ) >> 1;
+    tb = tc + t2;
+    ta = tb + t1;
+
+    if( vr1 >= 0 )
+    {
+        if( vr2 >= 0 )
+        {
+            svm->dPwm1 = (uint32_t)ta;
+            svm->dPwm2 = (uint32_t)tb;
+            svm->dPwm3 = (uint32_t)tc;
+        }
+        else if( vr3 >= 0 )
+        {
+            svm->dPwm1 = (uint32_t)tc;
+            svm->dPwm2 = (uint32_t)ta;
+            svm->dPwm3 = (uint32_t)tb;
+        }
+        else
+        {
+            svm->dPwm1 = (uint32_t)tb;
+            svm->dPwm2 = (uint32_t)ta;
+            svm->dPwm3 = (uint32_t)tc;
+        }
+    }
+    else
+    {
+        if( vr2 >= 0 )
+        {
+            if( vr3 >= 0 )
+            {
+                svm->dPwm1 = (uint32_t)tb;
+                svm->dPwm2 = (uint32_t)tc;
+                svm->dPwm3 = (uint32_t)ta;
+            }
+            else
+            {
+                svm->dPwm1 = (uint32_t)ta;
+                svm->dPwm2 = (uint32_t)tc;
+                svm->dPwm3 = (uint32_t)tb;
+            }
+        }
+        else
+        {
+            svm->dPwm1 = (uint32_t)tc;
+            svm->dPwm2 = (uint32_t)tb;
+            svm->dPwm3 = (uint32_t)ta;
+        }
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_InitializeControl                                     */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Integer coefficients from the floating point configuration.   */
+/*              Called once before the control interrupt is enabled.          */
+/******************************************************************************/
+void MCQ14_InitializeControl( void )
+{
+    const float lockCurrent = (float)( Q_CURRENT_REF_OPENLOOP / MCQ14_CURRENT_BASE * 1073741824.0 );
+    const float openLoopEndSpeed = (float)( OPEN_LOOP_END_SPEED_RADS_PER_SEC_ELEC / MCQ14_SPEED_BASE * 1073741824.0 );
+
+    /* Measurement scaling */
+    MCQ14_GainInitialize( &gMCQ14_Parameters.adcCurrent,
+                          (float)( ADC_CURRENT_SCALE / MCQ14_CURRENT_BASE * Q14_BASE_VALUE ) );
+    MCQ14_GainInitialize( &gMCQ14_Parameters.adcVoltage,
+                          (float)( VOLTAGE_ADC_TO_PHY_RATIO / DC_BUS_VOLTAGE * Q14_BASE_VALUE ) );
+
+    /* Limits and references */
+    gMCQ14_Parameters.maxStatorVolt = MCQ14_FROM_FLOAT( MAX_STATOR_VOLT, 1.0f );
+    gMCQ14_Parameters.maxMotorCurrent = MCQ14_FROM_FLOAT( MAX_MOTOR_CURRENT, MCQ14_CURRENT_BASE );
+    gMCQ14_Parameters.openLoopCurrent = MCQ14_FROM_FLOAT( Q_CURRENT_REF_OPENLOOP, MCQ14_CURRENT_BASE );
+    gMCQ14_Parameters.torqueCurrent = MCQ14_FROM_FLOAT( Q_CURRENT_REF_TORQUE, MCQ14_CURRENT_BASE );
+
+    /* Startup */
+    gMCQ14_Parameters.lockTimeCount = LOCK_COUNT_FOR_LOCK_TIME;
+    gMCQ14_Parameters.lockCurrentStep = (int32_t)( lockCurrent / (float)( LOCK_COUNT_FOR_LOCK_TIME >> 1 ) );
+    gMCQ14_Parameters.openLoopEndSpeed = (int32_t)openLoopEndSpeed;
+    gMCQ14_Parameters.openLoopSpeedRate = (int32_t)( openLoopEndSpeed * (float)( FAST_LOOP_TIME_SEC / OPEN_LOOP_RAMP_TIME_IN_SEC ) + 0.5f );
+    gMCQ14_Parameters.angleOffset = (int32_t)( (float)( ANGLE_OFFSET_DEG / 360.0 ) * 4294967296.0f );
+    gMCQ14_Parameters.angleOffsetStep = (int32_t)( (float)( ANGLE_OFFSET_MIN * MCQ14_RAD_TO_ANGLE ) + 0.5f );
+    gMCQ14_Parameters.period = (int32_t)MCHAL_PWMPrimaryPeriodGet( MCHAL_PWM_PH_U );
+
+    /* Controllers: current to voltage relative to umax, speed to current */
+    MCQ14_PIInitialize( &gMCQ14_IqPIController, (float)( Q_CURRCNTR_PTERM * MCQ14_CURRENT_BASE ),
+                        (float)( Q_CURRCNTR_ITERM * MCQ14_CURRENT_BASE ), MCQ14_FROM_FLOAT( Q_CURRCNTR_OUTMAX, 1.0f ) );
+    MCQ14_PIInitialize( &gMCQ14_IdPIController, (float)( D_CURRCNTR_PTERM * MCQ14_CURRENT_BASE ),
+                        (float)( D_CURRCNTR_ITERM * MCQ14_CURRENT_BASE ), MCQ14_FROM_FLOAT( D_CURRCNTR_OUTMAX, 1.0f ) );
+    MCQ14_PIInitialize( &gMCQ14_SpeedPIController, (float)( SPEEDCNTR_PTERM * MCQ14_SPEED_BASE / MCQ14_CURRENT_BASE ),
+                        (float)( SPEEDCNTR_ITERM * MCQ14_SPEED_BASE / MCQ14_CURRENT_BASE ),
+                        gMCQ14_Parameters.maxMotorCurrent );
+
+    /* PLL estimator */
+    MCQ14_PLLInitialize( &gMCQ14_PLLParam );
+
+    MCQ14_ResetControl();
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_ResetControl                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Reset controller and estimator states                         */
+/******************************************************************************/
+void MCQ14_ResetControl( void )
+{
+    gMCQ14_IqPIController.imem = 0;
+    gMCQ14_IqPIController.hlim = MCQ14_FROM_FLOAT( Q_CURRCNTR_OUTMAX, 1.0f );
+    gMCQ14_IqPIController.llim = -gMCQ14_IqPIController.hlim;
+    gMCQ14_IdPIController.imem = 0;
+    gMCQ14_SpeedPIController.imem = 0;
+
+    gMCQ14_CtrlSignals.vdq.x = 0;
+    gMCQ14_CtrlSignals.vdq.y = 0;
+    gMCQ14_CtrlSignals.vab.x = 0;
+    gMCQ14_CtrlSignals.vab.y = 0;
+    gMCQ14_CtrlSignals.idRef = 0;
+    gMCQ14_CtrlSignals.iqRef = 0;
+    gMCQ14_CtrlSignals.velRef = 0;
+    gMCQ14_CtrlSignals.angle = 0U;
+    gMCQ14_CtrlSignals.alignCurrent = 0;
+    gMCQ14_CtrlSignals.alignCount = 0U;
+    gMCQ14_CtrlSignals.openLoopSpeed = 0;
+    gMCQ14_CtrlSignals.closingLoopCount = 0U;
+
+    MCQ14_PLLReset( &gMCQ14_PLLState );
+    gMCQ14_PLLState.rhoOffset = 0;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_ReadCurrentOffsets                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Integer copy of the offsets of MCCUR_OffsetCalibration        */
+/******************************************************************************/
+void MCQ14_ReadCurrentOffsets( void )
+{
+    gMCQ14_CtrlSignals.iuOffset = (int16_t)gMCCUR_OutputSignals.iuOffset;
+    gMCQ14_CtrlSignals.ivOffset = (int16_t)gMCCUR_OutputSignals.ivOffset;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_CurrentMeasurement                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Phase currents with offset correction                         */
+/******************************************************************************/
+void MCQ14_CurrentMeasurement( void )
+{
+    int16_t iu, iv;
+
+    iu = (int16_t)( MCHAL_ADCChannelResultGet( MCHAL_ADC_PH_U ) >> MCHAL_ADC_RESULT_SHIFT );
+    iv = (int16_t)( MCHAL_ADCChannelResultGet( MCHAL_ADC_PH_V ) >> MCHAL_ADC_RESULT_SHIFT );
+
+    gMCQ14_CtrlSignals.iuvw.u = MCQ14_Gain( gMCQ14_CtrlSignals.iuOffset - iu, &gMCQ14_Parameters.adcCurrent );
+    gMCQ14_CtrlSignals.iuvw.v = MCQ14_Gain( gMCQ14_CtrlSignals.ivOffset - iv, &gMCQ14_Parameters.adcCurrent );
+
+    /* Calculate phase W current by Kirchoff's principle */
+    gMCQ14_CtrlSignals.iuvw.w = -gMCQ14_CtrlSignals.iuvw.u - gMCQ14_CtrlSignals.iuvw.v;
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_VoltageMeasurement                                    */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: DC bus voltage relative to DC_BUS_VOLTAGE                     */
+/******************************************************************************/
+void MCQ14_VoltageMeasurement( void )
+{
+    int16_t raw;
+
+    raw = (int16_t)( MCHAL_ADCChannelResultGet( MCHAL_ADC_VDC ) >> MCHAL_ADC_RESULT_SHIFT );
+    gMCQ14_CtrlSignals.umax = MCQ14_Gain( raw, &gMCQ14_Parameters.adcVoltage );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_SignalTransformation                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clarke and Park transform                                     */
+/******************************************************************************/
+void MCQ14_SignalTransformation( void )
+{
+    library_uvw_ab( &gMCQ14_CtrlSignals.iuvw, &gMCQ14_CtrlSignals.iab );
+    library_ab_dq( &gMCQ14_CtrlSignals.position, &gMCQ14_CtrlSignals.iab, &gMCQ14_CtrlSignals.idq );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_PositionMeasurement                                   */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: PLL estimator with the voltage of the previous cycle          */
+/******************************************************************************/
+void MCQ14_PositionMeasurement( void )
+{
+    MCQ14_PLLEstimator( &gMCQ14_CtrlSignals.iab, &gMCQ14_CtrlSignals.vab, gMCQ14_CtrlSignals.umax,
+                        &gMCQ14_PLLParam, &gMCQ14_PLLState );
+}
+
+/******************************************************************************/
+/* Function name: MCQ14_MotorControl                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: State machine, current control, inverse Park and SVPWM       */
+/******************************************************************************/
+void MCQ14_MotorControl( void )
+{
+    /* Control state machine */
+    MCQ14_StateMachine();
+
+    /* PI control for Iq torque control loop and Id flux control loop */
+    gMCQ14_CtrlSignals.vdq.y = library_pi_control( (int32_t)gMCQ14_CtrlSignals.iqRef - gMCQ14_CtrlSignals.idq.y,
+                                                   &gMCQ14_IqPIController );
+    gMCQ14_CtrlSignals.vdq.x = library_pi_control( (int32_t)gMCQ14_CtrlSignals.idRef - gMCQ14_CtrlSignals.idq.x,
+                                                   &gMCQ14_IdPIController );
+
+    /* Sine and cosine of the new angle, inverse Park transform */
+    gMCQ14_CtrlSignals.position.ang = (uint16_t)( gMCQ14_CtrlSignals.angle >> 16 );
+    MCQ14_SinCos( &gMCQ14_CtrlSignals.position );
+    library_dq_ab( &gMCQ14_CtrlSignals.position, &gMCQ14_CtrlSignals.vdq, &gMCQ14_CtrlSignals.vab );
+
+    /* PWM modulation */
+    MCQ14_SpaceVectorModulation( &gMCQ14_CtrlSignals.vab, gMCQ14_Parameters.period, &gMCPWM_SVPWM );
+    MCPWM_PWMDutyUpdate( &gMCPWM_SVPWM );
+
+    /* X2C scope update */
+    MCHAL_X2C_Update();
+}
+#endif
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,213 @@
+/*******************************************************************************
+ Q2.14 Fixed Point Control Backend interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_foc_q14.h
+
+  Summary:
+    Header file for mc_foc_q14.c
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    Q2.14 fixed point control backend, selected with ARITHMETIC ==
+    ARITHMETIC_Q14. The backend runs the stages of MCCTRL_CurrentLoopTasks
+    with the integer primitives of mc_q14_lib.h for parts without a floating
+    point unit. The signals are normalized to the bases below, 16384 = 1.0:
+
+      current   MCQ14_CURRENT_BASE  A, full scale of the current measurement
+      voltage   MCQ14_VOLTAGE_BASE  V, phase voltage limit at DC_BUS_VOLTAGE
+      speed     MCQ14_SPEED_BASE    electrical rad/s
+      angle     32 bit, 2^32 = 2pi, the upper 16 bits are the library angle
+
+    The voltage references are relative to the measured phase voltage limit,
+    as in the floating point path.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_FOC_Q14_H
+#define MC_FOC_Q14_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include <stdint.h>
+#include "mc_pmsm_foc_common.h"
+#include "mc_pwm.h"
+#include "mc_q14_lib.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Per unit bases */
+#define MCQ14_CURRENT_BASE                  (MAX_CURRENT)
+#define MCQ14_VOLTAGE_BASE                  (DC_BUS_VOLTAGE / SQRT3)
+#define MCQ14_SPEED_BASE                    (MAX_SPEED_RAD_PER_SEC_ELEC)
+
+/* Conversions between physical values and Q2.14, for the slow loop and initialization */
+#define MCQ14_FROM_FLOAT( value, base )     ((int16_t)( (float)(value) * ( (float)Q14_BASE_VALUE / (float)(base) ) ))
+#define MCQ14_TO_FLOAT( value, base )       ( (float)(value) * ( (float)(base) / (float)Q14_BASE_VALUE ) )
+#define MCQ14_ANGLE_TO_FLOAT( angle )       ( (float)(angle) * (float)( 2.0 * 3.14159265358979323846 / 4294967296.0 ) )
+
+/* Gain with a 16 bit mantissa, y = ( x * k ) >> sh, rounded */
+typedef struct
+{
+    int16_t                     k;
+    uint16_t                    sh;
+}tMCQ14_GAIN_S;
+
+/* PLL estimator parameters, per unit */
+typedef struct
+{
+    tMCQ14_GAIN_S               rs;                 /* Rs                                               */
+    tMCQ14_GAIN_S               lsDt;               /* Ls / Ts                                          */
+    tMCQ14_GAIN_S               invKFi;             /* 1 / BEMF constant                                */
+    int32_t                     kFilterEsdq;        /* BEMF filter coefficient, Q16                     */
+    int32_t                     kFilterVel;         /* Speed filter coefficient, Q16                    */
+    int16_t                     decimateSpeed;      /* Speed below which the speed sign is used         */
+    int32_t                     angleIncrement;     /* Angle per PWM period at a speed of 1, 2^32 = 2pi */
+}tMCQ14_PLL_PARAM_S;
+
+/* PLL estimator state */
+typedef struct
+{
+    vec2_t                      iLast;              /* Alpha-beta current of the previous cycle         */
+    vec2_t                      uLast;              /* Alpha-beta voltage of the previous cycle         */
+    int32_t                     esdState;           /* Filter states, Q14 << 16                         */
+    int32_t                     esqState;
+    int32_t                     velState;
+    int16_t                     esdf;               /* Filtered BEMF, rotating frame                    */
+    int16_t                     esqf;
+    int16_t                     omegaMr;            /* Unfiltered speed                                 */
+    int16_t                     velEstim;           /* Estimated speed                                  */
+    uint32_t                    rho;                /* Estimated angle                                  */
+    int32_t                     rhoOffset;          /* Angle offset while switching to closed loop      */
+}tMCQ14_PLL_STATE_S;
+
+/* Control parameters */
+typedef struct
+{
+    tMCQ14_GAIN_S               adcCurrent;         /* ADC counts to current                            */
+    tMCQ14_GAIN_S               adcVoltage;         /* ADC counts to DC bus voltage / DC_BUS_VOLTAGE    */
+    int16_t                     maxStatorVolt;      /* Voltage vector limit                             */
+    int16_t                     maxMotorCurrent;    /* Current vector limit                             */
+    int16_t                     openLoopCurrent;    /* Q axis current in alignment and open loop        */
+    int16_t                     torqueCurrent;      /* Q axis current in torque mode                    */
+    uint32_t                    lockTimeCount;      /* Alignment time, PWM periods                      */
+    int32_t                     lockCurrentStep;    /* Alignment current ramp per PWM period, Q30       */
+    int32_t                     openLoopEndSpeed;   /* Open loop end speed, Q30                         */
+    int32_t                     openLoopSpeedRate;  /* Open loop speed ramp per PWM period, Q30         */
+    int32_t                     angleOffset;        /* Estimator offset while switching to closed loop  */
+    int32_t                     angleOffsetStep;    /* Offset ramp per PWM period                       */
+    int32_t                     period;             /* PWM period, counts                               */
+}tMCQ14_PARAMETERS_S;
+
+/* Control signals */
+typedef struct
+{
+    vec3_t                      iuvw;               /* Phase currents                                   */
+    vec2_t                      iab;                /* Alpha-beta current                               */
+    vec2_t                      idq;                /* D-Q current                                      */
+    vec2_t                      vdq;                /* D-Q voltage reference                            */
+    vec2_t                      vab;                /* Alpha-beta voltage reference                     */
+    ang_sincos_t                position;           /* Control angle with sine and cosine               */
+    uint32_t                    angle;              /* Control angle                                    */
+    int16_t                     iuOffset;           /* Current sensor offsets, ADC counts               */
+    int16_t                     ivOffset;
+    int16_t                     umax;               /* DC bus voltage / DC_BUS_VOLTAGE                  */
+    int16_t                     idRef;
+    int16_t                     iqRef;
+    int16_t                     speedRef;           /* Speed command of the slow loop                   */
+    int16_t                     velRef;             /* Open loop speed                                  */
+    int32_t                     alignCurrent;       /* Alignment current, Q30                           */
+    uint32_t                    alignCount;
+    int32_t                     openLoopSpeed;      /* Open loop speed, Q30                             */
+    uint32_t                    closingLoopCount;
+}tMCQ14_CONTROL_SIGNALS_S;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+extern tMCQ14_PARAMETERS_S          gMCQ14_Parameters;
+extern tMCQ14_CONTROL_SIGNALS_S     gMCQ14_CtrlSignals;
+extern tMCQ14_PLL_PARAM_S           gMCQ14_PLLParam;
+extern tMCQ14_PLL_STATE_S           gMCQ14_PLLState;
+extern pi_cntrl_t                   gMCQ14_IdPIController;
+extern pi_cntrl_t                   gMCQ14_IqPIController;
+extern pi_cntrl_t                   gMCQ14_SpeedPIController;
+
+void MCQ14_InitializeControl( void );
+void MCQ14_ResetControl( void );
+void MCQ14_ReadCurrentOffsets( void );
+void MCQ14_GainInitialize( tMCQ14_GAIN_S * const pGain, const float gain );
+void MCQ14_PIInitialize( pi_cntrl_t * const pPI, const float kp, const float ki, const int16_t limit );
+void MCQ14_PLLInitialize( tMCQ14_PLL_PARAM_S * const pParam );
+void MCQ14_PLLReset( tMCQ14_PLL_STATE_S * const pState );
+void MCQ14_PLLEstimator( const vec2_t * const iab, const vec2_t * const uab, const int16_t umax,
+                         const tMCQ14_PLL_PARAM_S * const pParam, tMCQ14_PLL_STATE_S * const pState );
+void MCQ14_SpaceVectorModulation( const vec2_t * const vab, const int32_t period, tMCPWM_SVPWM_S * const svm );
+
+/* Stages of MCCTRL_CurrentLoopTasks */
+void MCQ14_CurrentMeasurement( void );
+void MCQ14_VoltageMeasurement( void );
+void MCQ14_SignalTransformation( void );
+void MCQ14_PositionMeasurement( void );
+void MCQ14_MotorControl( void );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif    /* MC_FOC_Q14_H */
+
+/**
+ End of File
+*/
@@ -47,7 +47,9 @@
 
 #include "definitions.h"                // SYS function prototypes
 #include "mc_generic_lib.h"
+#include "mc_placement.h"
 
+#if (SINCOS_METHOD == SINCOS_INTERPOLATED_TABLE) || defined(MCLIB_SINCOS_ALL_METHODS)
 /******************************************************************************/
 /*                   SIN Table  256  -  0.0244rad resolution                            */
 /******************************************************************************/
@@ -130,13 +132,13 @@ float cosineTable[TABLE_SIZE] =
 // </editor-fold>
 
 /******************************************************************************/
-/* Function name: MCLIB_SinCosCalc                                            */
+/* Function name: MCLIB_SinCosTable                                           */
 /* Function parameters: rotor_angle                                           */
 /* Function return: sineAngle, cosAngle                                       */
 /* Description: Calculates the sin and cosine of angle based upon             */
 /*              interpolation technique from the table.                       */
 /******************************************************************************/
-void MCLIB_SinCosCalc( float const rotor_angle, float* sineAngle, float* cosAngle )
+void MCLIB_SinCosTable( float const rotor_angle, float* sineAngle, float* cosAngle )
 {
     float angle = rotor_angle;
     /*
@@ -185,6 +187,244 @@ void MCLIB_SinCosCalc( float const rotor_angle, float* sineAngle, float* cosAngl
     *cosAngle = y0 + ((y1 - y0) * temp);
 
 }
+#endif
+
+#if (SINCOS_METHOD == SINCOS_QUARTER_WAVE_TABLE) || defined(MCLIB_SINCOS_ALL_METHODS)
+/******************************************************************************/
+/*         Quarter wave SIN Table  64 + 1  -  0.0245rad resolution            */
+/******************************************************************************/
+const float quarterSineTable[QUARTER_TABLE_SIZE + 1] =
+{
+     0.0000000,  0.0245412,  0.0490677,  0.0735646,  0.0980171,  0.1224107,  0.1467305,  0.1709619,
+     0.1950903,  0.2191012,  0.2429802,  0.2667128,  0.2902847,  0.3136817,  0.3368899,  0.3598950,
+     0.3826834,  0.4052413,  0.4275551,  0.4496113,  0.4713967,  0.4928982,  0.5141027,  0.5349976,
+     0.5555702,  0.5758082,  0.5956993,  0.6152316,  0.6343933,  0.6531728,  0.6715590,  0.6895405,
+     0.7071068,  0.7242471,  0.7409511,  0.7572088,  0.7730105,  0.7883464,  0.8032075,  0.8175848,
+     0.8314696,  0.8448536,  0.8577286,  0.8700870,  0.8819213,  0.8932243,  0.9039893,  0.9142098,
+     0.9238795,  0.9329928,  0.9415441,  0.9495282,  0.9569403,  0.9637761,  0.9700313,  0.9757021,
+     0.9807853,  0.9852776,  0.9891765,  0.9924795,  0.9951847,  0.9972905,  0.9987955,  0.9996988,
+     1.0000000
+};
+
+/******************************************************************************/
+/* Function name: MCLIB_QuarterWaveLookup                                     */
+/* Function parameters: index - table index over a full turn [0, 4*QUARTER]   */
+/*                      fraction - interpolation fraction [0, 1)              */
+/* Function return: sine                                                      */
+/* Description: Interpolated sine from the quarter wave table using the      */
+/*              symmetries of the sine wave                                   */
+/******************************************************************************/
+__STATIC_INLINE float MCLIB_QuarterWaveLookup( uint32_t index, const float fraction )
+{
+    uint32_t quadrant = ( index / QUARTER_TABLE_SIZE ) & 3U;
+    uint32_t offset = index % QUARTER_TABLE_SIZE;
+    float y0, y1;
+
+    if( 0U == ( quadrant & 1U ) )
+    {
+        /* Rising quarter */
+        y0 = quarterSineTable[offset];
+        y1 = quarterSineTable[offset + 1U];
+    }
+    else
+    {
+        /* Falling quarter */
+        y0 = quarterSineTable[QUARTER_TABLE_SIZE - offset];
+        y1 = quarterSineTable[QUARTER_TABLE_SIZE - offset - 1U];
+    }
+
+    y0 = y0 + ( ( y1 - y0 ) * fraction );
+    return ( quadrant < 2U ) ? y0 : -y0;
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_SinCosQuarterWave                                     */
+/* Function parameters: rotor_angle                                           */
+/* Function return: sineAngle, cosAngle                                       */
+/* Description: Calculates the sine and cosine of angle by interpolation in   */
+/*              a single quarter wave table. The cosine is the sine shifted   */
+/*              by a quarter wave.                                            */
+/******************************************************************************/
+void MCLIB_SinCosQuarterWave( float const rotor_angle, float* sineAngle, float* cosAngle )
+{
+    float angle = rotor_angle;
+    float position, fraction;
+    uint32_t index;
+
+    // Software check to ensure  0 <= Angle < 2*PI
+    if( angle <  0 )
+    {
+        angle = angle + TOTAL_SINE_TABLE_ANGLE;
+    }
+
+    if( angle >= TOTAL_SINE_TABLE_ANGLE  )
+    {
+        angle = angle - TOTAL_SINE_TABLE_ANGLE;
+    }
+
+    position = angle * ( (float)( 4U * QUARTER_TABLE_SIZE ) / TOTAL_SINE_TABLE_ANGLE );
+    index = (uint32_t)position;
+    fraction = position - (float)index;
+
+    *sineAngle = MCLIB_QuarterWaveLookup( index, fraction );
+    *cosAngle = MCLIB_QuarterWaveLookup( index + QUARTER_TABLE_SIZE, fraction );
+}
+#endif
+
+#if (SINCOS_METHOD == SINCOS_POLYNOMIAL) || (SINCOS_METHOD == SINCOS_CORDIC) || defined(MCLIB_SINCOS_ALL_METHODS)
+/******************************************************************************/
+/* Function name: MCLIB_QuadrantReduction                                     */
+/* Function parameters: angle - angle in [-2pi, 4pi)                          */
+/*                      reduced - angle in [-pi/4, pi/4]                      */
+/* Function return: quadrant 0..3                                             */
+/* Description: Subtracts the nearest multiple of pi/2 from the angle         */
+/******************************************************************************/
+__STATIC_INLINE uint32_t MCLIB_QuadrantReduction( float const angle, float * const reduced )
+{
+    int32_t quadrant = (int32_t)( ( angle * ( 2.0f / (float)M_PI ) ) + 4.5f ) - 4;
+
+    *reduced = angle - ( (float)quadrant * ( 0.5f * (float)M_PI ) );
+    return (uint32_t)quadrant & 3U;
+}
+
+/******************************************************************************/
+/* Function name: MCLIB_QuadrantRotation                                      */
+/* Function parameters: quadrant, sine and cosine of the reduced angle        */
+/* Function return: sineAngle, cosAngle                                       */
+/* Description: Adds the quadrant back by swapping and negating               */
+/******************************************************************************/
+__STATIC_INLINE void MCLIB_QuadrantRotation( const uint32_t quadrant, const float sine, const float cosine,
+                                             float* sineAngle, float* cosAngle )
+{
+    switch( quadrant )
+    {
+        case 0U:
+        {
+            *sineAngle = sine;
+            *cosAngle = cosine;
+        }
+        break;
+        case 1U:
+        {
+            *sineAngle = cosine;
+            *cosAngle = -sine;
+        }
+        break;
+        case 2U:
+        {
+            *sineAngle = -sine;
+            *cosAngle = -cosine;
+        }
+        break;
+        default:
+        {
+            *sineAngle = -cosine;
+            *cosAngle = sine;
+        }
+        break;
+    }
+}
+#endif
+
+#if (SINCOS_METHOD == SINCOS_POLYNOMIAL) || defined(MCLIB_SINCOS_ALL_METHODS)
+/******************************************************************************/
+/* Function name: MCLIB_SinCosPolynomial                                      */
+/* Function parameters: rotor_angle                                           */
+/* Function return: sineAngle, cosAngle                                       */
+/* Description: Calculates the sine and cosine of angle with minimax          */
+/*              polynomials on [-pi/4, pi/4] after a single quadrant          */
+/*              reduction. No table and no division are required.            */
+/******************************************************************************/
+void MCLIB_SinCosPolynomial( float const rotor_angle, float* sineAngle, float* cosAngle )
+{
+    float reduced, square, sine, cosine;
+    uint32_t quadrant;
+
+    quadrant = MCLIB_QuadrantReduction( rotor_angle, &reduced );
+    square = reduced * reduced;
+
+    /* Minimax coefficients, maximum error below 1e-7 on [-pi/4, pi/4] */
+    sine = reduced + ( reduced * square * ( -1.6666654611e-1f + square * ( 8.3321608736e-3f + square * -1.9515295891e-4f ) ) );
+    cosine = 1.0f - ( 0.5f * square )
+           + ( square * square * ( 4.166664568298827e-2f + square * ( -1.388731625493765e-3f + square * 2.443315711809948e-5f ) ) );
+
+    MCLIB_QuadrantRotation( quadrant, sine, cosine, sineAngle, cosAngle );
+}
+#endif
+
+#if (SINCOS_METHOD == SINCOS_CORDIC) || defined(MCLIB_SINCOS_ALL_METHODS)
+/******************************************************************************/
+/*            CORDIC arc tangent table atan(2^-i) in Q29 radians              */
+/******************************************************************************/
+const int32_t cordicAtanTable[CORDIC_ITERATIONS] =
+{
+     421657428,  248918915,  131521918,   66762579,   33510843,   16771758,
+       8387925,    4194219,    2097141,    1048575,     524288,     262144,
+        131072,      65536,      32768,      16384,       8192,       4096,
+          2048,       1024,        512,        256,        128,         64
+};
+
+/******************************************************************************/
+/* Function name: MCLIB_SinCosCordic                                          */
+/* Function parameters: rotor_angle                                           */
+/* Function return: sineAngle, cosAngle                                       */
+/* Description: Calculates the sine and cosine of angle with a fixed point    */
+/*              rotation mode CORDIC after a single quadrant reduction. Each  */
+/*              iteration adds about one bit of accuracy.                    */
+/******************************************************************************/
+void MCLIB_SinCosCordic( float const rotor_angle, float* sineAngle, float* cosAngle )
+{
+    float reduced;
+    uint32_t quadrant, i;
+    int32_t x, y, z, xNext;
+
+    quadrant = MCLIB_QuadrantReduction( rotor_angle, &reduced );
+
+    /* Start with the CORDIC gain compensation, Q30 */
+    x = CORDIC_GAIN_Q30;
+    y = 0;
+    z = (int32_t)( reduced * CORDIC_ANGLE_SCALE );
+
+    for( i = 0U; i < CORDIC_ITERATIONS; i++ )
+    {
+        if( z >= 0 )
+        {
+            xNext = x - ( y >> i );
+            y = y + ( x >> i );
+            z = z - cordicAtanTable[i];
+        }
+        else
+        {
+            xNext = x + ( y >> i );
+            y = y - ( x >> i );
+            z = z + cordicAtanTable[i];
+        }
+        x = xNext;
+    }
+
+    MCLIB_QuadrantRotation( quadrant, (float)y * CORDIC_ONE_BY_Q30, (float)x * CORDIC_ONE_BY_Q30, sineAngle, cosAngle );
+}
+#endif
+
+/******************************************************************************/
+/* Function name: MCLIB_SinCosCalc                                            */
+/* Function parameters: rotor_angle                                           */
+/* Function return: sineAngle, cosAngle                                       */
+/* Description: Calculates the sin and cosine of angle with the method        */
+/*              selected by SINCOS_METHOD                                     */
+/******************************************************************************/
+void MCLIB_SinCosCalc( float const rotor_angle, float* sineAngle, float* cosAngle )
+{
+#if (SINCOS_METHOD == SINCOS_POLYNOMIAL)
+    MCLIB_SinCosPolynomial( rotor_angle, sineAngle, cosAngle );
+#elif (SINCOS_METHOD == SINCOS_QUARTER_WAVE_TABLE)
+    MCLIB_SinCosQuarterWave( rotor_angle, sineAngle, cosAngle );
+#elif (SINCOS_METHOD == SINCOS_CORDIC)
+    MCLIB_SinCosCordic( rotor_angle, sineAngle, cosAngle );
+#else
+    MCLIB_SinCosTable( rotor_angle, sineAngle, cosAngle );
+#endif
+}
 
 /******************************************************************************/
 /* Function name: MCLIB_WrapAngle                                             */
@@ -208,6 +448,31 @@ void MCLIB_WrapAngle( float * const angle )
     }
 }
 
+/******************************************************************************/
+/* Function name: MCLIB_AngleDifference                                       */
+/* Function parameters: angle, reference - angles in [ 0, 2pi ]               */
+/* Function return: angle - reference in [ -pi, pi ]                          */
+/* Description:  Difference of two electrical angles                          */
+/******************************************************************************/
+float MCLIB_AngleDifference( const float angle, const float reference )
+{
+    float difference = angle - reference;
+
+    if( difference >= (float)M_PI )
+    {
+        difference -= SINGLE_ELEC_ROT_RADS_PER_SEC;
+    }
+    else if( difference < -(float)M_PI )
+    {
+        difference += SINGLE_ELEC_ROT_RADS_PER_SEC;
+    }
+    else
+    {
+        /* Do nothing */
+    }
+    return difference;
+}
+
 
 /******************************************************************************/
 /* Function name: MCLIB_linearRamp                                            */
@@ -75,6 +75,15 @@ extern "C" {
 #define     ANGLE_STEP                             (TOTAL_SINE_TABLE_ANGLE/(float)TABLE_SIZE)
 #define     ONE_BY_ANGLE_STEP                      (1/ANGLE_STEP)
 
+/* Quarter wave table intervals */
+#define     QUARTER_TABLE_SIZE                      64U
+
+/* CORDIC: iterations, gain compensation and fixed point scaling */
+#define     CORDIC_ITERATIONS                      (24U)
+#define     CORDIC_GAIN_Q30                        (652032874)
+#define     CORDIC_ANGLE_SCALE                     (536870912.0f)
+#define     CORDIC_ONE_BY_Q30                      (1.0f / 1073741824.0f)
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -82,7 +91,20 @@ extern "C" {
 // *****************************************************************************
 // *****************************************************************************
 void MCLIB_SinCosCalc( float const rotor_angle, float* sineAngle, float* cosAngle );
+#if (SINCOS_METHOD == SINCOS_INTERPOLATED_TABLE) || defined(MCLIB_SINCOS_ALL_METHODS)
+void MCLIB_SinCosTable( float const rotor_angle, float* sineAngle, float* cosAngle );
+#endif
+#if (SINCOS_METHOD == SINCOS_POLYNOMIAL) || defined(MCLIB_SINCOS_ALL_METHODS)
+void MCLIB_SinCosPolynomial( float const rotor_angle, float* sineAngle, float* cosAngle );
+#endif
+#if (SINCOS_METHOD == SINCOS_QUARTER_WAVE_TABLE) || defined(MCLIB_SINCOS_ALL_METHODS)
+void MCLIB_SinCosQuarterWave( float const rotor_angle, float* sineAngle, float* cosAngle );
+#endif
+#if (SINCOS_METHOD == SINCOS_CORDIC) || defined(MCLIB_SINCOS_ALL_METHODS)
+void MCLIB_SinCosCordic( float const rotor_angle, float* sineAngle, float* cosAngle );
+#endif
 void MCLIB_WrapAngle( float * const angle );
+float MCLIB_AngleDifference( const float angle, const float reference );
 void MCLIB_LinearRamp(float * const input, const float stepSize, const float finalValue );
 void MCLIB_ImposeLimits( float * const input, const float lowerLimit, const float upperLimit );
 
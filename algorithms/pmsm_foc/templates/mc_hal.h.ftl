@@ -151,10 +151,65 @@ extern "C" {
 #define MCHAL_IntDisable(irq)       EVIC_SourceDisable(irq)
 #define MCHAL_IntEnable(irq)        EVIC_SourceEnable(irq)
 #define MCHAL_IntClear(irq)         EVIC_SourceStatusClear(irq)
+#define MCHAL_MemoryBarrier()       __sync_synchronize()
 <#else>
 #define MCHAL_IntDisable(irq)       NVIC_DisableIRQ(irq)
 #define MCHAL_IntEnable(irq)        NVIC_EnableIRQ(irq)
 #define MCHAL_IntClear(irq)         NVIC_ClearPendingIRQ(irq)
+#define MCHAL_MemoryBarrier()       __DMB()
+</#if>
+
+/* Software interrupt of the slow task scheduler, lowest priority. The control
+   interrupt has to preempt it, its configured priority is checked here and
+   not changed at run time */
+<#if MCPMSMFOC_TASK_SCHEDULER == true>
+<#if (HarmonyCore.SELECT_RTOS)?? && HarmonyCore.SELECT_RTOS != "BareMetal">
+#error "TASK_SCHEDULER uses the software interrupt of the RTOS kernel, disable it with an RTOS"
+</#if>
+<#assign mcHalCtrlPriority = "">
+<#if __PROCESSOR?matches("PIC32M.*") == true>
+<#assign mcHalCtrlHandler = .vars["${MCPMSMFOC_ADCPLIB?lower_case}"].INTERRUPT_ADC_RESULT?remove_beginning("INT_SOURCE_") + "_InterruptHandler">
+<#list 0..255 as vector>
+<#if (core["EVIC_${vector}_INTERRUPT_HANDLER"])?? && core["EVIC_${vector}_INTERRUPT_HANDLER"] == mcHalCtrlHandler>
+<#assign mcHalCtrlPriority = core["EVIC_${vector}_PRIORITY"]>
+</#if>
+</#list>
+<#else>
+<#assign mcHalCtrlHandler = .vars["${MCPMSMFOC_ADCPLIB?lower_case}"].INTERRUPT_ADC_RESULT?remove_ending("IRQn") + "InterruptHandler">
+<#list 0..255 as vector>
+<#if (core["NVIC_${vector}_0_HANDLER"])?? && core["NVIC_${vector}_0_HANDLER"] == mcHalCtrlHandler>
+<#assign mcHalCtrlPriority = core["NVIC_${vector}_0_PRIORITY"]>
+</#if>
+</#list>
+</#if>
+<#if mcHalCtrlPriority == "">
+#error "TASK_SCHEDULER: no priority of ${mcHalCtrlHandler} in the interrupt controller configuration"
+<#else>
+#define MCHAL_CTRL_IRQ_PRIORITY     (${mcHalCtrlPriority}U)
+</#if>
+</#if>
+<#if __PROCESSOR?matches("PIC32M.*") == true>
+#define MCHAL_SW_IRQ                (INT_SOURCE_CORE_SOFTWARE_0)
+#define MCHAL_SwIrqInitialize()     do { IPC0CLR = _IPC0_CS0IP_MASK | _IPC0_CS0IS_MASK; \
+                                         IPC0SET = ( 1U << _IPC0_CS0IP_POSITION ); \
+                                         EVIC_SourceStatusClear(MCHAL_SW_IRQ); \
+                                         EVIC_SourceEnable(MCHAL_SW_IRQ); } while(0)
+#define MCHAL_SwIrqPend()           EVIC_SourceStatusSet(MCHAL_SW_IRQ)
+#define MCHAL_SwIrqAcknowledge()    EVIC_SourceStatusClear(MCHAL_SW_IRQ)
+#define MCHAL_SW_IRQ_HANDLER()      void __ISR(_CORE_SOFTWARE_0_VECTOR, IPL1AUTO) CORE_SOFTWARE_0_Handler( void )
+#if defined(MCHAL_CTRL_IRQ_PRIORITY) && (MCHAL_CTRL_IRQ_PRIORITY <= 1U)
+#error "TASK_SCHEDULER: the control interrupt has to be configured above IPL1, the level of the software interrupt"
+#endif
+<#else>
+#define MCHAL_SW_IRQ                (PendSV_IRQn)
+#define MCHAL_SwIrqInitialize()     NVIC_SetPriority(MCHAL_SW_IRQ, (1UL << __NVIC_PRIO_BITS) - 1UL)
+#define MCHAL_SwIrqPend()           (SCB->ICSR = SCB_ICSR_PENDSVSET_Msk)
+#define MCHAL_SwIrqAcknowledge()
+/* Replaces the weak PendSV_Handler of interrupts.c, not available with an RTOS */
+#define MCHAL_SW_IRQ_HANDLER()      void PendSV_Handler( void )
+#if defined(MCHAL_CTRL_IRQ_PRIORITY) && (MCHAL_CTRL_IRQ_PRIORITY >= ((1U << __NVIC_PRIO_BITS) - 1U))
+#error "TASK_SCHEDULER: the control interrupt has to be configured above the lowest priority, that of the software interrupt"
+#endif
 </#if>
 
 
@@ -172,6 +227,26 @@ extern "C" {
 
 #define MCHAL_DIR_SWITCH_GET()         GPIO_${MCPMSMFOC_DIRECTION_BUTTON}_Get()
 
+/* Cycle counter */
+<#if __PROCESSOR?matches("PIC32M.*") == true>
+#define MCHAL_CYCLE_COUNTER_CLOCK_HZ   (CPU_CLOCK_FREQUENCY / 2U)
+#define MCHAL_CycleCounterStart()
+#define MCHAL_CycleCounterGet()        ((uint32_t)_CP0_GET_COUNT())
+<#else>
+#define MCHAL_CYCLE_COUNTER_CLOCK_HZ   (CPU_CLOCK_FREQUENCY)
+<#if __PROCESSOR?matches(".*SAME70.*") == true>
+#define MCHAL_CycleCounterStart()      do { CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; \
+                                            DWT->LAR = 0xC5ACCE55U; \
+                                            DWT->CYCCNT = 0U; \
+                                            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; } while(0)
+<#else>
+#define MCHAL_CycleCounterStart()      do { CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; \
+                                            DWT->CYCCNT = 0U; \
+                                            DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk; } while(0)
+</#if>
+#define MCHAL_CycleCounterGet()        (DWT->CYCCNT)
+</#if>
+
 <#if MCPMSMFOC_X2CScope != "None">
 #define MCHAL_X2C_Update()          X2CScope_Update()
 <#else>
@@ -0,0 +1,605 @@
+/*******************************************************************************
+ Motor Parameter Identification source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_identification.c
+
+  Summary:
+    Self-commissioning of the phase resistance, inductances, back EMF
+    constant and inertia, and the PI gain tuner
+
+  Description:
+    This file contains the identification steps executed by the control
+    interrupt in the state MCAPP_IDENTIFICATION. The voltages are the current
+    controller outputs of the previous PWM period, which drove the change of
+    the current up to the present sample, as in the stator voltage equations
+    of the PLL estimator. The resistance is the slope between two DC operating
+    points, so that a constant inverter voltage error cancels. The inductances
+    are the least squares fit of
+
+        L ( i(k) - i(k-1) ) / Ts = u(k-1) - Rs ( i(k) + i(k-1) ) / 2
+
+    over alternating voltage pulses with the current controllers bypassed.
+    The back EMF constant is the mean back EMF amplitude in the control frame
+    divided by the open loop speed, once the rotor follows the rotating
+    current vector. The air gap torque is the power into the back EMF
+    divided by the mechanical speed. The difference of its means over the
+    ramp up and the ramp down of the same speed range is twice the inertia
+    torque of the ramp, as the friction and load torques cancel.
+
+    The current controllers cancel the pole of the stator time constant of
+    their axis, with the controller output relative to umax:
+
+        kp = wc L / umax,   ki = wc Rs Ts / umax
+
+    The speed controller gives the crossover frequency ws with the torque
+    constant 1.5 p Ke acting on the inertia J, with its zero at
+    MCID_SPEED_ZERO_RATIO ws:
+
+        kp = ws J / ( 1.5 p^2 Ke ),   ki = kp MCID_SPEED_ZERO_RATIO ws Ts
+
+    with Ts the execution period of the controller. The anti windup gains
+    kc = ki / kp track the saturated output within the integral time.
+    ws is limited to the corner frequency of the speed estimate filter,
+    which with PLL_SPEED_SCHEDULING is the one at the end of the open loop
+    ramp.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"                // SYS function prototypes
+#include "device.h"
+#include "mc_derivedparams.h"
+#include "mc_identification.h"
+#include "mc_control_loop.h"
+#include "mc_voltagemeasurement.h"
+#include "mc_generic_lib.h"
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#include "mc_rotorposition.h"
+</#if>
+#include "mc_parameters.h"
+#include "math.h"
+
+#if (ENABLED == MOTOR_IDENTIFICATION)
+
+#if (ENABLED == FUSED_FOC_KERNEL) || (ARITHMETIC == ARITHMETIC_Q14)
+#error "Motor parameter identification uses the floating point current control of MCCTRL_MotorControl"
+#endif
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCID_NextStep( const tMCID_STEP_E step );
+static bool MCID_IsPlausible( const float value, const float configured );
+static void MCID_ParametersApply( void );
+__STATIC_INLINE float MCID_PulseVoltage( void );
+__STATIC_INLINE void MCID_InductanceFit( const float current, const float voltage );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCID_MOTOR_PARAM_S         gMCID_MotorParam;
+tMCID_MOTOR_PARAM_S         gMCID_Result;
+tMCID_STATE_S               gMCID_State;
+tMCID_TUNING_S              gMCID_Tuning;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCID_NextStep                                               */
+/* Function parameters: step - next identification step                       */
+/* Function return: None                                                      */
+/* Description: Clears the counter and the sums for the next step             */
+/******************************************************************************/
+static void MCID_NextStep( const tMCID_STEP_E step )
+{
+    gMCID_State.step = step;
+    gMCID_State.counter = 0U;
+    gMCID_State.sumX = 0.0f;
+    gMCID_State.sumY = 0.0f;
+    gMCID_State.sumXY = 0.0f;
+    gMCID_State.sumYY = 0.0f;
+}
+
+/******************************************************************************/
+/* Function name: MCID_IsPlausible                                            */
+/* Function parameters: value - identified, configured - configured value     */
+/* Function return: true if the value is within the accepted range            */
+/* Description: Rejects results of a failed measurement                       */
+/******************************************************************************/
+static bool MCID_IsPlausible( const float value, const float configured )
+{
+    return ( value > ( MCID_MIN_RATIO * configured ) ) && ( value < ( MCID_MAX_RATIO * configured ) );
+}
+
+/******************************************************************************/
+/* Function name: MCID_PulseVoltage                                           */
+/* Function parameters: None                                                  */
+/* Function return: Inductance pulse voltage of this PWM period (V)           */
+/* Description: Alternates the pulse polarity every MCID_PULSE_PERIODS        */
+/******************************************************************************/
+__STATIC_INLINE float MCID_PulseVoltage( void )
+{
+    return ( 0U == ( ( gMCID_State.counter / MCID_PULSE_PERIODS ) & 1U ) ) ? gMCID_State.pulse : -gMCID_State.pulse;
+}
+
+/******************************************************************************/
+/* Function name: MCID_InductanceFit                                          */
+/* Function parameters: current - present current of the pulsed axis,         */
+/*                      voltage - voltage of the last PWM period on the axis  */
+/* Function return: None                                                      */
+/* Description: Accumulates the least squares sums of the inductance          */
+/******************************************************************************/
+__STATIC_INLINE void MCID_InductanceFit( const float current, const float voltage )
+{
+    float x, y;
+
+    if( gMCID_State.counter > MCID_SETTLE_COUNT )
+    {
+        x = voltage - ( gMCID_Result.rs * 0.5f * ( current + gMCID_State.iLast ) );
+        y = ( current - gMCID_State.iLast ) / FAST_LOOP_TIME_SEC;
+        gMCID_State.sumXY += x * y;
+        gMCID_State.sumYY += y * y;
+    }
+    gMCID_State.iLast = current;
+}
+
+/******************************************************************************/
+/* Function name: MCID_ParametersApply                                        */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Loads the identified parameters into the estimator and field  */
+/*              weakening, and the tuned gains into the controllers           */
+/******************************************************************************/
+static void MCID_ParametersApply( void )
+{
+    tMCPAR_PI_GAINS_S idGains, iqGains, speedGains;
+
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+    /* The estimator runs with the current on the q-axis */
+    gMCRPOS_Parameters.lsDt = gMCID_MotorParam.lq / FAST_LOOP_TIME_SEC;
+    gMCRPOS_Parameters.rs = gMCID_MotorParam.rs;
+    gMCRPOS_Parameters.rsLsDt = gMCRPOS_Parameters.rs + gMCRPOS_Parameters.lsDt;
+    gMCRPOS_Parameters.invKFi = 1.0f / gMCID_MotorParam.ke;
+</#if>
+#if (ENABLED == FIELD_WEAKENING )
+    gMCCTRL_FieldWeakeningParam.ls = gMCID_MotorParam.ld;
+    gMCCTRL_FieldWeakeningParam.rs = gMCID_MotorParam.rs;
+#endif
+
+    MCID_GainsCalculate( &gMCID_MotorParam, gMCVOL_OutputSignals.umax, &idGains, &iqGains, &speedGains );
+    MCPAR_GainsWrite( &gMCLIB_IdPIController, &idGains );
+    MCPAR_GainsWrite( &gMCLIB_IqPIController, &iqGains );
+    MCPAR_GainsWrite( &gMCLIB_SpeedPIController, &speedGains );
+
+#if (ENABLED == LOAD_TORQUE_OBSERVER)
+    /* The configured inertia is kept as long as the identified one is unknown */
+    MCCTRL_InitializeLoadObserver( ( gMCID_MotorParam.inertia > 0.0f ) ? gMCID_MotorParam.inertia : MOTOR_INERTIA,
+                                   gMCID_MotorParam.ke );
+#endif
+
+#if (ENABLED == PARAMETER_CHANNEL)
+    /* Run time updates continue from the identified parameters */
+    MCPAR_Initialize();
+#endif
+}
+#endif
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCID_Initialize                                             */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Loads the configured motor parameters                         */
+/******************************************************************************/
+void MCID_Initialize( void )
+{
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    gMCID_MotorParam.rs = MOTOR_PER_PHASE_RESISTANCE;
+    gMCID_MotorParam.ld = MOTOR_PER_PHASE_INDUCTANCE;
+    gMCID_MotorParam.lq = MOTOR_Q_AXIS_INDUCTANCE;
+    gMCID_MotorParam.ke = MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC;
+    gMCID_MotorParam.inertia = 0.0f;
+    gMCID_Result = gMCID_MotorParam;
+    gMCID_Tuning.currentBandwidth = CURRENT_LOOP_BANDWIDTH;
+    gMCID_Tuning.speedBandwidth = SPEED_LOOP_BANDWIDTH;
+    gMCID_State.step = MCID_STEP_IDLE;
+    gMCID_State.voltageMode = false;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCID_Start                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the identification, with the rotor at standstill       */
+/******************************************************************************/
+void MCID_Start( void )
+{
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    gMCID_Result = gMCID_MotorParam;
+    gMCID_State.idGains.kp = gMCLIB_IdPIController.kp;
+    gMCID_State.idGains.ki = gMCLIB_IdPIController.ki;
+    gMCID_State.idGains.kc = gMCLIB_IdPIController.kc;
+    gMCID_State.iqGains.kp = gMCLIB_IqPIController.kp;
+    gMCID_State.iqGains.ki = gMCLIB_IqPIController.ki;
+    gMCID_State.iqGains.kc = gMCLIB_IqPIController.kc;
+    gMCID_State.angle = 0.0f;
+    gMCID_State.speed = 0.0f;
+    gMCID_State.voltageMode = false;
+    MCID_NextStep( MCID_STEP_ALIGN );
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCID_Identification                                         */
+/* Function parameters: None                                                  */
+/* Function return: MCAPP_SUCCESS or MCAPP_ERROR when finished                */
+/* Description: One PWM period of the identification. Sets the current        */
+/*              references and the control angle. Called from the control     */
+/*              state machine.                                                */
+/******************************************************************************/
+tMCAPP_STATUS_E MCID_Identification( void )
+{
+    tMCAPP_STATUS_E status = MCAPP_IN_PROGRESS;
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    const float umax = gMCVOL_OutputSignals.umax;
+    const float id = gMCLIB_CurrentDQ.directAxis;
+    const float iq = gMCLIB_CurrentDQ.quadratureAxis;
+    const float speed = (float)gMCCTRL_CtrlParam.rotationSign * gMCID_State.speed;
+    float ls, ed, eq, torque;
+    tMCPAR_PI_GAINS_S idGains, iqGains, speedGains;
+
+    gMCID_State.counter++;
+    gMCCTRL_CtrlParam.idRef = 0.0f;
+    gMCCTRL_CtrlParam.iqRef = 0.0f;
+
+    switch( gMCID_State.step )
+    {
+        case MCID_STEP_ALIGN:
+        {
+            gMCCTRL_CtrlParam.idRef = MCID_CURRENT;
+            if( gMCID_State.counter >= MCID_ALIGN_COUNT )
+            {
+                MCID_NextStep( MCID_STEP_RS_LOW );
+            }
+        }
+        break;
+
+        case MCID_STEP_RS_LOW:
+        case MCID_STEP_RS_HIGH:
+        {
+            gMCCTRL_CtrlParam.idRef = ( MCID_STEP_RS_LOW == gMCID_State.step ) ? ( 0.5f * MCID_CURRENT ) : MCID_CURRENT;
+            if( gMCID_State.counter > MCID_SETTLE_COUNT )
+            {
+                gMCID_State.sumX += gMCLIB_VoltageDQ.directAxis * umax;
+                gMCID_State.sumY += id;
+            }
+            if( gMCID_State.counter >= ( MCID_SETTLE_COUNT + MCID_MEASURE_COUNT ) )
+            {
+                if( MCID_STEP_RS_LOW == gMCID_State.step )
+                {
+                    gMCID_State.rsLowVoltage = gMCID_State.sumX / (float)MCID_MEASURE_COUNT;
+                    gMCID_State.rsLowCurrent = gMCID_State.sumY / (float)MCID_MEASURE_COUNT;
+                    MCID_NextStep( MCID_STEP_RS_HIGH );
+                }
+                else
+                {
+                    gMCID_Result.rs = ( ( gMCID_State.sumX / (float)MCID_MEASURE_COUNT ) - gMCID_State.rsLowVoltage )
+                                    / ( ( gMCID_State.sumY / (float)MCID_MEASURE_COUNT ) - gMCID_State.rsLowCurrent );
+
+                    /* Pulses on top of the DC voltage of the test current */
+                    gMCID_State.pulse = fminf( MCID_PULSE_RIPPLE * MCID_CURRENT * gMCID_MotorParam.ld
+                                               / ( (float)MCID_PULSE_PERIODS * FAST_LOOP_TIME_SEC ), 0.5f * umax );
+                    gMCID_State.vd = gMCID_Result.rs * MCID_CURRENT;
+                    gMCID_State.vq = 0.0f;
+                    gMCID_State.iLast = id;
+                    gMCID_State.voltageMode = true;
+                    MCID_NextStep( MCID_STEP_LD );
+                }
+            }
+        }
+        break;
+
+        case MCID_STEP_LD:
+        {
+            gMCCTRL_CtrlParam.idRef = MCID_CURRENT;
+            MCID_InductanceFit( id, gMCID_State.vd );
+            gMCID_State.vd = ( gMCID_Result.rs * MCID_CURRENT ) + MCID_PulseVoltage();
+            if( gMCID_State.counter >= ( MCID_SETTLE_COUNT + MCID_MEASURE_COUNT ) )
+            {
+                gMCID_Result.ld = gMCID_State.sumXY / gMCID_State.sumYY;
+                gMCID_State.vd = gMCID_Result.rs * MCID_CURRENT;
+                gMCID_State.iLast = iq;
+                MCID_NextStep( MCID_STEP_LQ );
+            }
+        }
+        break;
+
+        case MCID_STEP_LQ:
+        {
+            gMCCTRL_CtrlParam.idRef = MCID_CURRENT;
+            MCID_InductanceFit( iq, gMCID_State.vq );
+            gMCID_State.vq = MCID_PulseVoltage();
+            if( gMCID_State.counter >= ( MCID_SETTLE_COUNT + MCID_MEASURE_COUNT ) )
+            {
+                gMCID_Result.lq = gMCID_State.sumXY / gMCID_State.sumYY;
+
+                /* Current control of the open loop spin test, tuned for the identified resistance and
+                   inductances to follow the back EMF as the load angle changes */
+                MCID_GainsCalculate( &gMCID_Result, umax, &idGains, &iqGains, &speedGains );
+                MCPAR_GainsWrite( &gMCLIB_IdPIController, &idGains );
+                MCPAR_GainsWrite( &gMCLIB_IqPIController, &iqGains );
+                gMCID_State.voltageMode = false;
+                MCLIB_ResetPIParameters( &gMCLIB_IdPIController );
+                MCLIB_ResetPIParameters( &gMCLIB_IqPIController );
+                MCID_NextStep( MCID_STEP_SPIN );
+            }
+        }
+        break;
+
+        case MCID_STEP_SPIN:
+        case MCID_STEP_KE:
+        case MCID_STEP_INERTIA:
+        {
+            gMCCTRL_CtrlParam.iqRef = (float)gMCCTRL_CtrlParam.rotationSign * MCID_SPIN_CURRENT;
+            if( MCID_STEP_SPIN == gMCID_State.step )
+            {
+                if( gMCID_State.speed < MCID_SPIN_SPEED )
+                {
+                    gMCID_State.speed += MCID_SPIN_ACCELERATION * FAST_LOOP_TIME_SEC;
+                    gMCID_State.counter = 0U;
+                }
+                else if( gMCID_State.counter >= MCID_SPIN_SETTLE_COUNT )
+                {
+                    MCID_NextStep( MCID_STEP_KE );
+                }
+                else
+                {
+                    /* Rotor settles at the spin test speed */
+                }
+            }
+            else
+            {
+                /* Back EMF in the control frame, which turns with the rotor */
+                ls = 0.5f * ( gMCID_Result.ld + gMCID_Result.lq );
+                ed = ( gMCLIB_VoltageDQ.directAxis * umax ) - ( gMCID_Result.rs * id ) + ( speed * ls * iq );
+                eq = ( gMCLIB_VoltageDQ.quadratureAxis * umax ) - ( gMCID_Result.rs * iq ) - ( speed * ls * id );
+
+                if( MCID_STEP_KE == gMCID_State.step )
+                {
+                    gMCID_State.sumX += sqrtf( ( ed * ed ) + ( eq * eq ) );
+                    gMCID_State.sumY += gMCID_State.speed;
+                    if( gMCID_State.counter >= MCID_SPIN_MEASURE_COUNT )
+                    {
+                        gMCID_Result.ke = gMCID_State.sumX / gMCID_State.sumY;
+                        MCID_NextStep( MCID_STEP_INERTIA );
+                    }
+                }
+                else
+                {
+                    /* Air gap torque in the direction of rotation from the power into the back EMF */
+                    torque = 1.5f * NUM_POLE_PAIRS * ( ( ed * id ) + ( eq * iq ) ) / gMCID_State.speed;
+                    if( ( gMCID_State.counter % MCID_INERTIA_RAMP_COUNT ) > MCID_INERTIA_SETTLE_COUNT )
+                    {
+                        gMCID_State.sumX += torque;
+                        gMCID_State.sumY += 1.0f;
+                    }
+
+                    if( gMCID_State.counter <= MCID_INERTIA_RAMP_COUNT )
+                    {
+                        gMCID_State.speed += MCID_INERTIA_ACCELERATION * FAST_LOOP_TIME_SEC;
+                        if( gMCID_State.counter == MCID_INERTIA_RAMP_COUNT )
+                        {
+                            gMCID_State.torqueUp = gMCID_State.sumX / gMCID_State.sumY;
+                            gMCID_State.sumX = 0.0f;
+                            gMCID_State.sumY = 0.0f;
+                        }
+                    }
+                    else
+                    {
+                        gMCID_State.speed -= MCID_INERTIA_ACCELERATION * FAST_LOOP_TIME_SEC;
+                    }
+
+                    if( gMCID_State.counter >= ( 2U * MCID_INERTIA_RAMP_COUNT ) )
+                    {
+                        /* Mechanical acceleration is the electrical one over the pole pairs */
+                        gMCID_Result.inertia = ( gMCID_State.torqueUp - ( gMCID_State.sumX / gMCID_State.sumY ) )
+                                             * NUM_POLE_PAIRS / ( 2.0f * MCID_INERTIA_ACCELERATION );
+                        gMCCTRL_CtrlParam.iqRef = 0.0f;
+
+                        if( MCID_IsPlausible( gMCID_Result.rs, MOTOR_PER_PHASE_RESISTANCE )
+                         && MCID_IsPlausible( gMCID_Result.ld, MOTOR_PER_PHASE_INDUCTANCE )
+                         && MCID_IsPlausible( gMCID_Result.lq, MOTOR_Q_AXIS_INDUCTANCE )
+                         && MCID_IsPlausible( gMCID_Result.ke, MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC )
+                         && ( gMCID_Result.inertia > 0.0f ) )
+                        {
+                            gMCID_MotorParam = gMCID_Result;
+                            MCID_ParametersApply();
+                            MCID_NextStep( MCID_STEP_DONE );
+                            status = MCAPP_SUCCESS;
+                        }
+                        else
+                        {
+                            MCPAR_GainsWrite( &gMCLIB_IdPIController, &gMCID_State.idGains );
+                            MCPAR_GainsWrite( &gMCLIB_IqPIController, &gMCID_State.iqGains );
+                            MCID_NextStep( MCID_STEP_FAILED );
+                            status = MCAPP_ERROR;
+                        }
+                        gMCID_State.speed = 0.0f;
+                    }
+                }
+            }
+            gMCID_State.angle += speed * FAST_LOOP_TIME_SEC;
+            MCLIB_WrapAngle( &gMCID_State.angle );
+        }
+        break;
+
+        default:
+        {
+            /* Not started or finished */
+            status = ( MCID_STEP_DONE == gMCID_State.step ) ? MCAPP_SUCCESS : MCAPP_ERROR;
+        }
+    }
+
+    gMCCTRL_CtrlParam.velRef = gMCID_State.speed;
+    gMCLIB_Position.angle = gMCID_State.angle;
+#endif
+    return status;
+}
+
+/******************************************************************************/
+/* Function name: MCID_VoltageOverride                                        */
+/* Function parameters: pVoltage - d- and q-axis voltage relative to umax     */
+/* Function return: None                                                      */
+/* Description: Replaces the current controller outputs in the voltage pulse  */
+/*              steps                                                         */
+/******************************************************************************/
+void MCID_VoltageOverride( tMCLIB_PARK_TRANSFORM_S * const pVoltage )
+{
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    if( gMCID_State.voltageMode )
+    {
+        pVoltage->directAxis = gMCID_State.vd / gMCVOL_OutputSignals.umax;
+        pVoltage->quadratureAxis = gMCID_State.vq / gMCVOL_OutputSignals.umax;
+    }
+#else
+    (void)pVoltage;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCID_GainsCalculate                                         */
+/* Function parameters: pMotor - motor parameters,                            */
+/*                      umax - maximum phase voltage (V),                     */
+/*                      pIdGains, pIqGains, pSpeedGains - calculated gains    */
+/* Function return: None                                                      */
+/* Description: Calculates the PI gains for the bandwidths in gMCID_Tuning    */
+/*              from the motor parameters. The speed gains are those of the   */
+/*              controller while the inertia is unknown.                      */
+/******************************************************************************/
+void MCID_GainsCalculate( const tMCID_MOTOR_PARAM_S * const pMotor, const float umax, tMCPAR_PI_GAINS_S * const pIdGains,
+                          tMCPAR_PI_GAINS_S * const pIqGains, tMCPAR_PI_GAINS_S * const pSpeedGains )
+{
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    const float currentBandwidth = fminf( gMCID_Tuning.currentBandwidth, MCID_MAX_CURRENT_BANDWIDTH );
+    float speedBandwidth = fminf( gMCID_Tuning.speedBandwidth, MCID_MAX_SPEED_CURRENT_RATIO * currentBandwidth );
+    const float speedPeriod = FAST_LOOP_TIME_SEC;
+
+    pIdGains->kp = currentBandwidth * pMotor->ld / umax;
+    pIdGains->ki = currentBandwidth * pMotor->rs * FAST_LOOP_TIME_SEC / umax;
+    pIdGains->kc = pIdGains->ki / pIdGains->kp;
+    pIqGains->kp = currentBandwidth * pMotor->lq / umax;
+    pIqGains->ki = pIdGains->ki;
+    pIqGains->kc = pIqGains->ki / pIqGains->kp;
+
+    if( pMotor->inertia > 0.0f )
+    {
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+        /* The speed is measured by the estimator through a first order filter. With the speed scheduled
+           PLL filters its corner frequency rises with the speed, from the end of the open loop ramp on */
+#if (ENABLED == PLL_SPEED_SCHEDULING)
+        speedBandwidth = fminf( speedBandwidth, MCID_MAX_SPEED_FILTER_RATIO
+                                              * fmaxf( KFILTER_VELESTIM / FAST_LOOP_TIME_SEC, PLL_VELESTIM_BANDWIDTH_RATIO * MCID_SPIN_SPEED ) );
+#else
+        speedBandwidth = fminf( speedBandwidth, MCID_MAX_SPEED_FILTER_RATIO * KFILTER_VELESTIM / FAST_LOOP_TIME_SEC );
+#endif
+</#if>
+        /* Speed in rad/s electrical, output in A */
+        pSpeedGains->kp = speedBandwidth * pMotor->inertia / ( 1.5f * NUM_POLE_PAIRS * NUM_POLE_PAIRS * pMotor->ke );
+        pSpeedGains->ki = pSpeedGains->kp * MCID_SPEED_ZERO_RATIO * speedBandwidth * speedPeriod;
+        pSpeedGains->kc = pSpeedGains->ki / pSpeedGains->kp;
+    }
+    else
+    {
+        pSpeedGains->kp = gMCLIB_SpeedPIController.kp;
+        pSpeedGains->ki = gMCLIB_SpeedPIController.ki;
+        pSpeedGains->kc = gMCLIB_SpeedPIController.kc;
+    }
+#else
+    (void)pMotor;
+    (void)umax;
+    (void)pIdGains;
+    (void)pIqGains;
+    (void)pSpeedGains;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCID_GainsUpdate                                            */
+/* Function parameters: None                                                  */
+/* Function return: MCAPP_SUCCESS, MCAPP_IN_PROGRESS while the last parameter */
+/*                  update is pending                                         */
+/* Description: Calculates the PI gains for the present DC bus voltage and    */
+/*              hands them to the controllers, through the parameter update   */
+/*              channel when PARAMETER_CHANNEL is enabled. Called from the    */
+/*              application while the motor may run.                          */
+/******************************************************************************/
+tMCAPP_STATUS_E MCID_GainsUpdate( void )
+{
+    tMCAPP_STATUS_E status = MCAPP_SUCCESS;
+#if (ENABLED == MOTOR_IDENTIFICATION)
+#if (ENABLED == PARAMETER_CHANNEL)
+    tMCPAR_BLOCK_S * const pBlock = MCPAR_Edit();
+
+    if( NULL != pBlock )
+    {
+        MCID_GainsCalculate( &gMCID_MotorParam, gMCVOL_OutputSignals.umax, &pBlock->idController,
+                             &pBlock->iqController, &pBlock->speedController );
+        MCPAR_Publish();
+    }
+    else
+    {
+        status = MCAPP_IN_PROGRESS;
+    }
+#else
+    tMCPAR_PI_GAINS_S idGains, iqGains, speedGains;
+
+    /* Each gain is written at once, the controllers may run with a mix of old and new gains for one period */
+    MCID_GainsCalculate( &gMCID_MotorParam, gMCVOL_OutputSignals.umax, &idGains, &iqGains, &speedGains );
+    MCPAR_GainsWrite( &gMCLIB_IdPIController, &idGains );
+    MCPAR_GainsWrite( &gMCLIB_IqPIController, &iqGains );
+    MCPAR_GainsWrite( &gMCLIB_SpeedPIController, &speedGains );
+#endif
+#endif
+    return status;
+}
+
+/*******************************************************************************
+ End of File
+*/
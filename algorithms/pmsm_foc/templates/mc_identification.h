@@ -0,0 +1,265 @@
+/*******************************************************************************
+ Motor Parameter Identification interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_identification.h
+
+  Summary:
+    Header file for the motor parameter identification
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    self-commissioning mode. When MOTOR_IDENTIFICATION is enabled
+    PMSM_FOC_MotorIdentify runs the control interrupt in the state
+    MCAPP_IDENTIFICATION, which measures with the rotor aligned to the d-axis
+    - the phase resistance from the d-axis voltage at two DC currents,
+    - the d- and q-axis inductances from the current slopes of alternating
+      voltage pulses on top of the DC voltage, fitted by least squares,
+    and then, while the rotor is turned in open loop current control, the
+    back EMF constant from the back EMF amplitude and the inertia from the
+    air gap torque of a speed ramp up and down. The results replace the
+    configured motor parameters in gMCID_MotorParam and the estimator and
+    field weakening parameters.
+
+    The gain tuner calculates the current and speed PI gains from the
+    bandwidths in gMCID_Tuning, the parameters in gMCID_MotorParam and the
+    present DC bus voltage. It runs at the end of the identification and
+    again whenever the application calls MCID_GainsUpdate, e.g. after a
+    change of the DC bus voltage or of the bandwidths. The bandwidths are
+    limited by the PWM period and the speed measurement filter. The speed
+    gains keep their configured values as long as the inertia is unknown.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_IDENTIFICATION_H
+#define MC_IDENTIFICATION_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_lib.h"
+#include "mc_parameters.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Test current at standstill, large against the resolution of the current and the PWM duty, and durations
+   of the steps in PWM periods */
+#define MCID_CURRENT                    (float)(0.5f * MAX_MOTOR_CURRENT)
+#define MCID_ALIGN_COUNT                (uint32_t)(1.0f / FAST_LOOP_TIME_SEC)
+#define MCID_SETTLE_COUNT               (uint32_t)(0.2f / FAST_LOOP_TIME_SEC)
+#define MCID_MEASURE_COUNT              (uint32_t)(0.2f / FAST_LOOP_TIME_SEC)
+#define MCID_SPIN_SETTLE_COUNT          (uint32_t)(1.0f / FAST_LOOP_TIME_SEC)
+#define MCID_SPIN_MEASURE_COUNT         (uint32_t)(0.5f / FAST_LOOP_TIME_SEC)
+
+/* Inductance pulses: peak to peak current ripple relative to the test current with the configured
+   inductance, PWM periods per pulse */
+#define MCID_PULSE_RIPPLE               (0.5f)
+#define MCID_PULSE_PERIODS              (4U)
+
+/* Accepted results relative to the configured parameters */
+#define MCID_MIN_RATIO                  (0.25f)
+#define MCID_MAX_RATIO                  (4.0f)
+
+/* Spin test current and speed, those of the open loop startup */
+#define MCID_SPIN_CURRENT               (float)(Q_CURRENT_REF_OPENLOOP)
+#define MCID_SPIN_SPEED                 (float)(OPEN_LOOP_END_SPEED_RPM * 2.0f * (float)M_PI / 60.0f * NUM_POLE_PAIRS)
+#define MCID_SPIN_ACCELERATION          (float)(MCID_SPIN_SPEED / OPEN_LOOP_RAMP_TIME_IN_SEC)
+
+/* Inertia test: ramp from the spin test speed to twice the speed and back, each ramp in PWM periods, and
+   the periods at the start of each ramp without measurement */
+#define MCID_INERTIA_RAMP_COUNT         (uint32_t)(0.5f / FAST_LOOP_TIME_SEC)
+#define MCID_INERTIA_SETTLE_COUNT       (uint32_t)(0.1f / FAST_LOOP_TIME_SEC)
+#define MCID_INERTIA_ACCELERATION       (float)(MCID_SPIN_SPEED / ( (float)MCID_INERTIA_RAMP_COUNT * FAST_LOOP_TIME_SEC ))
+
+/* Gain tuner limits: current loop bandwidth against the delay of the PWM period, speed loop bandwidth
+   relative to the current loop bandwidth and to the lowest closed loop corner frequency of the speed
+   measurement filter, and the speed controller zero relative to the speed loop bandwidth. A higher
+   bandwidth or zero than these is not stable at the lowest closed loop speed */
+#define MCID_MAX_CURRENT_BANDWIDTH      (float)(0.2f / FAST_LOOP_TIME_SEC)
+#define MCID_MAX_SPEED_CURRENT_RATIO    (0.1f)
+#define MCID_MAX_SPEED_FILTER_RATIO     (1.0f)
+#define MCID_SPEED_ZERO_RATIO           (0.5f)
+
+typedef enum
+{
+    MCID_STEP_IDLE,
+    MCID_STEP_ALIGN,                    /* Rotor aligned with the d-axis current                  */
+    MCID_STEP_RS_LOW,                   /* d-axis voltage at half the test current                */
+    MCID_STEP_RS_HIGH,                  /* d-axis voltage at the test current                     */
+    MCID_STEP_LD,                       /* Voltage pulses on the d-axis                           */
+    MCID_STEP_LQ,                       /* Voltage pulses on the q-axis                           */
+    MCID_STEP_SPIN,                     /* Open loop acceleration to the spin test speed          */
+    MCID_STEP_KE,                       /* Back EMF amplitude at the spin test speed              */
+    MCID_STEP_INERTIA,                  /* Air gap torque of a speed ramp up and down             */
+    MCID_STEP_DONE,
+    MCID_STEP_FAILED
+}tMCID_STEP_E;
+
+/* Motor parameters used at run time */
+typedef struct
+{
+    float               rs;                 /* Phase resistance (Ohm)                               */
+    float               ld;                 /* d-axis inductance (H)                                */
+    float               lq;                 /* q-axis inductance (H)                                */
+    float               ke;                 /* Back EMF constant (V peak phase per rad/s elec)      */
+    float               inertia;            /* Rotor and load inertia (kg m^2), 0 if unknown        */
+}tMCID_MOTOR_PARAM_S;
+
+/* Bandwidth targets of the gain tuner */
+typedef struct
+{
+    float               currentBandwidth;   /* Current loop bandwidth (rad/s)                       */
+    float               speedBandwidth;     /* Speed loop bandwidth (rad/s)                         */
+}tMCID_TUNING_S;
+
+typedef struct
+{
+    tMCID_STEP_E        step;
+    uint32_t            counter;            /* PWM periods in the step                              */
+    float               angle;              /* Control angle                                        */
+    float               speed;              /* Open loop speed (rad/s elec)                         */
+    bool                voltageMode;        /* Voltages of the step replace the current controllers */
+    float               vd;                 /* Voltages of the voltage mode (V)                     */
+    float               vq;
+    float               pulse;              /* Inductance pulse amplitude (V)                       */
+    float               iLast;              /* Current of the pulsed axis in the last PWM period    */
+    float               sumX;               /* Sums of the measurement                              */
+    float               sumY;
+    float               sumXY;
+    float               sumYY;
+    float               rsLowVoltage;       /* Mean d-axis voltage and current at the low current   */
+    float               rsLowCurrent;
+    float               torqueUp;           /* Mean air gap torque of the ramp up (N m)             */
+    tMCPAR_PI_GAINS_S   idGains;            /* Current controller gains before the identification   */
+    tMCPAR_PI_GAINS_S   iqGains;
+}tMCID_STATE_S;
+
+/******************************************************************************/
+/*                       INTERFACE VARIABLES                                  */
+/******************************************************************************/
+#if (ENABLED == MOTOR_IDENTIFICATION)
+extern tMCID_MOTOR_PARAM_S gMCID_MotorParam;
+extern tMCID_MOTOR_PARAM_S gMCID_Result;
+extern tMCID_STATE_S gMCID_State;
+extern tMCID_TUNING_S gMCID_Tuning;
+#endif
+
+/******************************************************************************/
+/*                       INTERFACE FUNCTIONS                                  */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCID_Initialize                                             */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Loads the configured motor parameters                         */
+/******************************************************************************/
+void MCID_Initialize( void );
+
+/******************************************************************************/
+/* Function name: MCID_Start                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the identification, with the rotor at standstill       */
+/******************************************************************************/
+void MCID_Start( void );
+
+/******************************************************************************/
+/* Function name: MCID_Identification                                         */
+/* Function parameters: None                                                  */
+/* Function return: MCAPP_SUCCESS or MCAPP_ERROR when finished                */
+/* Description: One PWM period of the identification. Sets the current        */
+/*              references and the control angle. Called from the control     */
+/*              state machine.                                                */
+/******************************************************************************/
+tMCAPP_STATUS_E MCID_Identification( void );
+
+/******************************************************************************/
+/* Function name: MCID_VoltageOverride                                        */
+/* Function parameters: pVoltage - d- and q-axis voltage relative to umax     */
+/* Function return: None                                                      */
+/* Description: Replaces the current controller outputs in the voltage pulse  */
+/*              steps                                                         */
+/******************************************************************************/
+void MCID_VoltageOverride( tMCLIB_PARK_TRANSFORM_S * const pVoltage );
+
+/******************************************************************************/
+/* Function name: MCID_GainsCalculate                                         */
+/* Function parameters: pMotor - motor parameters,                            */
+/*                      umax - maximum phase voltage (V),                     */
+/*                      pIdGains, pIqGains, pSpeedGains - calculated gains    */
+/* Function return: None                                                      */
+/* Description: Calculates the PI gains for the bandwidths in gMCID_Tuning    */
+/*              from the motor parameters. The speed gains are those of the   */
+/*              controller while the inertia is unknown.                      */
+/******************************************************************************/
+void MCID_GainsCalculate( const tMCID_MOTOR_PARAM_S * const pMotor, const float umax, tMCPAR_PI_GAINS_S * const pIdGains,
+                          tMCPAR_PI_GAINS_S * const pIqGains, tMCPAR_PI_GAINS_S * const pSpeedGains );
+
+/******************************************************************************/
+/* Function name: MCID_GainsUpdate                                            */
+/* Function parameters: None                                                  */
+/* Function return: MCAPP_SUCCESS, MCAPP_IN_PROGRESS while the last parameter */
+/*                  update is pending                                         */
+/* Description: Calculates the PI gains for the present DC bus voltage and    */
+/*              hands them to the controllers, through the parameter update   */
+/*              channel when PARAMETER_CHANNEL is enabled. Called from the    */
+/*              application while the motor may run.                          */
+/******************************************************************************/
+tMCAPP_STATUS_E MCID_GainsUpdate( void );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif    /* MC_IDENTIFICATION_H */
@@ -49,6 +49,7 @@
 #include "definitions.h"                // SYS function prototypes
 #include "mc_lib.h"
 #include "mc_derivedparams.h"
+#include "mc_placement.h"
 
 /******************************************************************************/
 /* Local Function Prototype                                                   */
@@ -0,0 +1,253 @@
+/*******************************************************************************
+ Control Parameter Update source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_parameters.c
+
+  Summary:
+    Double buffered control parameter updates
+
+  Description:
+    This file contains the control parameter update channel. gMCPAR_Data.pActive
+    is only changed by the control interrupt, the other block is only written
+    by the application between MCPAR_Edit and MCPAR_Publish. The sequence
+    counters hand the ownership of the shadow block over: published and
+    applied sequences differ from MCPAR_Publish until the control interrupt
+    has swapped and applied the block.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"                // SYS function prototypes
+#include "device.h"
+#include "mc_derivedparams.h"
+#include "mc_parameters.h"
+#include "mc_control_loop.h"
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#include "mc_rotorposition.h"
+</#if>
+#include "mc_hal.h"
+
+#if (ENABLED == PARAMETER_CHANNEL)
+#if (ARITHMETIC == ARITHMETIC_Q14)
+#error "The parameter updates are written to the floating point controllers, disable PARAMETER_CHANNEL with ARITHMETIC_Q14"
+#endif
+
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+static void MCPAR_GainsRead( tMCPAR_PI_GAINS_S * const pGains, const tMCLIB_PICONTROLLER_S * const pController );
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+static void MCPAR_EstimatorRead( tMCPAR_POSITION_ESTIMATOR_S * const pEstimator );
+static void MCPAR_EstimatorWrite( const tMCPAR_POSITION_ESTIMATOR_S * const pEstimator );
+</#if>
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCPAR_DATA_S       gMCPAR_Data;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCPAR_GainsRead                                             */
+/* Function parameters: pGains - gains, pController - PI controller           */
+/* Function return: None                                                      */
+/* Description: Reads the gains of a PI controller                            */
+/******************************************************************************/
+static void MCPAR_GainsRead( tMCPAR_PI_GAINS_S * const pGains, const tMCLIB_PICONTROLLER_S * const pController )
+{
+    pGains->kp = pController->kp;
+    pGains->ki = pController->ki;
+    pGains->kc = pController->kc;
+}
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+
+/******************************************************************************/
+/* Function name: MCPAR_EstimatorRead                                         */
+/* Function parameters: pEstimator - estimator parameters                     */
+/* Function return: None                                                      */
+/* Description: Reads the parameters of the PLL estimator                     */
+/******************************************************************************/
+static void MCPAR_EstimatorRead( tMCPAR_POSITION_ESTIMATOR_S * const pEstimator )
+{
+    pEstimator->lsDt = gMCRPOS_Parameters.lsDt;
+    pEstimator->rs = gMCRPOS_Parameters.rs;
+    pEstimator->invKFi = gMCRPOS_Parameters.invKFi;
+    pEstimator->kFilterEsdq = gMCRPOS_Parameters.kFilterEsdq;
+    pEstimator->kFilterBEMFAmp = gMCRPOS_Parameters.kFilterBEMFAmp;
+    pEstimator->velEstimFilterK = gMCRPOS_Parameters.velEstimFilterK;
+  #if(ENABLED == PLL_SPEED_SCHEDULING )
+    pEstimator->esdqBandwidthRatio = PLL_ESDQ_BANDWIDTH_RATIO;
+    pEstimator->velEstimBandwidthRatio = PLL_VELESTIM_BANDWIDTH_RATIO;
+    pEstimator->angleLagPeriods = PLL_ANGLE_LAG_PERIODS;
+  #endif
+}
+
+/******************************************************************************/
+/* Function name: MCPAR_EstimatorWrite                                        */
+/* Function parameters: pEstimator - estimator parameters                     */
+/* Function return: None                                                      */
+/* Description: Writes the parameters of the PLL estimator and the terms      */
+/*              derived from them, its state is kept                          */
+/******************************************************************************/
+static void MCPAR_EstimatorWrite( const tMCPAR_POSITION_ESTIMATOR_S * const pEstimator )
+{
+    gMCRPOS_Parameters.lsDt = pEstimator->lsDt;
+    gMCRPOS_Parameters.rs = pEstimator->rs;
+    gMCRPOS_Parameters.rsLsDt = pEstimator->rs + pEstimator->lsDt;
+    gMCRPOS_Parameters.invKFi = pEstimator->invKFi;
+    gMCRPOS_Parameters.kFilterEsdq = pEstimator->kFilterEsdq;
+    gMCRPOS_Parameters.kFilterBEMFAmp = pEstimator->kFilterBEMFAmp;
+    gMCRPOS_Parameters.velEstimFilterK = pEstimator->velEstimFilterK;
+  #if(ENABLED == PLL_SPEED_SCHEDULING )
+    gMCRPOS_Parameters.kFilterEsdqPerSpeed = pEstimator->esdqBandwidthRatio * gMCRPOS_Parameters.deltaT;
+    gMCRPOS_Parameters.velEstimFilterKPerSpeed = pEstimator->velEstimBandwidthRatio * gMCRPOS_Parameters.deltaT;
+    gMCRPOS_Parameters.angleLagTime = pEstimator->angleLagPeriods * gMCRPOS_Parameters.deltaT;
+  #endif
+}
+</#if>
+#endif
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCPAR_GainsWrite                                            */
+/* Function parameters: pController - PI controller, pGains - gains           */
+/* Function return: None                                                      */
+/* Description: Writes the gains of a PI controller, its state is kept        */
+/******************************************************************************/
+void MCPAR_GainsWrite( tMCLIB_PICONTROLLER_S * const pController, const tMCPAR_PI_GAINS_S * const pGains )
+{
+    pController->kp = pGains->kp;
+    pController->ki = pGains->ki;
+    pController->kc = pGains->kc;
+}
+
+/******************************************************************************/
+/* Function name: MCPAR_Initialize                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Copies the initialized controller and estimator parameters    */
+/*              into the active block                                         */
+/******************************************************************************/
+void MCPAR_Initialize( void )
+{
+#if (ENABLED == PARAMETER_CHANNEL)
+    tMCPAR_BLOCK_S * const pBlock = &gMCPAR_Data.block[0];
+
+    MCPAR_GainsRead( &pBlock->iqController, &gMCLIB_IqPIController );
+    MCPAR_GainsRead( &pBlock->idController, &gMCLIB_IdPIController );
+    MCPAR_GainsRead( &pBlock->speedController, &gMCLIB_SpeedPIController );
+#if (ENABLED == FIELD_WEAKENING )
+    pBlock->fieldWeakening = gMCCTRL_FieldWeakeningParam;
+#endif
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+    MCPAR_EstimatorRead( &pBlock->positionEstimator );
+</#if>
+
+    gMCPAR_Data.block[1] = *pBlock;
+    gMCPAR_Data.pActive = pBlock;
+    gMCPAR_Data.appliedSequence = gMCPAR_Data.publishedSequence;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCPAR_Edit                                                  */
+/* Function parameters: None                                                  */
+/* Function return: Shadow block, NULL while the last update is pending       */
+/* Description: Starts an update. The shadow block is loaded with the active  */
+/*              parameters and may then be written by the application.       */
+/******************************************************************************/
+tMCPAR_BLOCK_S * MCPAR_Edit( void )
+{
+    tMCPAR_BLOCK_S * pShadow = NULL;
+
+#if (ENABLED == PARAMETER_CHANNEL)
+    if( gMCPAR_Data.publishedSequence == gMCPAR_Data.appliedSequence )
+    {
+        /* The interrupt does not swap without a published update */
+        pShadow = ( gMCPAR_Data.pActive == &gMCPAR_Data.block[0] ) ? &gMCPAR_Data.block[1] : &gMCPAR_Data.block[0];
+        *pShadow = *gMCPAR_Data.pActive;
+    }
+#endif
+
+    return pShadow;
+}
+
+/******************************************************************************/
+/* Function name: MCPAR_Publish                                               */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Hands the shadow block over to the control interrupt          */
+/******************************************************************************/
+void MCPAR_Publish( void )
+{
+#if (ENABLED == PARAMETER_CHANNEL)
+    /* All writes to the shadow block complete before the sequence changes */
+    MCHAL_MemoryBarrier();
+    gMCPAR_Data.publishedSequence = gMCPAR_Data.appliedSequence + 1U;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCPAR_Restore                                               */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Copies the active block into the controllers and estimator,   */
+/*              after they were initialized again from the configuration      */
+/******************************************************************************/
+void MCPAR_Restore( void )
+{
+#if (ENABLED == PARAMETER_CHANNEL)
+    const tMCPAR_BLOCK_S * const pBlock = gMCPAR_Data.pActive;
+
+    MCPAR_GainsWrite( &gMCLIB_IqPIController, &pBlock->iqController );
+    MCPAR_GainsWrite( &gMCLIB_IdPIController, &pBlock->idController );
+    MCPAR_GainsWrite( &gMCLIB_SpeedPIController, &pBlock->speedController );
+#if (ENABLED == FIELD_WEAKENING )
+    gMCCTRL_FieldWeakeningParam = pBlock->fieldWeakening;
+#endif
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+    MCPAR_EstimatorWrite( &pBlock->positionEstimator );
+</#if>
+#endif
+}
+
+/*******************************************************************************
+ End of File
+*/
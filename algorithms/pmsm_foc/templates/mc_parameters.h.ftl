@@ -0,0 +1,230 @@
+/*******************************************************************************
+ Control Parameter Update interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_parameters.h
+
+  Summary:
+    Header file for the double buffered control parameter updates
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    control parameter update channel. When PARAMETER_CHANNEL is enabled the
+    tunable parameters are kept in two blocks. The control interrupt uses the
+    active block, the application edits the other (shadow) block and
+    publishes it by incrementing a sequence counter. At the start of the next
+    control interrupt MCPAR_Update swaps the block pointers and copies the new
+    block into the controllers, so that the interrupt never sees a partially
+    written parameter set and no interrupt has to be disabled.
+
+    Sequence of an update from the application:
+
+        tMCPAR_BLOCK_S * pBlock = MCPAR_Edit();
+        if( NULL != pBlock )
+        {
+            pBlock->iqController.kp = kp;
+            pBlock->iqController.ki = ki;
+            MCPAR_Publish();
+        }
+
+    MCPAR_Edit returns NULL while the previous update is not yet applied.
+    From X2CScope write the fields of the shadow block and then increment
+    gMCPAR_Data.publishedSequence. The updates are written to the floating
+    point controllers, PARAMETER_CHANNEL is not available with ARITHMETIC_Q14.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_PARAMETERS_H
+#define MC_PARAMETERS_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_control_loop.h"
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#include "mc_rotorposition.h"
+</#if>
+#include "mc_hal.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+typedef struct
+{
+    float               kp;
+    float               ki;
+    float               kc;
+}tMCPAR_PI_GAINS_S;
+
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+/* PLL estimator parameters. The terms derived from them, as rsLsDt, are
+   computed when the block is applied */
+typedef struct
+{
+    float               lsDt;
+    float               rs;
+    float               invKFi;
+    float               kFilterEsdq;
+    float               kFilterBEMFAmp;
+    float               velEstimFilterK;
+  #if(ENABLED == PLL_SPEED_SCHEDULING )
+    float               esdqBandwidthRatio;         /* Esd/Esq filter corner frequency per estimated speed */
+    float               velEstimBandwidthRatio;     /* Speed filter corner frequency per estimated speed   */
+    float               angleLagPeriods;            /* Compensated estimation delay in PWM periods          */
+  #endif
+}tMCPAR_POSITION_ESTIMATOR_S;
+
+</#if>
+
+/* Parameters which can be changed while the motor runs */
+typedef struct
+{
+    tMCPAR_PI_GAINS_S       iqController;
+    tMCPAR_PI_GAINS_S       idController;
+    tMCPAR_PI_GAINS_S       speedController;
+#if (ENABLED == FIELD_WEAKENING )
+    tMCCTRL_FW_PARAM_S      fieldWeakening;
+#endif
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+    tMCPAR_POSITION_ESTIMATOR_S positionEstimator;
+</#if>
+}tMCPAR_BLOCK_S;
+
+typedef struct
+{
+    tMCPAR_BLOCK_S                  block[2];
+    tMCPAR_BLOCK_S * volatile       pActive;            /* Block used by the control interrupt          */
+    volatile uint32_t               publishedSequence;  /* Incremented by the application per update    */
+    volatile uint32_t               appliedSequence;    /* Last sequence applied by the interrupt       */
+}tMCPAR_DATA_S;
+
+/******************************************************************************/
+/*                       INTERFACE VARIABLES                                  */
+/******************************************************************************/
+#if (ENABLED == PARAMETER_CHANNEL)
+extern tMCPAR_DATA_S gMCPAR_Data;
+#endif
+
+/******************************************************************************/
+/*                       INTERFACE FUNCTIONS                                  */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCPAR_GainsWrite                                            */
+/* Function parameters: pController - PI controller, pGains - gains           */
+/* Function return: None                                                      */
+/* Description: Writes the gains of a PI controller, its state is kept        */
+/******************************************************************************/
+void MCPAR_GainsWrite( tMCLIB_PICONTROLLER_S * const pController, const tMCPAR_PI_GAINS_S * const pGains );
+
+/******************************************************************************/
+/* Function name: MCPAR_Initialize                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Copies the initialized controller and estimator parameters    */
+/*              into the active block                                         */
+/******************************************************************************/
+void MCPAR_Initialize( void );
+
+/******************************************************************************/
+/* Function name: MCPAR_Edit                                                  */
+/* Function parameters: None                                                  */
+/* Function return: Shadow block, NULL while the last update is pending       */
+/* Description: Starts an update. The shadow block is loaded with the active  */
+/*              parameters and may then be written by the application.       */
+/******************************************************************************/
+tMCPAR_BLOCK_S * MCPAR_Edit( void );
+
+/******************************************************************************/
+/* Function name: MCPAR_Publish                                               */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Hands the shadow block over to the control interrupt          */
+/******************************************************************************/
+void MCPAR_Publish( void );
+
+/******************************************************************************/
+/* Function name: MCPAR_Restore                                               */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Copies the active block into the controllers and estimator,   */
+/*              after they were initialized again from the configuration      */
+/******************************************************************************/
+void MCPAR_Restore( void );
+
+#if (ENABLED == PARAMETER_CHANNEL)
+/******************************************************************************/
+/* Function name: MCPAR_Update                                                */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Swaps in a published block. Called at the start of the        */
+/*              control interrupt.                                            */
+/******************************************************************************/
+__STATIC_INLINE void MCPAR_Update( void )
+{
+    const uint32_t sequence = gMCPAR_Data.publishedSequence;
+
+    if( sequence != gMCPAR_Data.appliedSequence )
+    {
+        gMCPAR_Data.pActive = ( gMCPAR_Data.pActive == &gMCPAR_Data.block[0] ) ? &gMCPAR_Data.block[1]
+                                                                               : &gMCPAR_Data.block[0];
+        MCPAR_Restore();
+        gMCPAR_Data.appliedSequence = sequence;
+    }
+}
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif    /* MC_PARAMETERS_H */
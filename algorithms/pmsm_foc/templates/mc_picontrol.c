@@ -48,6 +48,7 @@
 #include "definitions.h"                // SYS function prototypes
 #include "device.h"
 #include "mc_picontrol.h"
+#include "mc_placement.h"
 
 
 // *****************************************************************************
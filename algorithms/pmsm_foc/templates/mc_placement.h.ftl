@@ -0,0 +1,117 @@
+/*******************************************************************************
+ Hot Path Placement interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_placement.h
+
+  Summary:
+    Memory placement of the control interrupt code and data
+
+  Description:
+    This file places the functions and data of the hot path profile
+    (mcPmsmFocPlacementProfileDict in pmsm_foc.py) in the memory selected by
+    HOT_PATH_PLACEMENT:
+
+      PLACEMENT_FLASH   no placement
+      PLACEMENT_RAM     code in SRAM with __ramfunc__, data unchanged
+      PLACEMENT_TCM     code in ITCM and data in DTCM with the tcm attribute
+
+    Every entry is redeclared with the placement attribute, so the modules
+    include this file after all other headers and before their definitions.
+    The flash wait state stalls avoided by the placement are estimated by
+    host/mc_placement_report.py from the map of the linked image.
+ *******************************************************************************/
+
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+
+#ifndef MC_PLACEMENT_H
+#define MC_PLACEMENT_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include "definitions.h"
+#include "mc_pmsm_foc_common.h"
+#include "mc_control_loop.h"
+#include "mc_currmeasurement.h"
+#include "mc_voltagemeasurement.h"
+#include "mc_rotorposition.h"
+#include "mc_lib.h"
+#include "mc_generic_lib.h"
+#include "mc_picontrol.h"
+#include "mc_pwm.h"
+#include "mc_foc_kernel.h"
+#include "mc_foc_q14.h"
+#include "mc_q14_lib.h"
+#include "mc_scheduler.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+#if (HOT_PATH_PLACEMENT == PLACEMENT_TCM)
+#define MCPLACE_CODE                    __attribute__((tcm))
+#define MCPLACE_DATA                    __attribute__((tcm))
+#elif (HOT_PATH_PLACEMENT == PLACEMENT_RAM)
+#include <sys/attribs.h>
+#if defined(__mips__)
+#define MCPLACE_CODE                    __longramfunc__
+#else
+#define MCPLACE_CODE                    __ramfunc__
+#endif
+#define MCPLACE_DATA
+#else
+#define MCPLACE_CODE
+#define MCPLACE_DATA
+#endif
+
+/* Redeclaration of a function or an object with the placement attribute */
+#define MCPLACE_DECLARE_CODE( name )    extern __typeof__( name ) name MCPLACE_CODE
+#define MCPLACE_DECLARE_DATA( name )    extern __typeof__( name ) name MCPLACE_DATA
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Hot Path Profile
+// *****************************************************************************
+// *****************************************************************************
+
+#if (HOT_PATH_PLACEMENT != PLACEMENT_FLASH)
+${MCPMSMFOC_PLACEMENT_PROFILE}
+#endif
+
+#endif    /* MC_PLACEMENT_H */
+
+/**
+ End of File
+*/
@@ -60,7 +60,12 @@
 #include "mc_pwm.h"
 #include "mc_lib.h"
 #include "mc_picontrol.h"
+#include "mc_profiler.h"
+#include "mc_scheduler.h"
+#include "mc_parameters.h"
+#include "mc_identification.h"
 #include "mc_hal.h"
+#include "mc_foc_q14.h"
 
 
 /******************************************************************************/
@@ -68,6 +73,8 @@
 /******************************************************************************/
 
 static void PMSM_FOC_ButtonPolling( void );
+static void PMSM_FOC_SpeedLoop( void );
+static void PMSM_FOC_PositionLoop( void );
 
 static tMCCTRL_TASK_STATE_E PMSM_FOC_IsSpeedLoopActive( void );
 static tMCCTRL_TASK_STATE_E PMSM_FOC_IsPositionLoopActive( void );
@@ -80,6 +87,17 @@ static void PMSM_FOC_StartAdcInterrupt( void );
 tPMSM_FOC_BUTTON_STATE_S                  gMCLIB_StartStopState;
 tPMSM_FOC_BUTTON_STATE_S                  gMCLIB_DirectionToggleState;
 
+#if (ENABLED == TASK_SCHEDULER)
+/* Slow tasks in order of priority. The phase offsets keep them out of the
+   PWM period of the speed loop */
+const tMCSCH_TASK_PARAM_S gMCSCH_TaskTable[MCSCH_TASKS] =
+{
+    [MCSCH_SPEED_LOOP]      = { SPEED_LOOP_PWM_COUNT,    0U,                              PMSM_FOC_SpeedLoop },
+    [MCSCH_BUTTON_POLLING]  = { SPEED_LOOP_PWM_COUNT,    SPEED_LOOP_PWM_COUNT / 2U,       PMSM_FOC_ButtonPolling },
+    [MCSCH_POSITION_LOOP]   = { POSITION_LOOP_PWM_COUNT, SPEED_LOOP_PWM_COUNT / 4U,       PMSM_FOC_PositionLoop },
+};
+#endif
+
 
 /******************************************************************************/
 /*                   Local Functions                                         */
@@ -159,9 +177,21 @@ void PMSM_FOC_Initialize( void )
     /* Motor Controller parameter initialization */
     MCCTRL_InitializeMotorControl();
 
+    /* Configured motor parameters, replaced by the identified ones */
+    MCID_Initialize();
+
     /* Rotor position algorithm state initialization */
     MCRPOS_InitializeRotorPositionSensing();
 
+    /* Run time parameter updates start from the initialized parameters */
+    MCPAR_Initialize();
+
+    /* Control interrupt stage profiler */
+    MCPROF_Initialize();
+
+    /* Slow task scheduler */
+    MCSCH_Initialize();
+
     /* Start ADC Interrupt for current control */
     PMSM_FOC_StartAdcInterrupt();
 }
@@ -211,6 +241,35 @@ void PMSM_FOC_MotorStart(void)
 
 }
 
+#if (ENABLED == MOTOR_IDENTIFICATION)
+/*****************************************************************************/
+/* Function name: PMSM_FOC_MotorIdentify                                     */
+/* Function parameters: None                                                 */
+/* Function return: None                                                     */
+/* Description: Starts the motor parameter identification with the rotor at  */
+/*              standstill. The control returns to MCAPP_IDLE when finished, */
+/*              see gMCID_State.step for the result.                         */
+/*****************************************************************************/
+void PMSM_FOC_MotorIdentify(void)
+{
+    MCERR_ErrorClear();
+    PMSM_FOC_ResetParameters();
+
+    MCCTRL_ResetMotorControl();
+
+    MCID_Start();
+    gMCCTRL_CtrlParam.mcStateLast = gMCCTRL_CtrlParam.mcState;
+    gMCCTRL_CtrlParam.mcState = MCAPP_IDENTIFICATION;
+
+    /* Enable / Re-enable PWM output */
+    gMCPWM_SVPWM.dPwm1 = gMCPWM_SVPWM.neutralPWM;
+    gMCPWM_SVPWM.dPwm2 = gMCPWM_SVPWM.neutralPWM;
+    gMCPWM_SVPWM.dPwm3 = gMCPWM_SVPWM.neutralPWM;
+    MCPWM_PWMDutyUpdate(&gMCPWM_SVPWM);
+    MCPWM_PWMOutputEnable();
+}
+#endif
+
 /******************************************************************************/
 /* Function name: PMSM_FOC_MotorStop                                          */
 /* Function parameters: None                                                  */
@@ -259,6 +318,7 @@ void PMSM_FOC_DirectionToggle(void)
 /******************************************************************************/
 void PMSM_FOC_Tasks()
 {
+#if (DISABLED == TASK_SCHEDULER)
     /* Position Loop control tasks */
     if( MCCTRL_LOOP_ACTIVE == PMSM_FOC_IsSpeedLoopActive())
     {
@@ -266,6 +326,7 @@ void PMSM_FOC_Tasks()
     }
     /* Speed Loop Control tasks  */
     PMSM_FOC_SpeedLoopTasks();
+#endif
  }
 
 
@@ -281,21 +342,40 @@ void PMSM_FOC_SpeedLoopTasks()
 {
     if( MCCTRL_LOOP_ACTIVE == PMSM_FOC_IsSpeedLoopActive())
     {
-        if( MCAPP_CLOSED_LOOP  == gMCCTRL_CtrlParam.mcState )
-        {
-            /* Reference speed calculation */
-            MCSPE_SpeedCommand();
-        }
-        else
-        {
-            gMCSPE_OutputSignals.commandSpeed = gMCCTRL_CtrlParam.velRef;
-        }
+        PMSM_FOC_SpeedLoop();
 
         /* Reset Speed Loop counter */
         gMCCTRL_TaskStateSignals.speedLoopActive = MCCTRL_LOOP_INACTIVE;
     }
  }
 
+/******************************************************************************/
+/* Function name: PMSM_FOC_SpeedLoop                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Speed reference calculation, every SPEED_LOOP_PWM_COUNT       */
+/******************************************************************************/
+static void PMSM_FOC_SpeedLoop( void )
+{
+    if( MCAPP_CLOSED_LOOP  == gMCCTRL_CtrlParam.mcState )
+    {
+        /* Reference speed calculation */
+        MCSPE_SpeedCommand();
+    }
+    else
+    {
+#if (ARITHMETIC == ARITHMETIC_Q14)
+        gMCCTRL_CtrlParam.velRef = MCQ14_TO_FLOAT( gMCQ14_CtrlSignals.velRef, MCQ14_SPEED_BASE );
+#endif
+        gMCSPE_OutputSignals.commandSpeed = gMCCTRL_CtrlParam.velRef;
+    }
+
+#if (ARITHMETIC == ARITHMETIC_Q14)
+    /* Speed reference of the fixed point speed controller */
+    gMCQ14_CtrlSignals.speedRef = MCQ14_FROM_FLOAT( gMCSPE_OutputSignals.commandSpeed, MCQ14_SPEED_BASE );
+#endif
+}
+
 
 
 
@@ -309,7 +389,7 @@ void MCINF_PositionLoopTasks()
 {
     if( MCCTRL_LOOP_ACTIVE == PMSM_FOC_IsPositionLoopActive())
     {
-        /* Performs tasks for position loop  */
+        PMSM_FOC_PositionLoop();
 
         /* Reset Speed Loop counter */
         gMCCTRL_TaskStateSignals.positionLoopActive = MCCTRL_LOOP_INACTIVE;
@@ -317,6 +397,17 @@ void MCINF_PositionLoopTasks()
     }
  }
 
+/*****************************************************************************/
+/* Function name: PMSM_FOC_PositionLoop                                      */
+/* Function parameters: None                                                 */
+/* Function return: None                                                     */
+/* Description: Position loop, every POSITION_LOOP_PWM_COUNT                 */
+/*****************************************************************************/
+static void PMSM_FOC_PositionLoop( void )
+{
+    /* Performs tasks for position loop  */
+}
+
 /*******************************************************************************/
 /* Function name: PMSM_FOC_ButtonPolling                                          */
 /* Function parameters: None                                                   */
@@ -108,6 +108,9 @@ void PMSM_FOC_ResetParameters(void);
 
 void PMSM_FOC_MotorStart( void );
 void PMSM_FOC_MotorStop( void );
+#if (ENABLED == MOTOR_IDENTIFICATION)
+void PMSM_FOC_MotorIdentify( void );
+#endif
 
 void PMSM_FOC_SpeedLoopTasks( void );
 
@@ -78,6 +78,38 @@ extern "C" {
 /* Current measurement methods */
 #define DUAL_SHUNT                      (0U)
 
+/* Sine and cosine calculation methods */
+#define SINCOS_INTERPOLATED_TABLE       (0U)
+#define SINCOS_POLYNOMIAL               (1U)
+#define SINCOS_QUARTER_WAVE_TABLE       (2U)
+#define SINCOS_CORDIC                   (3U)
+
+/* Space vector modulation methods */
+#define SVPWM_SECTOR_TREE               (0U)
+#define SVPWM_MIN_MAX                   (1U)
+#define SVPWM_DPWM_MIN                  (2U)
+#define SVPWM_DPWM60                    (3U)
+#define SVPWM_DPWM30                    (4U)
+
+/* Voltage vector limits */
+#define VOLTAGE_LIMIT_LINEAR            (0U)
+#define VOLTAGE_LIMIT_OVERMODULATION    (1U)
+#define VOLTAGE_LIMIT_SIX_STEP          (2U)
+
+/* Field weakening methods */
+#define FW_FEED_FORWARD                 (0U)
+#define FW_VOLTAGE_LOOP                 (1U)
+#define FW_MAP_VOLTAGE_LOOP             (2U)
+
+/* Control arithmetic */
+#define ARITHMETIC_FLOAT                (0U)
+#define ARITHMETIC_Q14                  (1U)
+
+/* Hot path placement */
+#define PLACEMENT_FLASH                 (0U)
+#define PLACEMENT_RAM                   (1U)
+#define PLACEMENT_TCM                   (2U)
+
 #define ENABLED                          (1U)
 #define DISABLED                         (0U)
 
@@ -107,7 +139,8 @@ typedef enum
     MCAPP_FIELD_ALIGNMENT,
     MCAPP_OPEN_LOOP,
     MCAPP_CLOSING_LOOP,
-    MCAPP_CLOSED_LOOP
+    MCAPP_CLOSED_LOOP,
+    MCAPP_IDENTIFICATION
 }tMCAPP_CONTROL_STATE_E;
 
 
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ ISR Stage Profiler source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_profiler.c
+
+  Summary:
+    Execution time statistics of the control interrupt stages
+
+  Description:
+    This file contains the initialization of the stage profiler. The time
+    stamps are taken by the inline functions of mc_profiler.h, using the
+    cycle counter provided by mc_hal.h (DWT cycle counter on Cortex-M, core
+    timer on PIC32).
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"                // SYS function prototypes
+#include "device.h"
+#include "mc_derivedparams.h"
+#include "mc_profiler.h"
+#include "mc_hal.h"
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+#if (ENABLED == ISR_PROFILER)
+tMCPROF_DATA_S      gMCPROF_Data;
+#endif
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCPROF_Initialize                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the cycle counter, measures the cost of a counter     */
+/*              read and clears the statistics                                */
+/******************************************************************************/
+void MCPROF_Initialize( void )
+{
+#if (ENABLED == ISR_PROFILER)
+    uint32_t start, cycles, i;
+
+    MCHAL_CycleCounterStart();
+
+    gMCPROF_Data.clockHz = MCHAL_CYCLE_COUNTER_CLOCK_HZ;
+    gMCPROF_Data.periodCycles = gMCPROF_Data.clockHz / PWM_FREQUENCY;
+    gMCPROF_Data.binShift = ISR_PROFILER_BIN_SHIFT;
+
+    /* Back to back counter reads */
+    gMCPROF_Data.overheadCycles = UINT32_MAX;
+    for( i = 0U; i < 16U; i++ )
+    {
+        start = MCHAL_CycleCounterGet();
+        cycles = MCHAL_CycleCounterGet() - start;
+        if( cycles < gMCPROF_Data.overheadCycles )
+        {
+            gMCPROF_Data.overheadCycles = cycles;
+        }
+    }
+
+    MCPROF_Reset();
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCPROF_Reset                                                */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clears the statistics of all stages                           */
+/******************************************************************************/
+void MCPROF_Reset( void )
+{
+#if (ENABLED == ISR_PROFILER)
+    uint32_t stage, bin;
+
+    for( stage = 0U; stage < (uint32_t)MCPROF_STAGES; stage++ )
+    {
+        gMCPROF_Data.stage[stage].minCycles = UINT32_MAX;
+        gMCPROF_Data.stage[stage].maxCycles = 0U;
+        gMCPROF_Data.stage[stage].lastCycles = 0U;
+        gMCPROF_Data.stage[stage].count = 0U;
+        gMCPROF_Data.stage[stage].sumCycles = 0U;
+        for( bin = 0U; bin < MCPROF_HISTOGRAM_BINS; bin++ )
+        {
+            gMCPROF_Data.stage[stage].histogram[bin] = 0U;
+        }
+    }
+    gMCPROF_Data.resetRequest = 0U;
+#endif
+}
+
+/*******************************************************************************
+ End of File
+*/
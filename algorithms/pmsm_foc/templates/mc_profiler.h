@@ -0,0 +1,233 @@
+/*******************************************************************************
+ ISR Stage Profiler interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_profiler.h
+
+  Summary:
+    Header file for the control interrupt stage profiler
+
+  Description:
+    This file contains the data structures, instrumentation macros and function
+    prototypes of the stage profiler. When ISR_PROFILER is enabled every stage
+    of MCCTRL_CurrentLoopTasks is timed with the cycle counter of the device and
+    the minimum, maximum, average and a histogram of the execution time are kept
+    in gMCPROF_Data. The block can be read with the debugger or X2CScope. When
+    ISR_PROFILER is disabled the instrumentation macros expand to nothing.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_PROFILER_H
+#define MC_PROFILER_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_hal.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Number of histogram bins per stage. The last bin collects all longer executions */
+#define MCPROF_HISTOGRAM_BINS           (32U)
+
+typedef enum
+{
+    MCPROF_CURRENT_MEASUREMENT,
+    MCPROF_VOLTAGE_MEASUREMENT,
+    MCPROF_SIGNAL_TRANSFORMATION,
+    MCPROF_POSITION_MEASUREMENT,
+    MCPROF_MOTOR_CONTROL,
+    MCPROF_LOOP_SYNCHRONIZATION,
+    MCPROF_CURRENT_LOOP_TASKS,          /* Complete MCCTRL_CurrentLoopTasks */
+    MCPROF_STAGES
+}tMCPROF_STAGE_E;
+
+typedef struct
+{
+    uint32_t    minCycles;
+    uint32_t    maxCycles;
+    uint32_t    lastCycles;
+    uint32_t    count;
+    uint64_t    sumCycles;
+    uint32_t    histogram[MCPROF_HISTOGRAM_BINS];
+}tMCPROF_STAGE_S;
+
+typedef struct
+{
+    tMCPROF_STAGE_S     stage[MCPROF_STAGES];
+    uint32_t            clockHz;            /* Cycle counter frequency                     */
+    uint32_t            periodCycles;       /* PWM period in cycle counter ticks           */
+    uint32_t            binShift;           /* Histogram bin width is 2^binShift cycles    */
+    uint32_t            overheadCycles;     /* Cost of one cycle counter read, subtracted  */
+    uint32_t            isrStart;
+    uint32_t            stageStart;
+    volatile uint32_t   resetRequest;       /* Set from the debugger to restart statistics */
+}tMCPROF_DATA_S;
+
+/******************************************************************************/
+/*                       INTERFACE VARIABLES                                  */
+/******************************************************************************/
+#if (ENABLED == ISR_PROFILER)
+extern tMCPROF_DATA_S gMCPROF_Data;
+#endif
+
+/******************************************************************************/
+/*                       INTERFACE FUNCTIONS                                  */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCPROF_Initialize                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the cycle counter and clears the statistics            */
+/******************************************************************************/
+void MCPROF_Initialize( void );
+
+/******************************************************************************/
+/* Function name: MCPROF_Reset                                                */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clears the statistics of all stages                           */
+/******************************************************************************/
+void MCPROF_Reset( void );
+
+#if (ENABLED == ISR_PROFILER)
+/******************************************************************************/
+/* Function name: MCPROF_Record                                               */
+/* Function parameters: stage, cycles                                         */
+/* Function return: None                                                      */
+/* Description: Updates the statistics of a stage                            */
+/******************************************************************************/
+__STATIC_INLINE void MCPROF_Record( const tMCPROF_STAGE_E stage, uint32_t cycles )
+{
+    tMCPROF_STAGE_S * const pStage = &gMCPROF_Data.stage[stage];
+    uint32_t bin;
+
+    cycles = ( cycles > gMCPROF_Data.overheadCycles ) ? ( cycles - gMCPROF_Data.overheadCycles ) : 0U;
+
+    pStage->lastCycles = cycles;
+    pStage->sumCycles += cycles;
+    pStage->count++;
+    if( cycles < pStage->minCycles )
+    {
+        pStage->minCycles = cycles;
+    }
+    if( cycles > pStage->maxCycles )
+    {
+        pStage->maxCycles = cycles;
+    }
+
+    bin = cycles >> gMCPROF_Data.binShift;
+    if( bin >= MCPROF_HISTOGRAM_BINS )
+    {
+        bin = MCPROF_HISTOGRAM_BINS - 1U;
+    }
+    pStage->histogram[bin]++;
+}
+
+/******************************************************************************/
+/* Function name: MCPROF_IsrEntry                                             */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Time stamp at the start of the control interrupt              */
+/******************************************************************************/
+__STATIC_INLINE void MCPROF_IsrEntry( void )
+{
+    if( 0U != gMCPROF_Data.resetRequest )
+    {
+        MCPROF_Reset();
+    }
+    gMCPROF_Data.isrStart = MCHAL_CycleCounterGet();
+    gMCPROF_Data.stageStart = gMCPROF_Data.isrStart;
+}
+
+/******************************************************************************/
+/* Function name: MCPROF_StageEnd                                             */
+/* Function parameters: stage                                                 */
+/* Function return: None                                                      */
+/* Description: Records the stage which just completed. The time spent in     */
+/*              the bookkeeping is not charged to the next stage.             */
+/******************************************************************************/
+__STATIC_INLINE void MCPROF_StageEnd( const tMCPROF_STAGE_E stage )
+{
+    uint32_t now = MCHAL_CycleCounterGet();
+
+    MCPROF_Record( stage, now - gMCPROF_Data.stageStart );
+    gMCPROF_Data.stageStart = MCHAL_CycleCounterGet();
+}
+
+/******************************************************************************/
+/* Function name: MCPROF_IsrExit                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Records the complete interrupt including the profiler cost   */
+/******************************************************************************/
+__STATIC_INLINE void MCPROF_IsrExit( void )
+{
+    MCPROF_Record( MCPROF_CURRENT_LOOP_TASKS, MCHAL_CycleCounterGet() - gMCPROF_Data.isrStart );
+}
+
+#define MCPROF_ISR_ENTRY()              MCPROF_IsrEntry()
+#define MCPROF_STAGE_END(stage)         MCPROF_StageEnd(stage)
+#define MCPROF_ISR_EXIT()               MCPROF_IsrExit()
+#else
+#define MCPROF_ISR_ENTRY()
+#define MCPROF_STAGE_END(stage)
+#define MCPROF_ISR_EXIT()
+#endif
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif    /* MC_PROFILER_H */
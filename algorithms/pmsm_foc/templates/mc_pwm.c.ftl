@@ -54,12 +54,23 @@
 #include "mc_generic_lib.h"
 #include "math.h"
 #include "assert.h"
+#include "mc_placement.h"
 
 // *****************************************************************************
 // *****************************************************************************
 // Section: Data Types
 // *****************************************************************************
 // *****************************************************************************
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+/* Fundamental voltage at the end of overmodulation mode I (the reference
+   travels along the voltage hexagon) and of mode II (six-step), relative to
+   the linear range */
+#define MCPWM_MODE_I_LIMIT                  (1.0490974577f)
+#define MCPWM_SIX_STEP_LIMIT                (1.1026577908f)
+#define MCPWM_OVERMODULATION_TABLE_SIZE     (17U)
+#define MCPWM_MODE_I_TABLE_SCALE            ( (float)( MCPWM_OVERMODULATION_TABLE_SIZE - 1U ) / ( MCPWM_MODE_I_LIMIT - 1.0f ) )
+#define MCPWM_MODE_II_TABLE_SCALE           ( (float)( MCPWM_OVERMODULATION_TABLE_SIZE - 1U ) / ( MCPWM_SIX_STEP_LIMIT - MCPWM_MODE_I_LIMIT ) )
+#endif
 
 /******************************************************************************/
 /* Local Function Prototype                                                   */
@@ -72,6 +83,51 @@ __STATIC_INLINE void MCPWM_SVPWMTimeCalc(tMCPWM_SVPWM_S* svm);
 /******************************************************************************/
 tMCPWM_SVPWM_S    gMCPWM_SVPWM = {0.0f};
 
+#if (ENABLED == DEADTIME_COMPENSATION) || (ENABLED == VOLTAGE_RECONSTRUCTION)
+tMCPWM_DEADTIME_PARAM_S gMCPWM_DeadTimeParam =
+{
+    .duty = DEADTIME_COMP_DUTY,
+    .invBand = DEADTIME_COMP_INV_BAND
+};
+#endif
+
+#if (ENABLED == VOLTAGE_RECONSTRUCTION)
+tMCPWM_STATOR_VOLTAGE_S gMCPWM_StatorVoltage = { 0.0f };
+#endif
+
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+/* Mode I: radius of the reference circle which, clipped to the voltage
+   hexagon with the angle kept, has the fundamental of the table position.
+   Positions are evenly spaced from 1 to MCPWM_MODE_I_LIMIT. */
+const float overmodulationRadiusTable[MCPWM_OVERMODULATION_TABLE_SIZE] =
+{
+    1.000000f, 1.003430f, 1.007246f, 1.011388f, 1.015855f, 1.020664f, 1.025846f, 1.031441f, 1.037509f,
+    1.044129f, 1.051414f, 1.059527f, 1.068722f, 1.079423f, 1.092467f, 1.110005f, 1.154701f
+};
+
+#if (VOLTAGE_LIMIT_METHOD == VOLTAGE_LIMIT_SIX_STEP)
+/* Mode II: share of every hexagon side, at both ends, over which the output
+   is held on the active vector. Positions are evenly spaced from
+   MCPWM_MODE_I_LIMIT to MCPWM_SIX_STEP_LIMIT, 0.5 is six-step operation. */
+const float overmodulationHoldTable[MCPWM_OVERMODULATION_TABLE_SIZE] =
+{
+    0.000000f, 0.017950f, 0.036284f, 0.055055f, 0.074324f, 0.094171f, 0.114690f, 0.136000f, 0.158257f,
+    0.181665f, 0.206508f, 0.233193f, 0.262349f, 0.295039f, 0.333339f, 0.382637f, 0.500000f
+};
+
+/* Active voltage vectors 100, 110, 010, 011, 001, 101 at 0, 60, ... 300 degrees */
+const tMCLIB_CLARK_TRANSFORM_S overmodulationVertexTable[6] =
+{
+    {  1.1547005384f,  0.0f          },
+    {  0.5773502691f,  1.0f          },
+    { -0.5773502691f,  1.0f          },
+    { -1.1547005384f,  0.0f          },
+    { -0.5773502691f, -1.0f          },
+    {  0.5773502691f, -1.0f          }
+};
+#endif
+#endif
+
 
 /******************************************************************************/
 /*                          LOCAL FUNCTIONS                                   */
@@ -85,18 +141,42 @@ __STATIC_INLINE void MCPWM_SVPWMTimeCalc(tMCPWM_SVPWM_S * const svm)
     svm->ta = svm->tb + svm->t1;
 }
 
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+/******************************************************************************/
+/* Function name: MCPWM_TableInterpolate                                      */
+/* Function parameters: table, position - fractional table index             */
+/* Function return: Interpolated table value                                  */
+/* Description: Linear interpolation, the position is limited to the table    */
+/******************************************************************************/
+__STATIC_INLINE float MCPWM_TableInterpolate( const float * const table, float position )
+{
+    uint32_t index;
+
+    position = ( position > 0.0f ) ? position : 0.0f;
+    position = ( position < (float)( MCPWM_OVERMODULATION_TABLE_SIZE - 1U ) ) ? position
+                                                                                : (float)( MCPWM_OVERMODULATION_TABLE_SIZE - 1U );
+    index = (uint32_t)position;
+    if( index >= ( MCPWM_OVERMODULATION_TABLE_SIZE - 1U ) )
+    {
+        index = MCPWM_OVERMODULATION_TABLE_SIZE - 2U;
+    }
+    return table[index] + ( ( position - (float)index ) * ( table[index + 1U] - table[index] ) );
+}
+#endif
+
 /******************************************************************************/
 /*                      INTERFACE FUNCTIONS                                   */
 /******************************************************************************/
 
+#if (SVPWM_METHOD == SVPWM_SECTOR_TREE) || defined(MCPWM_SVPWM_ALL_METHODS)
 /******************************************************************************/
-/* Function name: MCPWM_SVPWMGen                                              */
+/* Function name: MCPWM_SVPWMSectorTree                                       */
 /* Function parameters: None                                                  */
 /* Function return: None                                                      */
 /* Description: Determines sector based upon three reference                  */
 /*              vectors amplitude and updates duty.                           */
 /******************************************************************************/
-void MCPWM_SVPWMGen( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm )
+void MCPWM_SVPWMSectorTree( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm )
 {
     svm->vr1 = vAlphaBeta->betaAxis;
     svm->vr2 = (-vAlphaBeta->betaAxis/2 + SQRT3_BY2 * vAlphaBeta->alphaAxis);
@@ -183,6 +263,206 @@ void MCPWM_SVPWMGen( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_S
             }
       }
 }
+#endif
+
+#if (SVPWM_METHOD == SVPWM_MIN_MAX) || defined(MCPWM_SVPWM_ALL_METHODS)
+/******************************************************************************/
+/* Function name: MCPWM_SVPWMMinMax                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Space vector modulation by min-max zero sequence injection    */
+/*              on the phase voltages, without sector decision                */
+/******************************************************************************/
+void MCPWM_SVPWMMinMax( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm )
+{
+    MCPWM_MinMaxDuty( vAlphaBeta->alphaAxis, vAlphaBeta->betaAxis, svm );
+}
+#endif
+
+#if (SVPWM_METHOD == SVPWM_DPWM_MIN) || (SVPWM_METHOD == SVPWM_DPWM60) || (SVPWM_METHOD == SVPWM_DPWM30) || defined(MCPWM_SVPWM_ALL_METHODS)
+/******************************************************************************/
+/* Function name: MCPWM_SVPWMDpwmMin                                          */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Discontinuous PWM, lowest phase clamped to the negative rail  */
+/******************************************************************************/
+void MCPWM_SVPWMDpwmMin( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm )
+{
+    MCPWM_DiscontinuousDuty( vAlphaBeta->alphaAxis, vAlphaBeta->betaAxis, svm, SVPWM_DPWM_MIN );
+}
+
+/******************************************************************************/
+/* Function name: MCPWM_SVPWMDpwm60                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Discontinuous PWM, 60 degree clamping around the phase peaks  */
+/******************************************************************************/
+void MCPWM_SVPWMDpwm60( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm )
+{
+    MCPWM_DiscontinuousDuty( vAlphaBeta->alphaAxis, vAlphaBeta->betaAxis, svm, SVPWM_DPWM60 );
+}
+
+/******************************************************************************/
+/* Function name: MCPWM_SVPWMDpwm30                                           */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Discontinuous PWM, 30 degree clamping intervals               */
+/******************************************************************************/
+void MCPWM_SVPWMDpwm30( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm )
+{
+    MCPWM_DiscontinuousDuty( vAlphaBeta->alphaAxis, vAlphaBeta->betaAxis, svm, SVPWM_DPWM30 );
+}
+#endif
+
+/******************************************************************************/
+/* Function name: MCPWM_SVPWMGen                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Space vector modulation with the method selected by           */
+/*              SVPWM_METHOD                                                  */
+/******************************************************************************/
+void MCPWM_SVPWMGen( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm )
+{
+#if (SVPWM_METHOD == SVPWM_MIN_MAX)
+    MCPWM_SVPWMMinMax( vAlphaBeta, svm );
+#elif (SVPWM_METHOD == SVPWM_DPWM_MIN)
+    MCPWM_SVPWMDpwmMin( vAlphaBeta, svm );
+#elif (SVPWM_METHOD == SVPWM_DPWM60)
+    MCPWM_SVPWMDpwm60( vAlphaBeta, svm );
+#elif (SVPWM_METHOD == SVPWM_DPWM30)
+    MCPWM_SVPWMDpwm30( vAlphaBeta, svm );
+#else
+    MCPWM_SVPWMSectorTree( vAlphaBeta, svm );
+#endif
+}
+
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+/******************************************************************************/
+/* Function name: MCPWM_Overmodulation                                        */
+/* Function parameters: vAlpha, vBeta - voltage reference outside the linear  */
+/*                      range, replaced by the voltage vector to be modulated */
+/*                      magnitudeSquared - squared reference magnitude        */
+/* Function return: None                                                      */
+/* Description: Two mode overmodulation. In mode I the reference is enlarged  */
+/*              and clipped to the voltage hexagon with its angle kept, the   */
+/*              enlargement recovers the fundamental lost at the corners. In  */
+/*              mode II the output travels along the hexagon and is held on   */
+/*              the active vectors at both ends of every side, up to six-step */
+/*              operation. The reference magnitude is the fundamental of the  */
+/*              output, up to the limit of the configured method.             */
+/******************************************************************************/
+void MCPWM_Overmodulation( float * const vAlpha, float * const vBeta, const float magnitudeSquared )
+{
+    float magnitude, scale, vr1, vr2, vr3, hexagon;
+#if (VOLTAGE_LIMIT_METHOD == VOLTAGE_LIMIT_SIX_STEP)
+    float hold, t1, t2, sum, span, share;
+    uint32_t vertex1, vertex2;
+#endif
+
+    magnitude = sqrtf( magnitudeSquared );
+
+#if (VOLTAGE_LIMIT_METHOD == VOLTAGE_LIMIT_SIX_STEP)
+    if( magnitude > MCPWM_MODE_I_LIMIT )
+    {
+        /* Mode II: position along the hexagon side from the sector times */
+        vr1 = *vBeta;
+        vr2 = ( -*vBeta/2 + SQRT3_BY2 * *vAlpha );
+        vr3 = ( -*vBeta/2 - SQRT3_BY2 * *vAlpha );
+        if( vr1 >= 0 )
+        {
+            if( vr2 >= 0 )
+            {
+                t1 = vr2;
+                t2 = vr1;
+                vertex1 = 0U;
+                vertex2 = 1U;
+            }
+            else if( vr3 >= 0 )
+            {
+                t1 = vr1;
+                t2 = vr3;
+                vertex1 = 2U;
+                vertex2 = 3U;
+            }
+            else
+            {
+                t1 = -vr2;
+                t2 = -vr3;
+                vertex1 = 2U;
+                vertex2 = 1U;
+            }
+        }
+        else
+        {
+            if( vr2 >= 0 )
+            {
+                if( vr3 >= 0 )
+                {
+                    t1 = vr3;
+                    t2 = vr2;
+                    vertex1 = 4U;
+                    vertex2 = 5U;
+                }
+                else
+                {
+                    t1 = -vr3;
+                    t2 = -vr1;
+                    vertex1 = 0U;
+                    vertex2 = 5U;
+                }
+            }
+            else
+            {
+                t1 = -vr1;
+                t2 = -vr2;
+                vertex1 = 4U;
+                vertex2 = 3U;
+            }
+        }
+
+        /* Hold on the nearest active vector, travel along the side in between */
+        hold = MCPWM_TableInterpolate( overmodulationHoldTable, ( magnitude - MCPWM_MODE_I_LIMIT ) * MCPWM_MODE_II_TABLE_SCALE );
+        sum = t1 + t2;
+        span = ( 1.0f - ( 2.0f * hold ) ) * sum;
+        if( span > ( 1.0e-3f * sum ) )
+        {
+            share = ( t2 - ( hold * sum ) ) / span;
+            share = ( share > 0.0f ) ? share : 0.0f;
+            share = ( share < 1.0f ) ? share : 1.0f;
+        }
+        else
+        {
+            /* Six-step */
+            share = ( t2 >= t1 ) ? 1.0f : 0.0f;
+        }
+
+        *vAlpha = overmodulationVertexTable[vertex1].alphaAxis
+                + ( share * ( overmodulationVertexTable[vertex2].alphaAxis - overmodulationVertexTable[vertex1].alphaAxis ) );
+        *vBeta = overmodulationVertexTable[vertex1].betaAxis
+               + ( share * ( overmodulationVertexTable[vertex2].betaAxis - overmodulationVertexTable[vertex1].betaAxis ) );
+        return;
+    }
+#endif
+
+    /* Mode I: reference enlarged to the radius of the fundamental */
+    scale = MCPWM_TableInterpolate( overmodulationRadiusTable, ( magnitude - 1.0f ) * MCPWM_MODE_I_TABLE_SCALE ) / magnitude;
+    *vAlpha = scale * *vAlpha;
+    *vBeta = scale * *vBeta;
+
+    /* Clipped to the voltage hexagon, on which the largest sector time is one */
+    vr1 = fabsf( *vBeta );
+    vr2 = fabsf( -*vBeta/2 + SQRT3_BY2 * *vAlpha );
+    vr3 = fabsf( -*vBeta/2 - SQRT3_BY2 * *vAlpha );
+    hexagon = ( vr1 > vr2 ) ? vr1 : vr2;
+    hexagon = ( hexagon > vr3 ) ? hexagon : vr3;
+    if( hexagon > 1.0f )
+    {
+        scale = 1.0f / hexagon;
+        *vAlpha = scale * *vAlpha;
+        *vBeta = scale * *vBeta;
+    }
+}
+#endif
 
 /******************************************************************************/
 /* Function name: MCPWM_PWMModulator                                          */
@@ -192,8 +472,25 @@ void MCPWM_SVPWMGen( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_S
 /******************************************************************************/
 void MCPWM_PWMModulator( void )
 {
+#if (ENABLED == DEADTIME_COMPENSATION)
+    tMCLIB_CLARK_TRANSFORM_S vAlphaBeta;
+#endif
+
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+    /* Overmodulation, the applied voltage is kept for the position estimation */
+    MCPWM_VoltageLimit( &gMCLIB_VoltageAlphaBeta.alphaAxis, &gMCLIB_VoltageAlphaBeta.betaAxis );
+
+#endif
+#if (ENABLED == DEADTIME_COMPENSATION)
+    /* Only the modulated voltage is compensated: the voltage reference kept for
+       the position estimation is the voltage the inverter applies to the motor */
+    vAlphaBeta = gMCLIB_VoltageAlphaBeta;
+    MCPWM_DeadTimeCompensation( gMCLIB_CurrentAlphaBeta.alphaAxis, gMCLIB_CurrentAlphaBeta.betaAxis, &vAlphaBeta.alphaAxis, &vAlphaBeta.betaAxis );
+    MCPWM_SVPWMGen(&vAlphaBeta, &gMCPWM_SVPWM);
+#else
     /* Calculate and set PWM duty cycles from Vr1,Vr2,Vr3 */
     MCPWM_SVPWMGen(&gMCLIB_VoltageAlphaBeta, &gMCPWM_SVPWM);
+#endif
     MCPWM_PWMDutyUpdate(&gMCPWM_SVPWM);
 }
 
@@ -230,10 +527,41 @@ void MCPWM_PWMOutputEnable(void)
 /* Function parameters: None                                                 */
 /* Function return: None                                                     */
 /* Description:                                                              */
-/* interface to update duty ratio in PWM timers                              */
+/* interface to update duty ratio in PWM timers. With discontinuous PWM the  */
+/* clamped phase keeps its duty for a third of the period, so only changed   */
+/* duties are written.                                                       */
 /*****************************************************************************/
 void MCPWM_PWMDutyUpdate(tMCPWM_SVPWM_S * const svm)
 {
+#if (SVPWM_METHOD == SVPWM_DPWM_MIN) || (SVPWM_METHOD == SVPWM_DPWM60) || (SVPWM_METHOD == SVPWM_DPWM30)
+    if( svm->dPwm1 != svm->lastPwm1 )
+    {
+        svm->lastPwm1 = svm->dPwm1;
+<#if __PROCESSOR?matches("PIC32M.*") == true>
+        MCHAL_PWMDutySet(MCHAL_PWM_PH_U, svm->dPwm1);
+<#else>
+        MCHAL_PWMDutySet(MCHAL_PWM_PH_U, svm->period - svm->dPwm1);
+</#if>
+    }
+    if( svm->dPwm2 != svm->lastPwm2 )
+    {
+        svm->lastPwm2 = svm->dPwm2;
+<#if __PROCESSOR?matches("PIC32M.*") == true>
+        MCHAL_PWMDutySet(MCHAL_PWM_PH_V, svm->dPwm2);
+<#else>
+        MCHAL_PWMDutySet(MCHAL_PWM_PH_V, svm->period - svm->dPwm2);
+</#if>
+    }
+    if( svm->dPwm3 != svm->lastPwm3 )
+    {
+        svm->lastPwm3 = svm->dPwm3;
+<#if __PROCESSOR?matches("PIC32M.*") == true>
+        MCHAL_PWMDutySet(MCHAL_PWM_PH_W, svm->dPwm3);
+<#else>
+        MCHAL_PWMDutySet(MCHAL_PWM_PH_W, svm->period - svm->dPwm3);
+</#if>
+    }
+#else
 <#if __PROCESSOR?matches("PIC32M.*") == true>
     MCHAL_PWMDutySet(MCHAL_PWM_PH_U, svm->dPwm1);
     MCHAL_PWMDutySet(MCHAL_PWM_PH_V, svm->dPwm2);
@@ -243,4 +571,37 @@ void MCPWM_PWMDutyUpdate(tMCPWM_SVPWM_S * const svm)
     MCHAL_PWMDutySet(MCHAL_PWM_PH_V, svm->period - svm->dPwm2);
     MCHAL_PWMDutySet(MCHAL_PWM_PH_W, svm->period - svm->dPwm3);
 </#if>
+#endif
+}
+
+#if (ENABLED == VOLTAGE_RECONSTRUCTION)
+/******************************************************************************/
+/* Function name: MCPWM_VoltageReconstruction                                 */
+/* Function parameters: udc - DC bus voltage sample of this interrupt        */
+/*                      iu, iv - phase current samples of this interrupt      */
+/* Function return: None                                                      */
+/* Description: Stator voltage of the duty cycles the previous interrupt      */
+/*              wrote to the PWM peripheral, less the phase voltage lost      */
+/*              during the dead time and across the switches. The voltage     */
+/*              reference differs from it where the modulator clamps the      */
+/*              duty cycles or the inverter loses voltage. The DC bus is the  */
+/*              mean of the last two samples.                                 */
+/******************************************************************************/
+void MCPWM_VoltageReconstruction( const float udc, const float iu, const float iv )
+{
+    const float invPeriod = 1.0f / gMCPWM_SVPWM.period;
+    float du, dv, dw, ua, ub, uc;
+
+    /* Applied phase duty cycles */
+    MCPWM_CurrentPolarity( iu, iv, &du, &dv, &dw );
+    ua = ( (float)gMCPWM_SVPWM.dPwm1 * invPeriod ) - ( gMCPWM_DeadTimeParam.duty * du );
+    ub = ( (float)gMCPWM_SVPWM.dPwm2 * invPeriod ) - ( gMCPWM_DeadTimeParam.duty * dv );
+    uc = ( (float)gMCPWM_SVPWM.dPwm3 * invPeriod ) - ( gMCPWM_DeadTimeParam.duty * dw );
+
+    /* Clarke transform, the zero sequence cancels and a phase duty cycle of 1/sqrt(3) is 1 */
+    gMCPWM_StatorVoltage.ualpha = TWO_BY_SQRT3 * ( ua - ( 0.5f * ( ub + uc ) ) );
+    gMCPWM_StatorVoltage.ubeta = ub - uc;
+    gMCPWM_StatorVoltage.umax = ( 0.5f * ONE_BY_SQRT3 ) * ( gMCPWM_StatorVoltage.udcLast + udc );
+    gMCPWM_StatorVoltage.udcLast = udc;
 }
+#endif
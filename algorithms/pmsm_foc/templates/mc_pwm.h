@@ -54,6 +54,8 @@
 */
 
 #include <stddef.h>
+#include "math.h"
+#include "mc_derivedparams.h"
 #include "mc_lib.h"
 
 
@@ -87,9 +89,43 @@ typedef struct
     uint32_t dPwm1;
     uint32_t dPwm2;
     uint32_t dPwm3;
+    bool     discontinuous;     /* Discontinuous PWM active, above the minimum modulation index */
+    uint32_t lastPwm1;          /* Duty cycles written to the PWM peripheral                    */
+    uint32_t lastPwm2;
+    uint32_t lastPwm3;
 } tMCPWM_SVPWM_S;
 
+/* Hysteresis of the switch between continuous and discontinuous PWM */
+#define MCPWM_DPWM_HYSTERESIS           (0.05f)
+#define MCPWM_DPWM_ON_SQUARED           ( DPWM_MIN_MODULATION_INDEX * DPWM_MIN_MODULATION_INDEX )
+#define MCPWM_DPWM_OFF_SQUARED          ( ( DPWM_MIN_MODULATION_INDEX - MCPWM_DPWM_HYSTERESIS ) \
+                                        * ( DPWM_MIN_MODULATION_INDEX - MCPWM_DPWM_HYSTERESIS ) )
+
+#if (ENABLED == DEADTIME_COMPENSATION) || (ENABLED == VOLTAGE_RECONSTRUCTION)
+typedef struct
+{
+    float    duty;              /* Phase voltage lost by the inverter, relative to the DC bus   */
+    float    invBand;           /* Inverse of the current band of the zero crossing (1/A)       */
+} tMCPWM_DEADTIME_PARAM_S;
+#endif
+
+#if (ENABLED == VOLTAGE_RECONSTRUCTION)
+typedef struct
+{
+    float    ualpha;            /* Stator voltage applied in the last PWM period, relative to umax */
+    float    ubeta;
+    float    umax;              /* Phase voltage limit of the mean DC bus of the period         */
+    float    udcLast;           /* DC bus voltage at the start of the period                    */
+} tMCPWM_STATOR_VOLTAGE_S;
+#endif
+
 extern tMCPWM_SVPWM_S gMCPWM_SVPWM;
+#if (ENABLED == DEADTIME_COMPENSATION) || (ENABLED == VOLTAGE_RECONSTRUCTION)
+extern tMCPWM_DEADTIME_PARAM_S gMCPWM_DeadTimeParam;
+#endif
+#if (ENABLED == VOLTAGE_RECONSTRUCTION)
+extern tMCPWM_STATOR_VOLTAGE_S gMCPWM_StatorVoltage;
+#endif
 
 // *****************************************************************************
 // *****************************************************************************
@@ -101,8 +137,242 @@ void MCPWM_PWMOutputDisable(void);
 void MCPWM_PWMOutputEnable(void);
 
 void MCPWM_SVPWMGen( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm );
+#if (SVPWM_METHOD == SVPWM_SECTOR_TREE) || defined(MCPWM_SVPWM_ALL_METHODS)
+void MCPWM_SVPWMSectorTree( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm );
+#endif
+#if (SVPWM_METHOD == SVPWM_MIN_MAX) || defined(MCPWM_SVPWM_ALL_METHODS)
+void MCPWM_SVPWMMinMax( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm );
+#endif
+#if (SVPWM_METHOD == SVPWM_DPWM_MIN) || (SVPWM_METHOD == SVPWM_DPWM60) || (SVPWM_METHOD == SVPWM_DPWM30) || defined(MCPWM_SVPWM_ALL_METHODS)
+void MCPWM_SVPWMDpwmMin( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm );
+void MCPWM_SVPWMDpwm60( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm );
+void MCPWM_SVPWMDpwm30( const tMCLIB_CLARK_TRANSFORM_S * const vAlphaBeta, tMCPWM_SVPWM_S * const svm );
+#endif
 void MCPWM_PWMDutyUpdate(tMCPWM_SVPWM_S * const svm);
+#if (ENABLED == VOLTAGE_RECONSTRUCTION)
+void MCPWM_VoltageReconstruction( const float udc, const float iu, const float iv );
+#endif
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+void MCPWM_Overmodulation( float * const vAlpha, float * const vBeta, const float magnitudeSquared );
+#endif
+
+
+/******************************************************************************/
+/* Function name: MCPWM_PhaseVoltages                                         */
+/* Function parameters: vAlpha, vBeta - voltage reference                     */
+/*                      ua, ub, uc - phase voltages                           */
+/* Function return: None                                                      */
+/* Description: Inverse Clarke transform, scaled by 1/sqrt(3) so that a line  */
+/*              voltage of 1 is one PWM period                                */
+/******************************************************************************/
+__STATIC_INLINE void MCPWM_PhaseVoltages( const float vAlpha, const float vBeta, float * const ua,
+                                          float * const ub, float * const uc )
+{
+    *ua = ONE_BY_SQRT3 * vAlpha;
+    *ub = 0.5f * ( vBeta - *ua );
+    *uc = -0.5f * ( vBeta + *ua );
+}
+
+/******************************************************************************/
+/* Function name: MCPWM_OffsetDuty                                            */
+/* Function parameters: ua, ub, uc - phase voltages                           */
+/*                      uRef, level - phase voltage uRef is placed at level   */
+/*                      svm - PWM period, duty outputs                        */
+/* Function return: None                                                      */
+/* Description: Duty cycles of the phase voltages with a zero sequence. The   */
+/*              phase equal to uRef gets exactly level times the period, so   */
+/*              a clamped phase does not switch. Duty cycles are clamped to   */
+/*              the period outside the voltage hexagon.                       */
+/******************************************************************************/
+__STATIC_INLINE void MCPWM_OffsetDuty( const float ua, const float ub, const float uc, const float uRef,
+                                       const float level, tMCPWM_SVPWM_S * const svm )
+{
+    float da, db, dc;
+
+    da = svm->period * ( ( ua - uRef ) + level );
+    db = svm->period * ( ( ub - uRef ) + level );
+    dc = svm->period * ( ( uc - uRef ) + level );
+
+    da = ( da > 0.0f ) ? da : 0.0f;
+    db = ( db > 0.0f ) ? db : 0.0f;
+    dc = ( dc > 0.0f ) ? dc : 0.0f;
+    da = ( da < svm->period ) ? da : svm->period;
+    db = ( db < svm->period ) ? db : svm->period;
+    dc = ( dc < svm->period ) ? dc : svm->period;
+
+    svm->dPwm1 = (uint32_t)da;
+    svm->dPwm2 = (uint32_t)db;
+    svm->dPwm3 = (uint32_t)dc;
+}
+
+/******************************************************************************/
+/* Function name: MCPWM_MinMaxDuty                                            */
+/* Function parameters: vAlpha, vBeta - voltage reference                     */
+/*                      svm - PWM period, duty outputs                        */
+/* Function return: None                                                      */
+/* Description: Duty cycles with min-max zero sequence injection. The         */
+/*              comparisons compile to conditional selects, so the execution  */
+/*              time does not depend on the sector.                           */
+/******************************************************************************/
+__STATIC_INLINE void MCPWM_MinMaxDuty( const float vAlpha, const float vBeta, tMCPWM_SVPWM_S * const svm )
+{
+    float ua, ub, uc, uMax, uMin;
+
+    MCPWM_PhaseVoltages( vAlpha, vBeta, &ua, &ub, &uc );
 
+    uMax = ( ua > ub ) ? ua : ub;
+    uMax = ( uMax > uc ) ? uMax : uc;
+    uMin = ( ua < ub ) ? ua : ub;
+    uMin = ( uMin < uc ) ? uMin : uc;
+
+    /* Centre of the phase voltages in the middle of the PWM period */
+    MCPWM_OffsetDuty( ua, ub, uc, 0.5f * ( uMax + uMin ), 0.5f, svm );
+}
+
+#if (VOLTAGE_LIMIT_METHOD != VOLTAGE_LIMIT_LINEAR)
+/******************************************************************************/
+/* Function name: MCPWM_VoltageLimit                                          */
+/* Function parameters: vAlpha, vBeta - voltage reference, replaced by the    */
+/*                      voltage vector to be modulated                        */
+/* Function return: None                                                      */
+/* Description: Inside the linear range the reference is modulated as it is, */
+/*              above it MCPWM_Overmodulation maps the reference fundamental  */
+/*              to a vector on or inside the voltage hexagon                  */
+/******************************************************************************/
+__STATIC_INLINE void MCPWM_VoltageLimit( float * const vAlpha, float * const vBeta )
+{
+    float magnitudeSquared = ( *vAlpha * *vAlpha ) + ( *vBeta * *vBeta );
+
+    if( magnitudeSquared > 1.0f )
+    {
+        MCPWM_Overmodulation( vAlpha, vBeta, magnitudeSquared );
+    }
+}
+#endif
+
+#if (ENABLED == DEADTIME_COMPENSATION) || (ENABLED == VOLTAGE_RECONSTRUCTION)
+/******************************************************************************/
+/* Function name: MCPWM_CurrentPolarity                                       */
+/* Function parameters: iu, iv - phase currents                               */
+/*                      du, dv, dw - polarity outputs                         */
+/* Function return: None                                                      */
+/* Description: Direction of the phase currents, -1 or 1, and proportional to */
+/*              the current within the current band of a zero crossing, where */
+/*              the current ripple changes the sign within the PWM period     */
+/******************************************************************************/
+__STATIC_INLINE void MCPWM_CurrentPolarity( const float iu, const float iv,
+                                            float * const du, float * const dv, float * const dw )
+{
+    float u, v, w;
+
+    u = iu * gMCPWM_DeadTimeParam.invBand;
+    v = iv * gMCPWM_DeadTimeParam.invBand;
+    w = -u - v;
+    u = ( u < 1.0f ) ? u : 1.0f;
+    v = ( v < 1.0f ) ? v : 1.0f;
+    w = ( w < 1.0f ) ? w : 1.0f;
+    *du = ( u > -1.0f ) ? u : -1.0f;
+    *dv = ( v > -1.0f ) ? v : -1.0f;
+    *dw = ( w > -1.0f ) ? w : -1.0f;
+}
+#endif
+
+#if (ENABLED == DEADTIME_COMPENSATION)
+/******************************************************************************/
+/* Function name: MCPWM_DeadTimeCompensation                                  */
+/* Function parameters: iAlpha, iBeta - measured current                      */
+/*                      vAlpha, vBeta - voltage reference, the compensation   */
+/*                      is added                                              */
+/* Function return: None                                                      */
+/* Description: Adds the phase voltage lost during the dead time and across   */
+/*              the switches in the direction of every phase current. Within  */
+/*              the current band of a zero crossing the compensation is       */
+/*              proportional to the current; the band is about half the peak  */
+/*              to peak current ripple. The result is clipped to the voltage  */
+/*              hexagon.                                                      */
+/******************************************************************************/
+__STATIC_INLINE void MCPWM_DeadTimeCompensation( const float iAlpha, const float iBeta,
+                                                 float * const vAlpha, float * const vBeta )
+{
+    float du, dv, dw, vr1, vr2, vr3, hexagon, scale;
+
+    MCPWM_CurrentPolarity( iAlpha, ( -0.5f * iAlpha ) + ( SQRT3_BY2 * iBeta ), &du, &dv, &dw );
+
+    /* Clarke transform of the phase duty cycles, a phase duty cycle of 1/sqrt(3) is 1 */
+    *vAlpha += ( TWO_BY_SQRT3 * gMCPWM_DeadTimeParam.duty ) * ( du - ( 0.5f * ( dv + dw ) ) );
+    *vBeta += gMCPWM_DeadTimeParam.duty * ( dv - dw );
+
+    /* On the voltage hexagon the largest sector time is one */
+    vr1 = fabsf( *vBeta );
+    vr2 = fabsf( -*vBeta/2 + SQRT3_BY2 * *vAlpha );
+    vr3 = fabsf( -*vBeta/2 - SQRT3_BY2 * *vAlpha );
+    hexagon = ( vr1 > vr2 ) ? vr1 : vr2;
+    hexagon = ( hexagon > vr3 ) ? hexagon : vr3;
+    if( hexagon > 1.0f )
+    {
+        scale = 1.0f / hexagon;
+        *vAlpha = scale * *vAlpha;
+        *vBeta = scale * *vBeta;
+    }
+}
+#endif
+
+#if (SVPWM_METHOD == SVPWM_DPWM_MIN) || (SVPWM_METHOD == SVPWM_DPWM60) || (SVPWM_METHOD == SVPWM_DPWM30) || defined(MCPWM_SVPWM_ALL_METHODS)
+/******************************************************************************/
+/* Function name: MCPWM_DiscontinuousDuty                                     */
+/* Function parameters: vAlpha, vBeta - voltage reference                     */
+/*                      svm - PWM period, duty outputs                        */
+/*                      method - SVPWM_DPWM_MIN, SVPWM_DPWM60, SVPWM_DPWM30   */
+/* Function return: None                                                      */
+/* Description: Duty cycles with one phase clamped to a DC bus rail. Below    */
+/*              DPWM_MIN_MODULATION_INDEX the min-max zero sequence is used.  */
+/*              SVPWM_DPWM_MIN clamps the lowest phase to the negative rail   */
+/*              for 120 degrees. SVPWM_DPWM60 clamps the phase with the       */
+/*              largest magnitude for 60 degrees around its peak, where the   */
+/*              phase current is largest, and SVPWM_DPWM30 clamps every phase */
+/*              for four 30 degree intervals. SVPWM_DPWM60 and SVPWM_DPWM30   */
+/*              also clamp to the positive rail, where the zero vector 111    */
+/*              leaves no time to sample low side shunts.                     */
+/******************************************************************************/
+__STATIC_INLINE void MCPWM_DiscontinuousDuty( const float vAlpha, const float vBeta, tMCPWM_SVPWM_S * const svm,
+                                              const uint32_t method )
+{
+    float ua, ub, uc, uMax, uMin, uRef, level, magnitude;
+    bool clampPositive;
+
+    MCPWM_PhaseVoltages( vAlpha, vBeta, &ua, &ub, &uc );
+
+    uMax = ( ua > ub ) ? ua : ub;
+    uMax = ( uMax > uc ) ? uMax : uc;
+    uMin = ( ua < ub ) ? ua : ub;
+    uMin = ( uMin < uc ) ? uMin : uc;
+
+    /* Modulation index relative to the linear range, with hysteresis */
+    magnitude = vAlpha * vAlpha + vBeta * vBeta;
+    svm->discontinuous = svm->discontinuous ? ( magnitude >= MCPWM_DPWM_OFF_SQUARED )
+                                            : ( magnitude > MCPWM_DPWM_ON_SQUARED );
+
+    if( SVPWM_DPWM60 == method )
+    {
+        clampPositive = ( ( uMax + uMin ) >= 0.0f );
+    }
+    else if( SVPWM_DPWM30 == method )
+    {
+        clampPositive = ( ( uMax + uMin ) < 0.0f );
+    }
+    else
+    {
+        clampPositive = false;
+    }
+
+    uRef = clampPositive ? uMax : uMin;
+    level = clampPositive ? 1.0f : 0.0f;
+    uRef = svm->discontinuous ? uRef : ( 0.5f * ( uMax + uMin ) );
+    level = svm->discontinuous ? level : 0.5f;
+
+    MCPWM_OffsetDuty( ua, ub, uc, uRef, level, svm );
+}
+#endif
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
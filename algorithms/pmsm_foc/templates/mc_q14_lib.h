@@ -0,0 +1,262 @@
+/*******************************************************************************
+ Q2.14 Fixed Point Motor Control Library interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_q14_lib.h
+
+  Summary:
+    Header file for mc_q14_lib.c
+
+  Description:
+    This file contains the data types and function prototypes of the Q2.14
+    fixed point motor control primitives used by the SAM C21 applications
+    (q14_generic_mcLib). The functions keep their library_* names and
+    results. The constants carry a Q14_ prefix so that they do not collide
+    with the floating point constants of mc_derivedparams.h. Changes of
+    q14_generic_mcLib.c are ported by hand, algorithms/q14_mclib/host/
+    q14_mclib_build.py --check fails while the results differ.
+
+    Signals are normalized to Q14_BASE_VALUE (1.0 = 16384). Angles are
+    unsigned 16 bit values, 65536 = 2pi.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_Q14_LIB_H
+#define MC_Q14_LIB_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stdint.h>
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Base value for normalization */
+#define Q14_SH_BASE_VALUE           ( 14U )             /* Q14_BASE_VALUE = 2^Q14_SH_BASE_VALUE */
+#define Q14_BASE_VALUE              ( 16384 )
+
+/* Numerical constants (referred to Q14_BASE_VALUE) */
+#define Q14_ONE_THIRD               (  5461 )           /* 1/3 = 5461.33333 */
+#define Q14_TWO_THIRDS              ( 10923 )           /* 2/3 = 10922.66666 */
+#define Q14_SQRT3                   ( 28378 )           /* sqrt(3) = 28377.92043 */
+#define Q14_SQRT3_BY2               ( 14189 )           /* sqrt(3)/2 = 14188.96022 */
+#define Q14_ONE_BY_SQRT3            (  9459 )           /* 1/sqrt(3) = 9459.30681 */
+#define Q14_TWO_BY_SQRT3            ( 18919 )           /* 2/sqrt(3) = 18918.61362 */
+
+/* Angles */
+#define Q14_PI_FOURTHS              (  8192U )          /* 0x2000  45 degrees */
+#define Q14_PI_HALVES               ( 16384U )          /* 0x4000  90 degrees */
+#define Q14_THREE_PI_FOURTHS        ( 24576U )          /* 0x6000 135 degrees */
+#define Q14_PI                      ( 32768U )          /* 0x8000 180 degrees */
+#define Q14_FIVE_PI_FOURTHS         ( 40960U )          /* 0xA000 225 degrees */
+#define Q14_THREE_PI_HALVES         ( 49152U )          /* 0xC000 270 degrees */
+#define Q14_SEVEN_PI_FOURTHS        ( 57344U )          /* 0xE000 315 degrees */
+
+/* Angle structure */
+typedef struct
+{
+    uint16_t        ang;    /* angle */
+    int16_t         sin;    /* sin(angle) */
+    int16_t         cos;    /* cos(angle) */
+}ang_sincos_t;
+
+/* Vector types */
+typedef struct
+{
+    int16_t         u;      /* first component */
+    int16_t         v;      /* second component */
+    int16_t         w;      /* third component */
+}vec3_t;
+
+typedef struct
+{
+    int16_t         x;      /* first component */
+    int16_t         y;      /* second component */
+}vec2_t;
+
+typedef struct
+{
+    uint16_t        r;      /* amplitude */
+    ang_sincos_t    t;      /* argument */
+}vecp_t;
+
+/* PI controller. Output = ( kp * e + imem ) >> shp, imem += ( ki * e ) >> shi */
+typedef struct
+{
+    int16_t         kp;     /* proportional gain */
+    uint16_t        shp;    /* proportional gain shifts down */
+    int16_t         ki;     /* integral gain */
+    uint16_t        shi;    /* integral gain shifts down */
+    int16_t         hlim;   /* upper clamp value */
+    int16_t         llim;   /* lower clamp value */
+    int32_t         imem;   /* integral term memory */
+}pi_cntrl_t;
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Interface Routines
+// *****************************************************************************
+// *****************************************************************************
+
+/******************************************************************************/
+/* Function name: library_sin                                                 */
+/* Function parameters: ang - angle, 65536 = 2pi                              */
+/* Function return: Q14_BASE_VALUE * sin(ang)                                 */
+/* Description: Sine from a 256 entry quarter wave table                      */
+/******************************************************************************/
+int16_t library_sin( uint16_t ang );
+
+/******************************************************************************/
+/* Function name: library_cos                                                 */
+/* Function parameters: ang - angle, 65536 = 2pi                              */
+/* Function return: Q14_BASE_VALUE * cos(ang)                                 */
+/* Description: Cosine from a 256 entry quarter wave table                    */
+/******************************************************************************/
+int16_t library_cos( uint16_t ang );
+
+/******************************************************************************/
+/* Function name: library_sincos                                              */
+/* Function parameters: t - angle structure                                   */
+/* Function return: None                                                      */
+/* Description: t->sin and t->cos from t->ang                                 */
+/******************************************************************************/
+void library_sincos( ang_sincos_t *t );
+
+/******************************************************************************/
+/* Function name: library_sinarcos                                            */
+/* Function parameters: x - normalized cosine, |x| <= Q14_BASE_VALUE          */
+/* Function return: Q14_BASE_VALUE * sin(acos(x / Q14_BASE_VALUE))            */
+/* Description: Table lookup                                                  */
+/******************************************************************************/
+int16_t library_sinarcos( int16_t x );
+
+/******************************************************************************/
+/* Function name: library_atan2                                               */
+/* Function parameters: x = A * cos(angle), y = A * sin(angle), 0 < A < 2^15  */
+/* Function return: angle, 65536 = 2pi                                        */
+/* Description: Four quadrant arc tangent, one division                       */
+/******************************************************************************/
+uint16_t library_atan2( int16_t x, int16_t y );
+
+/******************************************************************************/
+/* Function name: library_scat                                                */
+/* Function parameters: hypo - hypotenuse, fcat - first cathetus              */
+/* Function return: second cathetus sqrt(hypo^2 - fcat^2)                     */
+/* Description: Zero when |fcat| >= hypo, one division                        */
+/******************************************************************************/
+int16_t library_scat( int16_t hypo, int16_t fcat );
+
+/******************************************************************************/
+/* Function name: library_uvw_ab                                              */
+/* Function parameters: uvw - input, ab - output                              */
+/* Function return: None                                                      */
+/* Description: alpha = (2u - v - w)/3, beta = (v - w)/sqrt(3)                */
+/******************************************************************************/
+void library_uvw_ab( const vec3_t *uvw, vec2_t *ab );
+
+/******************************************************************************/
+/* Function name: library_ab_uvw                                              */
+/* Function parameters: ab - input, uvw - output                              */
+/* Function return: None                                                      */
+/* Description: u = alpha, v = (sqrt(3) beta - alpha)/2, w = -u - v           */
+/******************************************************************************/
+void library_ab_uvw( const vec2_t *ab, vec3_t *uvw );
+
+/******************************************************************************/
+/* Function name: library_ab_dq                                               */
+/* Function parameters: t - angle with sine and cosine, ab - input,           */
+/*                      dq - output                                           */
+/* Function return: None                                                      */
+/* Description: d = alpha cos + beta sin, q = beta cos - alpha sin            */
+/******************************************************************************/
+void library_ab_dq( const ang_sincos_t *t, const vec2_t *ab, vec2_t *dq );
+
+/******************************************************************************/
+/* Function name: library_dq_ab                                               */
+/* Function parameters: t - angle with sine and cosine, dq - input,           */
+/*                      ab - output                                           */
+/* Function return: None                                                      */
+/* Description: alpha = d cos - q sin, beta = d sin + q cos                   */
+/******************************************************************************/
+void library_dq_ab( const ang_sincos_t *t, const vec2_t *dq, vec2_t *ab );
+
+/******************************************************************************/
+/* Function name: library_xy_rt                                               */
+/* Function parameters: xy - input, rt - output                               */
+/* Function return: None                                                      */
+/* Description: Cartesian to polar coordinates                                */
+/******************************************************************************/
+void library_xy_rt( const vec2_t *xy, vecp_t *rt );
+
+/******************************************************************************/
+/* Function name: library_rt_xy                                               */
+/* Function parameters: rt - input, xy - output                               */
+/* Function return: None                                                      */
+/* Description: Polar to cartesian coordinates                                */
+/******************************************************************************/
+void library_rt_xy( const vecp_t *rt, vec2_t *xy );
+
+/******************************************************************************/
+/* Function name: library_pi_control                                          */
+/* Function parameters: erl - error, pi - controller                          */
+/* Function return: controller output, clamped to [llim, hlim]                */
+/* Description: PI control with anti-windup of the integral memory            */
+/******************************************************************************/
+int16_t library_pi_control( int32_t erl, pi_cntrl_t *pi );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif    /* MC_Q14_LIB_H */
+
+/**
+ End of File
+*/
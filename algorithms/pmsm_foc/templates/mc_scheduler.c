@@ -0,0 +1,278 @@
+/*******************************************************************************
+ Multi-rate Task Scheduler source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_scheduler.c
+
+  Summary:
+    Release and dispatch of the slow control tasks
+
+  Description:
+    This file contains the slow task scheduler. Each task of gMCSCH_TaskTable
+    has a countdown which is loaded with its phase offset at initialization
+    and with its period at every release. MCSCH_Tick runs at the end of the
+    control interrupt, counts a release of the tasks whose countdown expired
+    and pends the software interrupt. The software interrupt handler runs the
+    tasks with releases not yet started in table order; tasks do not preempt
+    each other but are preempted by the control interrupt. A task which is
+    released again before it started is counted as overrun and runs once.
+    The release count is only written by MCSCH_Tick and the start count only
+    by MCSCH_Dispatch, so no release is lost when the control interrupt
+    preempts the dispatch.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include "definitions.h"                // SYS function prototypes
+#include "device.h"
+#include "mc_derivedparams.h"
+#include "mc_scheduler.h"
+#include "mc_hal.h"
+#include "mc_placement.h"
+#if defined(__mips__)
+#include <sys/attribs.h>
+#endif
+
+#if (ENABLED == TASK_SCHEDULER)
+/******************************************************************************/
+/* Local Function Prototype                                                   */
+/******************************************************************************/
+__STATIC_INLINE void MCSCH_Record( uint32_t cycles, uint32_t * const pMin, uint32_t * const pMax, uint64_t * const pSum );
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+tMCSCH_DATA_S       gMCSCH_Data;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+/******************************************************************************/
+/* Function name: MCSCH_Record                                                */
+/* Function parameters: cycles, pMin, pMax, pSum - statistics to update       */
+/* Function return: None                                                      */
+/* Description: Updates minimum, maximum and sum of a measurement             */
+/******************************************************************************/
+__STATIC_INLINE void MCSCH_Record( uint32_t cycles, uint32_t * const pMin, uint32_t * const pMax, uint64_t * const pSum )
+{
+    cycles = ( cycles > gMCSCH_Data.overheadCycles ) ? ( cycles - gMCSCH_Data.overheadCycles ) : 0U;
+
+    *pSum += cycles;
+    if( cycles < *pMin )
+    {
+        *pMin = cycles;
+    }
+    if( cycles > *pMax )
+    {
+        *pMax = cycles;
+    }
+}
+
+/******************************************************************************/
+/* Function name: MCHAL_SW_IRQ_HANDLER                                        */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Software interrupt handler                                    */
+/******************************************************************************/
+MCHAL_SW_IRQ_HANDLER()
+{
+    MCHAL_SwIrqAcknowledge();
+    MCSCH_Dispatch();
+}
+#endif
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCSCH_Initialize                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Starts the cycle counter, loads the phase offsets, clears the */
+/*              statistics and enables the software interrupt                 */
+/******************************************************************************/
+void MCSCH_Initialize( void )
+{
+#if (ENABLED == TASK_SCHEDULER)
+    uint32_t start, cycles, i, task;
+
+    MCHAL_CycleCounterStart();
+    gMCSCH_Data.clockHz = MCHAL_CYCLE_COUNTER_CLOCK_HZ;
+
+    /* Back to back counter reads */
+    gMCSCH_Data.overheadCycles = UINT32_MAX;
+    for( i = 0U; i < 16U; i++ )
+    {
+        start = MCHAL_CycleCounterGet();
+        cycles = MCHAL_CycleCounterGet() - start;
+        if( cycles < gMCSCH_Data.overheadCycles )
+        {
+            gMCSCH_Data.overheadCycles = cycles;
+        }
+    }
+
+    for( task = 0U; task < (uint32_t)MCSCH_TASKS; task++ )
+    {
+        gMCSCH_Data.task[task].countdown = gMCSCH_TaskTable[task].phaseTicks;
+        gMCSCH_Data.task[task].releaseCount = 0U;
+        gMCSCH_Data.task[task].startCount = 0U;
+    }
+    MCSCH_Reset();
+
+    MCHAL_SwIrqInitialize();
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCSCH_Reset                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clears the statistics of all tasks                            */
+/******************************************************************************/
+void MCSCH_Reset( void )
+{
+#if (ENABLED == TASK_SCHEDULER)
+    uint32_t task;
+    tMCSCH_TASK_STATE_S * pTask;
+
+    for( task = 0U; task < (uint32_t)MCSCH_TASKS; task++ )
+    {
+        pTask = &gMCSCH_Data.task[task];
+        pTask->releases = 0U;
+        pTask->runs = 0U;
+        pTask->overruns = 0U;
+        pTask->minLatencyCycles = UINT32_MAX;
+        pTask->maxLatencyCycles = 0U;
+        pTask->sumLatencyCycles = 0U;
+        pTask->minExecCycles = UINT32_MAX;
+        pTask->maxExecCycles = 0U;
+        pTask->sumExecCycles = 0U;
+    }
+    gMCSCH_Data.resetRequest = 0U;
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCSCH_Tick                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Releases the tasks due in this PWM period and pends the       */
+/*              software interrupt                                            */
+/******************************************************************************/
+void MCSCH_Tick( void )
+{
+#if (ENABLED == TASK_SCHEDULER)
+    tMCSCH_TASK_STATE_S * pTask;
+    uint32_t task, now = MCHAL_CycleCounterGet();
+    bool released = false;
+
+    for( task = 0U; task < (uint32_t)MCSCH_TASKS; task++ )
+    {
+        pTask = &gMCSCH_Data.task[task];
+        if( 0U == pTask->countdown )
+        {
+            pTask->countdown = gMCSCH_TaskTable[task].periodTicks - 1U;
+            if( pTask->releaseCount != pTask->startCount )
+            {
+                pTask->overruns++;
+            }
+            pTask->releaseCycles = now;
+            pTask->releaseCount++;
+            pTask->releases++;
+            released = true;
+        }
+        else
+        {
+            pTask->countdown--;
+        }
+    }
+
+    if( released )
+    {
+        MCHAL_SwIrqPend();
+    }
+#endif
+}
+
+/******************************************************************************/
+/* Function name: MCSCH_Dispatch                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Runs the pending tasks in order of priority and records their */
+/*              start latency and execution time                              */
+/******************************************************************************/
+void MCSCH_Dispatch( void )
+{
+#if (ENABLED == TASK_SCHEDULER)
+    tMCSCH_TASK_STATE_S * pTask;
+    uint32_t task, start, releaseCount, releaseCycles;
+
+    if( 0U != gMCSCH_Data.resetRequest )
+    {
+        MCSCH_Reset();
+    }
+
+    for( task = 0U; task < (uint32_t)MCSCH_TASKS; task++ )
+    {
+        pTask = &gMCSCH_Data.task[task];
+        /* Release time of the counted release, read again if the control interrupt released in between */
+        do
+        {
+            releaseCount = pTask->releaseCount;
+            releaseCycles = pTask->releaseCycles;
+        } while( releaseCount != pTask->releaseCount );
+
+        if( releaseCount == pTask->startCount )
+        {
+            continue;
+        }
+
+        start = MCHAL_CycleCounterGet();
+        pTask->startCount = releaseCount;
+        MCSCH_Record( start - releaseCycles, &pTask->minLatencyCycles, &pTask->maxLatencyCycles,
+                      &pTask->sumLatencyCycles );
+
+        gMCSCH_TaskTable[task].handler();
+
+        MCSCH_Record( MCHAL_CycleCounterGet() - start, &pTask->minExecCycles, &pTask->maxExecCycles,
+                      &pTask->sumExecCycles );
+        pTask->runs++;
+    }
+#endif
+}
+
+/*******************************************************************************
+ End of File
+*/
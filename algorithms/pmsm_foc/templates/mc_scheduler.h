@@ -0,0 +1,178 @@
+/*******************************************************************************
+ Multi-rate Task Scheduler interface file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    mc_scheduler.h
+
+  Summary:
+    Header file for the slow task scheduler
+
+  Description:
+    This file contains the data structures and function prototypes of the
+    multi-rate task scheduler. When TASK_SCHEDULER is enabled the slow tasks
+    are described by a table of period and phase offset in PWM periods and a
+    handler. MCSCH_Tick is called at the end of every control interrupt and
+    releases the tasks which are due, the released tasks are executed by
+    MCSCH_Dispatch from the lowest priority software interrupt (PendSV on
+    Cortex-M, core software interrupt 0 on PIC32). The speed and position
+    loops therefore start at a fixed latency after the control interrupt,
+    independent of the main loop. The start latency and the execution time of
+    every task are kept in gMCSCH_Data.
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+#ifndef MC_SCHEDULER_H
+#define MC_SCHEDULER_H
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+
+#include <stddef.h>
+#include "definitions.h"
+#include "mc_derivedparams.h"
+#include "mc_hal.h"
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+extern "C" {
+
+#endif
+
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+
+/* Slow tasks in order of priority. The table is defined in mc_pmsm_foc.c */
+typedef enum
+{
+    MCSCH_SPEED_LOOP,
+    MCSCH_BUTTON_POLLING,
+    MCSCH_POSITION_LOOP,
+    MCSCH_TASKS
+}tMCSCH_TASK_E;
+
+typedef void ( *tMCSCH_HANDLER_F )( void );
+
+typedef struct
+{
+    uint32_t            periodTicks;        /* Period in PWM periods                              */
+    uint32_t            phaseTicks;         /* First release after this many PWM periods          */
+    tMCSCH_HANDLER_F    handler;
+}tMCSCH_TASK_PARAM_S;
+
+typedef struct
+{
+    uint32_t            countdown;          /* PWM periods until the next release                 */
+    volatile uint32_t   releaseCount;       /* Releases, written by MCSCH_Tick only               */
+    uint32_t            startCount;         /* Releases started, written by MCSCH_Dispatch only   */
+    volatile uint32_t   releaseCycles;      /* Cycle counter at the release                       */
+    uint32_t            releases;
+    uint32_t            runs;
+    uint32_t            overruns;           /* Releases while the previous one was still pending  */
+    uint32_t            minLatencyCycles;   /* Start latency after the release                    */
+    uint32_t            maxLatencyCycles;
+    uint64_t            sumLatencyCycles;
+    uint32_t            minExecCycles;      /* Execution time of the handler                      */
+    uint32_t            maxExecCycles;
+    uint64_t            sumExecCycles;
+}tMCSCH_TASK_STATE_S;
+
+typedef struct
+{
+    tMCSCH_TASK_STATE_S task[MCSCH_TASKS];
+    uint32_t            clockHz;            /* Cycle counter frequency                            */
+    uint32_t            overheadCycles;     /* Cost of one cycle counter read, subtracted         */
+    volatile uint32_t   resetRequest;       /* Set from the debugger to restart statistics        */
+}tMCSCH_DATA_S;
+
+/******************************************************************************/
+/*                       INTERFACE VARIABLES                                  */
+/******************************************************************************/
+#if (ENABLED == TASK_SCHEDULER)
+extern const tMCSCH_TASK_PARAM_S gMCSCH_TaskTable[MCSCH_TASKS];
+extern tMCSCH_DATA_S gMCSCH_Data;
+#endif
+
+/******************************************************************************/
+/*                       INTERFACE FUNCTIONS                                  */
+/******************************************************************************/
+
+/******************************************************************************/
+/* Function name: MCSCH_Initialize                                            */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Loads the phase offsets, clears the statistics and enables   */
+/*              the software interrupt at the lowest priority                 */
+/******************************************************************************/
+void MCSCH_Initialize( void );
+
+/******************************************************************************/
+/* Function name: MCSCH_Reset                                                 */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Clears the statistics of all tasks                            */
+/******************************************************************************/
+void MCSCH_Reset( void );
+
+/******************************************************************************/
+/* Function name: MCSCH_Tick                                                  */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Releases the tasks due in this PWM period and pends the       */
+/*              software interrupt. Called from the control interrupt.        */
+/******************************************************************************/
+void MCSCH_Tick( void );
+
+/******************************************************************************/
+/* Function name: MCSCH_Dispatch                                              */
+/* Function parameters: None                                                  */
+/* Function return: None                                                      */
+/* Description: Runs the released tasks in order of priority. Called from the */
+/*              software interrupt handler.                                   */
+/******************************************************************************/
+void MCSCH_Dispatch( void );
+
+// DOM-IGNORE-BEGIN
+#ifdef __cplusplus  // Provide C++ Compatibility
+
+}
+
+#endif
+// DOM-IGNORE-END
+
+#endif    /* MC_SCHEDULER_H */
@@ -100,6 +100,13 @@ void  MCSPE_InitializeSpeedControl(void)
     gMCSPE_Parameters.filterParam    =   KFILTER_POT;
     <#if MCPMSMFOC_POSITION_FB == "SENSORED_ENCODER">
     gMCSPE_Parameters.minSpeed       =   0;
+    <#elseif MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#if (ENABLED == HF_INJECTION)
+    /* The injection estimate holds down to standstill */
+    gMCSPE_Parameters.minSpeed       =   0;
+#else
+    gMCSPE_Parameters.minSpeed       =   OPEN_LOOP_END_SPEED_RADS_PER_SEC_ELEC ;
+#endif
     <#else>
     gMCSPE_Parameters.minSpeed       =   OPEN_LOOP_END_SPEED_RADS_PER_SEC_ELEC ;
     </#if>
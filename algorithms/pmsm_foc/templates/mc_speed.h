@@ -95,6 +95,7 @@ typedef struct
 /******************************************************************************/
 /*                       INTERFACE VARIABLES                                  */
 /******************************************************************************/
+extern tMCSPE_INPUT_SIGNAL_S  gMCSPE_InputSignals;
 extern tMCSPE_OUTPUT_SIGNAL_S gMCSPE_OutputSignals;
 
 
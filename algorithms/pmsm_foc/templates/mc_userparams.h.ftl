@@ -60,6 +60,8 @@
 </#if>
 #define TORQUE_MODE                      (${MCPMSMFOC_TORQUE_MODE?then('ENABLED','DISABLED')})  /* If enabled - torque control */
 #define FIELD_WEAKENING                  (${MCPMSMFOC_FIELD_WEAKENING?then('ENABLED','DISABLED')})  /* If enabled - Field weakening */
+#define FIELD_WEAKENING_METHOD           (${MCPMSMFOC_FW_METHOD})  /* Feed-forward, voltage loop or map with voltage loop */
+#define MTPA_CONTROL                     (${MCPMSMFOC_MTPA?then('ENABLED','DISABLED')})  /* If enabled - Maximum torque per ampere d-axis current */
 #define ALIGNMENT_METHOD                 (${MCPMSMFOC_ALIGNMENT_METHOD})  /* alignment method  */
 
 <#if MCPMSMFOC_ALIGNMENT == "0">
@@ -70,8 +72,31 @@
 <#if MCPMSMFOC_POSITION_FB != "SENSORED_ENCODER">
 #define ANGLE_OFFSET_DEG                 (float)45.0    /* Angle offset while switching to closed loop */
 </#if>
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#define PLL_SPEED_SCHEDULING             (${MCPMSMFOC_PLL_SPEED_SCHEDULING?then('ENABLED','DISABLED')})  /* If enabled - PLL filters scaled with speed, angle lag compensated */
+#define HF_INJECTION                     (${MCPMSMFOC_HF_INJECTION?then('ENABLED','DISABLED')})  /* If enabled - angle from high frequency injection below the back EMF handoff speed, no open loop startup */
+</#if>
 
 #define CURRENT_MEASUREMENT              (${MCPMSMFOC_CURRENT_MEAS})  /* Current measurement shunts */
+#define SINCOS_METHOD                    (${MCPMSMFOC_SINCOS})  /* Sine and cosine calculation */
+#define SVPWM_METHOD                     (${MCPMSMFOC_SVPWM})  /* Space vector modulation */
+#define DPWM_MIN_MODULATION_INDEX        (${MCPMSMFOC_DPWM_MIN_MI}f)  /* Continuous modulation below, relative to the linear range */
+#define VOLTAGE_LIMIT_METHOD             (${MCPMSMFOC_VOLTAGE_LIMIT})  /* Linear range, overmodulation or six-step */
+#define DEADTIME_COMPENSATION            (${MCPMSMFOC_DEADTIME_COMP?then('ENABLED','DISABLED')})  /* If enabled - phase voltage of the dead time and switch drop added by current polarity */
+#define VOLTAGE_RECONSTRUCTION           (${MCPMSMFOC_VOLTAGE_RECONSTRUCTION?then('ENABLED','DISABLED')})  /* If enabled - estimator voltage reconstructed from the applied duty cycles */
+
+#define FUSED_FOC_KERNEL                 (${MCPMSMFOC_FUSED_KERNEL?then('ENABLED','DISABLED')})  /* If enabled - current control in one pass by MCFOC_CurrentLoopKernel */
+#define ARITHMETIC                       (${MCPMSMFOC_ARITHMETIC})  /* Floating point or Q2.14 fixed point control */
+#define HOT_PATH_PLACEMENT               (${MCPMSMFOC_PLACEMENT})  /* Memory of the control interrupt code and data, see mc_placement.h */
+
+#define ISR_PROFILER                     (${MCPMSMFOC_ISR_PROFILER?then('ENABLED','DISABLED')})  /* If enabled - control interrupt stage timing */
+<#if MCPMSMFOC_ISR_PROFILER == true>
+#define ISR_PROFILER_BIN_SHIFT           (${MCPMSMFOC_ISR_PROFILER_BIN_SHIFT}U)  /* Histogram bin width is 2^n counter ticks */
+</#if>
+#define TASK_SCHEDULER                   (${MCPMSMFOC_TASK_SCHEDULER?then('ENABLED','DISABLED')})  /* If enabled - slow tasks dispatched from the software interrupt */
+#define PARAMETER_CHANNEL                (${MCPMSMFOC_PARAMETER_CHANNEL?then('ENABLED','DISABLED')})  /* If enabled - double buffered run time parameter updates, see mc_parameters.h */
+#define MOTOR_IDENTIFICATION             (${MCPMSMFOC_MOTOR_IDENTIFICATION?then('ENABLED','DISABLED')})  /* If enabled - motor parameter identification by PMSM_FOC_MotorIdentify, see mc_identification.h */
+#define LOAD_TORQUE_OBSERVER             (${MCPMSMFOC_LOAD_OBSERVER?then('ENABLED','DISABLED')})  /* If enabled - load torque observer with q-axis current feed-forward in the speed loop */
 
 <#if MCPMSMFOC_SPEED_REF_INPUT == "Potentiometer Analog Input">
 #define POTENTIOMETER_INPUT_ENABLED       ENABLED
@@ -84,11 +109,13 @@
 /***********************************************************************************************/
 #define MOTOR_PER_PHASE_RESISTANCE                          ((float)${MCPMSMFOC_R})
 #define MOTOR_PER_PHASE_INDUCTANCE                          ((float)${MCPMSMFOC_LD})
+#define MOTOR_Q_AXIS_INDUCTANCE                             ((float)${MCPMSMFOC_LQ})
 #define MOTOR_BEMF_CONST_V_PEAK_LL_KRPM_MECH                ((float)${MCPMSMFOC_BEMF_CONST})
 #define NUM_POLE_PAIRS                                      ((float)${MCPMSMFOC_POLE_PAIRS})
 #define RATED_SPEED_RPM                                     ((float)${MCPMSMFOC_RATED_SPEED})
 #define MAX_SPEED_RPM                                       ((float)${MCPMSMFOC_MAX_SPEED})
 #define MAX_MOTOR_CURRENT                                   ((float)${MCPMSMFOC_MAX_MOTOR_CURRENT})
+#define MOTOR_INERTIA                                       ((float)${MCPMSMFOC_INERTIA})
 #define MOTOR_CONNECTION                                    (${MCPMSMFOC_MOTOR_CONNECTION})
 <#if MCPMSMFOC_POSITION_FB == "SENSORED_ENCODER">
 #define ENCODER_PULSES_PER_REV                              ((float)${MCPMSMFOC_QE_PULSES_PER_REV})
@@ -116,11 +143,24 @@
 /* Field weakening - Limit for -ve Idref */
 #if(FIELD_WEAKENING == ENABLED)
 #define MAX_FW_NEGATIVE_ID_REF              (float)(${MCPMSMFOC_MAX_FW_CURRENT})
+
+/* Field weakening voltage loop - reference of the voltage magnitude relative to MAX_STATOR_VOLT, and
+   the PI gains in A per unit of the voltage relative to umax */
+#define FW_VOLTAGE_MARGIN                   (float)(${MCPMSMFOC_FW_VOLTAGE_MARGIN})
+#define FW_VOLTAGE_LOOP_PTERM               (float)(${MCPMSMFOC_FW_KP})
+#define FW_VOLTAGE_LOOP_ITERM               (float)(${MCPMSMFOC_FW_KI})
 #endif
 
 /******************************************************************************/
 /* PI controllers tuning values - */
 
+/* Current and speed loop bandwidths (rad/s) of the gains calculated from identified motor parameters */
+#define     CURRENT_LOOP_BANDWIDTH     (float)(${MCPMSMFOC_CL_BANDWIDTH})
+#define     SPEED_LOOP_BANDWIDTH       (float)(${MCPMSMFOC_SPEED_BANDWIDTH})
+
+/* Load torque observer bandwidth (rad/s) */
+#define     LOAD_OBSERVER_BANDWIDTH    (float)(${MCPMSMFOC_LOAD_OBSERVER_BANDWIDTH})
+
 /********* D Control Loop Coefficients ****************************************/
 #define     D_CURRCNTR_PTERM           (float)(${MCPMSMFOC_ID_KP})
 #define     D_CURRCNTR_ITERM           (float)(${MCPMSMFOC_ID_KI})
@@ -146,6 +186,29 @@
 #define KFILTER_VELESTIM               (float)((float)174/(float)32767)
 #define KFILTER_POT                    (float)((float)250/(float)32767)
 
+<#if MCPMSMFOC_POSITION_FB == "SENSORLESS_PLL">
+#if(PLL_SPEED_SCHEDULING == ENABLED)
+/* Speed scheduled PLL filters: corner frequency relative to the estimated electrical speed above the
+   corner frequency of KFILTER_ESDQ and KFILTER_VELESTIM */
+#define PLL_ESDQ_BANDWIDTH_RATIO       (float)(${MCPMSMFOC_PLL_ESDQ_BANDWIDTH_RATIO})
+#define PLL_VELESTIM_BANDWIDTH_RATIO   (float)(${MCPMSMFOC_PLL_VELESTIM_BANDWIDTH_RATIO})
+/* Estimation delay compensated in the estimated angle (PWM periods): the back EMF is the mean over the
+   previous period and the angle is integrated one period ahead, it lags the rotor angle at the end of
+   the period by half a period */
+#define PLL_ANGLE_LAG_PERIODS          (float)(0.5)
+#endif
+
+#if(HF_INJECTION == ENABLED)
+/* High frequency injection: pulsating voltage on the estimated d-axis, whose q-axis current response is
+   proportional to the angle error for Lq > Ld. The back EMF estimate takes over between half the handoff
+   speed and the handoff speed */
+#define HFI_VOLTAGE                    (float)(${MCPMSMFOC_HFI_VOLTAGE})
+#define HFI_SAMPLES                    (${MCPMSMFOC_HFI_PERIODS}U)
+#define HFI_BANDWIDTH                  (float)(${MCPMSMFOC_HFI_BANDWIDTH})
+#define HFI_HANDOFF_SPEED_RPM          (float)(${MCPMSMFOC_HFI_HANDOFF_SPEED})
+#endif
+</#if>
+
 /***********************************************************************************************/
 /* Driver board configuration Parameters */
 /***********************************************************************************************/
@@ -159,6 +222,11 @@
 
 #define STATOR_VOLTAGE_LIMIT                                (float)(0.98)   /* In percentage */
 
+#if(DEADTIME_COMPENSATION == ENABLED) || (VOLTAGE_RECONSTRUCTION == ENABLED)
+#define SWITCH_VOLTAGE_DROP                                 (float)${MCPMSMFOC_SWITCH_DROP}     /* Volts, on state drop of a switch or diode */
+#define DEADTIME_COMP_CURRENT_BAND                          (float)${MCPMSMFOC_DEADTIME_COMP_BAND}     /* Amps, linear compensation around the current zero crossing */
+#endif
+
 /***********************************************************************************************/
 /* Peripheral Configuration parameters */
 /***********************************************************************************************/
@@ -166,6 +234,9 @@
 /** PWM frequency in Hz */
 #define PWM_FREQUENCY                     (${MCPMSMFOC_PWM_FREQ}U)
 
+/** PWM dead time in seconds */
+#define PWM_DEAD_TIME_SEC                 ((float)${MCPMSMFOC_PWM_DEAD_TIME} * 1.0e-6f)
+
 /**********************************************************************************************/
 
 /***********************************************************************************************/
@@ -52,6 +52,7 @@
 #include "math.h"
 #include "mc_hal.h"
 #include "assert.h"
+#include "mc_placement.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -52,6 +52,7 @@
 #include "mc_hal.h"
 #include "math.h"
 #include "assert.h"
+#include "mc_placement.h"
 
 // *****************************************************************************
 // *****************************************************************************
@@ -51,9 +51,21 @@
 #include "mc_rotorposition.h"
 #include "mc_lib.h"
 #include "mc_voltagemeasurement.h"
+#include "mc_pwm.h"
 #include "mc_generic_lib.h"
+#include "mc_parameters.h"
+#include "mc_identification.h"
 #include "math.h"
 #include "assert.h"
+#include "mc_placement.h"
+
+#if (ENABLED == HF_INJECTION)
+#if (ENABLED == FUSED_FOC_KERNEL)
+#error "The high frequency injection voltage is added in the current control of MCCTRL_MotorControl, disable FUSED_FOC_KERNEL"
+#elif (ENABLED == OPEN_LOOP_FUNCTIONING)
+#error "The high frequency injection starts the motor in closed loop, disable OPEN_LOOP_FUNCTIONING"
+#endif
+#endif
 
 // *****************************************************************************
 // *****************************************************************************
@@ -69,6 +81,10 @@ __STATIC_INLINE void MCRPOS_ReadInputSignals( void );
 static void MCRPOS_ResetPLLEstimator( void );
 static void MCRPOS_InitializePLLEstimator ( void );
 __STATIC_INLINE void MCRPOS_PLLEstimator( void );
+#if (ENABLED == HF_INJECTION)
+static void MCRPOS_InitializeHfiEstimator( void );
+__STATIC_INLINE void MCRPOS_HfiEstimator( void );
+#endif
 
 /******************************************************************************/
 /*                   Global Variables                                         */
@@ -83,6 +99,11 @@ tMCRPOS_ROTOR_ALIGN_PARAM_S       gMCRPOS_RotorAlignParam  = {
                                                                   Q_CURRENT_REF_OPENLOOP,
                                                                   LOCK_COUNT_FOR_LOCK_TIME
                                                              };
+#if (ENABLED == HF_INJECTION)
+tMCRPOS_HFI_PARAMETERS_S          gMCRPOS_HfiParameters = { 0.0f };
+tMCRPOS_HFI_STATE_S               gMCRPOS_HfiState = { false };
+tMCRPOS_HFI_OUTPUT_S              gMCRPOS_HfiOutput = { 0.0f };
+#endif
 
 /******************************************************************************/
 /*                          LOCAL FUNCTIONS                                   */
@@ -99,9 +120,16 @@ __STATIC_INLINE void MCRPOS_ReadInputSignals( void )
     /* Initialize input pointers  */
     gMCRPOS_InputSignals.ialpha =  gMCLIB_CurrentAlphaBeta.alphaAxis;
     gMCRPOS_InputSignals.ibeta  =  gMCLIB_CurrentAlphaBeta.betaAxis;
+#if (ENABLED == VOLTAGE_RECONSTRUCTION)
+    /* Stator voltage reconstructed from the applied duty cycles */
+    gMCRPOS_InputSignals.ualpha =  gMCPWM_StatorVoltage.ualpha;
+    gMCRPOS_InputSignals.ubeta  =  gMCPWM_StatorVoltage.ubeta;
+    gMCRPOS_InputSignals.umax   =  gMCPWM_StatorVoltage.umax;
+#else
     gMCRPOS_InputSignals.ualpha =  gMCLIB_VoltageAlphaBeta.alphaAxis;
     gMCRPOS_InputSignals.ubeta  =  gMCLIB_VoltageAlphaBeta.betaAxis;
     gMCRPOS_InputSignals.umax   =  gMCVOL_OutputSignals.umax;
+#endif
 }
 
 /******************************************************************************/
@@ -114,23 +142,36 @@ __STATIC_INLINE void MCRPOS_ReadInputSignals( void )
 static void MCRPOS_InitializePLLEstimator( void )
 {
     /*  Observer state and parameters initialization */
-    gMCRPOS_Parameters.lsDt = (float)(MOTOR_PER_PHASE_INDUCTANCE / FAST_LOOP_TIME_SEC);
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    /* Identified or configured motor parameters */
+    gMCRPOS_Parameters.lsDt = gMCID_MotorParam.lq / FAST_LOOP_TIME_SEC;
+    gMCRPOS_Parameters.rs = gMCID_MotorParam.rs;
+    gMCRPOS_Parameters.invKFi = 1.0f / gMCID_MotorParam.ke;
+#else
+    /* Extended back EMF with the q-axis inductance, whose angle is the rotor angle also for
+       salient motors with d-axis current */
+    gMCRPOS_Parameters.lsDt = (float)(MOTOR_Q_AXIS_INDUCTANCE / FAST_LOOP_TIME_SEC);
     gMCRPOS_Parameters.rs = MOTOR_PER_PHASE_RESISTANCE;
     gMCRPOS_Parameters.invKFi = (float)(1.0 / MOTOR_BEMF_CONST_V_PEAK_PHASE_RAD_PER_SEC_ELEC);
+#endif
+    gMCRPOS_Parameters.rsLsDt = gMCRPOS_Parameters.rs + gMCRPOS_Parameters.lsDt;
     gMCRPOS_Parameters.kFilterEsdq = KFILTER_ESDQ;
     gMCRPOS_Parameters.kFilterBEMFAmp = KFILTER_BEMF_AMPLITUDE;
     gMCRPOS_Parameters.velEstimFilterK = KFILTER_VELESTIM;
     gMCRPOS_Parameters.deltaT = FAST_LOOP_TIME_SEC;
     gMCRPOS_Parameters.decimateRotorSpeed = DECIMATE_RATED_SPEED;
+  #if(ENABLED == PLL_SPEED_SCHEDULING )
+    gMCRPOS_Parameters.kFilterEsdqPerSpeed = PLL_ESDQ_BANDWIDTH_RATIO * FAST_LOOP_TIME_SEC;
+    gMCRPOS_Parameters.velEstimFilterKPerSpeed = PLL_VELESTIM_BANDWIDTH_RATIO * FAST_LOOP_TIME_SEC;
+    gMCRPOS_Parameters.angleLagTime = PLL_ANGLE_LAG_PERIODS * FAST_LOOP_TIME_SEC;
+  #endif
 
     /* Reset state variables */
     gMCRPOS_StateSignals.omegaMr = 0;
     gMCRPOS_StateSignals.bemfFilt = 0;
     gMCRPOS_StateSignals.velEstim = 0;
-    gMCRPOS_StateSignals.ialphaLast = 0;
-    gMCRPOS_StateSignals.ibetaLast = 0;
-    gMCRPOS_StateSignals.ualphaLast = 0;
-    gMCRPOS_StateSignals.ubetaLast = 0;
+    gMCRPOS_StateSignals.esaHistory = 0;
+    gMCRPOS_StateSignals.esbHistory = 0;
     gMCRPOS_StateSignals.esdf = 0;
     gMCRPOS_StateSignals.esqf = 0;
     gMCRPOS_StateSignals.rho = 0;
@@ -146,33 +187,24 @@ static void MCRPOS_InitializePLLEstimator( void )
 /******************************************************************************/
 __STATIC_INLINE void MCRPOS_PLLEstimator( void )
 {
-    float tempqVelEstim;
     tMCLIB_POSITION_S position;
-  #if(FIELD_WEAKENING == ENABLED)
+    float speedSignSource;
+    float speedSign;
+    float kFilterEsdq = gMCRPOS_Parameters.kFilterEsdq;
+    float velEstimFilterK = gMCRPOS_Parameters.velEstimFilterK;
+  #if (ENABLED == FIELD_WEAKENING ) && (FIELD_WEAKENING_METHOD == FW_FEED_FORWARD)
       float bemfAmp;
   #endif
 
-    if( gMCRPOS_StateSignals.velEstim < 0 )
-    {
-        tempqVelEstim = gMCRPOS_StateSignals.velEstim * (-1);
-    }
-    else
-    {
-        tempqVelEstim = gMCRPOS_StateSignals.velEstim;
-    }
-
-    /* Stator voltage equations along alpha axis : Ealpha = Ualpha - Rs ialpha - Ls dialpha/dt    */
-
-    gMCRPOS_StateSignals.esa    =     ( gMCRPOS_StateSignals.ualphaLast )
-                                -   ( gMCRPOS_Parameters.rs  * gMCRPOS_InputSignals.ialpha )
-                                -   ( gMCRPOS_Parameters.lsDt  * ( gMCRPOS_InputSignals.ialpha - gMCRPOS_StateSignals.ialphaLast ) );
+    /* Stator voltage equations : Es = U(k-1) - Rs i(k) - Ls/Ts ( i(k) - i(k-1) )
+       The terms of the previous cycle are summed up in esaHistory and esbHistory */
+    gMCRPOS_StateSignals.esa    =   gMCRPOS_StateSignals.esaHistory
+                                -   ( gMCRPOS_Parameters.rsLsDt * gMCRPOS_InputSignals.ialpha );
 
-    /*  Stator voltage equations along beta axis :  Ebeta = Ubeta - Rs ibeta - Ls dibeta/dt      */
-    gMCRPOS_StateSignals.esb        =     ( gMCRPOS_StateSignals.ubetaLast )
-                                  -   ( gMCRPOS_Parameters.rs  * gMCRPOS_InputSignals.ibeta )
-                                  -   ( gMCRPOS_Parameters.lsDt* ( gMCRPOS_InputSignals.ibeta - gMCRPOS_StateSignals.ibetaLast ) );
+    gMCRPOS_StateSignals.esb    =   gMCRPOS_StateSignals.esbHistory
+                                -   ( gMCRPOS_Parameters.rsLsDt * gMCRPOS_InputSignals.ibeta );
 
-  #if (ENABLED == FIELD_WEAKENING )
+  #if (ENABLED == FIELD_WEAKENING ) && (FIELD_WEAKENING_METHOD == FW_FEED_FORWARD)
     /* In field weakening BEMF amplitude is estimated to calculate Id_ref */
     bemfAmp = sqrtf((gMCRPOS_StateSignals.esa * gMCRPOS_StateSignals.esa) + (gMCRPOS_StateSignals.esb * gMCRPOS_StateSignals.esb));
 
@@ -184,13 +216,31 @@ __STATIC_INLINE void MCRPOS_PLLEstimator( void )
 
   #endif
 
-    /* Calculate Sin(Angle) and Cos(Angle) */
+  #if(ENABLED == PLL_SPEED_SCHEDULING )
+    /* Filter corner frequencies proportional to the estimated speed, so that the filters attenuate the
+       harmonics of the back EMF alike at all speeds and lag less at high speed. The fixed coefficients
+       are the lower limits at low speed */
+    kFilterEsdq = fmaxf( kFilterEsdq, fabsf( gMCRPOS_StateSignals.velEstim ) * gMCRPOS_Parameters.kFilterEsdqPerSpeed );
+    velEstimFilterK = fmaxf( velEstimFilterK, fabsf( gMCRPOS_StateSignals.velEstim ) * gMCRPOS_Parameters.velEstimFilterKPerSpeed );
+  #endif
+
+    /* Estimated angle */
     position.angle     =    gMCRPOS_StateSignals.rho + gMCRPOS_StateSignals.rhoOffset;
 
     MCLIB_WrapAngle( &position.angle);
 
-    /* Determine sin and cos values of the angle from the lookup table. */
-    MCLIB_SinCosCalc(position.angle, &position.sineAngle, &position.cosAngle);
+    /* In closed loop the estimated angle is the control angle of the previous cycle, whose sine
+       and cosine are still in gMCLIB_Position. Otherwise, and with the lag compensation of the output
+       angle, they are taken from the lookup table */
+    if( position.angle == gMCLIB_Position.angle )
+    {
+        position.sineAngle = gMCLIB_Position.sineAngle;
+        position.cosAngle = gMCLIB_Position.cosAngle;
+    }
+    else
+    {
+        MCLIB_SinCosCalc(position.angle, &position.sineAngle, &position.cosAngle);
+    }
 
     /*    Esd =  Esa*cos(Angle) + Esb*sin(Angle) */
     gMCRPOS_StateSignals.esd        =    (( gMCRPOS_StateSignals.esa * position.cosAngle ))
@@ -203,38 +253,19 @@ __STATIC_INLINE void MCRPOS_PLLEstimator( void )
     /* Filter first order for Esd and Esq
     EsdFilter = 1/TFilterd * Intergal{ (Esd-EsdFilter).dt } */
     gMCRPOS_StateSignals.esdf        =gMCRPOS_StateSignals.esdf +
-                  ( (gMCRPOS_StateSignals.esd - gMCRPOS_StateSignals.esdf) * gMCRPOS_Parameters.kFilterEsdq) ;
+                  ( (gMCRPOS_StateSignals.esd - gMCRPOS_StateSignals.esdf) * kFilterEsdq) ;
 
     gMCRPOS_StateSignals.esqf        = gMCRPOS_StateSignals.esqf +
-                  ( (gMCRPOS_StateSignals.esq - gMCRPOS_StateSignals.esqf) * gMCRPOS_Parameters.kFilterEsdq) ;
+                  ( (gMCRPOS_StateSignals.esq - gMCRPOS_StateSignals.esqf) * kFilterEsdq) ;
 
-    /* OmegaMr= InvKfi * (Esqf -sgn(Esqf) * Esdf) */
-    /* For stability the condition for low speed */
-    if (tempqVelEstim > gMCRPOS_Parameters.decimateRotorSpeed )
-    {
-        /* Estimated speed is greater than 10% of rated speed */
-        if( gMCRPOS_StateSignals.esqf > 0)
-        {
-            gMCRPOS_StateSignals.omegaMr = gMCRPOS_Parameters.invKFi * (gMCRPOS_StateSignals.esqf - gMCRPOS_StateSignals.esdf);
-        }
-        else
-        {
-            gMCRPOS_StateSignals.omegaMr = gMCRPOS_Parameters.invKFi * (gMCRPOS_StateSignals.esqf + gMCRPOS_StateSignals.esdf);
-        }
-    }
-    else
-    {
-        /* Estimated speed is less than 10% of rated speed */
-        if( gMCRPOS_StateSignals.velEstim > 0)
-        {
-            gMCRPOS_StateSignals.omegaMr    =    (( gMCRPOS_Parameters.invKFi * (gMCRPOS_StateSignals.esqf - gMCRPOS_StateSignals.esdf))) ;
-        }
-        else
-        {
-            gMCRPOS_StateSignals.omegaMr    =    (( gMCRPOS_Parameters.invKFi * (gMCRPOS_StateSignals.esqf + gMCRPOS_StateSignals.esdf))) ;
-        }
-    }
+    /* OmegaMr= InvKfi * (Esqf -sgn(Esqf) * Esdf)
+       For stability the sign is taken from the estimated speed below 10% of rated speed.
+       The sign is a select and a compare result instead of a branch tree */
+    speedSignSource = ( fabsf( gMCRPOS_StateSignals.velEstim ) > gMCRPOS_Parameters.decimateRotorSpeed )
+                    ? gMCRPOS_StateSignals.esqf : gMCRPOS_StateSignals.velEstim;
+    speedSign = (float)( ( 2 * (int32_t)( speedSignSource > 0.0f ) ) - 1 );
 
+    gMCRPOS_StateSignals.omegaMr = gMCRPOS_Parameters.invKFi * ( gMCRPOS_StateSignals.esqf - ( speedSign * gMCRPOS_StateSignals.esdf ) );
 
     /* the integral of the estimated speed(OmegaMr) is the estimated angle */
     gMCRPOS_StateSignals.rho    =     gMCRPOS_StateSignals.rho + (gMCRPOS_StateSignals.omegaMr) * (gMCRPOS_Parameters.deltaT);
@@ -245,17 +276,23 @@ __STATIC_INLINE void MCRPOS_PLLEstimator( void )
     /* is the same as for BEMF d-q components filtering */
     gMCRPOS_StateSignals.velEstim =   gMCRPOS_StateSignals.velEstim
                                   +    (  ( gMCRPOS_StateSignals.omegaMr - gMCRPOS_StateSignals.velEstim)
-                                     * ( gMCRPOS_Parameters.velEstimFilterK ) );
+                                     * ( velEstimFilterK ) );
 
     /* Update output signals */
+  #if(ENABLED == PLL_SPEED_SCHEDULING )
+    /* Angle advanced by the rotation during the estimation delay */
+    gMCRPOS_OutputSignals.angle = gMCRPOS_StateSignals.rho + ( gMCRPOS_StateSignals.velEstim * gMCRPOS_Parameters.angleLagTime );
+    MCLIB_WrapAngle( &gMCRPOS_OutputSignals.angle );
+  #else
     gMCRPOS_OutputSignals.angle = gMCRPOS_StateSignals.rho;
+  #endif
     gMCRPOS_OutputSignals.speed = gMCRPOS_StateSignals.velEstim;
 
-    /* Update  state variables for next loop  */
-    gMCRPOS_StateSignals.ialphaLast    =  gMCRPOS_InputSignals.ialpha;
-    gMCRPOS_StateSignals.ibetaLast     =  gMCRPOS_InputSignals.ibeta;
-    gMCRPOS_StateSignals.ualphaLast =  gMCRPOS_InputSignals.umax * gMCRPOS_InputSignals.ualpha;
-    gMCRPOS_StateSignals.ubetaLast  =  gMCRPOS_InputSignals.umax * gMCRPOS_InputSignals.ubeta;
+    /* Terms of this cycle for the stator voltage equations of the next one : U(k) + Ls/Ts i(k) */
+    gMCRPOS_StateSignals.esaHistory =   ( gMCRPOS_InputSignals.umax * gMCRPOS_InputSignals.ualpha )
+                                    +   ( gMCRPOS_Parameters.lsDt * gMCRPOS_InputSignals.ialpha );
+    gMCRPOS_StateSignals.esbHistory =   ( gMCRPOS_InputSignals.umax * gMCRPOS_InputSignals.ubeta )
+                                    +   ( gMCRPOS_Parameters.lsDt * gMCRPOS_InputSignals.ibeta );
 }
 
 /******************************************************************************/
@@ -271,15 +308,156 @@ static void MCRPOS_ResetPLLEstimator( void )
     gMCRPOS_StateSignals.omegaMr = 0;
     gMCRPOS_StateSignals.bemfFilt = 0;
     gMCRPOS_StateSignals.velEstim = 0;
-    gMCRPOS_StateSignals.ialphaLast = 0;
-    gMCRPOS_StateSignals.ibetaLast = 0;
-    gMCRPOS_StateSignals.ualphaLast = 0;
-    gMCRPOS_StateSignals.ubetaLast = 0;
+    gMCRPOS_StateSignals.esaHistory = 0;
+    gMCRPOS_StateSignals.esbHistory = 0;
     gMCRPOS_StateSignals.esdf = 0;
     gMCRPOS_StateSignals.esqf = 0;
     gMCRPOS_StateSignals.rho = 0;
 }
 
+#if (ENABLED == HF_INJECTION)
+/******************************************************************************/
+/* Function name: MCRPOS_InitializeHfiEstimator                               */
+/* Function parameters:   None                                                */
+/* Function return: None                                                      */
+/* Description:                                                               */
+/* Initialize the high frequency injection estimator parameters               */
+/******************************************************************************/
+static void MCRPOS_InitializeHfiEstimator( void )
+{
+    float ld, lq;
+
+#if (ENABLED == MOTOR_IDENTIFICATION)
+    ld = gMCID_MotorParam.ld;
+    lq = gMCID_MotorParam.lq;
+#else
+    ld = MOTOR_PER_PHASE_INDUCTANCE;
+    lq = MOTOR_Q_AXIS_INDUCTANCE;
+#endif
+    gMCRPOS_HfiParameters.voltage = HFI_VOLTAGE;
+    gMCRPOS_HfiParameters.phaseStep = SINGLE_ELEC_ROT_RADS_PER_SEC / (float)HFI_SAMPLES;
+    gMCRPOS_HfiParameters.invSamples = 1.0f / (float)HFI_SAMPLES;
+
+    /* The q- to d-axis response ratio is sin(2e)(1/Ld - 1/Lq) / (2 (cos^2(e)/Ld + sin^2(e)/Lq)), which is
+       (1 - Ld/Lq) e for a small angle error e. Without saliency there is no angle information */
+    gMCRPOS_HfiParameters.invSaliency = ( lq > ld ) ? ( lq / ( lq - ld ) ) : 0.0f;
+
+    /* Critically damped tracking loop, the speed is the integral term */
+    gMCRPOS_HfiParameters.kp = 2.0f * HFI_BANDWIDTH;
+    gMCRPOS_HfiParameters.ki = HFI_BANDWIDTH * HFI_BANDWIDTH * FAST_LOOP_TIME_SEC;
+
+    gMCRPOS_HfiParameters.lowSpeed = 0.5f * HFI_HANDOFF_SPEED_RADS_PER_SEC_ELEC;
+    gMCRPOS_HfiParameters.invSpeedBand = 1.0f / ( HFI_HANDOFF_SPEED_RADS_PER_SEC_ELEC - gMCRPOS_HfiParameters.lowSpeed );
+    gMCRPOS_HfiParameters.blendAngleLimit = (float)M_PI / 6.0f;
+    gMCRPOS_HfiParameters.deltaT = FAST_LOOP_TIME_SEC;
+}
+
+/******************************************************************************/
+/* Function name: MCRPOS_HfiEstimator                                         */
+/* Function parameters:   None                                                */
+/* Function return: None                                                      */
+/* Description:                                                               */
+/* Angle and speed from the current response to the pulsating voltage on the  */
+/* estimated d-axis. The output signals move from the injection estimate to   */
+/* the back EMF estimate of MCRPOS_PLLEstimator between the low speed and the */
+/* handoff speed, where the injection stops                                   */
+/******************************************************************************/
+__STATIC_INLINE void MCRPOS_HfiEstimator( void )
+{
+    uint32_t k, sample = gMCRPOS_HfiState.sample;
+    float id = gMCLIB_CurrentDQ.directAxis;
+    float iq = gMCLIB_CurrentDQ.quadratureAxis;
+    float idh, iqh, product, power, difference, sine, cosine;
+
+    /* Moving averages over the injection period cancel the injection response */
+    gMCRPOS_HfiState.idSum += id - gMCRPOS_HfiState.idBuffer[sample];
+    gMCRPOS_HfiState.iqSum += iq - gMCRPOS_HfiState.iqBuffer[sample];
+    gMCRPOS_HfiState.idBuffer[sample] = id;
+    gMCRPOS_HfiState.iqBuffer[sample] = iq;
+    gMCRPOS_HfiOutput.idFilt = gMCRPOS_HfiState.idSum * gMCRPOS_HfiParameters.invSamples;
+    gMCRPOS_HfiOutput.iqFilt = gMCRPOS_HfiState.iqSum * gMCRPOS_HfiParameters.invSamples;
+
+    /* The d-axis response is the demodulation reference, so that the delay of the PWM update and of the
+       current sampling cancels in the ratio of the sums */
+    idh = id - gMCRPOS_HfiOutput.idFilt;
+    iqh = iq - gMCRPOS_HfiOutput.iqFilt;
+    product = idh * iqh;
+    power = idh * idh;
+    gMCRPOS_HfiState.productSum += product - gMCRPOS_HfiState.productBuffer[sample];
+    gMCRPOS_HfiState.powerSum += power - gMCRPOS_HfiState.powerBuffer[sample];
+    gMCRPOS_HfiState.productBuffer[sample] = product;
+    gMCRPOS_HfiState.powerBuffer[sample] = power;
+
+    sample++;
+    if( sample >= HFI_SAMPLES )
+    {
+        /* Sums recalculated once per injection period, so that rounding errors do not accumulate */
+        sample = 0U;
+        gMCRPOS_HfiState.idSum = 0.0f;
+        gMCRPOS_HfiState.iqSum = 0.0f;
+        gMCRPOS_HfiState.productSum = 0.0f;
+        gMCRPOS_HfiState.powerSum = 0.0f;
+        for( k = 0U; k < HFI_SAMPLES; k++ )
+        {
+            gMCRPOS_HfiState.idSum += gMCRPOS_HfiState.idBuffer[k];
+            gMCRPOS_HfiState.iqSum += gMCRPOS_HfiState.iqBuffer[k];
+            gMCRPOS_HfiState.productSum += gMCRPOS_HfiState.productBuffer[k];
+            gMCRPOS_HfiState.powerSum += gMCRPOS_HfiState.powerBuffer[k];
+        }
+        gMCRPOS_HfiState.filled = true;
+    }
+    gMCRPOS_HfiState.sample = sample;
+
+    /* The response gives the angle error of the injection axis, which is the control angle of the previous
+       period. Its offset from the injection estimate is added */
+    if( gMCRPOS_HfiState.filled && ( gMCRPOS_HfiState.powerSum > 0.0f ) )
+    {
+        gMCRPOS_HfiState.error = ( gMCRPOS_HfiState.productSum / gMCRPOS_HfiState.powerSum ) * gMCRPOS_HfiParameters.invSaliency
+                               + MCLIB_AngleDifference( gMCLIB_Position.angle, gMCRPOS_HfiState.angle );
+    }
+    else
+    {
+        gMCRPOS_HfiState.error = 0.0f;
+    }
+
+    /* Tracking loop */
+    gMCRPOS_HfiState.speed += gMCRPOS_HfiParameters.ki * gMCRPOS_HfiState.error;
+    gMCRPOS_HfiState.angle += ( gMCRPOS_HfiState.speed + ( gMCRPOS_HfiParameters.kp * gMCRPOS_HfiState.error ) )
+                            * gMCRPOS_HfiParameters.deltaT;
+    MCLIB_WrapAngle( &gMCRPOS_HfiState.angle );
+
+    /* Output signals blended towards the back EMF estimate with the speed, as long as both estimates agree.
+       After a fast speed reversal the back EMF estimate needs time to lock again */
+    difference = MCLIB_AngleDifference( gMCRPOS_OutputSignals.angle, gMCRPOS_HfiState.angle );
+    if( fabsf( difference ) < gMCRPOS_HfiParameters.blendAngleLimit )
+    {
+        gMCRPOS_HfiState.weight = ( fabsf( gMCRPOS_HfiState.speed ) - gMCRPOS_HfiParameters.lowSpeed ) * gMCRPOS_HfiParameters.invSpeedBand;
+        gMCRPOS_HfiState.weight = fminf( fmaxf( gMCRPOS_HfiState.weight, 0.0f ), 1.0f );
+    }
+    else
+    {
+        gMCRPOS_HfiState.weight = 0.0f;
+    }
+    gMCRPOS_OutputSignals.angle = gMCRPOS_HfiState.angle + ( gMCRPOS_HfiState.weight * difference );
+    MCLIB_WrapAngle( &gMCRPOS_OutputSignals.angle );
+    gMCRPOS_OutputSignals.speed = gMCRPOS_HfiState.speed
+                                + ( gMCRPOS_HfiState.weight * ( gMCRPOS_OutputSignals.speed - gMCRPOS_HfiState.speed ) );
+
+    if( gMCRPOS_HfiState.weight >= 1.0f )
+    {
+        /* Handoff to the back EMF estimate */
+        gMCRPOS_HfiState.active = false;
+        gMCRPOS_HfiOutput.vdInjection = 0.0f;
+    }
+    else
+    {
+        /* Injection voltage of the next PWM period */
+        MCLIB_SinCosCalc( (float)sample * gMCRPOS_HfiParameters.phaseStep, &sine, &cosine );
+        gMCRPOS_HfiOutput.vdInjection = ( gMCRPOS_HfiParameters.voltage * cosine ) / gMCVOL_OutputSignals.umax;
+    }
+}
+#endif
+
 /******************************************************************************/
 /*                      INTERFACE FUNCTIONS                                   */
 /******************************************************************************/
@@ -295,6 +473,9 @@ void MCRPOS_InitializeRotorPositionSensing( void )
 {
     /* Initialize PLL Estimator */
     MCRPOS_InitializePLLEstimator( );
+#if (ENABLED == HF_INJECTION)
+    MCRPOS_InitializeHfiEstimator( );
+#endif
 
 }
 
@@ -317,7 +498,18 @@ tMCAPP_STATUS_E MCRPOS_InitialRotorPositonDetection(tMCRPOS_ROTOR_ALIGN_OUTPUT_S
             {
                 /* PLL initialization */
                 MCRPOS_InitializeRotorPositionSensing(  );
+#if (ENABLED == PARAMETER_CHANNEL)
+                /* Keep the estimator parameters updated at run time */
+                MCPAR_Restore( );
+#endif
+#if (ENABLED == HF_INJECTION)
+                /* The injection estimate starts from the aligned rotor, the back EMF estimate needs no offset
+                   of an open loop startup */
+                gMCRPOS_StateSignals.rhoOffset = 0.0f;
+                MCRPOS_HfiStart( 0.0f, 0.0f );
+#else
                 MCRPOS_OffsetCalibration(gMCCTRL_CtrlParam.rotationSign);
+#endif
                 gMCRPOS_RotorAlignState.rotorAlignState = MCRPOS_FORCE_ALIGN;
             }
         }
@@ -415,7 +607,57 @@ void MCRPOS_PositionMeasurement( void )
 {
     MCRPOS_ReadInputSignals( );
     MCRPOS_PLLEstimator( );
+#if (ENABLED == HF_INJECTION)
+    /* Back to the injection estimate below the blend band */
+    if( ( false == gMCRPOS_HfiState.active ) && ( MCAPP_CLOSED_LOOP == gMCCTRL_CtrlParam.mcState )
+     && ( fabsf( gMCRPOS_OutputSignals.speed ) < gMCRPOS_HfiParameters.lowSpeed ) )
+    {
+        MCRPOS_HfiStart( gMCRPOS_OutputSignals.angle, gMCRPOS_OutputSignals.speed );
+    }
+    if( gMCRPOS_HfiState.active )
+    {
+        MCRPOS_HfiEstimator( );
+    }
+#endif
+}
+
+#if (ENABLED == HF_INJECTION)
+/******************************************************************************/
+/* Function name: MCRPOS_HfiStart                                             */
+/* Function parameters: angle - electrical angle (rad), speed - electrical    */
+/*                      speed (rad/s) of the rotor                            */
+/* Function return: None                                                      */
+/* Description:                                                               */
+/* Starts the injection estimate from the given rotor angle and speed         */
+/******************************************************************************/
+void MCRPOS_HfiStart( const float angle, const float speed )
+{
+    uint32_t k;
+
+    for( k = 0U; k < HFI_SAMPLES; k++ )
+    {
+        gMCRPOS_HfiState.idBuffer[k] = gMCLIB_CurrentDQ.directAxis;
+        gMCRPOS_HfiState.iqBuffer[k] = gMCLIB_CurrentDQ.quadratureAxis;
+        gMCRPOS_HfiState.productBuffer[k] = 0.0f;
+        gMCRPOS_HfiState.powerBuffer[k] = 0.0f;
+    }
+    gMCRPOS_HfiState.idSum = (float)HFI_SAMPLES * gMCLIB_CurrentDQ.directAxis;
+    gMCRPOS_HfiState.iqSum = (float)HFI_SAMPLES * gMCLIB_CurrentDQ.quadratureAxis;
+    gMCRPOS_HfiState.productSum = 0.0f;
+    gMCRPOS_HfiState.powerSum = 0.0f;
+    gMCRPOS_HfiState.sample = 0U;
+    gMCRPOS_HfiState.filled = false;
+    gMCRPOS_HfiState.error = 0.0f;
+    gMCRPOS_HfiState.angle = angle;
+    gMCRPOS_HfiState.speed = speed;
+    gMCRPOS_HfiState.weight = 0.0f;
+
+    gMCRPOS_HfiOutput.idFilt = gMCLIB_CurrentDQ.directAxis;
+    gMCRPOS_HfiOutput.iqFilt = gMCLIB_CurrentDQ.quadratureAxis;
+    gMCRPOS_HfiOutput.vdInjection = 0.0f;
+    gMCRPOS_HfiState.active = true;
 }
+#endif
 
 /******************************************************************************/
 /* Function name: MCRPOS_ResetPositionSensing                               */
@@ -428,4 +670,8 @@ void MCRPOS_ResetPositionSensing( tMCRPOS_ALIGN_STATE_E state )
 {
     gMCRPOS_RotorAlignState.rotorAlignState = state;
     MCRPOS_ResetPLLEstimator( );
+#if (ENABLED == HF_INJECTION)
+    gMCRPOS_HfiState.active = false;
+    gMCRPOS_HfiOutput.vdInjection = 0.0f;
+#endif
 }
@@ -115,12 +115,18 @@ typedef struct
 {
     float                           lsDt;
     float                           rs;
+    float                           rsLsDt;
     float                           invKFi;
     float                           kFilterEsdq;
     float                           kFilterBEMFAmp;
     float                           velEstimFilterK;
     float                           deltaT;
     float                           decimateRotorSpeed;
+  #if(ENABLED == PLL_SPEED_SCHEDULING )
+    float                           kFilterEsdqPerSpeed;        /* Esd/Esq filter coefficient per rad/s of estimated speed */
+    float                           velEstimFilterKPerSpeed;    /* Speed filter coefficient per rad/s of estimated speed   */
+    float                           angleLagTime;               /* Estimation delay compensated in the output angle (s)   */
+  #endif
 }tMCRPOS_PARAMETERS_S;
 
 typedef struct
@@ -130,10 +136,8 @@ typedef struct
     float                            rhoOffset;
     float                            bemfFilt;
     float                            velEstim;
-    float                            ialphaLast;
-    float                            ibetaLast;
-    float                            ualphaLast;
-    float                            ubetaLast;
+    float                            esaHistory;
+    float                            esbHistory;
     float                            esa;
     float                            esb;
     float                            esd;
@@ -153,15 +157,64 @@ typedef struct
   #endif
 }tMCRPOS_OUTPUT_SIGNALS_S;
 
+#if (ENABLED == HF_INJECTION)
+typedef struct
+{
+    float                           voltage;            /* Injection amplitude (V)                                  */
+    float                           phaseStep;          /* Injection phase per PWM period (rad)                     */
+    float                           invSamples;         /* 1 / HFI_SAMPLES                                          */
+    float                           invSaliency;        /* Angle error per unit of the demodulated q-axis response  */
+    float                           kp;                 /* Tracking loop proportional gain (1/s)                    */
+    float                           ki;                 /* Tracking loop integral gain (1/s^2), per PWM period      */
+    float                           lowSpeed;           /* Start of the blend towards the back EMF estimate (rad/s) */
+    float                           invSpeedBand;       /* 1 / speed from the blend start to the handoff            */
+    float                           blendAngleLimit;    /* Largest difference of the estimates for the blend (rad)  */
+    float                           deltaT;
+}tMCRPOS_HFI_PARAMETERS_S;
+
+typedef struct
+{
+    bool                            active;             /* Injection estimate in use                                */
+    uint32_t                        sample;             /* PWM period within the injection period                   */
+    bool                            filled;             /* A full injection period in the buffers                   */
+    float                           idBuffer[HFI_SAMPLES];
+    float                           iqBuffer[HFI_SAMPLES];
+    float                           productBuffer[HFI_SAMPLES];
+    float                           powerBuffer[HFI_SAMPLES];
+    float                           idSum;              /* Sums over the last injection period                      */
+    float                           iqSum;
+    float                           productSum;         /* d- times q-axis response                                 */
+    float                           powerSum;           /* d-axis response squared                                  */
+    float                           error;              /* Angle error of the injection estimate (rad)              */
+    float                           angle;              /* Injection estimate of the electrical angle               */
+    float                           speed;              /* Injection estimate of the electrical speed (rad/s)       */
+    float                           weight;             /* Share of the back EMF estimate in the output signals     */
+}tMCRPOS_HFI_STATE_S;
+
+typedef struct
+{
+    float                           idFilt;             /* d- and q-axis currents averaged over the injection       */
+    float                           iqFilt;             /* period, without the injection response (A)               */
+    float                           vdInjection;        /* d-axis injection voltage relative to umax                */
+}tMCRPOS_HFI_OUTPUT_S;
+#endif
+
 
 // *****************************************************************************
 // *****************************************************************************
 // Section: Interface Routines
 // *****************************************************************************
 // *****************************************************************************
+extern tMCRPOS_PARAMETERS_S           gMCRPOS_Parameters;
+extern tMCRPOS_INPUT_SIGNAL_S         gMCRPOS_InputSignals;
 extern tMCRPOS_STATE_SIGNAL_S         gMCRPOS_StateSignals;
 extern tMCRPOS_OUTPUT_SIGNALS_S       gMCRPOS_OutputSignals;
 extern tMCRPOS_ROTOR_ALIGN_OUTPUT_S  gMCRPOS_RotorAlignOutput;
+#if (ENABLED == HF_INJECTION)
+extern tMCRPOS_HFI_PARAMETERS_S       gMCRPOS_HfiParameters;
+extern tMCRPOS_HFI_STATE_S            gMCRPOS_HfiState;
+extern tMCRPOS_HFI_OUTPUT_S           gMCRPOS_HfiOutput;
+#endif
 
 void MCRPOS_InitializeRotorPositionSensing(void);
 tMCAPP_STATUS_E MCRPOS_FieldAlignment( tMCRPOS_ROTOR_ALIGN_OUTPUT_S * const alignOutput );
@@ -169,6 +222,9 @@ tMCAPP_STATUS_E MCRPOS_InitialRotorPositonDetection(tMCRPOS_ROTOR_ALIGN_OUTPUT_S
 void MCRPOS_OffsetCalibration(const int16_t direction );
 void MCRPOS_PositionMeasurement( void );
 void MCRPOS_ResetPositionSensing( tMCRPOS_ALIGN_STATE_E state );
+#if (ENABLED == HF_INJECTION)
+void MCRPOS_HfiStart( const float angle, const float speed );
+#endif
 
 // DOM-IGNORE-BEGIN
 #ifdef __cplusplus  // Provide C++ Compatibility
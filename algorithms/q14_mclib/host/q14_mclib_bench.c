@@ -0,0 +1,550 @@
+/*******************************************************************************
+ Q14 Motor Control Library Benchmark source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    q14_mclib_bench.c
+
+  Summary:
+    Accuracy and execution time of the Q14 library functions
+
+  Description:
+    This file runs a microbenchmark per function of q14_generic_mcLib.c:
+    library_sincos, library_atan2, library_scat, library_xy_rt and
+    library_pi_control. For every function the maximum error against a
+    double precision reference over pseudo random inputs and the execution
+    time per call (best of several rounds) are reported. The errors are
+    referred to BASE_VALUE, the angle errors are in degrees.
+
+    Usage: q14_mclib_bench [--rounds <n>]
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "definitions.h"
+#include "q14_generic_mcLib.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     Q14BENCH_POINTS                 (4096U)
+#define     Q14BENCH_ROUNDS                 (500U)
+#define     Q14BENCH_RAD_TO_DEG             ( 180.0 / M_PI )
+#define     Q14BENCH_ANGLE_TO_RAD           ( 2.0 * M_PI / 65536.0 )
+
+/* PI controller under test, kp = 0.5, ki = 1/16 per call */
+#define     Q14BENCH_PI_KP                  ( 8192 )
+#define     Q14BENCH_PI_SHP                 ( 14U )
+#define     Q14BENCH_PI_KI                  ( 16384 )
+#define     Q14BENCH_PI_SHI                 ( 4U )
+#define     Q14BENCH_PI_LIMIT               ( 12000 )
+
+/* Load observer under test: speed change of 0.02 per current and period, double
+   pole at 0.02 per period (100 rad/s at 5 kHz) */
+#define     Q14BENCH_LOBS_KB                ( 5243 )
+#define     Q14BENCH_LOBS_KS                ( 10486 )
+#define     Q14BENCH_LOBS_KL                ( 5243 )
+#define     Q14BENCH_LOBS_SH                ( 18U )
+
+/* Load step on a speed loop with the load observer plant: speed controller with a
+   crossover of 0.01 per period, the load current steps to 0.25 at half speed */
+#define     Q14BENCH_STEP_SPE_KP            ( 8192 )
+#define     Q14BENCH_STEP_SPE_SHP           ( 14U )
+#define     Q14BENCH_STEP_SPE_KI            ( 1311 )
+#define     Q14BENCH_STEP_SPE_SHI           ( 6U )
+#define     Q14BENCH_STEP_SPEED             ( 8192 )
+#define     Q14BENCH_STEP_LOAD              ( 4096 )
+#define     Q14BENCH_STEP_PERIODS           ( 5000U )       /* 1 s at 5 kHz                      */
+#define     Q14BENCH_STEP_BAND              ( 82 )          /* recovered within 1 % of the speed */
+#define     Q14BENCH_STEP_LOAD_TOLERANCE    ( 82 )          /* 2 % of the load current           */
+
+typedef struct
+{
+    const char *                    name;
+    double                          (*error)( void );       /* maximum error                     */
+    void                            (*run)( void );         /* one call per input point          */
+    double                          maxError;               /* acceptance limit                  */
+    const char *                    unit;
+}tQ14BENCH_FUNCTION_S;
+
+typedef struct
+{
+    int32_t                         speedDip;               /* largest speed error after the step */
+    uint32_t                        recovery;               /* periods until within the band     */
+    int16_t                         load;                   /* final load current estimate       */
+}tQ14BENCH_LOAD_STEP_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static uint16_t gQ14BENCH_Angle[Q14BENCH_POINTS];
+static vec2_t gQ14BENCH_Vector[Q14BENCH_POINTS];
+static int16_t gQ14BENCH_Hypo[Q14BENCH_POINTS];
+static int16_t gQ14BENCH_Cathetus[Q14BENCH_POINTS];
+static int32_t gQ14BENCH_Error[Q14BENCH_POINTS];
+static int16_t gQ14BENCH_Speed[Q14BENCH_POINTS];
+static int16_t gQ14BENCH_Current[Q14BENCH_POINTS];
+volatile int32_t gQ14BENCH_Sink;
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+static double Q14BENCH_AngleError( double a, double b )
+{
+    double error = fmod( a - b, 2.0 * M_PI );
+
+    if( error > M_PI )
+    {
+        error -= 2.0 * M_PI;
+    }
+    else if( error < -M_PI )
+    {
+        error += 2.0 * M_PI;
+    }
+    return fabs( error ) * Q14BENCH_RAD_TO_DEG;
+}
+
+static void Q14BENCH_PIReset( pi_cntrl_t * const pi )
+{
+    pi->kp = Q14BENCH_PI_KP;
+    pi->shp = Q14BENCH_PI_SHP;
+    pi->ki = Q14BENCH_PI_KI;
+    pi->shi = Q14BENCH_PI_SHI;
+    pi->hlim = Q14BENCH_PI_LIMIT;
+    pi->llim = -Q14BENCH_PI_LIMIT;
+    pi->imem = 0;
+}
+
+static void Q14BENCH_LoadObserverReset( load_obs_t * const lo, int16_t speed )
+{
+    lo->kb = Q14BENCH_LOBS_KB;
+    lo->shb = Q14BENCH_LOBS_SH;
+    lo->ks = Q14BENCH_LOBS_KS;
+    lo->shs = Q14BENCH_LOBS_SH;
+    lo->kl = Q14BENCH_LOBS_KL;
+    lo->shl = Q14BENCH_LOBS_SH;
+    lo->lim = Q14BENCH_PI_LIMIT;
+    lo->smem = (int32_t)speed << SH_LOBS_MEM;
+    lo->lmem = 0;
+}
+
+/******************************************************************************/
+/* Function name: Q14BENCH_LoadStep                                           */
+/* Function parameters: observer - feed-forward of the load observer,         */
+/*                      pResult - speed dip, recovery and load estimate       */
+/* Function return: None                                                      */
+/* Description: Speed loop on the plant of the load observer, speed' =        */
+/*              kb * (iq - load), as the RUNNING state of the ROLO            */
+/*              applications. The load current steps after one second, the    */
+/*              signals around the step are recorded for library_load_observer*/
+/******************************************************************************/
+static void Q14BENCH_LoadStep( bool observer, tQ14BENCH_LOAD_STEP_S * const pResult )
+{
+    const double kb = (double)Q14BENCH_LOBS_KB / (double)( 1UL << Q14BENCH_LOBS_SH );
+    pi_cntrl_t pi;
+    load_obs_t lo;
+    double speed = (double)Q14BENCH_STEP_SPEED, load = 0.0;
+    int16_t measured, iq = 0, estimate = 0;
+    int32_t error;
+    uint32_t period, record = Q14BENCH_STEP_PERIODS - ( Q14BENCH_POINTS / 8U );
+
+    pi.kp = Q14BENCH_STEP_SPE_KP;
+    pi.shp = Q14BENCH_STEP_SPE_SHP;
+    pi.ki = Q14BENCH_STEP_SPE_KI;
+    pi.shi = Q14BENCH_STEP_SPE_SHI;
+    pi.imem = 0;
+    Q14BENCH_LoadObserverReset( &lo, (int16_t)Q14BENCH_STEP_SPEED );
+    memset( pResult, 0, sizeof( *pResult ) );
+
+    for( period = 0U; period < ( 2U * Q14BENCH_STEP_PERIODS ); period++ )
+    {
+        if( Q14BENCH_STEP_PERIODS == period )
+        {
+            load = (double)Q14BENCH_STEP_LOAD;
+        }
+        measured = (int16_t)lrint( speed );
+
+        /* speed control with the limits of the applications */
+        pi.hlim = Q14BENCH_PI_LIMIT;
+        pi.llim = -Q14BENCH_PI_LIMIT;
+        if( observer )
+        {
+            if( ( period >= record ) && ( ( period - record ) < Q14BENCH_POINTS ) )
+            {
+                gQ14BENCH_Speed[period - record] = measured;
+                gQ14BENCH_Current[period - record] = iq;
+            }
+            estimate = library_load_observer( measured, iq, &lo );
+            pi.hlim -= estimate;
+            pi.llim -= estimate;
+        }
+        iq = library_pi_control( (int32_t)Q14BENCH_STEP_SPEED - measured, &pi ) + estimate;
+
+        /* plant */
+        speed += kb * ( (double)iq - load );
+
+        error = (int32_t)Q14BENCH_STEP_SPEED - measured;
+        if( period >= Q14BENCH_STEP_PERIODS )
+        {
+            pResult->speedDip = ( error > pResult->speedDip ) ? error : pResult->speedDip;
+            if( abs( error ) > Q14BENCH_STEP_BAND )
+            {
+                pResult->recovery = period + 1U - Q14BENCH_STEP_PERIODS;
+            }
+        }
+    }
+    pResult->load = estimate;
+}
+
+/* library_sincos */
+static double Q14BENCH_SinCosError( void )
+{
+    ang_sincos_t t;
+    double error = 0.0;
+    uint32_t ang;
+
+    for( ang = 0U; ang < 65536U; ang++ )
+    {
+        t.ang = (uint16_t)ang;
+        library_sincos( &t );
+        error = fmax( error, fabs( ( (double)t.sin / BASE_VALUE_FL ) - sin( (double)ang * Q14BENCH_ANGLE_TO_RAD ) ) );
+        error = fmax( error, fabs( ( (double)t.cos / BASE_VALUE_FL ) - cos( (double)ang * Q14BENCH_ANGLE_TO_RAD ) ) );
+    }
+    return error;
+}
+
+static void Q14BENCH_SinCosRun( void )
+{
+    ang_sincos_t t;
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        t.ang = gQ14BENCH_Angle[i];
+        library_sincos( &t );
+        sum += t.sin + t.cos;
+    }
+    gQ14BENCH_Sink = sum;
+}
+
+/* library_atan2 */
+static double Q14BENCH_Atan2Error( void )
+{
+    double error = 0.0;
+    uint32_t i;
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        error = fmax( error, Q14BENCH_AngleError( (double)library_atan2( gQ14BENCH_Vector[i].x, gQ14BENCH_Vector[i].y ) * Q14BENCH_ANGLE_TO_RAD,
+                                                  atan2( (double)gQ14BENCH_Vector[i].y, (double)gQ14BENCH_Vector[i].x ) ) );
+    }
+    return error;
+}
+
+static void Q14BENCH_Atan2Run( void )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        sum += library_atan2( gQ14BENCH_Vector[i].x, gQ14BENCH_Vector[i].y );
+    }
+    gQ14BENCH_Sink = sum;
+}
+
+/* library_scat, the largest error is near |fcat| = hypo where the sinarcos table is coarse */
+static double Q14BENCH_ScatError( void )
+{
+    double error = 0.0, hypo, fcat;
+    uint32_t i;
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        hypo = (double)gQ14BENCH_Hypo[i];
+        fcat = (double)gQ14BENCH_Cathetus[i];
+        error = fmax( error, fabs( (double)library_scat( gQ14BENCH_Hypo[i], gQ14BENCH_Cathetus[i] ) - sqrt( ( hypo * hypo ) - ( fcat * fcat ) ) ) / BASE_VALUE_FL );
+    }
+    return error;
+}
+
+static void Q14BENCH_ScatRun( void )
+{
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        sum += library_scat( gQ14BENCH_Hypo[i], gQ14BENCH_Cathetus[i] );
+    }
+    gQ14BENCH_Sink = sum;
+}
+
+/* library_xy_rt, amplitude error */
+static double Q14BENCH_XyRtError( void )
+{
+    vecp_t rt;
+    double error = 0.0, x, y;
+    uint32_t i;
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        library_xy_rt( &gQ14BENCH_Vector[i], &rt );
+        x = (double)gQ14BENCH_Vector[i].x;
+        y = (double)gQ14BENCH_Vector[i].y;
+        error = fmax( error, fabs( (double)rt.r - hypot( x, y ) ) / BASE_VALUE_FL );
+    }
+    return error;
+}
+
+static void Q14BENCH_XyRtRun( void )
+{
+    vecp_t rt;
+    int32_t sum = 0;
+    uint32_t i;
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        library_xy_rt( &gQ14BENCH_Vector[i], &rt );
+        sum += rt.r;
+    }
+    gQ14BENCH_Sink = sum;
+}
+
+/* library_pi_control against the same controller in double precision */
+static double Q14BENCH_PIError( void )
+{
+    pi_cntrl_t pi;
+    double error = 0.0, imem = 0.0, e, output, limit = (double)Q14BENCH_PI_LIMIT;
+    double kp = (double)Q14BENCH_PI_KP / (double)( 1UL << Q14BENCH_PI_SHP );
+    double ki = (double)Q14BENCH_PI_KI / (double)( 1UL << Q14BENCH_PI_SHI ) / (double)( 1UL << Q14BENCH_PI_SHP );
+    uint32_t i;
+
+    Q14BENCH_PIReset( &pi );
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        e = (double)gQ14BENCH_Error[i];
+        imem += ki * e;
+        output = ( kp * e ) + imem;
+        if( output > limit )
+        {
+            output = limit;
+            imem = limit - ( kp * e );
+        }
+        else if( output < -limit )
+        {
+            output = -limit;
+            imem = -limit - ( kp * e );
+        }
+        error = fmax( error, fabs( (double)library_pi_control( gQ14BENCH_Error[i], &pi ) - output ) / BASE_VALUE_FL );
+    }
+    return error;
+}
+
+static void Q14BENCH_PIRun( void )
+{
+    pi_cntrl_t pi;
+    int32_t sum = 0;
+    uint32_t i;
+
+    Q14BENCH_PIReset( &pi );
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        sum += library_pi_control( gQ14BENCH_Error[i], &pi );
+    }
+    gQ14BENCH_Sink = sum;
+}
+
+/* library_load_observer against the same observer in double precision on the
+   signals of the load step */
+static double Q14BENCH_LoadObserverError( void )
+{
+    load_obs_t lo;
+    double error = 0.0, speed, load = 0.0, e, limit = (double)Q14BENCH_PI_LIMIT;
+    double kb = (double)Q14BENCH_LOBS_KB / (double)( 1UL << Q14BENCH_LOBS_SH );
+    double ks = (double)Q14BENCH_LOBS_KS / (double)( 1UL << Q14BENCH_LOBS_SH );
+    double kl = (double)Q14BENCH_LOBS_KL / (double)( 1UL << Q14BENCH_LOBS_SH );
+    uint32_t i;
+
+    Q14BENCH_LoadObserverReset( &lo, gQ14BENCH_Speed[0] );
+    speed = (double)gQ14BENCH_Speed[0];
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        e = (double)gQ14BENCH_Speed[i] - speed;
+        speed += ( kb * ( (double)gQ14BENCH_Current[i] - load ) ) + ( ks * e );
+        load = fmax( -limit, fmin( limit, load - ( kl * e ) ) );
+        error = fmax( error, fabs( (double)library_load_observer( gQ14BENCH_Speed[i], gQ14BENCH_Current[i], &lo ) - load ) / BASE_VALUE_FL );
+    }
+    return error;
+}
+
+static void Q14BENCH_LoadObserverRun( void )
+{
+    load_obs_t lo;
+    int32_t sum = 0;
+    uint32_t i;
+
+    Q14BENCH_LoadObserverReset( &lo, gQ14BENCH_Speed[0] );
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        sum += library_load_observer( gQ14BENCH_Speed[i], gQ14BENCH_Current[i], &lo );
+    }
+    gQ14BENCH_Sink = sum;
+}
+
+static const tQ14BENCH_FUNCTION_S gQ14BENCH_Functions[] =
+{
+    { "library_sincos",     Q14BENCH_SinCosError,   Q14BENCH_SinCosRun,     1.0e-2,     "1/BASE" },
+    { "library_atan2",      Q14BENCH_Atan2Error,    Q14BENCH_Atan2Run,      0.5,        "deg"    },
+    { "library_scat",       Q14BENCH_ScatError,     Q14BENCH_ScatRun,       1.5e-1,     "1/BASE" },
+    { "library_xy_rt",      Q14BENCH_XyRtError,     Q14BENCH_XyRtRun,       1.0e-2,     "1/BASE" },
+    { "library_pi_control", Q14BENCH_PIError,       Q14BENCH_PIRun,         1.0e-3,     "1/BASE" },
+    { "library_load_observer", Q14BENCH_LoadObserverError, Q14BENCH_LoadObserverRun, 1.0e-3, "1/BASE" },
+};
+
+/******************************************************************************/
+/* Function name: Q14BENCH_Time                                               */
+/* Function parameters: run - one call per input point, rounds               */
+/* Function return: ns per call                                               */
+/* Description: Best round, free from preemption                              */
+/******************************************************************************/
+static double Q14BENCH_Time( void (*run)( void ), uint32_t rounds )
+{
+    struct timespec start, stop;
+    double elapsed, best = 1.0e9;
+    uint32_t round;
+
+    for( round = 0U; round < rounds; round++ )
+    {
+        clock_gettime( CLOCK_MONOTONIC, &start );
+        run();
+        clock_gettime( CLOCK_MONOTONIC, &stop );
+        elapsed = ( (double)( stop.tv_sec - start.tv_sec ) * 1.0e9 ) + (double)( stop.tv_nsec - start.tv_nsec );
+        if( elapsed < best )
+        {
+            best = elapsed;
+        }
+    }
+    return best / (double)Q14BENCH_POINTS;
+}
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( int argc, char * argv[] )
+{
+    const tQ14BENCH_FUNCTION_S * pFunction;
+    tQ14BENCH_LOAD_STEP_S pi, observer;
+    uint32_t i, seed = 12345U, rounds = Q14BENCH_ROUNDS;
+    int32_t amplitude, integral = 0;
+    double error, angle, ns;
+    int result = 0;
+
+    if( ( argc == 3 ) && ( 0 == strcmp( argv[1], "--rounds" ) ) )
+    {
+        rounds = (uint32_t)strtoul( argv[2], NULL, 0 );
+    }
+    else if( argc != 1 )
+    {
+        fprintf( stderr, "usage: %s [--rounds n]\n", argv[0] );
+        return 2;
+    }
+
+    for( i = 0U; i < Q14BENCH_POINTS; i++ )
+    {
+        seed = ( seed * 1664525U ) + 1013904223U;
+        gQ14BENCH_Angle[i] = (uint16_t)( seed >> 16 );
+
+        /* Vectors with an amplitude from 0.1 to 1.5 */
+        angle = (double)gQ14BENCH_Angle[i] * Q14BENCH_ANGLE_TO_RAD;
+        seed = ( seed * 1664525U ) + 1013904223U;
+        amplitude = 1638 + (int32_t)( ( seed >> 8 ) % 22938U );
+        gQ14BENCH_Vector[i].x = (int16_t)lrint( (double)amplitude * cos( angle ) );
+        gQ14BENCH_Vector[i].y = (int16_t)lrint( (double)amplitude * sin( angle ) );
+
+        /* Right angled triangles, |first cathetus| < hypotenuse */
+        gQ14BENCH_Hypo[i] = (int16_t)amplitude;
+        seed = ( seed * 1664525U ) + 1013904223U;
+        gQ14BENCH_Cathetus[i] = (int16_t)( ( (int32_t)( seed >> 16 ) % ( 2 * amplitude - 1 ) ) - amplitude + 1 );
+
+        /* Controller error, a random walk which drives the output into both limits */
+        seed = ( seed * 1664525U ) + 1013904223U;
+        integral += (int32_t)( seed >> 22 ) - 512;
+        integral = ( integral > 8192 ) ? 8192 : ( ( integral < -8192 ) ? -8192 : integral );
+        gQ14BENCH_Error[i] = integral;
+    }
+
+    /* Load step without and with the observer, which records the observer signals */
+    Q14BENCH_LoadStep( false, &pi );
+    Q14BENCH_LoadStep( true, &observer );
+
+    printf( "Q14 motor control library %u.%u\n", (unsigned)Q14_MCLIB_VERSION_MAJOR, (unsigned)Q14_MCLIB_VERSION_MINOR );
+    printf( "%-22s %12s %8s %10s\n", "Function", "max error", "unit", "ns" );
+    for( i = 0U; i < ( sizeof( gQ14BENCH_Functions ) / sizeof( gQ14BENCH_Functions[0] ) ); i++ )
+    {
+        pFunction = &gQ14BENCH_Functions[i];
+        error = pFunction->error();
+        ns = Q14BENCH_Time( pFunction->run, rounds );
+        printf( "%-22s %12.3e %8s %10.2f\n", pFunction->name, error, pFunction->unit, ns );
+        if( error > pFunction->maxError )
+        {
+            result = 1;
+        }
+    }
+
+    printf( "%-22s %12s %12s %12s\n", "Load step", "speed dip", "recovery", "load" );
+    printf( "%-22s %12.3e %9.1f ms %12s\n", "PI", (double)pi.speedDip / BASE_VALUE_FL,
+            (double)pi.recovery * 1000.0 / (double)Q14BENCH_STEP_PERIODS, "-" );
+    printf( "%-22s %12.3e %9.1f ms %12.3e\n", "PI and observer", (double)observer.speedDip / BASE_VALUE_FL,
+            (double)observer.recovery * 1000.0 / (double)Q14BENCH_STEP_PERIODS, (double)observer.load / BASE_VALUE_FL );
+    if( ( observer.speedDip >= pi.speedDip ) || ( observer.recovery >= pi.recovery )
+     || ( pi.recovery >= Q14BENCH_STEP_PERIODS ) || ( abs( observer.load - Q14BENCH_STEP_LOAD ) > Q14BENCH_STEP_LOAD_TOLERANCE ) )
+    {
+        result = 1;
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -0,0 +1,229 @@
+# coding: utf-8
+"""*****************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*****************************************************************************"""
+
+###################################################################################################
+########################### Build of the Q14 motor control library ################################
+###################################################################################################
+#
+# The Q2.14 fixed point library of the SAM C21 applications (q14_generic_mcLib and the ROLO
+# observer q14_rolo_mcLib) has a single source in ../src. The applications keep their own copy
+# so that every MPLAB X project stays self contained; --sync writes the copies and --check
+# fails when one of them differs from the source. The pmsm_foc component carries the
+# primitives in templates/mc_q14_lib.c/.h with Q14_ prefixed constants, which cannot be
+# copied: --sync and --check build q14_mclib_fork, which compares its results with those of
+# the library, and fail when they differ. That copy has to be ported by hand.
+#
+#   python3 q14_mclib_build.py [-o <output folder>] [--arch host|cortex-m0plus] [-D NAME[=value]] [target ...]
+#   python3 q14_mclib_build.py --sync | --check
+#
+# Targets: q14_mclib (static library), q14_mclib_bench (host microbenchmark, which also
+# builds the library) and q14_mclib_fork (host comparison with the pmsm_foc copy). The
+# cortex-m0plus build uses arm-none-eabi-gcc (or $CROSS_COMPILE) and prints the code size of
+# every library function.
+
+import argparse
+import filecmp
+import glob
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+q14Path = os.path.dirname(os.path.abspath(__file__))
+q14SourcePath = os.path.join(q14Path, "..", "src")
+q14AppsPath = os.path.join(q14Path, "..", "..", "..", "apps")
+q14ForkPath = os.path.join(q14Path, "..", "..", "pmsm_foc", "templates")
+
+q14GenericFiles = ["q14_generic_mcLib.c", "q14_generic_mcLib.h"]
+q14RoloFiles = ["q14_rolo_mcLib.c", "q14_rolo_mcLib.h"]
+
+# Applications using the library and the files they take from it. bldc_bc_hall_sam_c21 has a
+# different library under the same name and pmsm_foc_rolo_wm_sam_c21 its own observer.
+q14AppDict = { 'acim_vhz_sam_c21'              : q14GenericFiles,
+               'pmsm_foc_rolo_1shunt'          : q14GenericFiles + q14RoloFiles,
+               'pmsm_foc_rolo_fw_mtpa_sam_c21' : q14GenericFiles + q14RoloFiles,
+               'pmsm_foc_rolo_sam_c21'         : q14GenericFiles + q14RoloFiles,
+               'pmsm_foc_rolo_wm_sam_c21'      : q14GenericFiles,
+             }
+
+# Copy of the primitives in the pmsm_foc component, checked by q14_mclib_fork
+q14ForkFiles = ["mc_q14_lib.c", "mc_q14_lib.h"]
+
+q14ArchDict = { 'host'          : { 'CC'     : os.environ.get("CC", "gcc"),
+                                    'AR'     : os.environ.get("AR", "ar"),
+                                    'CFLAGS' : ["-O2"],
+                                  },
+                'cortex-m0plus' : { 'CC'     : os.environ.get("CROSS_COMPILE", "arm-none-eabi-") + "gcc",
+                                    'AR'     : os.environ.get("CROSS_COMPILE", "arm-none-eabi-") + "ar",
+                                    'NM'     : os.environ.get("CROSS_COMPILE", "arm-none-eabi-") + "nm",
+                                    'CFLAGS' : ["-mcpu=cortex-m0plus", "-mthumb", "-Os", "-ffunction-sections"],
+                                  },
+              }
+
+# The flags of pmsm_foc/host/mc_host_build.py, the optimization level is set per architecture
+q14CFlags = ["-std=gnu99", "-Wall", "-Wextra", "-Wno-missing-field-initializers"]
+
+###################################################################################################
+########################### Synchronization of the applications  ##################################
+###################################################################################################
+def q14AppFiles():
+    for app in sorted(q14AppDict.keys()):
+        for filename in q14AppDict[app]:
+            yield os.path.join(q14SourcePath, filename), os.path.join(q14AppsPath, app, "firmware", "src", filename)
+
+def q14ForkCheck():
+    # Built in a folder of its own, so that --check leaves no output behind
+    outputPath = tempfile.mkdtemp(prefix = "q14_mclib_fork_")
+    try:
+        executable = q14BuildFork(outputPath, "host", [])
+        result = subprocess.call([executable])
+    finally:
+        shutil.rmtree(outputPath)
+    if 0 != result:
+        for filename in q14ForkFiles:
+            print("Port by hand " + os.path.relpath(os.path.join(q14ForkPath, filename), os.path.join(q14Path, "..", "..")))
+    return result
+
+def q14Sync():
+    for source, destination in q14AppFiles():
+        if not os.path.isfile(destination) or not filecmp.cmp(source, destination, shallow = False):
+            print("Updating " + os.path.relpath(destination, q14AppsPath))
+            shutil.copyfile(source, destination)
+    return q14ForkCheck()
+
+def q14Check():
+    result = 0
+    for source, destination in q14AppFiles():
+        if not os.path.isfile(destination) or not filecmp.cmp(source, destination, shallow = False):
+            print("Out of date " + os.path.relpath(destination, q14AppsPath))
+            result = 1
+    if 0 != q14ForkCheck():
+        result = 1
+    print("Result                       : " + ("PASS" if 0 == result else "FAIL"))
+    return result
+
+###################################################################################################
+########################### Build   ###############################################################
+###################################################################################################
+def q14Compile(outputPath, arch, defines):
+    objectPath = os.path.join(outputPath, arch)
+    if not os.path.isdir(objectPath):
+        os.makedirs(objectPath)
+    objects = []
+    for source in sorted(glob.glob(os.path.join(q14SourcePath, "*.c"))):
+        objectFile = os.path.join(objectPath, os.path.splitext(os.path.basename(source))[0] + ".o")
+        command = [q14ArchDict[arch]['CC']] + q14ArchDict[arch]['CFLAGS'] + q14CFlags
+        command += ["-D" + define for define in defines]
+        command += ["-I" + q14Path, "-I" + q14SourcePath, "-c", source, "-o", objectFile]
+        subprocess.check_call(command)
+        objects.append(objectFile)
+    return objects
+
+def q14BuildLibrary(outputPath, arch, defines):
+    objects = q14Compile(outputPath, arch, defines)
+    library = os.path.join(outputPath, arch, "libq14_mclib.a")
+    if os.path.isfile(library):
+        os.remove(library)
+    print("Building " + library)
+    subprocess.check_call([q14ArchDict[arch]['AR'], "rcs", library] + objects)
+
+    # Code size per function, the numbers that matter for the 32 KB parts
+    if 'NM' in q14ArchDict[arch]:
+        output = subprocess.check_output([q14ArchDict[arch]['NM'], "--size-sort", "-S", "-t", "d", library])
+        for line in output.decode().splitlines():
+            fields = line.split()
+            if len(fields) == 4 and fields[2] in "tT":
+                print("%-36s %6d bytes" % (fields[3], int(fields[1])))
+    return library
+
+def q14BuildBench(outputPath, arch, defines):
+    if 'host' != arch:
+        raise SystemExit("q14_mclib_bench runs on the host only")
+    library = q14BuildLibrary(outputPath, arch, defines)
+    executable = os.path.join(outputPath, arch, "q14_mclib_bench")
+    command = [q14ArchDict[arch]['CC']] + q14ArchDict[arch]['CFLAGS'] + q14CFlags
+    command += ["-D" + define for define in defines]
+    command += ["-I" + q14Path, "-I" + q14SourcePath, os.path.join(q14Path, "q14_mclib_bench.c")]
+    command += [library, "-o", executable, "-lm"]
+    print("Building " + executable)
+    subprocess.check_call(command)
+    return executable
+
+def q14BuildFork(outputPath, arch, defines):
+    if 'host' != arch:
+        raise SystemExit("q14_mclib_fork runs on the host only")
+    objects = q14Compile(outputPath, arch, defines)
+
+    # The functions of the copy get the fork_ prefix, its tables are static
+    with open(os.path.join(q14ForkPath, "mc_q14_lib.h")) as f:
+        functions = re.findall(r"^\w+\s+(library_\w+)\s*\(", f.read(), re.MULTILINE)
+    forkObject = os.path.join(outputPath, arch, "mc_q14_lib.o")
+    command = [q14ArchDict[arch]['CC']] + q14ArchDict[arch]['CFLAGS'] + q14CFlags
+    command += ["-D" + function + "=fork_" + function for function in functions]
+    command += ["-I" + q14Path, "-I" + q14ForkPath, "-c", os.path.join(q14ForkPath, "mc_q14_lib.c"), "-o", forkObject]
+    subprocess.check_call(command)
+
+    executable = os.path.join(outputPath, arch, "q14_mclib_fork")
+    command = [q14ArchDict[arch]['CC']] + q14ArchDict[arch]['CFLAGS'] + q14CFlags
+    command += ["-D" + define for define in defines]
+    command += ["-I" + q14Path, "-I" + q14SourcePath, os.path.join(q14Path, "q14_mclib_fork.c")]
+    command += objects + [forkObject, "-o", executable, "-lm"]
+    print("Building " + executable)
+    subprocess.check_call(command)
+    return executable
+
+q14TargetDict = { 'q14_mclib'       : q14BuildLibrary,
+                  'q14_mclib_bench' : q14BuildBench,
+                  'q14_mclib_fork'  : q14BuildFork,
+                }
+
+def main():
+    parser = argparse.ArgumentParser(description = "Build of the Q14 motor control library")
+    parser.add_argument("-o", "--output", default = "q14_mclib_out", help = "output folder")
+    parser.add_argument("--arch", choices = sorted(q14ArchDict.keys()), default = "host", help = "target architecture")
+    parser.add_argument("-D", "--define", action = "append", default = [], help = "preprocessor define NAME[=value]")
+    parser.add_argument("--sync", action = "store_true", help = "copy the library into the applications")
+    parser.add_argument("--check", action = "store_true", help = "check that the applications are in sync")
+    parser.add_argument("targets", nargs = "*", help = "targets to build (default: q14_mclib_bench for the host, q14_mclib otherwise)")
+    args = parser.parse_args()
+
+    if args.sync:
+        return q14Sync()
+    if args.check:
+        return q14Check()
+
+    if args.targets:
+        targets = args.targets
+    elif 'host' == args.arch:
+        targets = ["q14_mclib_bench"]
+    else:
+        targets = ["q14_mclib"]
+    for target in targets:
+        q14TargetDict[target](args.output, args.arch, args.define)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
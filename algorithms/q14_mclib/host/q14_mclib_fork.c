@@ -0,0 +1,299 @@
+/*******************************************************************************
+ Q14 Motor Control Library Fork Check source file
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    q14_mclib_fork.c
+
+  Summary:
+    Comparison of the pmsm_foc copy of the Q14 primitives with the library
+
+  Description:
+    The Q2.14 backend of the pmsm_foc component carries the primitives of
+    q14_generic_mcLib.c in templates/mc_q14_lib.c, rewritten with Q14_
+    prefixed constants which do not collide with those of mc_derivedparams.h,
+    so that --sync cannot copy them. q14_mclib_build.py compiles that file
+    with the fork_ prefix on every library_* name and links it with the
+    library. This file calls both implementations with the same inputs and
+    counts the results which differ: all angles for the trigonometric
+    functions, all cosines for library_sinarcos, grids over the int16 range
+    for library_atan2 and library_scat, pseudo random vectors for the
+    transformations and pseudo random errors and gains for the PI control.
+
+    Usage: q14_mclib_fork
+ *******************************************************************************/
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+* Copyright (C) 2020 Microchip Technology Inc. and its subsidiaries.
+*
+* Subject to your compliance with these terms, you may use Microchip software
+* and any derivatives exclusively with Microchip products. It is your
+* responsibility to comply with third party license terms applicable to your
+* use of third party software (including open source software) that may
+* accompany Microchip software.
+*
+* THIS SOFTWARE IS SUPPLIED BY MICROCHIP "AS IS". NO WARRANTIES, WHETHER
+* EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED
+* WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS FOR A
+* PARTICULAR PURPOSE.
+*
+* IN NO EVENT WILL MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+* INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+* WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS
+* BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE
+* FULLEST EXTENT ALLOWED BY LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS IN
+* ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT OF FEES, IF ANY,
+* THAT YOU HAVE PAID DIRECTLY TO MICROCHIP FOR THIS SOFTWARE.
+*******************************************************************************/
+// DOM-IGNORE-END
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Included Files
+// *****************************************************************************
+// *****************************************************************************
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "definitions.h"
+#include "q14_generic_mcLib.h"
+
+// *****************************************************************************
+// *****************************************************************************
+// Section: Data Types
+// *****************************************************************************
+// *****************************************************************************
+#define     Q14FORK_VECTORS                 (1000000U)
+#define     Q14FORK_GRID_STEP               (97)
+#define     Q14FORK_PI_SETS                 (64U)
+#define     Q14FORK_PI_STEPS                (4096U)
+
+typedef struct
+{
+    const char *                    name;
+    uint32_t                        (*compare)( uint32_t * const pInputs );  /* number of differences */
+}tQ14FORK_FUNCTION_S;
+
+/******************************************************************************/
+/*                   Global Variables                                         */
+/******************************************************************************/
+static uint32_t gQ14FORK_Seed = 12345U;
+
+/******************************************************************************/
+/*              pmsm_foc copy, templates/mc_q14_lib.c                         */
+/******************************************************************************/
+int16_t fork_library_sin( uint16_t ang );
+int16_t fork_library_cos( uint16_t ang );
+void fork_library_sincos( ang_sincos_t *t );
+int16_t fork_library_sinarcos( int16_t x );
+uint16_t fork_library_atan2( int16_t x, int16_t y );
+int16_t fork_library_scat( int16_t hypo, int16_t fcat );
+void fork_library_uvw_ab( const vec3_t *uvw, vec2_t *ab );
+void fork_library_ab_uvw( const vec2_t *ab, vec3_t *uvw );
+void fork_library_ab_dq( const ang_sincos_t *t, const vec2_t *ab, vec2_t *dq );
+void fork_library_dq_ab( const ang_sincos_t *t, const vec2_t *dq, vec2_t *ab );
+void fork_library_xy_rt( const vec2_t *xy, vecp_t *rt );
+void fork_library_rt_xy( const vecp_t *rt, vec2_t *xy );
+int16_t fork_library_pi_control( int32_t erl, pi_cntrl_t *pi );
+
+/******************************************************************************/
+/*                          LOCAL FUNCTIONS                                   */
+/******************************************************************************/
+static uint16_t Q14FORK_Random( void )
+{
+    gQ14FORK_Seed = ( gQ14FORK_Seed * 1664525U ) + 1013904223U;
+    return (uint16_t)( gQ14FORK_Seed >> 16 );
+}
+
+/* Vector with an amplitude up to 1.5, the range of the control signals */
+static void Q14FORK_Vector( vec2_t * const v )
+{
+    ang_sincos_t t;
+    int32_t amplitude;
+
+    t.ang = Q14FORK_Random();
+    library_sincos( &t );
+    amplitude = (int32_t)( Q14FORK_Random() % 24576U );
+    v->x = (int16_t)( ( amplitude * t.cos ) >> SH_BASE_VALUE );
+    v->y = (int16_t)( ( amplitude * t.sin ) >> SH_BASE_VALUE );
+}
+
+static uint32_t Q14FORK_SinCos( uint32_t * const pInputs )
+{
+    ang_sincos_t t, f;
+    uint32_t ang, differences = 0U;
+
+    for( ang = 0U; ang < 65536U; ang++ )
+    {
+        t.ang = (uint16_t)ang;
+        f.ang = (uint16_t)ang;
+        library_sincos( &t );
+        fork_library_sincos( &f );
+        differences += ( ( t.sin != f.sin ) || ( t.cos != f.cos )
+                      || ( library_sin( (uint16_t)ang ) != fork_library_sin( (uint16_t)ang ) )
+                      || ( library_cos( (uint16_t)ang ) != fork_library_cos( (uint16_t)ang ) ) ) ? 1U : 0U;
+    }
+    *pInputs = 65536U;
+    return differences;
+}
+
+static uint32_t Q14FORK_SinArcos( uint32_t * const pInputs )
+{
+    int32_t x;
+    uint32_t differences = 0U;
+
+    for( x = -32768; x < 32768; x++ )
+    {
+        differences += ( library_sinarcos( (int16_t)x ) != fork_library_sinarcos( (int16_t)x ) ) ? 1U : 0U;
+    }
+    *pInputs = 65536U;
+    return differences;
+}
+
+static uint32_t Q14FORK_Atan2( uint32_t * const pInputs )
+{
+    int32_t x, y;
+    uint32_t inputs = 0U, differences = 0U;
+
+    for( x = -32767; x < 32768; x += Q14FORK_GRID_STEP )
+    {
+        for( y = -32767; y < 32768; y += Q14FORK_GRID_STEP )
+        {
+            differences += ( library_atan2( (int16_t)x, (int16_t)y ) != fork_library_atan2( (int16_t)x, (int16_t)y ) ) ? 1U : 0U;
+            inputs++;
+        }
+    }
+    *pInputs = inputs;
+    return differences;
+}
+
+static uint32_t Q14FORK_Scat( uint32_t * const pInputs )
+{
+    int32_t hypo, fcat;
+    uint32_t inputs = 0U, differences = 0U;
+
+    for( hypo = 0; hypo < 32768; hypo += Q14FORK_GRID_STEP )
+    {
+        for( fcat = -32767; fcat < 32768; fcat += Q14FORK_GRID_STEP )
+        {
+            differences += ( library_scat( (int16_t)hypo, (int16_t)fcat ) != fork_library_scat( (int16_t)hypo, (int16_t)fcat ) ) ? 1U : 0U;
+            inputs++;
+        }
+    }
+    *pInputs = inputs;
+    return differences;
+}
+
+static uint32_t Q14FORK_Transformations( uint32_t * const pInputs )
+{
+    ang_sincos_t t;
+    vec3_t uvw, uvwLib, uvwFork;
+    vec2_t v, lib, fork;
+    vecp_t rt, rtLib, rtFork;
+    uint32_t i, differences = 0U;
+
+    for( i = 0U; i < Q14FORK_VECTORS; i++ )
+    {
+        Q14FORK_Vector( &v );
+        t.ang = Q14FORK_Random();
+        library_sincos( &t );
+
+        /* Balanced three phase quantities of the vector */
+        library_ab_uvw( &v, &uvw );
+        library_uvw_ab( &uvw, &lib );
+        fork_library_uvw_ab( &uvw, &fork );
+        differences += ( ( lib.x != fork.x ) || ( lib.y != fork.y ) ) ? 1U : 0U;
+        library_ab_uvw( &v, &uvwLib );
+        fork_library_ab_uvw( &v, &uvwFork );
+        differences += ( ( uvwLib.u != uvwFork.u ) || ( uvwLib.v != uvwFork.v ) || ( uvwLib.w != uvwFork.w ) ) ? 1U : 0U;
+
+        library_ab_dq( &t, &v, &lib );
+        fork_library_ab_dq( &t, &v, &fork );
+        differences += ( ( lib.x != fork.x ) || ( lib.y != fork.y ) ) ? 1U : 0U;
+        library_dq_ab( &t, &v, &lib );
+        fork_library_dq_ab( &t, &v, &fork );
+        differences += ( ( lib.x != fork.x ) || ( lib.y != fork.y ) ) ? 1U : 0U;
+
+        library_xy_rt( &v, &rtLib );
+        fork_library_xy_rt( &v, &rtFork );
+        differences += ( ( rtLib.r != rtFork.r ) || ( rtLib.t.ang != rtFork.t.ang )
+                      || ( rtLib.t.sin != rtFork.t.sin ) || ( rtLib.t.cos != rtFork.t.cos ) ) ? 1U : 0U;
+        rt.r = (uint16_t)( Q14FORK_Random() % 24576U );
+        rt.t = t;
+        library_rt_xy( &rt, &lib );
+        fork_library_rt_xy( &rt, &fork );
+        differences += ( ( lib.x != fork.x ) || ( lib.y != fork.y ) ) ? 1U : 0U;
+    }
+    *pInputs = 6U * Q14FORK_VECTORS;
+    return differences;
+}
+
+static uint32_t Q14FORK_PIControl( uint32_t * const pInputs )
+{
+    pi_cntrl_t lib, fork;
+    int32_t erl;
+    int16_t limit;
+    uint32_t set, step, differences = 0U;
+
+    for( set = 0U; set < Q14FORK_PI_SETS; set++ )
+    {
+        limit = (int16_t)( 1024U + ( Q14FORK_Random() % 31744U ) );
+        lib.kp = (int16_t)( Q14FORK_Random() & 0x7FFFU );
+        lib.shp = (uint16_t)( 8U + ( Q14FORK_Random() % 8U ) );
+        lib.ki = (int16_t)( Q14FORK_Random() & 0x7FFFU );
+        lib.shi = (uint16_t)( Q14FORK_Random() % 12U );
+        lib.hlim = limit;
+        lib.llim = (int16_t)-limit;
+        lib.imem = 0;
+        fork = lib;
+        for( step = 0U; step < Q14FORK_PI_STEPS; step++ )
+        {
+            /* Errors beyond the int16 range exercise the preliminary clamp */
+            erl = (int32_t)(int16_t)Q14FORK_Random() * ( ( 0U == ( step & 7U ) ) ? 3 : 1 );
+            differences += ( ( library_pi_control( erl, &lib ) != fork_library_pi_control( erl, &fork ) )
+                          || ( lib.imem != fork.imem ) ) ? 1U : 0U;
+        }
+    }
+    *pInputs = Q14FORK_PI_SETS * Q14FORK_PI_STEPS;
+    return differences;
+}
+
+static const tQ14FORK_FUNCTION_S gQ14FORK_Functions[] =
+{
+    { "library_sin/cos/sincos", Q14FORK_SinCos          },
+    { "library_sinarcos",       Q14FORK_SinArcos        },
+    { "library_atan2",          Q14FORK_Atan2           },
+    { "library_scat",           Q14FORK_Scat            },
+    { "transformations",        Q14FORK_Transformations },
+    { "library_pi_control",     Q14FORK_PIControl       },
+};
+
+/******************************************************************************/
+/*                      INTERFACE FUNCTIONS                                   */
+/******************************************************************************/
+int main( void )
+{
+    uint32_t i, inputs, differences;
+    int result = 0;
+
+    printf( "Q14 motor control library %u.%u against pmsm_foc templates/mc_q14_lib.c\n",
+            (unsigned)Q14_MCLIB_VERSION_MAJOR, (unsigned)Q14_MCLIB_VERSION_MINOR );
+    printf( "%-24s %10s %12s\n", "Function", "inputs", "differences" );
+    for( i = 0U; i < ( sizeof( gQ14FORK_Functions ) / sizeof( gQ14FORK_Functions[0] ) ); i++ )
+    {
+        differences = gQ14FORK_Functions[i].compare( &inputs );
+        printf( "%-24s %10u %12u\n", gQ14FORK_Functions[i].name, (unsigned)inputs, (unsigned)differences );
+        if( 0U != differences )
+        {
+            result = 1;
+        }
+    }
+    printf( "Result                       : %s\n", ( 0 == result ) ? "PASS" : "FAIL" );
+    return result;
+}
+
+/*******************************************************************************
+ End of File
+*/
@@ -2,7 +2,7 @@
   System Definitions
 
   File Name:
-    q14_vhz_mcLib.h
+    q14_generic_mcLib.h
 
   Summary:
     Header file which contains variables and function prototypes for Motor Control.
@@ -10,6 +10,9 @@
   Description:
     This file contains variables and function prototypes which are generally used in Motor Control.
     Implemented in Q2.14 Fixed Point Arithmetic.
+
+    Single source of the ROLO observer of the SAM C21 applications, see
+    algorithms/q14_mclib/readme.md.
  *******************************************************************************/
 
 //DOM-IGNORE-BEGIN
@@ -37,13 +40,16 @@
  *******************************************************************************/
 //DOM-IGNORE-END
 
-#ifndef Q14_VHZ_MCLIB_H
-#define Q14_VHZ_MCLIB_H
+#ifndef Q14_ROLO_MCLIB_H
+#define Q14_ROLO_MCLIB_H
 
 /*******************************************************************************
 Macro definitions
 *******************************************************************************/
+/*	observer gain, which places the observer pole; can be overridden in userparams.h */
+#ifndef OBS_H_GAIN
 #define	OBS_H_GAIN			( 0.2f )				/* RANGE: 0.2 - 0.5 */
+#endif
 #define	OBS_C0_GAIN			( 1.0f - OBS_H_GAIN )	/* > 0 */
 #define	OBS_MINFREQ_HZ		( 3.0f )
 #define	OBS_MINSPEED_R_S	((float32_t)(2.0f * FLOAT_PI * OBS_MINFREQ_HZ))
@@ -57,9 +63,18 @@ Macro definitions
 
 /*	only the cross-coupling coefficients are speed dependent, and their value is usually
 	much lesser than the others; so in first approximation they could be neglected, saving
-	a lot of computation time; furthermore, neglecting them could lead to a higher noise immunity */
-/* uncomment the following macro to enable the cross-coupling observer terms */
-// #define CROSS_COUPLING_ENABLED 
+	a lot of computation time; furthermore, neglecting them could lead to a higher noise immunity.
+	define OBS_NO_CROSS_COUPLING in userparams.h to neglect them */
+#ifndef OBS_NO_CROSS_COUPLING
+#define CROSS_COUPLING_ENABLED
+#endif
+
+/*	medium delay of the estimation in half sampling periods, compensated by delay_comp:
+	2 (1 sampling period, PMSM applications) or 3 (1.5 sampling periods, V/Hz variant).
+	can be overridden in userparams.h */
+#ifndef OBS_DELAY_HALF_PERIODS
+#define OBS_DELAY_HALF_PERIODS	( 2 )
+#endif
 
 /* uncomment the following macro to enable amplification clamping */
 /* #define AMP_CLAMP */
@@ -68,7 +83,7 @@ Macro definitions
 Type definitions
 *******************************************************************************/
 
-/*	to make the calculations with enought resolution, the coefficients are represented
+/*	to make the calculations with enough resolution, the coefficients are represented
 	with an amplified value and the number of amplification shifts */
 typedef struct
 {
@@ -147,6 +162,19 @@ int16_t get_angular_speed(void);
 #endif
 
 
+/******************************************************************************
+Function:		get_Bemf_magnitude
+Description:	returns the back emf magnitude
+Input:			nothing
+Output:			estimated back emf amplitude
+******************************************************************************/
+#ifdef RAM_EXECUTE
+uint16_t __ramfunc__ get_Bemf_magnitude(void);
+#else
+uint16_t get_Bemf_magnitude(void);
+#endif
+
+
 /*******************************************************************************
 Private functions declaration
 *******************************************************************************/
@@ -217,7 +245,7 @@ void phase_estimation(void);
 #endif
 /*******************************************************************************
 Function:		phase_estimation_init
-Description:	init rouitine for use of phase estimation
+Description:	init routine for use of phase estimation
 Input:			nothing (uses global variable bemf vector)
 Output:			nothing (modifies global variable flx_arg)
 *******************************************************************************/
@@ -255,4 +283,4 @@ uint16_t __ramfunc__ delay_comp(void);
 uint16_t delay_comp(void);
 #endif
 
-#endif // Q14_VHZ_MCLIB_H
+#endif // Q14_GENERIC_MCLIB_H
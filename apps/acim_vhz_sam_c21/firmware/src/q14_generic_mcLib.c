@@ -51,7 +51,6 @@ Headers inclusions
 #include "definitions.h"
 #include "userparams.h"
 
-int16_t result_soft,result_divas;
 /*******************************************************************************
 Macro definitions
 *******************************************************************************/
@@ -228,7 +227,7 @@ int16_t library_cos(uint16_t ang)
 {
 	uint16_t	a;
 	int16_t		y;
-    uint16_t  ang_temp;
+        uint16_t  ang_temp;
 
 	/* overflow is OK here due to angle periodicity */
 	ang_temp = ang + PIHALVES;
@@ -423,7 +422,7 @@ uint16_t library_atan2(int16_t x, int16_t y)
 /******************************************************************************
 Function:		library_scat
 Description:	calculation of the second cathetus of a right angled triangle
-				(Pitagora theorem)
+				(pythagoras theorem)
 Input:			hypotenuse hypo
 				first cathetus fcat
 Output:			second cathetus
@@ -431,7 +430,7 @@ Notes:			if the first cathetus is negative, its absolute value is
 				considered;
 				if the first cathetus absolute value is greater or equal than
 				the hypotenuse, the result will be zero (as a consequence, if
-				the hypothenuse is zero or negative, the result will be zero)
+				the hypotenuse is zero or negative, the result will be zero)
 ******************************************************************************/
 #ifdef RAM_EXECUTE
 int16_t  __ramfunc__ library_scat(int16_t hypo, int16_t fcat)
@@ -477,7 +476,7 @@ Input:			uvw, input vector structure address
 				ab, output vector structure address
 Output:			nothing
 Modifies:		x (a), y (b) components of ab vector
-Note:			no limitation (omopolar component kept into account)
+Note:			no limitation (homopolar component kept into account)
 Revision:		1.0
 ******************************************************************************/
 #ifdef RAM_EXECUTE
@@ -786,3 +785,75 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 	}
         return(s16t);
 }
+
+/******************************************************************************
+Function:		library_load_observer
+Description:	Load torque observer of the speed loop
+Input:			measured speed
+				measured q current iq (the reference if it is not voltage limited)
+				pointer to the load observer structure lo
+Output:			load current estimate
+Modifies:		speed and load memories smem and lmem of the observer
+******************************************************************************/
+#ifdef RAM_EXECUTE
+int16_t __ramfunc__ library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#else
+int16_t library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#endif
+{
+	int32_t s32e, s32d, s32l;
+
+	/* speed estimate error, rounded to the speed unit and clamped */
+	s32e = ((int32_t)speed << SH_LOBS_MEM) - (lo->smem);
+	s32e += (int32_t)1 << (SH_LOBS_MEM - 1U);
+	s32e >>= SH_LOBS_MEM;
+	if(32767 < s32e)
+	{
+		s32e = 32767;
+	}
+	else if(-32767 > s32e)
+	{
+		s32e = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* accelerating current, clamped */
+	s32l = (lo->lmem) >> SH_LOBS_MEM;
+	s32d = (int32_t)iq - s32l;
+	if(32767 < s32d)
+	{
+		s32d = 32767;
+	}
+	else if(-32767 > s32d)
+	{
+		s32d = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* speed estimate */
+	(lo->smem) += (s32d * (int32_t)(lo->kb)) >> ((lo->shb) - SH_LOBS_MEM);
+	(lo->smem) += (s32e * (int32_t)(lo->ks)) >> ((lo->shs) - SH_LOBS_MEM);
+
+	/* load current estimate and clamp */
+	(lo->lmem) -= (s32e * (int32_t)(lo->kl)) >> ((lo->shl) - SH_LOBS_MEM);
+	s32l = (int32_t)(lo->lim) << SH_LOBS_MEM;
+	if(s32l < (lo->lmem))
+	{
+		(lo->lmem) = s32l;
+	}
+	else if(-s32l > (lo->lmem))
+	{
+		(lo->lmem) = -s32l;
+	}
+	else
+	{
+		/* no action */
+	}
+	return((int16_t)((lo->lmem) >> SH_LOBS_MEM));
+}
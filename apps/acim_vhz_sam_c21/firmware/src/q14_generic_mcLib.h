@@ -10,6 +10,10 @@
   Description:
     This file contains variables and function prototypes which are generally used in Motor Control.
     Implemented in Q2.14 Fixed Point Arithmetic.
+
+    Single source of the Q14 library of the SAM C21 applications, see
+    algorithms/q14_mclib/readme.md. Edit this copy and synchronize the
+    applications with q14_mclib_build.py --sync.
  *******************************************************************************/
 
 //DOM-IGNORE-BEGIN
@@ -47,6 +51,11 @@
 Macro definitions and typedefs
 ******************************************************************************/
 
+/* library version */
+#define Q14_MCLIB_VERSION_MAJOR		( 1U )
+#define Q14_MCLIB_VERSION_MINOR		( 2U )
+#define Q14_MCLIB_VERSION			( ( Q14_MCLIB_VERSION_MAJOR << 8U ) | Q14_MCLIB_VERSION_MINOR )
+
 typedef float   float32_t;
 
 /* pi */
@@ -177,6 +186,28 @@ typedef struct
 	int32_t			imem;	// integral term memory
 }	pi_cntrl_t;
 
+/* load observer structure, gains are k / 2^sh with sh >= SH_LOBS_MEM */
+#define SH_LOBS_MEM		( 15U )			// observer memories amplification
+typedef struct
+{
+	int16_t			kb;		// speed change per q current and period
+	uint16_t		shb;	// kb shifts down
+	int16_t			ks;		// speed estimate correction gain
+	uint16_t		shs;	// ks shifts down
+	int16_t			kl;		// load current estimate correction gain
+	uint16_t		shl;	// kl shifts down
+	int16_t			lim;	// load current clamp value
+	int32_t			smem;	// speed estimate memory
+	int32_t			lmem;	// load current estimate memory
+}	load_obs_t;
+
+/* PI control intermediate values, for monitoring */
+typedef struct
+{
+	int32_t			s32i, s32p, s32t;
+	int16_t			s16e, s16t;
+}	pi_cntrl_iv_t;
+
 /* measurement units conversion constants (referred to internal representation
 	of physical quantities) */
 #define K_ANGLE		((float32_t)(TWOPI / (2.0 * FLOAT_PI)))
@@ -261,7 +292,7 @@ uint16_t library_atan2(int16_t x, int16_t y);
 /******************************************************************************
 Function:		library_scat
 Description:	calculation of the second cathetus of a right angled triangle
-				(Pitagora theorem)
+				(pythagoras theorem)
 Input:			hypotenuse hypo
 				first cathetus fcat
 Output:			second cathetus
@@ -269,7 +300,7 @@ Notes:			if the first cathetus is negative, its absolute value is
 				considered;
 				if the first cathetus absolute value is greater or equal than
 				the hypotenuse, the result will be zero (as a consequence, if
-				the hypothenuse is zero or negative, the result will be zero)
+				the hypotenuse is zero or negative, the result will be zero)
 ******************************************************************************/
 #ifdef RAM_EXECUTE
 int16_t __ramfunc__ library_scat(int16_t hypo, int16_t fcat);
@@ -289,7 +320,7 @@ Input:			uvw, input vector structure address
 				ab, output vector structure address
 Output:			nothing
 Modifies:		x (a), y (b) components of ab vector
-Note:			no limitation (omopolar component kept into account)
+Note:			no limitation (homopolar component kept into account)
 Revision:		1.0
 ******************************************************************************/
 #ifdef RAM_EXECUTE
@@ -395,6 +426,23 @@ int16_t __ramfunc__ library_pi_control(int32_t erl, pi_cntrl_t *pi);
 int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi);
 #endif
 
+/******************************************************************************
+Function:		library_load_observer
+Description:	Load torque observer of the speed loop, the load torque is
+				estimated as the q current which balances it:
+				speed' = kb * (iq - load), load' = 0
+Input:			measured speed
+				measured q current iq (the reference if it is not voltage limited)
+				pointer to the load observer structure lo
+Output:			load current estimate, |load| <= lim
+Modifies:		speed and load memories of the observer
+******************************************************************************/
+#ifdef RAM_EXECUTE
+int16_t __ramfunc__ library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo);
+#else
+int16_t library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo);
+#endif
+
 /* END OF CONTROL FUNCTIONS *************************************************/
 
 
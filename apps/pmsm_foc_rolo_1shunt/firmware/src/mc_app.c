@@ -160,6 +160,14 @@ pi_cntrl_t
     iq_pi,
     sp_pi;
 
+#ifdef LOAD_OBSERVER
+/* load torque observer of the speed control */
+load_obs_t
+    lo_obs;
+int16_t
+    lo_cur;     /* load current estimate [internal current unit] */
+#endif
+
 int16_t
     spe_ref_sgn,  /* speed reference sign (speed_ramp routine output) */
     ref_sgn,      /* speed reference sign (speed_ramp routine input, 
@@ -418,6 +426,20 @@ void motorcontrol_vars_init(void)
   sp_pi.hlim = 0;
   sp_pi.llim = 0;
 
+#ifdef LOAD_OBSERVER
+    /* load observer gains */
+  lo_obs.kb = KB_LOBS;
+  lo_obs.shb = (uint16_t)SH_LOBS;
+  lo_obs.ks = KS_LOBS;
+  lo_obs.shs = (uint16_t)SH_LOBS;
+  lo_obs.kl = KL_LOBS;
+  lo_obs.shl = (uint16_t)SH_LOBS;
+  lo_obs.lim = 0;
+  lo_obs.smem = 0;
+  lo_obs.lmem = 0;
+  lo_cur = 0;
+#endif
+
   /* */
   state_run = 0;
   ext_speed_ref_rpm = 0;
@@ -1919,6 +1941,11 @@ void motorcontrol(void)
                 /* speed PI control memory setting */
                 sp_pi.imem = curdqr.y;
                 sp_pi.imem <<= sp_pi.shp;  /* speed PI integral term */
+                #ifdef LOAD_OBSERVER
+                /* load observer from the estimated speed, without load */
+                lo_obs.smem = (int32_t)get_angular_speed() << SH_LOBS_MEM;
+                lo_obs.lmem = 0;
+                #endif
                 /* position loss control reset */
                 pos_lost_control_reset();
 
@@ -1979,7 +2006,16 @@ void motorcontrol(void)
                 #ifdef TORQUE_MODE
                 curdqr.y = torque_adc_ref;
                 #else // Speed Control
-                curdqr.y = library_pi_control(s32a, &sp_pi); 
+                #ifdef LOAD_OBSERVER
+                /* load current estimate from the measured q current fed forward, the speed control limits leave room for it */
+                lo_obs.lim = sp_pi.hlim;
+                lo_cur = library_load_observer(elespeed, curdqm.y, &lo_obs);
+                sp_pi.hlim -= lo_cur;
+                sp_pi.llim -= lo_cur;
+                curdqr.y = library_pi_control(s32a, &sp_pi) + lo_cur;
+                #else
+                curdqr.y = library_pi_control(s32a, &sp_pi);
+                #endif
                 #endif
 
                 curdqr.x = 0 ; 
@@ -2142,6 +2178,10 @@ void motorcontrol(void)
         id_pi.imem = 0;
         iq_pi.imem = 0;
         sp_pi.imem = 0;
+#ifdef LOAD_OBSERVER
+        lo_obs.lmem = 0;
+        lo_cur = 0;
+#endif
 
         outvdq.x = 0;
         outvdq.y = 0;
@@ -51,7 +51,6 @@ Headers inclusions
 #include "definitions.h"
 #include "userparams.h"
 
-int16_t result_soft,result_divas;
 /*******************************************************************************
 Macro definitions
 *******************************************************************************/
@@ -786,3 +785,75 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 	}
         return(s16t);
 }
+
+/******************************************************************************
+Function:		library_load_observer
+Description:	Load torque observer of the speed loop
+Input:			measured speed
+				measured q current iq (the reference if it is not voltage limited)
+				pointer to the load observer structure lo
+Output:			load current estimate
+Modifies:		speed and load memories smem and lmem of the observer
+******************************************************************************/
+#ifdef RAM_EXECUTE
+int16_t __ramfunc__ library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#else
+int16_t library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#endif
+{
+	int32_t s32e, s32d, s32l;
+
+	/* speed estimate error, rounded to the speed unit and clamped */
+	s32e = ((int32_t)speed << SH_LOBS_MEM) - (lo->smem);
+	s32e += (int32_t)1 << (SH_LOBS_MEM - 1U);
+	s32e >>= SH_LOBS_MEM;
+	if(32767 < s32e)
+	{
+		s32e = 32767;
+	}
+	else if(-32767 > s32e)
+	{
+		s32e = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* accelerating current, clamped */
+	s32l = (lo->lmem) >> SH_LOBS_MEM;
+	s32d = (int32_t)iq - s32l;
+	if(32767 < s32d)
+	{
+		s32d = 32767;
+	}
+	else if(-32767 > s32d)
+	{
+		s32d = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* speed estimate */
+	(lo->smem) += (s32d * (int32_t)(lo->kb)) >> ((lo->shb) - SH_LOBS_MEM);
+	(lo->smem) += (s32e * (int32_t)(lo->ks)) >> ((lo->shs) - SH_LOBS_MEM);
+
+	/* load current estimate and clamp */
+	(lo->lmem) -= (s32e * (int32_t)(lo->kl)) >> ((lo->shl) - SH_LOBS_MEM);
+	s32l = (int32_t)(lo->lim) << SH_LOBS_MEM;
+	if(s32l < (lo->lmem))
+	{
+		(lo->lmem) = s32l;
+	}
+	else if(-s32l > (lo->lmem))
+	{
+		(lo->lmem) = -s32l;
+	}
+	else
+	{
+		/* no action */
+	}
+	return((int16_t)((lo->lmem) >> SH_LOBS_MEM));
+}
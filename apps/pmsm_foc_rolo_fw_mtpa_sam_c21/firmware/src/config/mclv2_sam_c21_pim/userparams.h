@@ -72,6 +72,19 @@
 /*Defining USE_DIVAS uses the DIVAS peripheral for division and square root operatons*/
 #define USE_DIVAS
 
+/* Defining LOAD_OBSERVER estimates the load torque from the q current reference and the estimated speed
+ and feeds it forward to the speed control, which reduces the speed dip at load steps.
+ Undefining LOAD_OBSERVER keeps the speed PI control alone */
+#undef LOAD_OBSERVER
+#define KT_NM_A         (  0.06   )     /* torque constant [Nm/A peak], 1.5 * POLAR_COUPLES * magnet flux [Wb] */
+#define INERTIA_KGM2    (  8.0e-6 )     /* inertia of the rotor and the load [kg m^2] */
+#define LOBS_BW_RS      (  100.0  )     /* load observer bandwidth [rad/s] */
+
+/* Defining DISCONTINUOUS_PWM clamps the phase with the lowest voltage to the negative rail (2-phase modulation)
+ above the modulation index DPWM_MIN_MOD_INDEX, which saves a third of the switching events.
+ Undefining DISCONTINUOUS_PWM keeps the center-aligned modulation at every modulation index */
+#undef DISCONTINUOUS_PWM
+
 /*******************************************************************************
 Macro definitions
 *******************************************************************************/
@@ -226,6 +239,10 @@ Macro definitions
 #define K_MODLOSSES     ((DELMAX_TICKS_FL) / (float32_t)PWM_HPER_TICKS)
 /* linear modulation */
 #define K_AVAIL_VOL     ((int16_t)(K_MODLOSSES * (float32_t)ONEBYSQRT3))
+/* discontinuous modulation above this ratio of the linear range, with hysteresis */
+#define DPWM_MIN_MOD_INDEX  (0.5f)
+#define K_DPWM_ON       ((int16_t)((float32_t)K_AVAIL_VOL * (DPWM_MIN_MOD_INDEX + 0.05f)))
+#define K_DPWM_OFF      ((int16_t)((float32_t)K_AVAIL_VOL * (DPWM_MIN_MOD_INDEX - 0.05f)))
 /* over modulation */
 /*#define K_AVAIL_VOL     ((int16_t)(K_MODLOSSES * TWOTHIRDS))*/
 /* maximum voltage readable by the A/D converter */
@@ -391,6 +408,15 @@ Macro definitions
 #define SH_INTS         (  6U )
 #define KP_SPE          ((int16_t)(KP_SPEPIF * (float32_t)(((uint16_t)1 << (uint16_t)SH_PROS))))
 #define KI_SPE          ((int16_t)(KI_SPEPIF * (float32_t)(((uint32_t)1 << (uint32_t)(SH_INTS + SH_PROS)))))
+
+/* load observer: speed change per q current and sampling period, observer pole per period */
+#define KB_LOBSF        ((K_SPEED * (float32_t)POLAR_COUPLES * (float32_t)KT_NM_A / (K_CURRENT * K_TIME * (float32_t)INERTIA_KGM2)))
+#define POLE_LOBSF      ((float32_t)LOBS_BW_RS / K_TIME)
+/* gains shift, KB_LOBSF and 2 * POLE_LOBSF have to be below 0.125 */
+#define SH_LOBS         ( 18U )
+#define KB_LOBS         ((int16_t)(KB_LOBSF * (float32_t)((uint32_t)1 << SH_LOBS)))
+#define KS_LOBS         ((int16_t)(2.0f * POLE_LOBSF * (float32_t)((uint32_t)1 << SH_LOBS)))
+#define KL_LOBS         ((int16_t)(POLE_LOBSF * POLE_LOBSF / KB_LOBSF * (float32_t)((uint32_t)1 << SH_LOBS)))
 /* conversion constant current[mA] = K_INTCUR2MA * current[internal current unit] */
 #define K_INTCUR2MA     ((uint16_t)(BASE_VALUE_FL * 1000.0f / K_CURRENT))
 /* conversion constant voltage[V/10] = K_INTVOL2DV * voltage[internal voltage unit] */
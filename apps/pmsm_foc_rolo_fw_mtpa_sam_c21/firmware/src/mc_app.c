@@ -199,6 +199,14 @@ pi_cntrl_t
     iq_pi,
     sp_pi;
 
+#ifdef LOAD_OBSERVER
+/* load torque observer of the speed control */
+load_obs_t
+    lo_obs;
+int16_t
+    lo_cur;     /* load current estimate [internal current unit] */
+#endif
+
 int16_t
     spe_ref_sgn,  /* speed reference sign (speed_ramp routine output) */
     ref_sgn,      /* speed reference sign (speed_ramp routine input,
@@ -247,6 +255,11 @@ static ang_sincos_t
 /* vector containing the PWM timer compare values */
 static int32_t dutycycle[3];
 
+#ifdef DISCONTINUOUS_PWM
+/* discontinuous modulation active (modulation index above DPWM_MIN_MOD_INDEX) */
+static bool dpwm_active;
+#endif
+
 static vec3_t
     cur3m,      /* three-phases vector of current measurement [internal current unit] */
     outv3;      /* three-phases vector of output voltage reference [internal voltage unit] */
@@ -471,6 +484,20 @@ void motorcontrol_vars_init(void)
   sp_pi.hlim = 0;
   sp_pi.llim = 0;
 
+#ifdef LOAD_OBSERVER
+    /* load observer gains */
+  lo_obs.kb = KB_LOBS;
+  lo_obs.shb = (uint16_t)SH_LOBS;
+  lo_obs.ks = KS_LOBS;
+  lo_obs.shs = (uint16_t)SH_LOBS;
+  lo_obs.kl = KL_LOBS;
+  lo_obs.shl = (uint16_t)SH_LOBS;
+  lo_obs.lim = 0;
+  lo_obs.smem = 0;
+  lo_obs.lmem = 0;
+  lo_cur = 0;
+#endif
+
   /* */
   state_run = 0;
   ext_speed_ref_rpm = 0;
@@ -889,6 +916,9 @@ Output:      nothing
 ******************************************************************************/
 static inline void pwm_modulation_reset(void)
 {
+#ifdef DISCONTINUOUS_PWM
+    dpwm_active = false;
+#endif
     outv3.u = 0;
     outv3.v = 0;
     outv3.w = 0;
@@ -914,6 +944,8 @@ Description:  output duties calc, and three shunts current reading order
 Input:      nothing (uses global variables vbus and outvab)
 Output:      nothing (directly updates the duty registers)
 Note:      implements a clamped modulation (min-max);
+        with DISCONTINUOUS_PWM defined, the phase with the lowest voltage
+        is clamped to the negative rail above DPWM_MIN_MOD_INDEX;
         in case of clamping (hexagonal saturation), it re-calculates
         the output voltage value to keep the saturation into account
 ******************************************************************************/
@@ -928,6 +960,9 @@ void pwm_modulation(void)
   /* addresses of min, med and max duty */
   int16_t *amin, *amed, *amax;
   int16_t s16a, n_shft;
+#ifdef DISCONTINUOUS_PWM
+  int32_t s32b;
+#endif
 
   /* reverse-Clarke transformation */
   library_ab_uvw(&outvab, &outv3);
@@ -1094,13 +1129,38 @@ void pwm_modulation(void)
   else
   {
         /* duties update */
-#if 0  /* 2-phase modulation */
-    /* duties update */
-    (*amin) = (int16_t)PWM_HPER_TICKS - (*amax);
-    /* surely greater than DMIN, due to previous
-    comparison ((*amax) <= DELMAX_TICKS) */
-    (*amed) += (*amin);
-    (*amax) = (int16_t)PWM_HPER_TICKS;
+#ifdef DISCONTINUOUS_PWM
+    /* modulation index check with hysteresis: |outvab| against the
+      linear range limit vbus * K_AVAIL_VOL, scaled by the thresholds */
+    s32a = ((int32_t)outvab.x * (int32_t)outvab.x) + ((int32_t)outvab.y * (int32_t)outvab.y);
+    if(dpwm_active)
+    {
+      s32b = ((int32_t)vbus * (int32_t)K_DPWM_OFF) >> SH_BASE_VALUE;
+      dpwm_active = (s32a >= (s32b * s32b));
+    }
+    else
+    {
+      s32b = ((int32_t)vbus * (int32_t)K_DPWM_ON) >> SH_BASE_VALUE;
+      dpwm_active = (s32a > (s32b * s32b));
+    }
+    if(dpwm_active)
+    {
+      /* 2-phase modulation: the phase with the lowest voltage (maximum
+        duty) is clamped to the negative rail for the whole period, so its
+        low side switch stays on and the shunt current can still be read */
+      (*amin) = (int16_t)PWM_HPER_TICKS - (*amax);
+      /* surely greater than DMIN, due to previous
+      comparison ((*amax) <= DELMAX_TICKS) */
+      (*amed) += (*amin);
+      (*amax) = (int16_t)PWM_HPER_TICKS;
+    }
+    else
+    {
+      /* center-aligned modulation below the minimum modulation index */
+      (*amin) = HALF_HPER_TICKS - (*amax>>1);
+      (*amax) += (*amin);
+      (*amed) += (*amin);
+    }
 #else  /* center-aligned modulation */
     (*amin) = HALF_HPER_TICKS - (*amax>>1);
     (*amax) += (*amin);
@@ -1495,6 +1555,11 @@ void motorcontrol(void)
                 /* speed PI control memory setting */
                 sp_pi.imem = curdqr.y;
                 sp_pi.imem <<= sp_pi.shp;  /* speed PI integral term */
+                #ifdef LOAD_OBSERVER
+                /* load observer from the estimated speed, without load */
+                lo_obs.smem = (int32_t)get_angular_speed() << SH_LOBS_MEM;
+                lo_obs.lmem = 0;
+                #endif
                 /* position loss control reset */
                 pos_lost_control_reset();
 
@@ -1691,8 +1756,17 @@ static void MCAPP_MotorCurrentControl(void )
     #ifdef TORQUE_MODE
     curdqr.y = torque_adc_ref;
     #else // Speed Control
+    #ifdef LOAD_OBSERVER
+    /* load current estimate from the measured q current fed forward, the speed control limits leave room for it */
+    lo_obs.lim = sp_pi.hlim;
+    lo_cur = library_load_observer(elespeed, curdqm.y, &lo_obs);
+    sp_pi.hlim -= lo_cur;
+    sp_pi.llim -= lo_cur;
+    curdqr.y = library_pi_control(s32a, &sp_pi) + lo_cur;
+    #else
     curdqr.y = library_pi_control(s32a, &sp_pi);
     #endif
+    #endif
 
 #if( 1U == ENABLE_MTPA )
     dcurref_mtpa = MCAPP_idmaxTorquePerAmpere( );
@@ -1890,6 +1964,10 @@ void MCAPP_ResetStateVariables( void )
     id_pi.imem = 0;
     iq_pi.imem = 0;
     sp_pi.imem = 0;
+#ifdef LOAD_OBSERVER
+    lo_obs.lmem = 0;
+    lo_cur = 0;
+#endif
 
     outvdq.x = 0;
     outvdq.y = 0;
@@ -51,11 +51,10 @@ Headers inclusions
 #include "definitions.h"
 #include "userparams.h"
 
-int16_t result_soft,result_divas;
 /*******************************************************************************
 Macro definitions
 *******************************************************************************/
-extern pi_cntrl_t sp_pi;
+
 /* trigonometric tables */
 #define SH_TRITAB_DIM	( 8U )
 #define TRITAB_DIM		( (uint16_t)1U << (uint16_t)SH_TRITAB_DIM )
@@ -691,12 +690,9 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 		s32i = (int32_t)s16e * (int32_t)(pi->ki);
 		s32i >>= (pi->shi);
 		s32i += (pi->imem);
-        
-        
-                
 
 		/* proportional term */
-		s32p = (int32_t)s16e * (int32_t)(pi->kp);      
+		s32p = (int32_t)s16e * (int32_t)(pi->kp);
 
 		/* total control */
 		s32t = s32i + s32p;
@@ -705,7 +701,7 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 		/* result clamp and integral memory update */
 		if(s16t > (pi->hlim))
 		{
-            s16t = (pi->hlim);
+			s16t = (pi->hlim);
 			s32t = s16t;
 			s32t <<= (pi->shp);
 			(pi->imem) = s32t - s32p;
@@ -747,15 +743,15 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 
 		/* result clamp and integral memory update */
 		if(s16t < (pi->llim))
-		{           
-            s16t = (pi->llim);
+		{
+			s16t = (pi->llim);
 			s32t = s16t;
 			s32t <<= (pi->shp);
 			(pi->imem) = s32t + s32p;
 		}
 		else if(s16t > (pi->hlim))	/* case possible only if limit is changed */
 		{
-            s16t = (pi->hlim);
+			s16t = (pi->hlim);
 			s32t = s16t;
 			(pi->imem) = s32t << (pi->shp);
 		}
@@ -763,7 +759,6 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 		{
 			(pi->imem) = -s32i;
 		}
-        
 	}
 	else	/* error is 0 */
 	{
@@ -783,11 +778,82 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 			s32t = s16t;
 			(pi->imem) = s32t << (pi->shp);
 		}
-        else
-        {
-            /* no action */
-        }
+                else
+                {
+                  /* no action */
+                }
+	}
+        return(s16t);
+}
+
+/******************************************************************************
+Function:		library_load_observer
+Description:	Load torque observer of the speed loop
+Input:			measured speed
+				measured q current iq (the reference if it is not voltage limited)
+				pointer to the load observer structure lo
+Output:			load current estimate
+Modifies:		speed and load memories smem and lmem of the observer
+******************************************************************************/
+#ifdef RAM_EXECUTE
+int16_t __ramfunc__ library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#else
+int16_t library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#endif
+{
+	int32_t s32e, s32d, s32l;
+
+	/* speed estimate error, rounded to the speed unit and clamped */
+	s32e = ((int32_t)speed << SH_LOBS_MEM) - (lo->smem);
+	s32e += (int32_t)1 << (SH_LOBS_MEM - 1U);
+	s32e >>= SH_LOBS_MEM;
+	if(32767 < s32e)
+	{
+		s32e = 32767;
+	}
+	else if(-32767 > s32e)
+	{
+		s32e = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* accelerating current, clamped */
+	s32l = (lo->lmem) >> SH_LOBS_MEM;
+	s32d = (int32_t)iq - s32l;
+	if(32767 < s32d)
+	{
+		s32d = 32767;
+	}
+	else if(-32767 > s32d)
+	{
+		s32d = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* speed estimate */
+	(lo->smem) += (s32d * (int32_t)(lo->kb)) >> ((lo->shb) - SH_LOBS_MEM);
+	(lo->smem) += (s32e * (int32_t)(lo->ks)) >> ((lo->shs) - SH_LOBS_MEM);
+
+	/* load current estimate and clamp */
+	(lo->lmem) -= (s32e * (int32_t)(lo->kl)) >> ((lo->shl) - SH_LOBS_MEM);
+	s32l = (int32_t)(lo->lim) << SH_LOBS_MEM;
+	if(s32l < (lo->lmem))
+	{
+		(lo->lmem) = s32l;
+	}
+	else if(-s32l > (lo->lmem))
+	{
+		(lo->lmem) = -s32l;
+	}
+	else
+	{
+		/* no action */
 	}
-    
-    return(s16t);
+	return((int16_t)((lo->lmem) >> SH_LOBS_MEM));
 }
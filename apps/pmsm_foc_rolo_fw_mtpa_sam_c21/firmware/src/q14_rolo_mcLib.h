@@ -10,6 +10,9 @@
   Description:
     This file contains variables and function prototypes which are generally used in Motor Control.
     Implemented in Q2.14 Fixed Point Arithmetic.
+
+    Single source of the ROLO observer of the SAM C21 applications, see
+    algorithms/q14_mclib/readme.md.
  *******************************************************************************/
 
 //DOM-IGNORE-BEGIN
@@ -43,7 +46,10 @@
 /*******************************************************************************
 Macro definitions
 *******************************************************************************/
+/*	observer gain, which places the observer pole; can be overridden in userparams.h */
+#ifndef OBS_H_GAIN
 #define	OBS_H_GAIN			( 0.2f )				/* RANGE: 0.2 - 0.5 */
+#endif
 #define	OBS_C0_GAIN			( 1.0f - OBS_H_GAIN )	/* > 0 */
 #define	OBS_MINFREQ_HZ		( 3.0f )
 #define	OBS_MINSPEED_R_S	((float32_t)(2.0f * FLOAT_PI * OBS_MINFREQ_HZ))
@@ -57,8 +63,18 @@ Macro definitions
 
 /*	only the cross-coupling coefficients are speed dependent, and their value is usually
 	much lesser than the others; so in first approximation they could be neglected, saving
-	a lot of computation time; furthermore, neglecting them could lead to a higher noise immunity */
- #define CROSS_COUPLING_ENABLED 
+	a lot of computation time; furthermore, neglecting them could lead to a higher noise immunity.
+	define OBS_NO_CROSS_COUPLING in userparams.h to neglect them */
+#ifndef OBS_NO_CROSS_COUPLING
+#define CROSS_COUPLING_ENABLED
+#endif
+
+/*	medium delay of the estimation in half sampling periods, compensated by delay_comp:
+	2 (1 sampling period, PMSM applications) or 3 (1.5 sampling periods, V/Hz variant).
+	can be overridden in userparams.h */
+#ifndef OBS_DELAY_HALF_PERIODS
+#define OBS_DELAY_HALF_PERIODS	( 2 )
+#endif
 
 /* uncomment the following macro to enable amplification clamping */
 /* #define AMP_CLAMP */
@@ -148,9 +164,9 @@ int16_t get_angular_speed(void);
 
 /******************************************************************************
 Function:		get_Bemf_magnitude
-Description:	returns nack emf magnitude
+Description:	returns the back emf magnitude
 Input:			nothing
-Output:			compensated estimated position
+Output:			estimated back emf amplitude
 ******************************************************************************/
 #ifdef RAM_EXECUTE
 uint16_t __ramfunc__ get_Bemf_magnitude(void);
@@ -74,6 +74,11 @@
 /*Defining USE_DIVAS uses the DIVAS peripheral for division and square root operatons*/
 #define USE_DIVAS
 
+/* Defining DISCONTINUOUS_PWM clamps the phase with the lowest voltage to the negative rail (2-phase modulation)
+ above the modulation index DPWM_MIN_MOD_INDEX, which saves a third of the switching events.
+ Undefining DISCONTINUOUS_PWM keeps the center-aligned modulation at every modulation index */
+#undef DISCONTINUOUS_PWM
+
 
 
 /*******************************************************************************
@@ -220,6 +225,10 @@ Macro definitions
 #define K_MODLOSSES     ((DELMAX_TICKS_FL) / (float32_t)PWM_HPER_TICKS)  
 /* linear modulation */
 #define K_AVAIL_VOL     ((int16_t)(K_MODLOSSES * (float32_t)ONEBYSQRT3)) 
+/* discontinuous modulation above this ratio of the linear range, with hysteresis */
+#define DPWM_MIN_MOD_INDEX  (0.5f)
+#define K_DPWM_ON       ((int16_t)((float32_t)K_AVAIL_VOL * (DPWM_MIN_MOD_INDEX + 0.05f)))
+#define K_DPWM_OFF      ((int16_t)((float32_t)K_AVAIL_VOL * (DPWM_MIN_MOD_INDEX - 0.05f)))
 /* overmodulation */
 /*#define K_AVAIL_VOL     ((int16_t)(K_MODLOSSES * TWOTHIRDS))*/    
 /* maximum voltage readable by the A/D converter */
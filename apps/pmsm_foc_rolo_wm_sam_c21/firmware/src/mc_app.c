@@ -218,6 +218,11 @@ static ang_sincos_t
 /* vector containing the PWM timer compare values */
 static int32_t dutycycle[3];  
 
+#ifdef DISCONTINUOUS_PWM
+/* discontinuous modulation active (modulation index above DPWM_MIN_MOD_INDEX) */
+static bool dpwm_active;
+#endif
+
 static vec3_t
     cur3m,      /* three-phases vector of current measurement [internal current unit] */
     outv3;      /* three-phases vector of output voltage reference [internal voltage unit] */
@@ -845,6 +850,9 @@ Output:      nothing
 ******************************************************************************/
 static inline void pwm_modulation_reset(void)
 {
+#ifdef DISCONTINUOUS_PWM
+    dpwm_active = false;
+#endif
     outv3.u = 0;
     outv3.v = 0;
     outv3.w = 0;
@@ -868,6 +876,8 @@ Description:  output duties calc, and three shunts current reading order
 Input:      nothing (uses global variables vbus and outvab)
 Output:      nothing (directly updates the duty registers)
 Note:      implements a clamped modulation (min-max);
+        with DISCONTINUOUS_PWM defined, the phase with the lowest voltage
+        is clamped to the negative rail above DPWM_MIN_MOD_INDEX;
         in case of clamping (hexagonal saturation), it re-calculates
         the output voltage value to keep the saturation into account
 ******************************************************************************/
@@ -882,6 +892,9 @@ void pwm_modulation(void)
   /* addresses of min, med and max duty */
   int16_t *amin, *amed, *amax;  
   int16_t s16a, n_shft;
+#ifdef DISCONTINUOUS_PWM
+  int32_t s32b;
+#endif
 
   /* reverse-Clarke transformation */
   library_ab_uvw(&outvab, &outv3);
@@ -1047,13 +1060,38 @@ void pwm_modulation(void)
   else
   {
         /* duties update */
-#if 0  /* 2-phase modulation */
-    /* duties update */
-    (*amin) = (int16_t)PWM_HPER_TICKS - (*amax);
-    /* surely greater than DMIN, due to previous 
-    comparison ((*amax) <= DELMAX_TICKS) */
-    (*amed) += (*amin);
-    (*amax) = (int16_t)PWM_HPER_TICKS;
+#ifdef DISCONTINUOUS_PWM
+    /* modulation index check with hysteresis: |outvab| against the
+      linear range limit vbus * K_AVAIL_VOL, scaled by the thresholds */
+    s32a = ((int32_t)outvab.x * (int32_t)outvab.x) + ((int32_t)outvab.y * (int32_t)outvab.y);
+    if(dpwm_active)
+    {
+      s32b = ((int32_t)vbus * (int32_t)K_DPWM_OFF) >> SH_BASE_VALUE;
+      dpwm_active = (s32a >= (s32b * s32b));
+    }
+    else
+    {
+      s32b = ((int32_t)vbus * (int32_t)K_DPWM_ON) >> SH_BASE_VALUE;
+      dpwm_active = (s32a > (s32b * s32b));
+    }
+    if(dpwm_active)
+    {
+      /* 2-phase modulation: the phase with the lowest voltage (maximum
+        duty) is clamped to the negative rail for the whole period, so its
+        low side switch stays on and the shunt current can still be read */
+      (*amin) = (int16_t)PWM_HPER_TICKS - (*amax);
+      /* surely greater than DMIN, due to previous
+      comparison ((*amax) <= DELMAX_TICKS) */
+      (*amed) += (*amin);
+      (*amax) = (int16_t)PWM_HPER_TICKS;
+    }
+    else
+    {
+      /* center-aligned modulation below the minimum modulation index */
+      (*amin) = HALF_HPER_TICKS - (*amax>>1);
+      (*amax) += (*amin);
+      (*amed) += (*amin);
+    }
 #else  /* center-aligned modulation */
     (*amin) = HALF_HPER_TICKS - (*amax>>1);
     (*amax) += (*amin);
@@ -48,9 +48,8 @@ Headers inclusions
 #include <math.h>
 #include <stdint.h>
 #include "q14_generic_mcLib.h"
-#include "userparams.h"
 #include "definitions.h"
-
+#include "userparams.h"
 
 /*******************************************************************************
 Macro definitions
@@ -70,8 +69,6 @@ Macro definitions
 /******************************************************************************
 Private global variables
 ******************************************************************************/
-int32_t g_s32i, g_s32p, g_s32t;
-	int16_t	g_s16e, g_s16t;
 
 /* table y = BASE_VALUE * sin((pi/2) * x / TRITAB_DIM)
  0 <= x <= TRITAB_DIM, 0 <= y <= BASE_VALUE (first quarter) */
@@ -394,13 +391,17 @@ uint16_t library_atan2(int16_t x, int16_t y)
 		else if(b < a)
 		{
 			u32a = (uint32_t)b * (uint32_t)BASE_VALUE_INT;
-			u16a = (uint16_t)(u32a / a);
+
+            u16a = (uint16_t)(u32a / a);
+
 			u16a = (uint16_t)library_tbact[u16a >> (uint16_t)SH_ACTTAB];
 		}
 		else
 		{
 			u32a = (uint32_t)a * (uint32_t)BASE_VALUE_INT;
-			u16a = (uint16_t)(u32a / b);
+
+            u16a = (uint16_t)(u32a / b);
+
 			u16a = (uint16_t)library_tbact[u16a >> (uint16_t)SH_ACTTAB];
 			u16a = PIHALVES - u16a;	
                         /* overflow is OK here! */
@@ -522,6 +523,7 @@ void library_ab_uvw(const vec2_t *ab, vec3_t *uvw)
 	s32a = ((int32_t)(ab->y)) * SQRT3;
     s32a >>= SH_BASE_VALUE;
 	s32a -= (ab->x);
+	
     (uvw->v) = (int16_t)(s32a >> 1);
 
 	/* w */
@@ -620,7 +622,7 @@ void library_xy_rt(const vec2_t *xy, vecp_t *rt)
 	else
 	{	/* |sin(ang)|<=|cos(ang)|*/
 		s32a = ((int32_t)(xy->x)) * (int32_t)BASE_VALUE_INT;
-		temp =  (int16_t)(s32a / ((rt->t).cos)) ;
+        temp =  (int16_t)(s32a / ((rt->t).cos)) ;
         (rt->r) = (uint16_t)temp;
 	}
 }
@@ -691,12 +693,12 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
 
 		/* proportional term */
 		s32p = (int32_t)s16e * (int32_t)(pi->kp);
-        
+
 		/* total control */
 		s32t = s32i + s32p;
 		s16t = (int16_t)(s32t >> (pi->shp));
-       
-       		/* result clamp and integral memory update */
+
+		/* result clamp and integral memory update */
 		if(s16t > (pi->hlim))
 		{
 			s16t = (pi->hlim);
@@ -781,7 +783,77 @@ int16_t library_pi_control(int32_t erl, pi_cntrl_t *pi)
                   /* no action */
                 }
 	}
-
         return(s16t);
 }
 
+/******************************************************************************
+Function:		library_load_observer
+Description:	Load torque observer of the speed loop
+Input:			measured speed
+				measured q current iq (the reference if it is not voltage limited)
+				pointer to the load observer structure lo
+Output:			load current estimate
+Modifies:		speed and load memories smem and lmem of the observer
+******************************************************************************/
+#ifdef RAM_EXECUTE
+int16_t __ramfunc__ library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#else
+int16_t library_load_observer(int16_t speed, int16_t iq, load_obs_t *lo)
+#endif
+{
+	int32_t s32e, s32d, s32l;
+
+	/* speed estimate error, rounded to the speed unit and clamped */
+	s32e = ((int32_t)speed << SH_LOBS_MEM) - (lo->smem);
+	s32e += (int32_t)1 << (SH_LOBS_MEM - 1U);
+	s32e >>= SH_LOBS_MEM;
+	if(32767 < s32e)
+	{
+		s32e = 32767;
+	}
+	else if(-32767 > s32e)
+	{
+		s32e = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* accelerating current, clamped */
+	s32l = (lo->lmem) >> SH_LOBS_MEM;
+	s32d = (int32_t)iq - s32l;
+	if(32767 < s32d)
+	{
+		s32d = 32767;
+	}
+	else if(-32767 > s32d)
+	{
+		s32d = -32767;
+	}
+	else
+	{
+		/* no action */
+	}
+
+	/* speed estimate */
+	(lo->smem) += (s32d * (int32_t)(lo->kb)) >> ((lo->shb) - SH_LOBS_MEM);
+	(lo->smem) += (s32e * (int32_t)(lo->ks)) >> ((lo->shs) - SH_LOBS_MEM);
+
+	/* load current estimate and clamp */
+	(lo->lmem) -= (s32e * (int32_t)(lo->kl)) >> ((lo->shl) - SH_LOBS_MEM);
+	s32l = (int32_t)(lo->lim) << SH_LOBS_MEM;
+	if(s32l < (lo->lmem))
+	{
+		(lo->lmem) = s32l;
+	}
+	else if(-s32l > (lo->lmem))
+	{
+		(lo->lmem) = -s32l;
+	}
+	else
+	{
+		/* no action */
+	}
+	return((int16_t)((lo->lmem) >> SH_LOBS_MEM));
+}